@@ -0,0 +1,896 @@
+#include "mio/mio.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#	include <psapi.h>
+#	include <sys/stat.h>
+#else
+#	include <sys/resource.h>
+#	include <sys/stat.h>
+#	include <time.h>
+#endif
+
+// mio_bench: generates a large synthetic mesh, writes and reads it back in every supported format,
+// and reports the time, throughput and peak memory of each step as one JSON object per line. Steps
+// that read a file also report the breakdown of "MioLoadStats". The output of the library itself
+// is turned off.
+//
+//   mio_bench [-f faces] [-s tri|quad|mixed] [-a] [-t threads] [-n runs] [-o dir] [-r file] [-k]
+//
+//   -f  number of faces to generate (default 1000000)
+//   -s  face shapes: triangles, quads, or a mix of triangles, quads and hexagons (default quad)
+//   -a  generate texture coordinates and normals as well
+//   -t  number of threads for the parallel readers and writers (default 0 = number of hardware
+//       threads)
+//   -n  number of times that each step is run, of which the fastest is reported (default 1)
+//   -o  directory where the files are written (default ".")
+//   -r  file where the results are written (default stdout)
+//   -k  keep the files that were written
+
+enum Shape
+{
+	SHAPE_TRI,
+	SHAPE_QUAD,
+	SHAPE_MIXED
+};
+
+typedef struct Options
+{
+	unsigned long long numFaces;
+	enum Shape shape;
+	int withAttributes;
+	unsigned int numThreads;
+	unsigned int numRuns;
+	const char* pDir;
+	const char* pResultsPath;
+	int keepFiles;
+} Options;
+
+// the mesh that is written and read back (and the triangle soup that is written as .stl)
+typedef struct BenchMesh
+{
+	MioMesh mesh;
+	size_t numFaceVertices;
+
+	double* pSoupVertices;
+	double* pSoupNormals;
+	unsigned int numSoupVertices;
+} BenchMesh;
+
+// state that is shared by the steps
+typedef struct Bench
+{
+	const Options* pOptions;
+	BenchMesh* pMesh;
+	FILE* results;
+	char path[4096];
+} Bench;
+
+static double getTime(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+#endif
+}
+
+// Function to reset the peak resident set size (where the OS supports it), so that the peak that
+// is reported for a step is that of the step rather than that of the whole process so far
+static void resetPeakRSS(void)
+{
+#if defined(__linux__)
+	FILE* file = fopen("/proc/self/clear_refs", "w");
+
+	if(file != NULL)
+	{
+		fputs("5", file);
+		fclose(file);
+	}
+#endif
+}
+
+// Function to get the peak resident set size in KiB (0 if unknown)
+static unsigned long long getPeakRSS(void)
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return (unsigned long long)counters.PeakWorkingSetSize / 1024;
+	}
+
+	return 0;
+#elif defined(__linux__)
+	// (unlike getrusage) this reflects "resetPeakRSS"
+	FILE* file = fopen("/proc/self/status", "r");
+	char line[256];
+	unsigned long long peak = 0;
+
+	while(file != NULL && fgets(line, sizeof(line), file) != NULL)
+	{
+		if(strncmp(line, "VmHWM:", 6) == 0)
+		{
+			peak = strtoull(line + 6, NULL, 10);
+			break;
+		}
+	}
+
+	if(file != NULL)
+	{
+		fclose(file);
+	}
+
+	return peak;
+#else
+	struct rusage usage;
+
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+
+#	if defined(__APPLE__)
+	return (unsigned long long)usage.ru_maxrss / 1024; // bytes
+#	else
+	return (unsigned long long)usage.ru_maxrss;
+#	endif
+#endif
+}
+
+static unsigned long long getFileSize(const char* fpath)
+{
+#if defined(_WIN32)
+	struct _stat64 info;
+
+	return (_stat64(fpath, &info) == 0) ? (unsigned long long)info.st_size : 0;
+#else
+	struct stat info;
+
+	return (stat(fpath, &info) == 0) ? (unsigned long long)info.st_size : 0;
+#endif
+}
+
+static void* allocateOrDie(size_t count, size_t elemSize)
+{
+	void* ptr = malloc(count * elemSize);
+
+	if(ptr == NULL && count != 0)
+	{
+		fprintf(stderr, "error: failed to allocate %zu elements of %zu bytes\n", count, elemSize);
+		exit(1);
+	}
+
+	return ptr;
+}
+
+static void addFace(BenchMesh* pMesh, const unsigned int* pIndices, unsigned int count)
+{
+	MioMesh* pOut = &pMesh->mesh;
+
+	pOut->pFaceSizes[pOut->numFaces++] = count;
+	memcpy(pOut->pFaceVertexIndices + pMesh->numFaceVertices,
+		   pIndices,
+		   sizeof(unsigned int) * count);
+	pMesh->numFaceVertices += count;
+}
+
+// Function to generate a grid of faces with the given shape, where every cell is a quad or two
+// triangles, and "mixed" cycles through pairs of cells that are a hexagon, two quads or four
+// triangles. The coordinates are perturbed so that they do not all have short decimal forms.
+static void generateMesh(const Options* pOptions, BenchMesh* pMesh)
+{
+	// faces per cell (mixed: 7 faces per 3 pairs of cells)
+	const double facesPerCell =
+		(pOptions->shape == SHAPE_TRI) ? 2.0 : ((pOptions->shape == SHAPE_QUAD) ? 1.0 : 7.0 / 6.0);
+	const double numCells = ceil((double)pOptions->numFaces / facesPerCell);
+	unsigned long long width = (unsigned long long)ceil(sqrt(numCells));
+
+	width += (width & 1); // mixed faces span two cells
+	const unsigned long long height = (unsigned long long)ceil(numCells / (double)width);
+	const unsigned long long numVertices = (width + 1) * (height + 1);
+
+	if(numVertices > 0xffffffffull || width * height * 2 > 0xffffffffull)
+	{
+		fprintf(stderr, "error: too many faces\n");
+		exit(1);
+	}
+
+	memset(pMesh, 0, sizeof(BenchMesh));
+
+	MioMesh* pOut = &pMesh->mesh;
+
+	pOut->numVertices = (unsigned int)numVertices;
+	pOut->pVertices = (double*)allocateOrDie(numVertices * 3, sizeof(double));
+
+	for(unsigned long long y = 0; y <= height; ++y)
+	{
+		for(unsigned long long x = 0; x <= width; ++x)
+		{
+			double* pCoords = pOut->pVertices + (y * (width + 1) + x) * 3;
+
+			pCoords[0] = (double)x / (double)width;
+			pCoords[1] = (double)y / (double)height;
+			pCoords[2] = 0.05 * sin((double)x * 0.37) * cos((double)y * 0.21);
+		}
+	}
+
+	if(pOptions->withAttributes)
+	{
+		pOut->numNormals = pOut->numVertices;
+		pOut->numTexCoords = pOut->numVertices;
+		pOut->pNormals = (double*)allocateOrDie(numVertices * 3, sizeof(double));
+		pOut->pTexCoords = (double*)allocateOrDie(numVertices * 2, sizeof(double));
+
+		for(unsigned long long i = 0; i < numVertices; ++i)
+		{
+			const double* pCoords = pOut->pVertices + i * 3;
+			const double nx = -pCoords[2];
+			const double length = sqrt(nx * nx + 1.0);
+
+			pOut->pNormals[i * 3 + 0] = nx / length;
+			pOut->pNormals[i * 3 + 1] = 0.0;
+			pOut->pNormals[i * 3 + 2] = 1.0 / length;
+			pOut->pTexCoords[i * 2 + 0] = pCoords[0];
+			pOut->pTexCoords[i * 2 + 1] = pCoords[1];
+		}
+	}
+
+	// upper bounds: 4 faces and 12 face-vertices per pair of cells
+	const size_t maxFaces = (size_t)(width * height * 2);
+	const size_t maxFaceVertices = (size_t)(width * height * 6);
+
+	pOut->pFaceSizes = (unsigned int*)allocateOrDie(maxFaces, sizeof(unsigned int));
+	pOut->pFaceVertexIndices = (unsigned int*)allocateOrDie(maxFaceVertices, sizeof(unsigned int));
+
+	const unsigned int rowSize = (unsigned int)(width + 1);
+
+	for(unsigned int y = 0; y < (unsigned int)height; ++y)
+	{
+		for(unsigned int x = 0; x < (unsigned int)width; x += 2)
+		{
+			// corners of the two cells (x, y) and (x + 1, y) in counter-clockwise order
+			const unsigned int v0 = y * rowSize + x;
+			const unsigned int b[3] = {v0, v0 + 1, v0 + 2};
+			const unsigned int t[3] = {v0 + rowSize, v0 + rowSize + 1, v0 + rowSize + 2};
+			enum Shape shape = pOptions->shape;
+			unsigned int mixedCase = 0;
+
+			if(shape == SHAPE_MIXED)
+			{
+				mixedCase = (y * (unsigned int)(width / 2) + x / 2) % 3;
+				shape = (mixedCase == 2) ? SHAPE_TRI : SHAPE_QUAD;
+			}
+
+			if(mixedCase == 0 && pOptions->shape == SHAPE_MIXED)
+			{
+				const unsigned int hexagon[6] = {b[0], b[1], b[2], t[2], t[1], t[0]};
+
+				addFace(pMesh, hexagon, 6);
+				continue;
+			}
+
+			for(int i = 0; i < 2; ++i)
+			{
+				if(shape == SHAPE_QUAD)
+				{
+					const unsigned int quad[4] = {b[i], b[i + 1], t[i + 1], t[i]};
+
+					addFace(pMesh, quad, 4);
+				}
+				else
+				{
+					const unsigned int tri0[3] = {b[i], b[i + 1], t[i + 1]};
+					const unsigned int tri1[3] = {b[i], t[i + 1], t[i]};
+
+					addFace(pMesh, tri0, 3);
+					addFace(pMesh, tri1, 3);
+				}
+			}
+		}
+	}
+
+	if(pOptions->withAttributes)
+	{
+		// the normals and texture coordinates are per vertex
+		const size_t indicesSize = sizeof(unsigned int) * pMesh->numFaceVertices;
+
+		pOut->pFaceVertexNormalIndices =
+			(unsigned int*)allocateOrDie(pMesh->numFaceVertices, sizeof(unsigned int));
+		pOut->pFaceVertexTexCoordIndices =
+			(unsigned int*)allocateOrDie(pMesh->numFaceVertices, sizeof(unsigned int));
+		memcpy(pOut->pFaceVertexNormalIndices, pOut->pFaceVertexIndices, indicesSize);
+		memcpy(pOut->pFaceVertexTexCoordIndices, pOut->pFaceVertexIndices, indicesSize);
+	}
+
+	// the triangle soup for .stl files (with a fan for each face)
+	size_t numTriangles = 0;
+
+	for(unsigned int i = 0; i < pOut->numFaces; ++i)
+	{
+		numTriangles += pOut->pFaceSizes[i] - 2;
+	}
+
+	if(numTriangles * 3 > 0xffffffffull)
+	{
+		return; // cannot be written as .stl
+	}
+
+	pMesh->numSoupVertices = (unsigned int)(numTriangles * 3);
+	pMesh->pSoupVertices = (double*)allocateOrDie(numTriangles * 9, sizeof(double));
+	pMesh->pSoupNormals = (double*)allocateOrDie(numTriangles * 9, sizeof(double));
+
+	const unsigned int* pIndex = pOut->pFaceVertexIndices;
+	double* pSoupVertex = pMesh->pSoupVertices;
+	double* pSoupNormal = pMesh->pSoupNormals;
+
+	for(unsigned int i = 0; i < pOut->numFaces; ++i)
+	{
+		for(unsigned int j = 1; j + 1 < pOut->pFaceSizes[i]; ++j)
+		{
+			const unsigned int corners[3] = {pIndex[0], pIndex[j], pIndex[j + 1]};
+
+			for(int k = 0; k < 3; ++k)
+			{
+				memcpy(pSoupVertex, pOut->pVertices + (size_t)corners[k] * 3, sizeof(double) * 3);
+				pSoupNormal[0] = 0.0;
+				pSoupNormal[1] = 0.0;
+				pSoupNormal[2] = 1.0;
+				pSoupVertex += 3;
+				pSoupNormal += 3;
+			}
+		}
+
+		pIndex += pOut->pFaceSizes[i];
+	}
+}
+
+static void freeBenchMesh(BenchMesh* pMesh)
+{
+	free(pMesh->mesh.pVertices);
+	free(pMesh->mesh.pNormals);
+	free(pMesh->mesh.pTexCoords);
+	free(pMesh->mesh.pFaceSizes);
+	free(pMesh->mesh.pFaceVertexIndices);
+	free(pMesh->mesh.pFaceVertexTexCoordIndices);
+	free(pMesh->mesh.pFaceVertexNormalIndices);
+	free(pMesh->pSoupVertices);
+	free(pMesh->pSoupNormals);
+	memset(pMesh, 0, sizeof(BenchMesh));
+}
+
+// a benchmarked step, which reads or writes the file at "fpath"
+typedef void (*StepFunc)(Bench* pBench, const char* fpath);
+
+// Function to write the result of a step, where "pStats" is NULL for steps that do not read a file
+static void printResult(Bench* pBench,
+						const char* pStep,
+						const char* fpath,
+						double seconds,
+						unsigned long long numFaces,
+						unsigned long long peakRSS,
+						const MioLoadStats* pStats)
+{
+	const unsigned long long numBytes = (fpath != NULL) ? getFileSize(fpath) : 0;
+
+	fprintf(pBench->results,
+			"{\"step\":\"%s\",\"faces\":%llu,\"bytes\":%llu,\"seconds\":%.6f,"
+			"\"mb_per_s\":%.3f,\"mfaces_per_s\":%.3f,\"peak_rss_kib\":%llu",
+			pStep,
+			numFaces,
+			numBytes,
+			seconds,
+			(seconds > 0.0) ? (double)numBytes / seconds * 1e-6 : 0.0,
+			(seconds > 0.0) ? (double)numFaces / seconds * 1e-6 : 0.0,
+			peakRSS);
+
+	if(pStats != NULL)
+	{
+		fprintf(pBench->results,
+				",\"lines\":%llu,\"passes\":%u,\"io_seconds\":%.6f,\"alloc_seconds\":%.6f,"
+				"\"parse_seconds\":%.6f",
+				pStats->numLines,
+				pStats->numPasses,
+				pStats->ioSeconds,
+				pStats->allocSeconds,
+				pStats->parseSeconds);
+	}
+
+	fputs("}\n", pBench->results);
+	fflush(pBench->results);
+}
+
+// Function to run "pfnStep" on "<dir>/<pFileName>" the given number of times and report the
+// fastest run
+static void runStep(Bench* pBench, const char* pStep, const char* pFileName, StepFunc pfnStep)
+{
+	double bestSeconds = -1.0;
+	unsigned long long peakRSS = 0;
+	MioLoadStats stats;
+	MioLoadStats bestStats;
+
+	memset(&bestStats, 0, sizeof(MioLoadStats));
+	snprintf(pBench->path, sizeof(pBench->path), "%s/%s", pBench->pOptions->pDir, pFileName);
+
+	for(unsigned int i = 0; i < pBench->pOptions->numRuns; ++i)
+	{
+		resetPeakRSS();
+		memset(&stats, 0, sizeof(MioLoadStats));
+		mioSetLoadStats(&stats);
+
+		const double start = getTime();
+
+		pfnStep(pBench, pBench->path);
+
+		const double seconds = getTime() - start;
+		const unsigned long long rss = getPeakRSS();
+
+		mioSetLoadStats(NULL);
+
+		if(bestSeconds < 0.0 || seconds < bestSeconds)
+		{
+			bestSeconds = seconds;
+			bestStats = stats;
+		}
+
+		peakRSS = (rss > peakRSS) ? rss : peakRSS;
+	}
+
+	printResult(pBench,
+				pStep,
+				pBench->path,
+				bestSeconds,
+				pBench->pMesh->mesh.numFaces,
+				peakRSS,
+				(bestStats.numPasses > 0) ? &bestStats : NULL); // i.e. the step has read a file
+}
+
+static void writeOBJStep(Bench* pBench, const char* fpath)
+{
+	MioMesh* pMesh = &pBench->pMesh->mesh;
+
+	mioWriteOBJ(fpath,
+				pMesh->pVertices,
+				pMesh->pNormals,
+				pMesh->pTexCoords,
+				pMesh->pFaceSizes,
+				pMesh->pFaceVertexIndices,
+				pMesh->pFaceVertexTexCoordIndices,
+				pMesh->pFaceVertexNormalIndices,
+				pMesh->numVertices,
+				pMesh->numNormals,
+				pMesh->numTexCoords,
+				pMesh->numFaces);
+}
+
+static void writeOBJParallelStep(Bench* pBench, const char* fpath)
+{
+	MioMesh* pMesh = &pBench->pMesh->mesh;
+
+	mioWriteOBJParallel(fpath,
+						pMesh->pVertices,
+						pMesh->pNormals,
+						pMesh->pTexCoords,
+						pMesh->pFaceSizes,
+						pMesh->pFaceVertexIndices,
+						pMesh->pFaceVertexTexCoordIndices,
+						pMesh->pFaceVertexNormalIndices,
+						pMesh->numVertices,
+						pMesh->numNormals,
+						pMesh->numTexCoords,
+						pMesh->numFaces,
+						pBench->pOptions->numThreads);
+}
+
+static void readOBJStep(Bench* pBench, const char* fpath)
+{
+	(void)pBench;
+
+	MioMesh mesh;
+
+	memset(&mesh, 0, sizeof(MioMesh));
+	mioReadOBJ(fpath,
+			   &mesh.pVertices,
+			   &mesh.pNormals,
+			   &mesh.pTexCoords,
+			   &mesh.pFaceSizes,
+			   &mesh.pFaceVertexIndices,
+			   &mesh.pFaceVertexTexCoordIndices,
+			   &mesh.pFaceVertexNormalIndices,
+			   &mesh.numVertices,
+			   &mesh.numNormals,
+			   &mesh.numTexCoords,
+			   &mesh.numFaces);
+	mioFreeMesh(&mesh);
+}
+
+static void readOBJParallelStep(Bench* pBench, const char* fpath)
+{
+	MioMesh mesh;
+
+	memset(&mesh, 0, sizeof(MioMesh));
+	mioReadOBJParallel(fpath,
+					   &mesh.pVertices,
+					   &mesh.pNormals,
+					   &mesh.pTexCoords,
+					   &mesh.pFaceSizes,
+					   &mesh.pFaceVertexIndices,
+					   &mesh.pFaceVertexTexCoordIndices,
+					   &mesh.pFaceVertexNormalIndices,
+					   &mesh.numVertices,
+					   &mesh.numNormals,
+					   &mesh.numTexCoords,
+					   &mesh.numFaces,
+					   pBench->pOptions->numThreads);
+	mioFreeMesh(&mesh);
+}
+
+static void visitOnVertex(const double* pCoords, void* pUserData)
+{
+	*(double*)pUserData += pCoords[0];
+}
+
+static void visitOBJStep(Bench* pBench, const char* fpath)
+{
+	(void)pBench;
+
+	double sum = 0.0;
+	const MioVisitor visitor = {visitOnVertex, NULL, NULL, NULL, &sum};
+
+	mioVisitOBJ(fpath, &visitor);
+}
+
+static void writeOFFStep(Bench* pBench, const char* fpath)
+{
+	MioMesh* pMesh = &pBench->pMesh->mesh;
+
+	mioWriteOFF(fpath,
+				pMesh->pVertices,
+				pMesh->pFaceVertexIndices,
+				pMesh->pFaceSizes,
+				NULL,
+				pMesh->numVertices,
+				pMesh->numFaces,
+				0);
+}
+
+static void writeOFFParallelStep(Bench* pBench, const char* fpath)
+{
+	MioMesh* pMesh = &pBench->pMesh->mesh;
+
+	mioWriteOFFParallel(fpath,
+						pMesh->pVertices,
+						pMesh->pFaceVertexIndices,
+						pMesh->pFaceSizes,
+						NULL,
+						pMesh->numVertices,
+						pMesh->numFaces,
+						0,
+						pBench->pOptions->numThreads);
+}
+
+static void readOFFStep(Bench* pBench, const char* fpath)
+{
+	(void)pBench;
+
+	MioMesh mesh;
+
+	memset(&mesh, 0, sizeof(MioMesh));
+	mioReadOFF(fpath,
+			   &mesh.pVertices,
+			   &mesh.pFaceVertexIndices,
+			   &mesh.pFaceSizes,
+			   &mesh.numVertices,
+			   &mesh.numFaces);
+	mioFreeMesh(&mesh);
+}
+
+static void writePLYStep(Bench* pBench, const char* fpath)
+{
+	MioMesh* pMesh = &pBench->pMesh->mesh;
+
+	mioWritePLY(fpath,
+				pMesh->pVertices,
+				pMesh->pNormals,
+				pMesh->pTexCoords,
+				pMesh->pFaceSizes,
+				pMesh->pFaceVertexIndices,
+				pMesh->numVertices,
+				pMesh->numFaces);
+}
+
+static void writePLYBinaryStep(Bench* pBench, const char* fpath)
+{
+	MioMesh* pMesh = &pBench->pMesh->mesh;
+
+	mioWritePLYBinary(fpath,
+					  pMesh->pVertices,
+					  pMesh->pNormals,
+					  pMesh->pTexCoords,
+					  pMesh->pFaceSizes,
+					  pMesh->pFaceVertexIndices,
+					  pMesh->numVertices,
+					  pMesh->numFaces);
+}
+
+static void readPLYStep(Bench* pBench, const char* fpath)
+{
+	(void)pBench;
+
+	MioMesh mesh;
+
+	memset(&mesh, 0, sizeof(MioMesh));
+	mioReadPLY(fpath,
+			   &mesh.pVertices,
+			   &mesh.pNormals,
+			   &mesh.pTexCoords,
+			   &mesh.pFaceSizes,
+			   &mesh.pFaceVertexIndices,
+			   &mesh.numVertices,
+			   &mesh.numFaces);
+	mioFreeMesh(&mesh);
+}
+
+static void writeSTLStep(Bench* pBench, const char* fpath)
+{
+	BenchMesh* pMesh = pBench->pMesh;
+
+	mioWriteSTL(fpath, pMesh->pSoupVertices, pMesh->pSoupNormals, pMesh->numSoupVertices);
+}
+
+static void writeSTLBinaryStep(Bench* pBench, const char* fpath)
+{
+	BenchMesh* pMesh = pBench->pMesh;
+
+	mioWriteSTLBinary(fpath, pMesh->pSoupVertices, pMesh->pSoupNormals, pMesh->numSoupVertices);
+}
+
+static void readSTLStep(Bench* pBench, const char* fpath)
+{
+	(void)pBench;
+
+	double* pVertices = NULL;
+	double* pNormals = NULL;
+	unsigned int numVertices = 0;
+
+	mioReadSTL(fpath, &pVertices, &pNormals, &numVertices);
+	mioFree(pVertices);
+	mioFree(pNormals);
+}
+
+static void readSTLWeldedStep(Bench* pBench, const char* fpath)
+{
+	(void)pBench;
+
+	MioMesh mesh;
+
+	memset(&mesh, 0, sizeof(MioMesh));
+	mioReadSTLWelded(fpath,
+					 &mesh.pVertices,
+					 &mesh.pNormals,
+					 &mesh.pFaceSizes,
+					 &mesh.pFaceVertexIndices,
+					 &mesh.numVertices,
+					 &mesh.numFaces,
+					 0.0);
+	mioFreeMesh(&mesh);
+}
+
+static void writeMIOBStep(Bench* pBench, const char* fpath)
+{
+	mioWriteMIOB(fpath, &pBench->pMesh->mesh);
+}
+
+static void readMIOBStep(Bench* pBench, const char* fpath)
+{
+	(void)pBench;
+
+	MioMesh mesh;
+	volatile double sum = 0.0;
+
+	mioReadMIOB(fpath, &mesh);
+
+	// touch every page of the vertices, which are otherwise only mapped
+	for(size_t i = 0; i < (size_t)mesh.numVertices * 3; i += 512)
+	{
+		sum += mesh.pVertices[i];
+	}
+
+	mioFreeMesh(&mesh);
+}
+
+static void usage(void)
+{
+	fprintf(stderr,
+			"usage: mio_bench [-f faces] [-s tri|quad|mixed] [-a] [-t threads] [-n runs] "
+			"[-o dir] [-r file] [-k]\n");
+	exit(1);
+}
+
+static void parseOptions(int argc, char* argv[], Options* pOptions)
+{
+	memset(pOptions, 0, sizeof(Options));
+	pOptions->numFaces = 1000000;
+	pOptions->shape = SHAPE_QUAD;
+	pOptions->numRuns = 1;
+	pOptions->pDir = ".";
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const char* pArg = argv[i];
+		const char* pValue = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+		if(strcmp(pArg, "-a") == 0)
+		{
+			pOptions->withAttributes = 1;
+			continue;
+		}
+
+		if(strcmp(pArg, "-k") == 0)
+		{
+			pOptions->keepFiles = 1;
+			continue;
+		}
+
+		if(pValue == NULL)
+		{
+			usage();
+		}
+
+		if(strcmp(pArg, "-f") == 0)
+		{
+			pOptions->numFaces = strtoull(pValue, NULL, 10);
+		}
+		else if(strcmp(pArg, "-s") == 0)
+		{
+			if(strcmp(pValue, "tri") == 0)
+			{
+				pOptions->shape = SHAPE_TRI;
+			}
+			else if(strcmp(pValue, "quad") == 0)
+			{
+				pOptions->shape = SHAPE_QUAD;
+			}
+			else if(strcmp(pValue, "mixed") == 0)
+			{
+				pOptions->shape = SHAPE_MIXED;
+			}
+			else
+			{
+				usage();
+			}
+		}
+		else if(strcmp(pArg, "-t") == 0)
+		{
+			pOptions->numThreads = (unsigned int)strtoul(pValue, NULL, 10);
+		}
+		else if(strcmp(pArg, "-n") == 0)
+		{
+			pOptions->numRuns = (unsigned int)strtoul(pValue, NULL, 10);
+		}
+		else if(strcmp(pArg, "-o") == 0)
+		{
+			pOptions->pDir = pValue;
+		}
+		else if(strcmp(pArg, "-r") == 0)
+		{
+			pOptions->pResultsPath = pValue;
+		}
+		else
+		{
+			usage();
+		}
+
+		++i; // the value
+	}
+
+	if(pOptions->numFaces == 0 || pOptions->numRuns == 0)
+	{
+		usage();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	BenchMesh mesh;
+	Bench bench;
+
+	parseOptions(argc, argv, &options);
+	mioSetLogLevel(MIO_LOG_LEVEL_ERRORS);
+
+	memset(&bench, 0, sizeof(Bench));
+	bench.pOptions = &options;
+	bench.pMesh = &mesh;
+	bench.results = stdout;
+
+	if(options.pResultsPath != NULL)
+	{
+		bench.results = fopen(options.pResultsPath, "w");
+
+		if(bench.results == NULL)
+		{
+			fprintf(stderr, "error: failed to open `%s`\n", options.pResultsPath);
+			return 1;
+		}
+	}
+
+	resetPeakRSS();
+
+	const double start = getTime();
+
+	generateMesh(&options, &mesh);
+	printResult(
+		&bench, "generate", NULL, getTime() - start, mesh.mesh.numFaces, getPeakRSS(), NULL);
+
+	// each writer is followed by the readers of the file that it wrote
+	static const struct
+	{
+		const char* pStep;
+		const char* pFileName;
+		StepFunc pfnStep;
+	} steps[] = {
+		{"write_obj", "mio_bench.obj", writeOBJStep},
+		{"write_obj_parallel", "mio_bench-parallel.obj", writeOBJParallelStep},
+		{"read_obj", "mio_bench.obj", readOBJStep},
+		{"read_obj_parallel", "mio_bench.obj", readOBJParallelStep},
+		{"visit_obj", "mio_bench.obj", visitOBJStep},
+		{"write_off", "mio_bench.off", writeOFFStep},
+		{"write_off_parallel", "mio_bench-parallel.off", writeOFFParallelStep},
+		{"read_off", "mio_bench.off", readOFFStep},
+		{"write_ply", "mio_bench.ply", writePLYStep},
+		{"read_ply", "mio_bench.ply", readPLYStep},
+		{"write_ply_binary", "mio_bench-binary.ply", writePLYBinaryStep},
+		{"read_ply_binary", "mio_bench-binary.ply", readPLYStep},
+		{"write_stl", "mio_bench.stl", writeSTLStep},
+		{"read_stl", "mio_bench.stl", readSTLStep},
+		{"write_stl_binary", "mio_bench-binary.stl", writeSTLBinaryStep},
+		{"read_stl_binary", "mio_bench-binary.stl", readSTLStep},
+		{"read_stl_binary_welded", "mio_bench-binary.stl", readSTLWeldedStep},
+		{"write_miob", "mio_bench.miob", writeMIOBStep},
+		{"read_miob", "mio_bench.miob", readMIOBStep},
+	};
+
+	for(size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); ++i)
+	{
+		if(mesh.pSoupVertices == NULL && strstr(steps[i].pStep, "stl") != NULL)
+		{
+			continue; // too many triangles for .stl
+		}
+
+		runStep(&bench, steps[i].pStep, steps[i].pFileName, steps[i].pfnStep);
+	}
+
+	for(size_t i = 0; !options.keepFiles && i < sizeof(steps) / sizeof(steps[0]); ++i)
+	{
+		snprintf(bench.path, sizeof(bench.path), "%s/%s", options.pDir, steps[i].pFileName);
+		remove(bench.path);
+	}
+
+	freeBenchMesh(&mesh);
+
+	if(bench.results != stdout)
+	{
+		fclose(bench.results);
+	}
+
+	return 0;
+}
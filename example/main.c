@@ -1,7 +1,13 @@
 #include "mio/mio.h"
 
+#include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#if defined(MIO_HAS_ZLIB)
+#	include <zlib.h>
+#endif
 
 #define STR(x) #x
 #define ASSERT(x)                                                                                  \
@@ -15,6 +21,145 @@
 		abort();                                                                                   \
 	}
 
+// allocator that counts the number of live allocations (see "mioSetAllocator")
+static void* countingMalloc(size_t size, void* pUserData)
+{
+	void* ptr = malloc(size);
+	*(int*)pUserData += (ptr != NULL);
+	return ptr;
+}
+
+static void* countingRealloc(void* ptr, size_t size, void* pUserData)
+{
+	void* pNew = realloc(ptr, size);
+	*(int*)pUserData += (ptr == NULL && pNew != NULL);
+	return pNew;
+}
+
+static void countingFree(void* ptr, void* pUserData)
+{
+	*(int*)pUserData -= (ptr != NULL);
+	free(ptr);
+}
+
+// bounding box and face count of a mesh that is computed with "MioVisitor" callbacks
+typedef struct MeshStats
+{
+	double minCoords[3];
+	double maxCoords[3];
+	unsigned int numVertices;
+	unsigned int numFaces;
+} MeshStats;
+
+static void statsOnVertex(const double* pCoords, void* pUserData)
+{
+	MeshStats* pStats = (MeshStats*)pUserData;
+
+	for(int i = 0; i < 3; ++i)
+	{
+		if(pStats->numVertices == 0 || pCoords[i] < pStats->minCoords[i])
+		{
+			pStats->minCoords[i] = pCoords[i];
+		}
+		if(pStats->numVertices == 0 || pCoords[i] > pStats->maxCoords[i])
+		{
+			pStats->maxCoords[i] = pCoords[i];
+		}
+	}
+
+	pStats->numVertices++;
+}
+
+static void statsOnFace(const unsigned int* pVertexIndices,
+						const unsigned int* pTexCoordIndices,
+						const unsigned int* pNormalIndices,
+						unsigned int count,
+						void* pUserData)
+{
+	(void)pVertexIndices;
+	(void)pTexCoordIndices;
+	(void)pNormalIndices;
+	(void)count;
+	((MeshStats*)pUserData)->numFaces++;
+}
+
+// Function to check whether the files at "pPathA" and "pPathB" have the same contents
+static int filesAreEqual(const char* pPathA, const char* pPathB)
+{
+	FILE* pFileA = fopen(pPathA, "rb");
+	FILE* pFileB = fopen(pPathB, "rb");
+	int equal = (pFileA != NULL && pFileB != NULL);
+
+	while(equal)
+	{
+		const int a = fgetc(pFileA);
+		const int b = fgetc(pFileB);
+
+		equal = (a == b);
+
+		if(a == EOF)
+		{
+			break;
+		}
+	}
+
+	if(pFileA != NULL)
+	{
+		fclose(pFileA);
+	}
+	if(pFileB != NULL)
+	{
+		fclose(pFileB);
+	}
+
+	return equal;
+}
+
+// Function to check whether the "count" elements of "size" bytes at "pA" and "pB" are the same
+static int arraysAreEqual(const void* pA, const void* pB, size_t count, size_t size)
+{
+	if(pA == NULL || pB == NULL)
+	{
+		return pA == pB;
+	}
+
+	return memcmp(pA, pB, count * size) == 0;
+}
+
+// Function to check whether the meshes "pA" and "pB" have the same elements (bit for bit)
+static int meshesAreEqual(const MioMesh* pA, const MioMesh* pB)
+{
+	if(pA->numVertices != pB->numVertices || pA->numNormals != pB->numNormals ||
+	   pA->numTexCoords != pB->numTexCoords || pA->numFaces != pB->numFaces ||
+	   !arraysAreEqual(pA->pFaceSizes, pB->pFaceSizes, pA->numFaces, sizeof(unsigned int)))
+	{
+		return 0;
+	}
+
+	size_t numFaceVertices = 0;
+
+	for(unsigned int i = 0; i < pA->numFaces; ++i)
+	{
+		numFaceVertices += pA->pFaceSizes[i];
+	}
+
+	return arraysAreEqual(pA->pVertices, pB->pVertices, pA->numVertices * 3, sizeof(double)) &&
+		   arraysAreEqual(pA->pNormals, pB->pNormals, pA->numNormals * 3, sizeof(double)) &&
+		   arraysAreEqual(pA->pTexCoords, pB->pTexCoords, pA->numTexCoords * 2, sizeof(double)) &&
+		   arraysAreEqual(pA->pFaceVertexIndices,
+						  pB->pFaceVertexIndices,
+						  numFaceVertices,
+						  sizeof(unsigned int)) &&
+		   arraysAreEqual(pA->pFaceVertexTexCoordIndices,
+						  pB->pFaceVertexTexCoordIndices,
+						  numFaceVertices,
+						  sizeof(unsigned int)) &&
+		   arraysAreEqual(pA->pFaceVertexNormalIndices,
+						  pB->pFaceVertexNormalIndices,
+						  numFaceVertices,
+						  sizeof(unsigned int));
+}
+
 int main()
 {
 	double* pVertices = NULL;
@@ -378,6 +523,55 @@ int main()
 		numFaces = 0;
 	}
 
+	{ // mioReadOBJParallel (vertices, texture coordinates, normals and faces)
+
+		mioReadOBJParallel(DATA_DIR "/cube-normals-uv.obj",
+						   &pVertices,
+						   &pNormals,
+						   &pTexCoords,
+						   &pFaceSizes,
+						   &pFaceVertexIndices,
+						   &pFaceVertexTexCoordIndices,
+						   &pFaceVertexNormalIndices,
+						   &numVertices,
+						   &numNormals,
+						   &numTexCoords,
+						   &numFaces,
+						   0 /*use all hardware threads*/);
+
+		ASSERT(pVertices != NULL);
+		ASSERT(pNormals != NULL);
+		ASSERT(pTexCoords != NULL);
+		ASSERT(pFaceSizes != NULL);
+		ASSERT(pFaceVertexIndices != NULL);
+		ASSERT(pFaceVertexTexCoordIndices != NULL);
+		ASSERT(pFaceVertexNormalIndices != NULL);
+		ASSERT(numVertices == 8);
+		ASSERT(numNormals == 6);
+		ASSERT(numTexCoords == 14);
+		ASSERT(numFaces == 12);
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pNormals);
+		pNormals = NULL;
+		mioFree(pTexCoords);
+		pTexCoords = NULL;
+		mioFree(pFaceSizes);
+		pFaceSizes = NULL;
+		mioFree(pFaceVertexIndices);
+		pFaceVertexIndices = NULL;
+		mioFree(pFaceVertexTexCoordIndices);
+		pFaceVertexTexCoordIndices = NULL;
+		mioFree(pFaceVertexNormalIndices);
+		pFaceVertexNormalIndices = NULL;
+
+		numVertices = 0;
+		numNormals = 0;
+		numTexCoords = 0;
+		numFaces = 0;
+	}
+
 	///////////////////////////////////////////////////////////////////////////////
 	// OFF files
 	///////////////////////////////////////////////////////////////////////////////
@@ -420,6 +614,86 @@ int main()
 		numFaces = 0;
 	}
 
+	///////////////////////////////////////////////////////////////////////////////
+	// PLY files
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadPLY (ASCII file)
+
+		mioReadPLY(DATA_DIR "/cube.ply",
+				   &pVertices,
+				   &pNormals,
+				   &pTexCoords,
+				   &pFaceSizes,
+				   &pFaceVertexIndices,
+				   &numVertices,
+				   &numFaces);
+
+		ASSERT(pVertices != NULL);
+		ASSERT(pNormals == NULL);
+		ASSERT(pTexCoords == NULL);
+		ASSERT(pFaceSizes != NULL);
+		ASSERT(pFaceVertexIndices != NULL);
+		ASSERT(numVertices == 8);
+		ASSERT(numFaces == 12);
+
+		mioWritePLY("cube-out.ply",
+					pVertices,
+					pNormals,
+					pTexCoords,
+					pFaceSizes,
+					pFaceVertexIndices,
+					numVertices,
+					numFaces);
+
+		mioWritePLYBinary("cube-out-binary.ply",
+						  pVertices,
+						  pNormals,
+						  pTexCoords,
+						  pFaceSizes,
+						  pFaceVertexIndices,
+						  numVertices,
+						  numFaces);
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pFaceSizes);
+		pFaceSizes = NULL;
+		mioFree(pFaceVertexIndices);
+		pFaceVertexIndices = NULL;
+
+		numVertices = 0;
+		numFaces = 0;
+	}
+
+	{ // mioReadPLY (binary file written above)
+
+		mioReadPLY("cube-out-binary.ply",
+				   &pVertices,
+				   &pNormals,
+				   &pTexCoords,
+				   &pFaceSizes,
+				   &pFaceVertexIndices,
+				   &numVertices,
+				   &numFaces);
+
+		ASSERT(pVertices != NULL);
+		ASSERT(pVertices[0] == -0.5);
+		ASSERT(numVertices == 8);
+		ASSERT(numFaces == 12);
+		ASSERT(pFaceVertexIndices[35] == 1);
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pFaceSizes);
+		pFaceSizes = NULL;
+		mioFree(pFaceVertexIndices);
+		pFaceVertexIndices = NULL;
+
+		numVertices = 0;
+		numFaces = 0;
+	}
+
 	///////////////////////////////////////////////////////////////////////////////
 	// STL files
 	///////////////////////////////////////////////////////////////////////////////
@@ -436,6 +710,155 @@ int main()
 
 		mioWriteSTL("cube-out.stl", pVertices, pNormals, numVertices);
 
+		mioWriteSTLBinary("cube-out-binary.stl", pVertices, pNormals, numVertices);
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pNormals);
+		pNormals = NULL;
+		numVertices = 0;
+	}
+
+	{ // mioReadSTLWelded (indexed mesh)
+
+		mioReadSTLWelded(DATA_DIR "/cube.stl",
+						 &pVertices,
+						 &pNormals,
+						 &pFaceSizes,
+						 &pFaceVertexIndices,
+						 &numVertices,
+						 &numFaces,
+						 0.0 /*exact*/);
+
+		ASSERT(pVertices != NULL);
+		ASSERT(pNormals != NULL);
+		ASSERT(pFaceSizes != NULL);
+		ASSERT(pFaceVertexIndices != NULL);
+		ASSERT(numVertices == 8);
+		ASSERT(numFaces == 12);
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pNormals);
+		pNormals = NULL;
+		mioFree(pFaceSizes);
+		pFaceSizes = NULL;
+		mioFree(pFaceVertexIndices);
+		pFaceVertexIndices = NULL;
+		numVertices = 0;
+		numFaces = 0;
+	}
+
+	{ // mioReadSTL (binary file written above)
+
+		mioReadSTL("cube-out-binary.stl", &pVertices, &pNormals, &numVertices);
+
+		ASSERT(pVertices != NULL);
+		ASSERT(pNormals != NULL);
+		ASSERT(numVertices == 36);
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pNormals);
+		pNormals = NULL;
+		numVertices = 0;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// in-memory buffers
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadOBJFromMemory (e.g. a mesh that was received over the network)
+
+		const char objData[] = "# quad\n"
+							   "v 0 0 0\n"
+							   "v 1 0 0\n"
+							   "v 1 1 0\n"
+							   "v 0 1 0\n"
+							   "f 1 2 3 4\n";
+
+		mioReadOBJFromMemory(objData,
+							 sizeof(objData) - 1,
+							 &pVertices,
+							 &pNormals,
+							 &pTexCoords,
+							 &pFaceSizes,
+							 &pFaceVertexIndices,
+							 &pFaceVertexTexCoordIndices,
+							 &pFaceVertexNormalIndices,
+							 &numVertices,
+							 &numNormals,
+							 &numTexCoords,
+							 &numFaces);
+
+		ASSERT(pVertices != NULL);
+		ASSERT(pFaceSizes != NULL);
+		ASSERT(pFaceVertexIndices != NULL);
+		ASSERT(numVertices == 4);
+		ASSERT(numFaces == 1);
+		ASSERT(pFaceSizes[0] == 4);
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pFaceSizes);
+		pFaceSizes = NULL;
+		mioFree(pFaceVertexIndices);
+		pFaceVertexIndices = NULL;
+
+		numVertices = 0;
+		numFaces = 0;
+	}
+
+	{ // mioReadOFFFromMemory
+
+		const char offData[] = "OFF\n"
+							   "3 1 0\n"
+							   "0 0 0\n"
+							   "1 0 0\n"
+							   "0 1 0\n"
+							   "3 0 1 2\n";
+
+		mioReadOFFFromMemory(offData,
+							 sizeof(offData) - 1,
+							 &pVertices,
+							 &pFaceVertexIndices,
+							 &pFaceSizes,
+							 &numVertices,
+							 &numFaces);
+
+		ASSERT(pVertices != NULL);
+		ASSERT(numVertices == 3);
+		ASSERT(numFaces == 1);
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pFaceSizes);
+		pFaceSizes = NULL;
+		mioFree(pFaceVertexIndices);
+		pFaceVertexIndices = NULL;
+
+		numVertices = 0;
+		numFaces = 0;
+	}
+
+	{ // mioReadSTLFromMemory
+
+		const char stlData[] = "solid triangle\n"
+							   "facet normal 0 0 1\n"
+							   "outer loop\n"
+							   "vertex 0 0 0\n"
+							   "vertex 1 0 0\n"
+							   "vertex 0 1 0\n"
+							   "endloop\n"
+							   "endfacet\n"
+							   "endsolid\n";
+
+		mioReadSTLFromMemory(stlData, sizeof(stlData) - 1, &pVertices, &pNormals, &numVertices);
+
+		ASSERT(pVertices != NULL);
+		ASSERT(pNormals != NULL);
+		ASSERT(numVertices == 3);
+
 		mioFree(pVertices);
 		pVertices = NULL;
 		mioFree(pNormals);
@@ -443,5 +866,1109 @@ int main()
 		numVertices = 0;
 	}
 
+	///////////////////////////////////////////////////////////////////////////////
+	// single precision (float) variants
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadOBJf (vertices, texture coordinates, normals and faces)
+
+		float* pVerticesf = NULL;
+		float* pNormalsf = NULL;
+		float* pTexCoordsf = NULL;
+
+		mioReadOBJf(DATA_DIR "/cube-normals-uv.obj",
+					&pVerticesf,
+					&pNormalsf,
+					&pTexCoordsf,
+					&pFaceSizes,
+					&pFaceVertexIndices,
+					&pFaceVertexTexCoordIndices,
+					&pFaceVertexNormalIndices,
+					&numVertices,
+					&numNormals,
+					&numTexCoords,
+					&numFaces);
+
+		ASSERT(pVerticesf != NULL);
+		ASSERT(pNormalsf != NULL);
+		ASSERT(pTexCoordsf != NULL);
+		ASSERT(numVertices == 8);
+		ASSERT(numNormals == 6);
+		ASSERT(numTexCoords == 14);
+		ASSERT(numFaces == 12);
+
+		mioWriteOBJf("cube-normals-uv-out-float.obj",
+					 pVerticesf,
+					 pNormalsf,
+					 pTexCoordsf,
+					 pFaceSizes,
+					 pFaceVertexIndices,
+					 pFaceVertexTexCoordIndices,
+					 pFaceVertexNormalIndices,
+					 numVertices,
+					 numNormals,
+					 numTexCoords,
+					 numFaces);
+
+		mioFree(pVerticesf);
+		mioFree(pNormalsf);
+		mioFree(pTexCoordsf);
+		mioFree(pFaceSizes);
+		pFaceSizes = NULL;
+		mioFree(pFaceVertexIndices);
+		pFaceVertexIndices = NULL;
+		mioFree(pFaceVertexTexCoordIndices);
+		pFaceVertexTexCoordIndices = NULL;
+		mioFree(pFaceVertexNormalIndices);
+		pFaceVertexNormalIndices = NULL;
+
+		numVertices = 0;
+		numNormals = 0;
+		numTexCoords = 0;
+		numFaces = 0;
+	}
+
+	{ // mioReadSTLf (binary file written above)
+
+		float* pVerticesf = NULL;
+		float* pNormalsf = NULL;
+
+		mioReadSTLf("cube-out-binary.stl", &pVerticesf, &pNormalsf, &numVertices);
+
+		ASSERT(pVerticesf != NULL);
+		ASSERT(pNormalsf != NULL);
+		ASSERT(numVertices == 36);
+
+		mioFree(pVerticesf);
+		mioFree(pNormalsf);
+		numVertices = 0;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// MioMesh, allocator hooks and arena allocation
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadMesh (with a custom allocator)
+
+		int numAllocations = 0;
+		const MioAllocator allocator = {
+			countingMalloc, countingRealloc, countingFree, &numAllocations};
+
+		mioSetAllocator(&allocator);
+
+		MioMesh mesh;
+
+		mioReadMesh(DATA_DIR "/cube-normals-uv.obj", &mesh, 0);
+
+		ASSERT(mesh.numVertices == 8);
+		ASSERT(mesh.numNormals == 6);
+		ASSERT(mesh.numTexCoords == 14);
+		ASSERT(mesh.numFaces == 12);
+		ASSERT(mesh.pArena == NULL);
+		ASSERT(numAllocations == 7);
+
+		mioFreeMesh(&mesh);
+
+		ASSERT(numAllocations == 0);
+
+		// all arrays in one block
+		mioReadMesh(DATA_DIR "/cube-normals-uv.obj", &mesh, MIO_MESH_ARENA);
+
+		ASSERT(mesh.numFaces == 12);
+		ASSERT(mesh.pArena != NULL);
+		ASSERT(((size_t)mesh.pFaceVertexIndices % 64) == 0);
+		ASSERT(numAllocations == 1);
+
+		mioFreeMesh(&mesh);
+
+		ASSERT(numAllocations == 0);
+
+		mioReadMesh("cube-out-binary.stl", &mesh, MIO_MESH_ARENA);
+
+		ASSERT(mesh.numVertices == 8);
+		ASSERT(mesh.numNormals == 12);
+		ASSERT(mesh.numFaces == 12);
+		ASSERT(mesh.pFaceVertexNormalIndices[35] == 11);
+
+		mioFreeMesh(&mesh);
+
+		ASSERT(numAllocations == 0);
+
+		mioSetAllocator(NULL);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// .miob binary meshes and caches
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioWriteMIOB and mioReadMIOB
+
+		MioMesh mesh;
+		MioMesh mappedMesh;
+
+		mioReadMesh(DATA_DIR "/cube-normals-uv.obj", &mesh, 0);
+		mioWriteMIOB("cube-out.miob", &mesh);
+		mioReadMIOB("cube-out.miob", &mappedMesh);
+
+		ASSERT(mappedMesh.pMapping != NULL);
+		ASSERT(mappedMesh.numVertices == mesh.numVertices);
+		ASSERT(mappedMesh.numNormals == mesh.numNormals);
+		ASSERT(mappedMesh.numTexCoords == mesh.numTexCoords);
+		ASSERT(mappedMesh.numFaces == mesh.numFaces);
+		ASSERT(memcmp(mappedMesh.pVertices,
+					  mesh.pVertices,
+					  sizeof(double) * 3 * mesh.numVertices) == 0);
+		ASSERT(memcmp(mappedMesh.pFaceVertexNormalIndices,
+					  mesh.pFaceVertexNormalIndices,
+					  sizeof(unsigned int) * 36) == 0);
+
+		mappedMesh.pVertices[0] = 42.0; // copy-on-write
+
+		mioFreeMesh(&mappedMesh);
+		mioFreeMesh(&mesh);
+
+		// first read writes the cache, second read maps it
+		remove("cube-out.obj.miob");
+		mioReadMesh("cube-out.obj", &mesh, MIO_MESH_CACHE);
+
+		ASSERT(mesh.pMapping == NULL);
+
+		mioReadMesh("cube-out.obj", &mappedMesh, MIO_MESH_CACHE);
+
+		ASSERT(mappedMesh.pMapping != NULL);
+		ASSERT(mappedMesh.numFaces == mesh.numFaces);
+		ASSERT(memcmp(mappedMesh.pFaceVertexIndices,
+					  mesh.pFaceVertexIndices,
+					  sizeof(unsigned int) * 36) == 0);
+
+		mioFreeMesh(&mappedMesh);
+		mioFreeMesh(&mesh);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// quiet mode and load statistics
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioSetLogLevel and mioSetLoadStats
+
+		MioLoadStats stats;
+		MioMesh mesh;
+
+		mioSetLogLevel(MIO_LOG_LEVEL_NONE);
+		mioSetLoadStats(&stats);
+
+		mioReadMesh(DATA_DIR "/cube-normals-uv.obj", &mesh, 0);
+
+		ASSERT(stats.numBytes > 0);
+		ASSERT(stats.numLines > 36);
+		ASSERT(stats.numPasses == 1);
+		ASSERT(stats.totalSeconds >= stats.ioSeconds + stats.allocSeconds);
+
+		mioFreeMesh(&mesh);
+
+		mioReadMesh("cube-out-binary.ply", &mesh, 0);
+
+		ASSERT(stats.numLines > 0); // the header
+		ASSERT(stats.numBytes > 36 * sizeof(unsigned int));
+
+		mioFreeMesh(&mesh);
+
+		mioSetLoadStats(NULL);
+		mioSetLogLevel(MIO_LOG_LEVEL_ALL);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// 64-bit counts and indices
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadMesh64
+
+		MioMesh64 mesh;
+
+		mioReadMesh64(DATA_DIR "/cube.obj", &mesh, 0);
+
+		ASSERT(mesh.indexSize == sizeof(uint32_t)); // the indices fit in 32 bits
+		ASSERT(mesh.numVertices == 8);
+		ASSERT(mesh.numFaceVertices == 36);
+
+		mioFreeMesh64(&mesh);
+
+		mioReadMesh64("cube-out.miob", &mesh, MIO_MESH_64BIT_INDICES);
+
+		ASSERT(mesh.indexSize == sizeof(uint64_t));
+		ASSERT(mesh.numFaceVertices == 36);
+		ASSERT(((const uint64_t*)mesh.pFaceVertexIndices)[35] < 8);
+
+		mioFreeMesh64(&mesh);
+
+		// an index beyond the 32-bit range is read, but it refers to no vertex
+		FILE* pFile = fopen("cube-out-index64.obj", "w");
+
+		ASSERT(pFile != NULL);
+		fputs("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\nf 1 2 4294967297\n", pFile);
+		fclose(pFile);
+
+		ASSERT(mioTryReadMesh64("cube-out-index64.obj", &mesh, 0) == MIO_STATUS_MALFORMED);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// batch of files
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadBatch
+
+		// NOTE: the format of "cube-out-noext" is guessed from its contents
+		FILE* pFile = fopen("cube-out-noext", "w");
+
+		ASSERT(pFile != NULL);
+		fputs("# cube\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n", pFile);
+		fclose(pFile);
+
+		const char* paths[] = {DATA_DIR "/cube.obj",
+							   DATA_DIR "/cube.off",
+							   "cube-out-binary.stl",
+							   "cube-out-binary.ply",
+							   "cube-out-noext",
+							   "does-not-exist.obj"};
+		const size_t numFiles = sizeof(paths) / sizeof(paths[0]);
+		MioMesh meshes[sizeof(paths) / sizeof(paths[0])];
+		enum MioStatus statuses[sizeof(paths) / sizeof(paths[0])];
+
+		mioReadBatch(paths, numFiles, meshes, statuses, 0, 0);
+
+		for(size_t i = 0; i + 2 < numFiles; ++i)
+		{
+			ASSERT(statuses[i] == MIO_STATUS_OK);
+			ASSERT(meshes[i].numFaces == 12);
+		}
+
+		ASSERT(statuses[4] == MIO_STATUS_OK);
+		ASSERT(meshes[4].numVertices == 3);
+		ASSERT(statuses[5] == MIO_STATUS_OPEN_FAILED);
+		ASSERT(meshes[5].pVertices == NULL);
+
+		for(size_t i = 0; i < numFiles; ++i)
+		{
+			mioFreeMesh(&meshes[i]);
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// errors as status codes (instead of ending the program)
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioTryReadMesh
+
+		FILE* pFile = fopen("cube-out-malformed.obj", "w");
+
+		ASSERT(pFile != NULL);
+		fputs("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 0\n", pFile); // (face index 0 is invalid)
+		fclose(pFile);
+
+		MioMesh mesh;
+
+		ASSERT(mioTryReadMesh("cube-out-malformed.obj", &mesh, 0) == MIO_STATUS_MALFORMED);
+		ASSERT(mesh.pVertices == NULL && mesh.numVertices == 0);
+
+		ASSERT(mioTryReadMesh("does-not-exist.obj", &mesh, 0) == MIO_STATUS_OPEN_FAILED);
+
+		ASSERT(mioTryReadMesh(DATA_DIR "/cube.obj", &mesh, 0) == MIO_STATUS_OK);
+		ASSERT(mesh.numVertices == 8 && mesh.numFaces == 12);
+
+		mioFreeMesh(&mesh);
+	}
+
+#if defined(MIO_HAS_ZLIB)
+	///////////////////////////////////////////////////////////////////////////////
+	// compressed files (e.g. mesh.obj.gz)
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadMesh and mioTryReadMesh on a gzip-compressed .obj file
+
+		// the .obj file is written through gzip
+		char data[4096];
+		FILE* pFile = fopen(DATA_DIR "/cube.obj", "rb");
+		gzFile compressedFile = gzopen("cube-out.obj.gz", "wb");
+
+		ASSERT(pFile != NULL && compressedFile != NULL);
+
+		for(size_t size = 0; (size = fread(data, 1, sizeof(data), pFile)) > 0;)
+		{
+			ASSERT(gzwrite(compressedFile, data, (unsigned int)size) == (int)size);
+		}
+
+		fclose(pFile);
+		ASSERT(gzclose(compressedFile) == Z_OK);
+
+		MioMesh mesh;
+		MioMesh compressedMesh;
+
+		mioReadMesh(DATA_DIR "/cube.obj", &mesh, 0);
+		mioReadMesh("cube-out.obj.gz", &compressedMesh, 0);
+
+		ASSERT(mesh.numVertices == 8 && mesh.numFaces == 12);
+		ASSERT(meshesAreEqual(&mesh, &compressedMesh));
+
+		mioFreeMesh(&compressedMesh);
+		mioFreeMesh(&mesh);
+
+		// a file that ends in the middle of its compressed data is malformed
+		pFile = fopen("cube-out.obj.gz", "rb");
+		ASSERT(pFile != NULL);
+		const size_t size = fread(data, 1, sizeof(data), pFile);
+		fclose(pFile);
+
+		pFile = fopen("cube-out-truncated.obj.gz", "wb");
+		ASSERT(pFile != NULL && size > 0);
+		fwrite(data, 1, size / 2, pFile);
+		fclose(pFile);
+
+		ASSERT(mioTryReadMesh("cube-out-truncated.obj.gz", &mesh, 0) == MIO_STATUS_MALFORMED);
+		ASSERT(mesh.pVertices == NULL);
+	}
+#endif // #if defined(MIO_HAS_ZLIB)
+
+	///////////////////////////////////////////////////////////////////////////////
+	// relative (negative) .obj indices
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadOBJParallel on a file with relative indices, and on the same file with absolute ones
+
+		FILE* pRelativeFile = fopen("cube-out-relative.obj", "w");
+		FILE* pAbsoluteFile = fopen("cube-out-absolute.obj", "w");
+
+		ASSERT(pRelativeFile != NULL && pAbsoluteFile != NULL);
+
+		// a triangle with a normal of its own; enough of them for the file to be parsed in
+		// several chunks, so that the relative indices of a chunk refer to earlier chunks
+		const unsigned int numTriangles = 60000;
+
+		for(unsigned int i = 0; i < numTriangles; ++i)
+		{
+			fprintf(pRelativeFile, "v %u 0 0\nv 0 %u 0\nv 0 0 %u\nvn 0 0 1\n", i, i, i);
+			fprintf(pAbsoluteFile, "v %u 0 0\nv 0 %u 0\nv 0 0 %u\nvn 0 0 1\n", i, i, i);
+
+			// the first triangle refers back to the vertices of the previous one
+			fputs((i % 2 == 0) ? "f -3//-1 -2//-1 -1//-1\n" : "f -6 -2 -1\n", pRelativeFile);
+
+			if(i % 2 == 0)
+			{
+				fprintf(pAbsoluteFile,
+						"f %u//%u %u//%u %u//%u\n",
+						i * 3 + 1,
+						i + 1,
+						i * 3 + 2,
+						i + 1,
+						i * 3 + 3,
+						i + 1);
+			}
+			else
+			{
+				fprintf(pAbsoluteFile, "f %u %u %u\n", i * 3 - 2, i * 3 + 2, i * 3 + 3);
+			}
+		}
+
+		fclose(pRelativeFile);
+		fclose(pAbsoluteFile);
+
+		const unsigned int threadCounts[2] = {1, 4};
+		MioMesh meshes[2][2]; // [relative, absolute][thread count]
+
+		for(int i = 0; i < 2; ++i)
+		{
+			for(int j = 0; j < 2; ++j)
+			{
+				MioMesh* pMesh = &meshes[i][j];
+
+				memset(pMesh, 0, sizeof(MioMesh));
+
+				mioReadOBJParallel((i == 0) ? "cube-out-relative.obj" : "cube-out-absolute.obj",
+								   &pMesh->pVertices,
+								   &pMesh->pNormals,
+								   &pMesh->pTexCoords,
+								   &pMesh->pFaceSizes,
+								   &pMesh->pFaceVertexIndices,
+								   &pMesh->pFaceVertexTexCoordIndices,
+								   &pMesh->pFaceVertexNormalIndices,
+								   &pMesh->numVertices,
+								   &pMesh->numNormals,
+								   &pMesh->numTexCoords,
+								   &pMesh->numFaces,
+								   threadCounts[j]);
+			}
+		}
+
+		ASSERT(meshes[0][0].numVertices == numTriangles * 3);
+		ASSERT(meshes[0][0].numFaces == numTriangles);
+		ASSERT(meshes[0][0].pFaceVertexIndices[3] == 0); // (vertex -6 of the second triangle)
+		ASSERT(meshes[0][1].pFaceVertexNormalIndices[numTriangles * 3 - 6] ==
+			   numTriangles - 2);
+
+		ASSERT(meshesAreEqual(&meshes[0][0], &meshes[0][1]));
+		ASSERT(meshesAreEqual(&meshes[0][0], &meshes[1][0]));
+		ASSERT(meshesAreEqual(&meshes[0][0], &meshes[1][1]));
+
+		for(int i = 0; i < 2; ++i)
+		{
+			mioFreeMesh(&meshes[i][0]);
+			mioFreeMesh(&meshes[i][1]);
+		}
+
+		// a small file, and indices that refer to no vertex
+		const char* const pFiles[4] = {"v 0 0 0\nv 1 0 0\nv 0 1 0\nf -3 -2 -1\n",
+									   "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n",
+									   "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n",
+									   "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -4 -2 -1\n"};
+		const char* const pPaths[4] = {"cube-out-relative-small.obj",
+									   "cube-out-absolute-small.obj",
+									   "cube-out-zero-index.obj",
+									   "cube-out-relative-range.obj"};
+		MioMesh smallMeshes[4];
+
+		for(int i = 0; i < 4; ++i)
+		{
+			FILE* pFile = fopen(pPaths[i], "w");
+
+			ASSERT(pFile != NULL);
+			fputs(pFiles[i], pFile);
+			fclose(pFile);
+		}
+
+		ASSERT(mioTryReadMesh(pPaths[0], &smallMeshes[0], 0) == MIO_STATUS_OK);
+		ASSERT(mioTryReadMesh(pPaths[1], &smallMeshes[1], 0) == MIO_STATUS_OK);
+		ASSERT(meshesAreEqual(&smallMeshes[0], &smallMeshes[1]));
+		ASSERT(smallMeshes[0].pFaceVertexIndices[2] == 2);
+		ASSERT(mioTryReadMesh(pPaths[2], &smallMeshes[2], 0) == MIO_STATUS_MALFORMED);
+		ASSERT(mioTryReadMesh(pPaths[3], &smallMeshes[3], 0) == MIO_STATUS_MALFORMED);
+
+		mioFreeMesh(&smallMeshes[0]);
+		mioFreeMesh(&smallMeshes[1]);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// exact round trip of the coordinates (shortest formatting and correct rounding)
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioWriteOBJ and mioReadOBJ on boundary values
+
+		double coords[15] = {DBL_MIN,
+							 DBL_MIN / 2.0, // subnormal
+							 DBL_MIN - 5e-324, // largest subnormal
+							 5e-324, // smallest subnormal
+							 -5e-324,
+							 0.1,
+							 1e23,
+							 -0.0,
+							 9007199254740993.0, // 2^53 + 1 (which rounds to 2^53)
+							 9007199254740994.0,
+							 DBL_MAX,
+							 -DBL_MAX,
+							 1.0 / 3.0,
+							 123456789012345680.0,
+							 2.2250738585072011e-308};
+		unsigned int faceSize = 3;
+		unsigned int faceVertexIndices[3] = {0, 1, 4};
+
+		mioWriteOBJ("cube-out-coords.obj",
+					coords,
+					NULL,
+					NULL,
+					&faceSize,
+					faceVertexIndices,
+					NULL,
+					NULL,
+					5,
+					0,
+					0,
+					1);
+
+		mioReadOBJ("cube-out-coords.obj",
+				   &pVertices,
+				   &pNormals,
+				   &pTexCoords,
+				   &pFaceSizes,
+				   &pFaceVertexIndices,
+				   &pFaceVertexTexCoordIndices,
+				   &pFaceVertexNormalIndices,
+				   &numVertices,
+				   &numNormals,
+				   &numTexCoords,
+				   &numFaces);
+
+		ASSERT(numVertices == 5 && numFaces == 1);
+		ASSERT(memcmp(pVertices, coords, sizeof(coords)) == 0); // (bit for bit, e.g. for -0.0)
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pFaceSizes);
+		pFaceSizes = NULL;
+		mioFree(pFaceVertexIndices);
+		pFaceVertexIndices = NULL;
+
+		// decimal numbers that are not doubles are rounded to the nearest one (like "strtod")
+		const char* const pNumbers[3] = {
+			"9007199254740993", "2.2250738585072011e-308", "0.30000000000000001665"};
+		FILE* pFile = fopen("cube-out-coords-text.obj", "w");
+
+		ASSERT(pFile != NULL);
+		fprintf(pFile, "v %s %s %s\n", pNumbers[0], pNumbers[1], pNumbers[2]);
+		fputs("v 0 0 0\nv 1 1 1\nf 1 2 3\n", pFile);
+		fclose(pFile);
+
+		mioReadOBJ("cube-out-coords-text.obj",
+				   &pVertices,
+				   &pNormals,
+				   &pTexCoords,
+				   &pFaceSizes,
+				   &pFaceVertexIndices,
+				   &pFaceVertexTexCoordIndices,
+				   &pFaceVertexNormalIndices,
+				   &numVertices,
+				   &numNormals,
+				   &numTexCoords,
+				   &numFaces);
+
+		for(int i = 0; i < 3; ++i)
+		{
+			const double expected = strtod(pNumbers[i], NULL);
+
+			ASSERT(memcmp(&pVertices[i], &expected, sizeof(double)) == 0);
+		}
+
+		mioFree(pVertices);
+		pVertices = NULL;
+		mioFree(pFaceSizes);
+		pFaceSizes = NULL;
+		mioFree(pFaceVertexIndices);
+		pFaceVertexIndices = NULL;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// element counts without reading the mesh
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioProbe
+
+		MioMeshInfo info;
+
+		ASSERT(mioProbe(DATA_DIR "/cube-normals-uv.obj", &info) == MIO_STATUS_OK);
+		ASSERT(info.format == MIO_FORMAT_OBJ);
+		ASSERT(info.numVertices == 8 && info.numNormals == 6 && info.numTexCoords == 14);
+		ASSERT(info.numFaces == 12 && info.numFaceVertices == 36);
+
+		ASSERT(mioProbe(DATA_DIR "/cube.off", &info) == MIO_STATUS_OK);
+		ASSERT(info.format == MIO_FORMAT_OFF && info.numFaceVertices == 36);
+
+		ASSERT(mioProbe("cube-out-binary.ply", &info) == MIO_STATUS_OK);
+		ASSERT(info.format == MIO_FORMAT_PLY && info.numFaceVertices == 36);
+
+		// the corners of the triangles (which "mioReadMesh" welds)
+		ASSERT(mioProbe("cube-out-binary.stl", &info) == MIO_STATUS_OK);
+		ASSERT(info.format == MIO_FORMAT_STL && info.numVertices == 36 && info.numNormals == 12);
+
+		ASSERT(mioProbe("cube-out-noext", &info) == MIO_STATUS_OK);
+		ASSERT(info.format == MIO_FORMAT_OBJ && info.numVertices == 3);
+
+		ASSERT(mioProbe("does-not-exist.obj", &info) == MIO_STATUS_OPEN_FAILED);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// triangulated faces
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // MIO_MESH_TRIANGULATE
+
+		MioMesh mesh;
+
+		mioReadMesh(DATA_DIR "/cube-quads-normals.obj", &mesh, MIO_MESH_TRIANGULATE);
+
+		ASSERT(mesh.numFaces == 12);
+		ASSERT(mesh.pFaceSizes[0] == 3 && mesh.pFaceSizes[11] == 3);
+		ASSERT(mesh.pSourceFaces[0] == 0 && mesh.pSourceFaces[1] == 0);
+		ASSERT(mesh.pSourceFaces[11] == 5);
+		// the two triangles of a quad share its first corner (and its normal)
+		ASSERT(mesh.pFaceVertexIndices[0] == mesh.pFaceVertexIndices[3]);
+		ASSERT(mesh.pFaceVertexNormalIndices[0] == mesh.pFaceVertexNormalIndices[5]);
+
+		mioFreeMesh(&mesh);
+
+		// the triangles of a mapped mesh are put into a block of their own
+		MioMesh quadMesh;
+
+		mioReadMesh(DATA_DIR "/cube-quads.obj", &quadMesh, 0);
+		mioWriteMIOB("cube-out-quads.miob", &quadMesh);
+		mioFreeMesh(&quadMesh);
+
+		mioReadMesh("cube-out-quads.miob", &mesh, MIO_MESH_TRIANGULATE | MIO_MESH_ARENA);
+
+		ASSERT(mesh.pMapping != NULL && mesh.pArena != NULL);
+		ASSERT(mesh.numFaces == 12 && mesh.pSourceFaces[11] == 5);
+
+		mioFreeMesh(&mesh);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// indexed meshes (one index per face-vertex)
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadOBJIndexed and mioReadOBJIndexedf
+
+		MioIndexedMesh mesh;
+
+		// each corner of the cube has a normal per face it is part of
+		mioReadOBJIndexed(DATA_DIR "/cube-quads-normals.obj", &mesh);
+
+		ASSERT(mesh.numVertices == 24 && mesh.numFaces == 6);
+		ASSERT(mesh.numCoords == 6 && mesh.hasNormals && !mesh.hasTexCoords);
+		ASSERT(mesh.pFaceSizes[0] == 4);
+
+		mioFreeIndexedMesh(&mesh);
+
+		// without normals, the corners are shared by the faces
+		mioReadOBJIndexedf(DATA_DIR "/cube-quads.obj", &mesh);
+
+		ASSERT(mesh.numVertices == 8 && mesh.numCoords == 3);
+
+		mioFreeIndexedMesh(&mesh);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// obj section index (reading some of the objects/groups/materials)
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioBuildOBJIndex and mioReadOBJSections
+
+		MioObjIndex index;
+
+		// NOTE: "mioLoadOBJIndex" would also persist the index next to the file
+		mioBuildOBJIndex(DATA_DIR "/cube-uv.obj", &index);
+
+		ASSERT(index.numSections == 1 && index.numFaces == 12);
+		ASSERT(strcmp(index.pNames + index.pSections[0].object, "Cube") == 0);
+		ASSERT(strcmp(index.pNames + index.pSections[0].material, "Material") == 0);
+		ASSERT(index.pSections[0].firstFace == 0 && index.pSections[0].numFaces == 12);
+
+		double* pVertices = NULL;
+		double* pNormals = NULL;
+		double* pTexCoords = NULL;
+		unsigned int* pFaceSizes = NULL;
+		unsigned int* pFaceVertexIndices = NULL;
+		unsigned int* pFaceVertexTexCoordIndices = NULL;
+		unsigned int* pFaceVertexNormalIndices = NULL;
+		unsigned int numVertices = 0;
+		unsigned int numNormals = 0;
+		unsigned int numTexCoords = 0;
+		unsigned int numFaces = 0;
+		const unsigned int sectionId = 0;
+
+		mioReadOBJSections(DATA_DIR "/cube-uv.obj",
+						   &index,
+						   &sectionId,
+						   1,
+						   &pVertices,
+						   &pNormals,
+						   &pTexCoords,
+						   &pFaceSizes,
+						   &pFaceVertexIndices,
+						   &pFaceVertexTexCoordIndices,
+						   &pFaceVertexNormalIndices,
+						   &numVertices,
+						   &numNormals,
+						   &numTexCoords,
+						   &numFaces);
+
+		ASSERT(numFaces == 12 && numVertices == 8 && numTexCoords == 14 && numNormals == 0);
+		ASSERT(pFaceVertexTexCoordIndices != NULL && pFaceVertexNormalIndices == NULL);
+
+		mioFree(pVertices);
+		mioFree(pNormals);
+		mioFree(pTexCoords);
+		mioFree(pFaceSizes);
+		mioFree(pFaceVertexIndices);
+		mioFree(pFaceVertexTexCoordIndices);
+		mioFree(pFaceVertexNormalIndices);
+
+		mioFreeOBJIndex(&index);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// reading into caller-owned (interleaved) arrays
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadOBJInto, mioReadOFFIntof and mioReadSTLInto
+
+		// an interleaved vertex buffer with a position and a colour per vertex
+		typedef struct Vertex
+		{
+			float position[3];
+			unsigned int colour;
+		} Vertex;
+
+		Vertex vertexData[36];
+		float normalData[36 * 3];
+		unsigned int faceSizeData[12];
+		unsigned int indexData[36];
+		unsigned int normalIndexData[36];
+
+		MioMeshBuffers buffers;
+		MioMeshCounts counts;
+
+		memset(&buffers, 0, sizeof(MioMeshBuffers));
+
+		buffers.vertices.pData = &vertexData[0].position;
+		buffers.vertices.capacity = 36;
+		buffers.vertices.stride = sizeof(Vertex);
+		buffers.normals.pData = normalData;
+		buffers.normals.capacity = 36;
+		buffers.faceSizes.pData = faceSizeData;
+		buffers.faceSizes.capacity = 12;
+		buffers.faceVertexIndices.pData = indexData;
+		buffers.faceVertexIndices.capacity = 36;
+		buffers.faceVertexNormalIndices.pData = normalIndexData;
+		buffers.faceVertexNormalIndices.capacity = 36;
+
+		ASSERT(mioReadOBJIntof(DATA_DIR "/cube-normals.obj", &buffers, &counts, 1) ==
+			   MIO_STATUS_OK);
+		ASSERT(counts.numVertices == 8 && counts.numNormals == 6 && counts.numFaces == 12);
+		ASSERT(counts.numFaceVertices == 36 && faceSizeData[11] == 3);
+
+		ASSERT(mioReadOFFIntof(DATA_DIR "/cube.off", &buffers, &counts) == MIO_STATUS_OK);
+		ASSERT(counts.numVertices == 8 && counts.numFaceVertices == 36);
+
+		// the coordinates are doubles, so they no longer fit into the interleaved buffer
+		double positions[36 * 3];
+
+		buffers.vertices.pData = positions;
+		buffers.vertices.stride = 0;
+		buffers.normals.pData = NULL;
+
+		ASSERT(mioReadSTLInto("cube-out-binary.stl", &buffers, &counts) == MIO_STATUS_OK);
+		ASSERT(counts.numVertices == 36 && counts.numNormals == 12 && normalIndexData[35] == 11);
+
+		// an array that is too small is not overrun, and the counts are still known. Nothing is
+		// written to the arrays (see "MioMeshBuffers").
+		buffers.vertices.capacity = 8;
+		memset(positions, 0, sizeof(positions));
+		memset(indexData, 0, sizeof(indexData));
+
+		ASSERT(mioReadSTLInto("cube-out-binary.stl", &buffers, &counts) ==
+			   MIO_STATUS_BUFFER_TOO_SMALL);
+		ASSERT(counts.numVertices == 36);
+		ASSERT(positions[3] == 0.0 && indexData[2] == 0);
+
+		ASSERT(mioReadSTLInto(DATA_DIR "/cube.stl", &buffers, &counts) ==
+			   MIO_STATUS_BUFFER_TOO_SMALL);
+		ASSERT(counts.numVertices == 36);
+		ASSERT(positions[3] == 0.0 && indexData[2] == 0);
+
+		buffers.faceVertexIndices.capacity = 35; // (the cube has 36 face-vertices)
+
+		ASSERT(mioReadOFFInto(DATA_DIR "/cube.off", &buffers, &counts) ==
+			   MIO_STATUS_BUFFER_TOO_SMALL);
+		ASSERT(counts.numVertices == 8 && counts.numFaceVertices == 36);
+		ASSERT(positions[3] == 0.0 && indexData[2] == 0);
+
+		ASSERT(mioReadOBJInto(DATA_DIR "/cube.obj", &buffers, &counts, 1) ==
+			   MIO_STATUS_BUFFER_TOO_SMALL);
+		ASSERT(counts.numVertices == 8 && counts.numFaceVertices == 36);
+		ASSERT(positions[3] == 0.0 && indexData[2] == 0);
+
+		buffers.faceVertexIndices.capacity = 36;
+
+		// a file that cannot be read gives its status (instead of ending the program)
+		FILE* pFile = fopen("cube-out-bad-index.off", "w");
+
+		ASSERT(pFile != NULL);
+		fputs("OFF\n3 1 0\n0 0 0\n1 0 0\n0 1 0\n3 0 1 9\n", pFile); // (there is no vertex 9)
+		fclose(pFile);
+
+		buffers.vertices.capacity = 36;
+
+		ASSERT(mioReadOFFInto("cube-out-bad-index.off", &buffers, &counts) ==
+			   MIO_STATUS_MALFORMED);
+		ASSERT(counts.numVertices == 0);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// visitor callbacks (without storing the mesh)
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioVisitOBJ, mioVisitOFF and mioVisitSTL
+
+		MeshStats stats = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, 0, 0};
+		const MioVisitor visitor = {statsOnVertex, NULL, NULL, statsOnFace, &stats};
+
+		ASSERT(mioVisitOBJ(DATA_DIR "/cube.obj", &visitor) == MIO_STATUS_OK);
+
+		ASSERT(stats.numVertices == 8);
+		ASSERT(stats.numFaces == 12);
+		ASSERT(stats.maxCoords[0] > stats.minCoords[0]);
+
+		stats.numVertices = 0;
+		stats.numFaces = 0;
+
+		ASSERT(mioVisitOFF(DATA_DIR "/cube.off", &visitor) == MIO_STATUS_OK);
+
+		ASSERT(stats.numVertices == 8);
+		ASSERT(stats.numFaces == 12);
+
+		stats.numVertices = 0;
+		stats.numFaces = 0;
+
+		ASSERT(mioVisitSTL("cube-out-binary.stl", &visitor) == MIO_STATUS_OK);
+
+		ASSERT(stats.numVertices == 36);
+		ASSERT(stats.numFaces == 12);
+
+		ASSERT(mioVisitOBJ("does-not-exist.obj", &visitor) == MIO_STATUS_OPEN_FAILED);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// .off variants with per-vertex attributes (NOFF, COFF, STOFF)
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReadOFFWithAttributes
+
+		FILE* pFile = fopen("cube-out-variant.off", "w");
+
+		ASSERT(pFile != NULL);
+		// position, normal, colour (RGB, without alpha) and texture coordinate of each vertex
+		fputs("STCNOFF\n3 1 0\n"
+			  "0 0 0  0 0 1  1 0 0  0 0\n"
+			  "1 0 0  0 0 1  0 1 0  1 0\n"
+			  "0 1 0  0 0 1  0 0 1  0 1\n"
+			  "3 0 1 2\n",
+			  pFile);
+		fclose(pFile);
+
+		double* pVertices = NULL;
+		double* pNormals = NULL;
+		double* pColors = NULL;
+		double* pTexCoords = NULL;
+		unsigned int* pFaceVertexIndices = NULL;
+		unsigned int* pFaceSizes = NULL;
+		unsigned int numVertices = 0;
+		unsigned int numFaces = 0;
+
+		mioReadOFFWithAttributes("cube-out-variant.off",
+								 &pVertices,
+								 &pNormals,
+								 &pColors,
+								 &pTexCoords,
+								 &pFaceVertexIndices,
+								 &pFaceSizes,
+								 &numVertices,
+								 &numFaces);
+
+		ASSERT(numVertices == 3 && numFaces == 1);
+		ASSERT(pNormals != NULL && pNormals[2] == 1.0);
+		ASSERT(pColors != NULL && pColors[4 + 1] == 1.0 && pColors[4 + 3] == 1.0);
+		ASSERT(pTexCoords != NULL && pTexCoords[2 * 2 + 1] == 1.0);
+
+		mioFree(pVertices);
+		mioFree(pNormals);
+		mioFree(pColors);
+		mioFree(pTexCoords);
+		mioFree(pFaceVertexIndices);
+		mioFree(pFaceSizes);
+
+		// "mioReadMesh" keeps the normals and texture coordinates (which are per vertex)
+		MioMesh mesh;
+
+		mioReadMesh("cube-out-variant.off", &mesh, 0);
+
+		ASSERT(mesh.numNormals == 3 && mesh.numTexCoords == 3);
+		ASSERT(mesh.pFaceVertexNormalIndices[2] == 2);
+
+		mioFreeMesh(&mesh);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// writing on multiple threads
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioWriteOBJParallel and mioWriteOFFParallel
+
+		// a grid of quads with enough faces to be split into several chunks
+		const unsigned int gridSize = 300;
+		const unsigned int numGridVertices = (gridSize + 1) * (gridSize + 1);
+		const unsigned int numGridFaces = gridSize * gridSize;
+
+		double* pGridVertices = (double*)malloc(numGridVertices * 3 * sizeof(double));
+		unsigned int* pGridFaceSizes = (unsigned int*)malloc(numGridFaces * sizeof(unsigned int));
+		unsigned int* pGridIndices = (unsigned int*)malloc(numGridFaces * 4 * sizeof(unsigned int));
+
+		ASSERT(pGridVertices != NULL && pGridFaceSizes != NULL && pGridIndices != NULL);
+
+		for(unsigned int i = 0; i < numGridVertices; ++i)
+		{
+			pGridVertices[i * 3 + 0] = (double)(i % (gridSize + 1)) * 0.1;
+			pGridVertices[i * 3 + 1] = (double)(i / (gridSize + 1)) / 3.0;
+			pGridVertices[i * 3 + 2] = 0.0;
+		}
+
+		for(unsigned int f = 0; f < numGridFaces; ++f)
+		{
+			const unsigned int corner = (f / gridSize) * (gridSize + 1) + (f % gridSize);
+
+			pGridFaceSizes[f] = 4;
+			pGridIndices[f * 4 + 0] = corner;
+			pGridIndices[f * 4 + 1] = corner + 1;
+			pGridIndices[f * 4 + 2] = corner + gridSize + 2;
+			pGridIndices[f * 4 + 3] = corner + gridSize + 1;
+		}
+
+		mioWriteOBJ("grid-out.obj",
+					pGridVertices,
+					NULL,
+					NULL,
+					pGridFaceSizes,
+					pGridIndices,
+					NULL,
+					NULL,
+					numGridVertices,
+					0,
+					0,
+					numGridFaces);
+
+		mioWriteOBJParallel("grid-out-parallel.obj",
+							pGridVertices,
+							NULL,
+							NULL,
+							pGridFaceSizes,
+							pGridIndices,
+							NULL,
+							NULL,
+							numGridVertices,
+							0,
+							0,
+							numGridFaces,
+							3);
+
+		// the lines are formatted on several threads, but the files are the same
+		ASSERT(filesAreEqual("grid-out.obj", "grid-out-parallel.obj"));
+
+		mioWriteOFF("grid-out.off",
+					pGridVertices,
+					pGridIndices,
+					pGridFaceSizes,
+					NULL,
+					numGridVertices,
+					numGridFaces,
+					0);
+
+		mioWriteOFFParallel("grid-out-parallel.off",
+							pGridVertices,
+							pGridIndices,
+							pGridFaceSizes,
+							NULL,
+							numGridVertices,
+							numGridFaces,
+							0,
+							3);
+
+		ASSERT(filesAreEqual("grid-out.off", "grid-out-parallel.off"));
+
+		free(pGridVertices);
+		free(pGridFaceSizes);
+		free(pGridIndices);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// writing a mesh block by block
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioBeginMeshWrite, mioWriteMeshVertices, mioWriteMeshFaces and mioEndMeshWrite
+
+		// a unit square (two triangles), which is written once per block with its own vertices
+		const double squareVertices[4 * 3] = {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0};
+		const unsigned int squareIndices[2 * 3] = {0, 1, 2, 0, 2, 3};
+
+		const char* const paths[3] = {"blocks-out.obj", "blocks-out.off", "blocks-out.stl"};
+		const enum MioFormat formats[3] = {MIO_FORMAT_OBJ, MIO_FORMAT_OFF, MIO_FORMAT_STL};
+
+		for(int i = 0; i < 3; ++i)
+		{
+			MioMeshWriter* pWriter = mioBeginMeshWrite(paths[i], formats[i]);
+
+			ASSERT(pWriter != NULL);
+
+			for(int block = 0; block < 3; ++block)
+			{
+				// the face indices of each block are relative to its own vertices
+				mioWriteMeshVertices(pWriter, squareVertices, 4);
+				mioWriteMeshFaces(pWriter, NULL, squareIndices, 2);
+			}
+
+			ASSERT(mioEndMeshWrite(pWriter) == 1);
+
+			MioMesh mesh;
+
+			mioReadMesh(paths[i], &mesh, 0);
+
+			ASSERT(mesh.numFaces == 6);
+			// (the corners of the .stl triangles are welded)
+			ASSERT(mesh.numVertices == ((formats[i] == MIO_FORMAT_STL) ? 4 : 12));
+			ASSERT(mesh.pFaceVertexIndices[17] == ((formats[i] == MIO_FORMAT_STL) ? 3 : 11));
+
+			mioFreeMesh(&mesh);
+		}
+
+		// mioEndMeshWrite fails if a face refers to a vertex outside of its block
+		MioMeshWriter* pWriter = mioBeginMeshWrite("blocks-out-bad.obj", MIO_FORMAT_OBJ);
+		const unsigned int badIndices[3] = {0, 2, 4};
+
+		ASSERT(pWriter != NULL);
+		mioWriteMeshVertices(pWriter, squareVertices, 4);
+		mioWriteMeshFaces(pWriter, NULL, badIndices, 1);
+		ASSERT(mioEndMeshWrite(pWriter) == 0);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// reordering a mesh for cache locality
+	///////////////////////////////////////////////////////////////////////////////
+
+	{ // mioReorderMesh
+
+		MioMesh mesh;
+		MioMesh reordered;
+
+		mioReadMesh(DATA_DIR "/cube-quads-normals.obj", &mesh, MIO_MESH_TRIANGULATE);
+		mioReadMesh(DATA_DIR "/cube-quads-normals.obj", &reordered, MIO_MESH_TRIANGULATE);
+
+		unsigned int* pVertexOrder = NULL;
+		unsigned int* pFaceOrder = NULL;
+
+		ASSERT(mioReorderMesh(
+			&reordered, MIO_REORDER_VERTICES | MIO_REORDER_FACES, &pVertexOrder, &pFaceOrder));
+		ASSERT(pVertexOrder != NULL && pFaceOrder != NULL);
+
+		// each face refers to the same positions and normals as the face that it came from
+		for(unsigned int f = 0; f < reordered.numFaces; ++f)
+		{
+			const unsigned int sourceFace = pFaceOrder[f];
+
+			ASSERT(reordered.pSourceFaces[f] == mesh.pSourceFaces[sourceFace]);
+
+			for(unsigned int j = 0; j < 3; ++j)
+			{
+				const unsigned int vertex = reordered.pFaceVertexIndices[f * 3 + j];
+				const unsigned int sourceVertex = mesh.pFaceVertexIndices[sourceFace * 3 + j];
+
+				ASSERT(pVertexOrder[vertex] == sourceVertex);
+				ASSERT(memcmp(&reordered.pVertices[vertex * 3],
+							  &mesh.pVertices[sourceVertex * 3],
+							  3 * sizeof(double)) == 0);
+				ASSERT(reordered.pFaceVertexNormalIndices[f * 3 + j] ==
+					   mesh.pFaceVertexNormalIndices[sourceFace * 3 + j]);
+			}
+		}
+
+		mioFree(pVertexOrder);
+		mioFree(pFaceOrder);
+		mioFreeMesh(&reordered);
+		mioFreeMesh(&mesh);
+	}
+
 	return 0;
 }
\ No newline at end of file
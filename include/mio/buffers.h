@@ -0,0 +1,98 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_BUFFERS_H__
+#define __MIO_BUFFERS_H__  1
+
+#include <stddef.h> // size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+// caller-owned array of points (double or float coordinates, depending on the reader). Each
+// point is stored as its coordinates one after the other, and the points are "stride" bytes
+// apart (0 = tightly packed), which allows them to be read straight into an interleaved
+// vertex buffer. The stride must be at least the size of a point.
+typedef struct MioCoordBuffer
+{
+    // pointer to the first point (NULL = do not read these points)
+    void* pData;
+    // number of points that fit at "pData"
+    size_t capacity;
+    // number of bytes from one point to the next (0 = tightly packed)
+    size_t stride;
+} MioCoordBuffer;
+
+// caller-owned array of indices or face sizes
+typedef struct MioIndexBuffer
+{
+    // pointer to the first element (NULL = do not read these elements)
+    unsigned int* pData;
+    // number of elements that fit at "pData"
+    size_t capacity;
+} MioIndexBuffer;
+
+/*
+    Destination arrays for the "mioRead*Into" functions, which read a mesh file into
+    memory that is owned by the caller instead of allocating the arrays. The layout of
+    each array is that of the corresponding (allocated) array of the other readers.
+    Any array can be left NULL, in which case its elements are counted but not stored.
+    The elements of a file are counted before any of them is stored, so if an array is
+    too small for the file, nothing is written to any of the arrays (and the reader
+    returns MIO_STATUS_BUFFER_TOO_SMALL with the counts of the whole file). The arrays
+    of a file that cannot be read (e.g. a malformed file) may hold some of its elements.
+*/
+typedef struct MioMeshBuffers
+{
+    // vertex positions stored as [xyz]
+    MioCoordBuffer vertices;
+    // normals stored as [xyz]
+    MioCoordBuffer normals;
+    // texture coordinates stored as [xy]
+    MioCoordBuffer texCoords;
+    // face sizes (number of vertices in each face)
+    MioIndexBuffer faceSizes;
+    // face-vertex indices
+    MioIndexBuffer faceVertexIndices;
+    // face-vertex texture-coord indices
+    MioIndexBuffer faceVertexTexCoordIndices;
+    // face-vertex normal indices
+    MioIndexBuffer faceVertexNormalIndices;
+} MioMeshBuffers;
+
+// element counts of a file that is read by a "mioRead*Into" function, which are the numbers
+// of elements that are (or would be) stored in each of the arrays of "MioMeshBuffers"
+typedef struct MioMeshCounts
+{
+    size_t numVertices;
+    size_t numNormals;
+    size_t numTexCoords;
+    size_t numFaces;
+    // number of face-vertex indices, which is also the number of face-vertex texture-coord
+    // (normal) indices when the file has texture coordinates (normals)
+    size_t numFaceVertices;
+} MioMeshCounts;
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __MIO_BUFFERS_H__
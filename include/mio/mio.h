@@ -27,8 +27,13 @@ extern "C" {
     
 #include "mio/obj.h"
 #include "mio/off.h"
+#include "mio/ply.h"
+#include "mio/status.h"
 #include "mio/stl.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
 #if defined(_WIN32)
 // https://stackoverflow.com/questions/735126/are-there-alternate-implementations-of-gnu-getline-interface/735472#735472
 /* Modifications, public domain as well, by Antti Haapala, 11/10/17
@@ -57,6 +62,18 @@ typedef struct MioMesh
 	unsigned int numNormals;
 	unsigned int numTexCoords;
 	unsigned int numFaces;
+
+	// index of the face in the file that each face (triangle) was split from when the mesh is read
+	// with "MIO_MESH_TRIANGULATE" (NULL otherwise)
+	unsigned int* pSourceFaces;
+
+	// single block that holds all of the above arrays when the mesh is read with "MIO_MESH_ARENA"
+	// (NULL otherwise). NOTE: must be NULL for meshes whose arrays are allocated separately
+	void* pArena;
+
+	// mapping of the .miob file that holds all of the above arrays when the mesh is read with
+	// "mioReadMIOB" or from a cache ("MIO_MESH_CACHE"), and NULL otherwise
+	void* pMapping;
 }MioMesh;
 
 /*
@@ -92,6 +109,387 @@ void mioWrite(
     unsigned int* numFaces
 );
 
+// format of the floating point numbers that are written to text files
+enum MioFloatFormat
+{
+    // the shortest decimal that parses back to the same value e.g. "0.1", "-3", "1.5e-07" (default)
+    MIO_FLOAT_FORMAT_SHORTEST,
+    // the same as printf's "%f" i.e. six decimal places e.g. "0.100000" (which can lose precision)
+    MIO_FLOAT_FORMAT_FIXED
+};
+
+/*
+    Function to set the format of the floating point numbers (coordinates) that are
+    written by the .obj, .off and (ASCII) .stl writers.
+    NOTE: this is a global setting, which should not be changed while a file is written.
+*/
+void mioSetFloatFormat(enum MioFloatFormat format);
+
+// amount of output that mio writes (progress on stdout, notes and errors on stderr)
+enum MioLogLevel
+{
+    // progress (e.g. "read .obj file: ..." and element counts), notes and errors (default)
+    MIO_LOG_LEVEL_ALL,
+    // errors only
+    MIO_LOG_LEVEL_ERRORS,
+    // nothing at all
+    MIO_LOG_LEVEL_NONE
+};
+
+/*
+    Function to set the amount of output that mio writes.
+    NOTE: this is a global setting, which should not be changed while a file is read or written.
+*/
+void mioSetLogLevel(enum MioLogLevel level);
+
+// statistics of a read (see "mioSetLoadStats"), where the times are wall-clock seconds
+typedef struct MioLoadStats
+{
+    // number of bytes of the file (or memory) that were read
+    unsigned long long numBytes;
+    // number of lines that were read (0 for binary files)
+    unsigned long long numLines;
+    // number of passes over the input
+    unsigned int numPasses;
+    // time of the whole read
+    double totalSeconds;
+    // time spent opening (and mapping) the file, and reading blocks of a file that is not mapped
+    double ioSeconds;
+    // time spent allocating, resizing and freeing memory on the calling thread
+    double allocSeconds;
+    // the remaining time, which is spent tokenizing the input and parsing numbers (including
+    // the page faults that read in a mapped file, and the work of any other threads)
+    double parseSeconds;
+} MioLoadStats;
+
+/*
+    Function to make each read (and visit) on the calling thread fill "pStats" with its
+    statistics, where NULL turns the statistics off (default). "pStats" is overwritten by
+    every read, and must remain valid until the statistics are turned off.
+*/
+void mioSetLoadStats(MioLoadStats* pStats);
+
+// functions that mio uses to allocate memory (including the memory that is handed over to the
+// caller). Each function receives "pUserData" as its last parameter.
+// NOTE: the functions must be thread-safe because .obj files can be read with multiple threads
+typedef struct MioAllocator
+{
+	void* (*pfnMalloc)(size_t size, void* pUserData);
+	void* (*pfnRealloc)(void* ptr, size_t size, void* pUserData);
+	void (*pfnFree)(void* ptr, void* pUserData);
+	void* pUserData;
+} MioAllocator;
+
+/*
+    Function to set the functions that mio uses to allocate memory, where NULL restores
+    the default (malloc, realloc and free). Memory that mio hands over must then be freed
+    with "mioFree" or "mioFreeMesh" (instead of "free").
+    NOTE: this is a global setting, which should not be changed while memory that was
+    allocated by mio is still in use.
+*/
+void mioSetAllocator(const MioAllocator* pAllocator);
+
+// flags for "mioReadMesh"
+enum MioMeshFlags
+{
+    // place all arrays of the mesh in a single (64-byte aligned) block, which is released with
+    // one call to free in "mioFreeMesh"
+    MIO_MESH_ARENA = 1u << 0,
+    // read the mesh from the cache file "<fpath>.miob" if that file was written for the current
+    // version of "fpath" (the same size and modification time), and (re)write the cache otherwise
+    MIO_MESH_CACHE = 1u << 1,
+    // store the face indices of a "MioMesh64" in 64 bits even if they all fit in 32 bits
+    MIO_MESH_64BIT_INDICES = 1u << 2,
+    // split the faces into triangles, so that each face has 3 face-vertices (and face i starts at
+    // face-vertex 3i). Convex faces are split into a fan and the other faces are ear-clipped,
+    // faces with fewer than 3 vertices are dropped, and "pSourceFaces" maps each triangle to the
+    // face that it was split from. NOTE: a cache file holds the faces as they are in the file.
+    MIO_MESH_TRIANGULATE = 1u << 3
+};
+
+/*
+    Function to read in a mesh file into "pMesh", where the format is given by the
+    extension of the file (.obj, .off, .ply, .stl or .miob). STL triangle corners that share
+    a position are welded, and each face refers to its own normal. PLY normals and
+    texture coordinates (and those of NOFF and STOFF files) are per vertex, so the
+    face-vertex normal and texture-coord indices are the same as the vertex indices. The
+    colours of COFF files are skipped (see "mioReadOFFWithAttributes"). The arrays of "pMesh" will be
+    allocated inside this function and must be freed with "mioFreeMesh".
+    NOTE: files that are compressed with gzip or zstd (e.g. "mesh.obj.gz" or "mesh.stl.zst")
+    are decompressed on a separate thread while they are parsed, if mio is built with zlib
+    or libzstd (see the MIO_USE_ZLIB and MIO_USE_ZSTD options). This is also the case for
+    the readers of the individual formats (e.g. "mioReadOBJ").
+*/
+void mioReadMesh(
+    // absolute path to file
+    const char* fpath,
+    // the mesh that is read (any previous contents are overwritten, not freed)
+    MioMesh* pMesh,
+    // bitwise-or of "MioMeshFlags" (or 0)
+    unsigned int flags);
+
+/*
+    Function to write "pMesh" to a .miob file, which is mio's native binary format. The file
+    holds the arrays of the mesh exactly as they are in memory (in the byte order of this
+    host), so that it can be read back without any parsing.
+*/
+void mioWriteMIOB(
+    // absolute path to file
+    const char* fpath,
+    // the mesh that is written
+    const MioMesh* pMesh);
+
+/*
+    Funcion to read in a .miob file (see "mioWriteMIOB") into "pMesh". The file is mapped into
+    memory and the arrays of "pMesh" point into the mapping, so the time to read the file does
+    not depend on its size. The arrays can be modified (without affecting the file), and are
+    released with "mioFreeMesh".
+*/
+void mioReadMIOB(
+    // absolute path to file
+    const char* fpath,
+    // the mesh that is read (any previous contents are overwritten, not freed)
+    MioMesh* pMesh);
+
+/*
+    Function to read in a mesh file into "pMesh" like "mioReadMesh", but where errors are
+    returned instead of ending the program: if the file cannot be read, everything that was
+    allocated for it is freed, "pMesh" is empty and the reason is returned. The readers are
+    reentrant (they keep their state on the stack, and the failure of a read only affects the
+    thread that runs it), so different threads can read files at the same time.
+    NOTE: the readers that return no status (e.g. "mioReadMesh", "mioReadOBJ" or "mioReadSTLf")
+    end the program if a file cannot be read, so only this function, "mioTryReadMesh64",
+    "mioReadBatch", "mioProbe", the "mioRead*Into" functions and the "mioVisit*" functions are
+    safe to call on files that may be invalid (e.g. in a server).
+    NOTE: the settings ("mioSetLogLevel", "mioSetAllocator" etc.) are global, and must not be
+    changed while a file is read.
+*/
+enum MioStatus mioTryReadMesh(
+    // absolute path to file
+    const char* fpath,
+    // the mesh that is read (any previous contents are overwritten, not freed)
+    MioMesh* pMesh,
+    // bitwise-or of "MioMeshFlags" (or 0)
+    unsigned int flags);
+
+/*
+    Function to read in the "numFiles" mesh files at "pPaths" (like "mioReadMesh" with
+    "flags") on up to "numThreads" threads (0 = number of hardware threads). Each thread
+    reads one file at a time, and the operating system is asked to read ahead the files
+    that are next in line, so that reading from disk overlaps with parsing. The format of a
+    file is given by its extension, or is guessed from its contents for other extensions.
+    "pMeshes[i]" and "pStatuses[i]" receive the mesh and the status of file i, where the
+    mesh is empty unless the status is "MIO_STATUS_OK". The meshes must be freed with
+    "mioFreeMesh". Like in "mioTryReadMesh", a file that cannot be read does not end the
+    program.
+*/
+void mioReadBatch(
+    // absolute paths to the files
+    const char* const* pPaths,
+    // number of paths in "pPaths"
+    size_t numFiles,
+    // array of "numFiles" meshes that are read (any previous contents are overwritten)
+    MioMesh* pMeshes,
+    // array of "numFiles" statuses
+    enum MioStatus* pStatuses,
+    // number of threads to read the files with (0 = number of hardware threads)
+    unsigned int numThreads,
+    // bitwise-or of "MioMeshFlags" (or 0)
+    unsigned int flags);
+
+// format of a mesh file
+enum MioFormat
+{
+    // the format is not known
+    MIO_FORMAT_UNKNOWN,
+    MIO_FORMAT_OBJ,
+    MIO_FORMAT_OFF,
+    MIO_FORMAT_PLY,
+    MIO_FORMAT_STL,
+    MIO_FORMAT_MIOB
+};
+
+// element counts of a mesh file (see "mioProbe")
+typedef struct MioMeshInfo
+{
+    enum MioFormat format;
+    // number of elements of the mesh that "mioReadMesh" reads from the file, where a count of
+    // zero means that the file has no such elements (e.g. no texture coordinates)
+    // NOTE: "mioReadMesh" welds the triangle corners of an .stl file, so for .stl files
+    // "numVertices" is the number of corners, which is an upper bound of the welded vertices
+    uint64_t numVertices;
+    uint64_t numNormals;
+    uint64_t numTexCoords;
+    uint64_t numFaces;
+    // number of face-vertex indices (the sum of the face sizes)
+    uint64_t numFaceVertices;
+} MioMeshInfo;
+
+/*
+    Function to get the format and the element counts of a mesh file without reading the
+    mesh, e.g. to decide whether a file is read at all, or to reserve memory for it. The
+    format is given by the extension of the file, or is guessed from its contents for
+    other extensions. The counts of .miob and binary .stl files are in their headers. Other
+    files are scanned line by line (and the face records of .ply files are skipped over),
+    where only the face sizes are parsed and no coordinates. Returns "MIO_STATUS_OK", or
+    the reason why the file cannot be probed (where "pInfo" is zero).
+    A malformed file does not end the program (like in "mioTryReadMesh").
+*/
+enum MioStatus mioProbe(
+    // absolute path to file
+    const char* fpath,
+    // the counts of the file
+    MioMeshInfo* pInfo);
+
+// structure for a mesh with 64-bit element counts (see "mioReadMesh64"). The face indices are
+// 32-bit (uint32_t) whenever they fit, which halves the memory of the index arrays, and 64-bit
+// (uint64_t) otherwise.
+typedef struct MioMesh64
+{
+	double* pVertices;
+	double* pNormals;
+	double* pTexCoords;
+
+	unsigned int* pFaceSizes;
+	// arrays of "numFaceVertices" indices of "indexSize" bytes each
+	void* pFaceVertexIndices;
+	void* pFaceVertexTexCoordIndices;
+	void* pFaceVertexNormalIndices;
+
+	// size of a face index i.e. sizeof(uint32_t) or sizeof(uint64_t)
+	size_t indexSize;
+
+	uint64_t numVertices;
+	uint64_t numNormals;
+	uint64_t numTexCoords;
+	uint64_t numFaces;
+	// number of elements in each face index array (the sum of the face sizes)
+	uint64_t numFaceVertices;
+} MioMesh64;
+
+/*
+    Function to read in a mesh file into "pMesh" like "mioReadMesh", but for meshes with
+    more than 4 billion elements or face indices. Only .obj files can hold such meshes (the
+    .off, .ply and .stl formats are limited to 32-bit counts or indices), and .obj files are
+    parsed on all hardware threads. The arrays of "pMesh" will be allocated inside this
+    function and must be freed with "mioFreeMesh64".
+*/
+void mioReadMesh64(
+    // absolute path to file
+    const char* fpath,
+    // the mesh that is read (any previous contents are overwritten, not freed)
+    MioMesh64* pMesh,
+    // "MIO_MESH_64BIT_INDICES" (or 0), where other flags are ignored
+    unsigned int flags);
+
+/*
+    Function to read in a mesh file into "pMesh" like "mioReadMesh64", but where errors are
+    returned instead of ending the program (see "mioTryReadMesh").
+*/
+enum MioStatus mioTryReadMesh64(
+    // absolute path to file
+    const char* fpath,
+    // the mesh that is read (any previous contents are overwritten, not freed)
+    MioMesh64* pMesh,
+    // "MIO_MESH_64BIT_INDICES" (or 0), where other flags are ignored
+    unsigned int flags);
+
+// Frees the memory of the given mesh pointers and sets the pointers to NULL.
+void mioFreeMesh64(MioMesh64* pMesh);
+
+// writer of a mesh file that is written block by block (see "mioBeginMeshWrite")
+typedef struct MioMeshWriter MioMeshWriter;
+
+/*
+    Function to begin writing a mesh file in "format" (MIO_FORMAT_OBJ, MIO_FORMAT_OFF or
+    MIO_FORMAT_STL, which is written as binary STL) from a mesh that is produced block by
+    block, e.g. by a marching cubes or tiling job. Each block of vertices and faces that is
+    passed to "mioWriteMeshVertices" and "mioWriteMeshFaces" is written as it arrives, so
+    only one block needs to be in memory at a time, and the counts in the header of the
+    file (.off and .stl) are filled in by "mioEndMeshWrite". Returns NULL (after logging
+    an error) if the file cannot be opened or if the format cannot be written this way.
+    NOTE: the faces of an .off file are kept in a temporary file until the file is ended,
+    since all of its vertices must come before its faces.
+*/
+MioMeshWriter* mioBeginMeshWrite(
+    // absolute path to file
+    const char* fpath,
+    // format of the file
+    enum MioFormat format);
+
+/*
+    Function to write the next block of vertices, which the faces that are written after it
+    (and before the next block) refer to.
+*/
+void mioWriteMeshVertices(
+    // the writer that was returned by "mioBeginMeshWrite"
+    MioMeshWriter* pWriter,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    const double* pVertices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices);
+
+/*
+    Function to write faces of the last block of vertices, where the face-vertex indices are
+    relative to the first vertex of the block (i.e. they are in [0, numVertices) of the last
+    "mioWriteMeshVertices") and are rebased onto the vertices of the whole file. The faces
+    of an .stl file are split into fans of triangles (with zero normals). A face that refers
+    to a vertex outside of the block is dropped (after logging an error), which makes
+    "mioEndMeshWrite" fail.
+*/
+void mioWriteMeshFaces(
+    // the writer that was returned by "mioBeginMeshWrite"
+    MioMeshWriter* pWriter,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    // or NULL if all faces are triangles
+    const unsigned int* pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    const unsigned int* pFaceVertexIndices,
+    // number of faces
+    unsigned int numFaces);
+
+/*
+    Function to end writing a mesh file that was begun with "mioBeginMeshWrite", which fills
+    in the counts of the header, closes the file and frees "pWriter". Returns 1 if the file
+    was written, and 0 (after logging an error) if a write failed or a face was dropped.
+*/
+int mioEndMeshWrite(
+    // the writer that was returned by "mioBeginMeshWrite"
+    MioMeshWriter* pWriter);
+
+// flags for "mioReorderMesh"
+enum MioReorderFlags
+{
+    // sort the vertices along a Morton (Z-order) curve through the bounding box of the mesh, so
+    // that vertices which are close in space are close in memory, and remap the face-vertex
+    // indices. NOTE: the normals and texture coordinates have their own indices and are not moved.
+    MIO_REORDER_VERTICES = 1u << 0,
+    // order the faces for the reuse of vertices in a (16-entry) post-transform vertex cache with
+    // the "Tipsify" algorithm of Sander et al., which also moves their normal and texture-coord
+    // indices and their "pSourceFaces"
+    MIO_REORDER_FACES = 1u << 1
+};
+
+/*
+    Function to reorder the vertices and/or faces of "pMesh" (that was read with e.g.
+    "mioReadMesh") for cache locality, in place, where the vertices are reordered before the
+    faces. The applied permutations are returned in "pVertexOrder" and "pFaceOrder", as the
+    index before the reordering of each vertex or face (like "pSourceFaces"), so that the
+    callers can reorder their own attributes. Returns 1, or 0 (after logging an error, with
+    "pMesh" unchanged) if a face-vertex index refers to no vertex.
+*/
+int mioReorderMesh(
+    // the mesh that is reordered
+    MioMesh* pMesh,
+    // bitwise-or of "MioReorderFlags"
+    unsigned int flags,
+    // the previous index of each vertex (numVertices elements), which must be freed with
+    // "mioFree", or NULL. NULL is returned if the vertices are not reordered (or there are none).
+    unsigned int** pVertexOrder,
+    // the previous index of each face (numFaces elements), which must be freed with "mioFree",
+    // or NULL. NULL is returned if the faces are not reordered (or there are none).
+    unsigned int** pFaceOrder);
+
 // Frees the memory associated with the given pointer 
 // NOTE: pMemPtr must be the address of a pointer that was internally allocated by "mio"
 void mioFree(void* pMemPtr);
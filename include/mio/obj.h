@@ -21,6 +21,12 @@
 #ifndef __MIO_OBJ_H__
 #define __MIO_OBJ_H__  1
 
+#include <stddef.h> // size_t
+
+#include "mio/buffers.h"
+#include "mio/status.h"
+#include "mio/visitor.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif // #ifdef __cplusplus
@@ -30,8 +36,9 @@ extern "C" {
     format). The pointer parameters will be allocated inside this function and must
     be freed by caller. The function only handles polygonal faces, so commands like
     "vp" command (which is used to specify control points of the surface or curve)
-    are ignored if encountered in file.
-
+    are ignored if encountered in file. NOTE: this function (like the other
+    readers of this header that return no status) ends the program if the file
+    cannot be read (see "mioTryReadMesh" for a read that returns the error).
 */
 void mioReadOBJ(
     // absolute path to file
@@ -59,6 +66,74 @@ void mioReadOBJ(
     // number of faces
     unsigned int* numFaces);
 
+/*
+    Funcion to read in an obj file like "mioReadOBJ", but from the contents of the
+    file in memory (e.g. a network receive buffer), which are parsed in place. The
+    buffer is not modified and is no longer needed once the function returns.
+*/
+void mioReadOBJFromMemory(
+    // the contents of an obj file (which do not need to be null-terminated)
+    const void* pData,
+    // number of bytes at "pData"
+    size_t dataSize,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    double** pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    double** pNormals,
+    // pointer to list of texture coordinates list stored as [xy,xy,xy...]
+    double** pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexTexCoordIndices,
+    // pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexNormalIndices,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of vertex normals in "pNormals"
+    unsigned int* numNormals,
+    // number of texture coordinates in "pTexCoords"
+    unsigned int* numTexcoords,
+    // number of faces
+    unsigned int* numFaces);
+
+/*
+    Funcion to read in an obj file in the same way as "mioReadOBJ", but with the
+    lines of the file split into chunks that are parsed on multiple threads. The
+    output is identical to that of "mioReadOBJ". Files that are too small to be
+    worth splitting, or that cannot be memory-mapped (e.g. pipes), are parsed on
+    the calling thread.
+*/
+void mioReadOBJParallel(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    double** pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    double** pNormals,
+    // pointer to list of texture coordinates list stored as [xy,xy,xy...]
+    double** pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexTexCoordIndices,
+    // pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexNormalIndices,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of vertex normals in "pNormals"
+    unsigned int* numNormals,
+    // number of texture coordinates in "pTexCoords"
+    unsigned int* numTexcoords,
+    // number of faces
+    unsigned int* numFaces,
+    // number of threads to use (0 = number of hardware threads)
+    unsigned int numThreads);
+
 /*
     Funcion to write out an obj file that stores a single 3D mesh object (in ASCII
     format).
@@ -89,6 +164,383 @@ void mioWriteOBJ(
     // number of faces (number of element in "pFaceSizes")
     unsigned int numFaces);
 
+/*
+    Funcion to write out an obj file in the same way as "mioWriteOBJ", but with the
+    lines split into chunks that are formatted on multiple threads, each into a
+    buffer of its own. The buffers are written out in order, so the file is
+    identical to that of "mioWriteOBJ". Meshes that are too small to be worth
+    splitting are written on the calling thread.
+*/
+void mioWriteOBJParallel(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    double* pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    double* pNormals,
+    // pointer to list of texture coordinates list stored as [xy,xy,xy...]
+    double* pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int* pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int* pFaceVertexIndices,
+    // pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int* pFaceVertexTexCoordIndices,
+    // pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int* pFaceVertexNormalIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of vertex normals in "pNormals"
+    unsigned int numNormals,
+    // number of texture coordinates in "pTexCoords"
+    unsigned int numTexcoords,
+    // number of faces (number of element in "pFaceSizes")
+    unsigned int numFaces,
+    // number of threads to use (0 = number of hardware threads)
+    unsigned int numThreads);
+
+/*
+    Funcion to read in an obj file like "mioReadOBJ", but with the vertex
+    coordinates, normals and texture coordinates parsed straight into single
+    precision (float) arrays, which are correctly rounded from the decimal text.
+*/
+void mioReadOBJf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    float** pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    float** pNormals,
+    // pointer to list of texture coordinates list stored as [xy,xy,xy...]
+    float** pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexTexCoordIndices,
+    // pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexNormalIndices,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of vertex normals in "pNormals"
+    unsigned int* numNormals,
+    // number of texture coordinates in "pTexCoords"
+    unsigned int* numTexcoords,
+    // number of faces
+    unsigned int* numFaces);
+
+/*
+    Funcion to read in an obj file like "mioReadOBJParallel", but with single
+    precision (float) coordinates (see "mioReadOBJf").
+*/
+void mioReadOBJParallelf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    float** pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    float** pNormals,
+    // pointer to list of texture coordinates list stored as [xy,xy,xy...]
+    float** pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexTexCoordIndices,
+    // pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexNormalIndices,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of vertex normals in "pNormals"
+    unsigned int* numNormals,
+    // number of texture coordinates in "pTexCoords"
+    unsigned int* numTexcoords,
+    // number of faces
+    unsigned int* numFaces,
+    // number of threads to use (0 = number of hardware threads)
+    unsigned int numThreads);
+
+/*
+    Funcion to read in an obj file like "mioReadOBJParallel", but into the caller-owned
+    arrays of "pBuffers" instead of allocating them (see "MioMeshBuffers"), e.g. to read
+    the vertices straight into an interleaved vertex buffer. The face-vertex texture-coord
+    (normal) indices are only stored when the file has texture coordinates (normals).
+    Returns MIO_STATUS_BUFFER_TOO_SMALL (after logging an error) if an array is too
+    small (see "MioMeshBuffers"), and the status of the failure (with zero counts) if
+    the file cannot be read. NOTE: a file can be probed with "mioProbe" to size the
+    arrays before it is read.
+*/
+enum MioStatus mioReadOBJInto(
+    // absolute path to file
+    const char* fpath,
+    // the arrays to read the coordinates (double) and faces into
+    const MioMeshBuffers* pBuffers,
+    // the element counts of the file
+    MioMeshCounts* pCounts,
+    // number of threads to use (0 = number of hardware threads)
+    unsigned int numThreads);
+
+/*
+    Funcion to read in an obj file like "mioReadOBJInto", but with single precision
+    (float) coordinates.
+*/
+enum MioStatus mioReadOBJIntof(
+    // absolute path to file
+    const char* fpath,
+    // the arrays to read the coordinates (float) and faces into
+    const MioMeshBuffers* pBuffers,
+    // the element counts of the file
+    MioMeshCounts* pCounts,
+    // number of threads to use (0 = number of hardware threads)
+    unsigned int numThreads);
+
+/*
+    Funcion to write out an obj file like "mioWriteOBJ", but from single precision
+    (float) coordinates. With the default float format, each number is written as
+    the shortest decimal that reads back to the same float.
+*/
+void mioWriteOBJf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    float* pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    float* pNormals,
+    // pointer to list of texture coordinates list stored as [xy,xy,xy...]
+    float* pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int* pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int* pFaceVertexIndices,
+    // pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int* pFaceVertexTexCoordIndices,
+    // pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int* pFaceVertexNormalIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of vertex normals in "pNormals"
+    unsigned int numNormals,
+    // number of texture coordinates in "pTexCoords"
+    unsigned int numTexcoords,
+    // number of faces (number of element in "pFaceSizes")
+    unsigned int numFaces);
+
+/*
+    Funcion to write out an obj file like "mioWriteOBJParallel", but from single
+    precision (float) coordinates (see "mioWriteOBJf").
+*/
+void mioWriteOBJParallelf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    float* pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    float* pNormals,
+    // pointer to list of texture coordinates list stored as [xy,xy,xy...]
+    float* pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int* pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int* pFaceVertexIndices,
+    // pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int* pFaceVertexTexCoordIndices,
+    // pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+    unsigned int* pFaceVertexNormalIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of vertex normals in "pNormals"
+    unsigned int numNormals,
+    // number of texture coordinates in "pTexCoords"
+    unsigned int numTexcoords,
+    // number of faces (number of element in "pFaceSizes")
+    unsigned int numFaces,
+    // number of threads to use (0 = number of hardware threads)
+    unsigned int numThreads);
+
+// An indexed mesh, where each distinct (position, texcoord, normal) combination of the
+// face-vertices of an obj file is one vertex, so that the faces need a single index array
+typedef struct MioIndexedMesh
+{
+    // interleaved vertex coordinates, "numCoords" per vertex and laid out as [xyz] position,
+    // then [xy] texcoord (if "hasTexCoords") and then [xyz] normal (if "hasNormals"), stored
+    // as double or float (see "mioReadOBJIndexedf")
+    void* pVertices;
+    // number of coordinates per vertex (3, 5, 6 or 8)
+    unsigned int numCoords;
+    // number of vertices in "pVertices"
+    unsigned int numVertices;
+    // number of face vertices for each face
+    unsigned int* pFaceSizes;
+    // the vertex index of each face-vertex, which is flattened (like in "mioReadOBJ")
+    unsigned int* pFaceVertexIndices;
+    // number of faces (number of element in "pFaceSizes")
+    unsigned int numFaces;
+    // true if the vertices have texcoords
+    unsigned int hasTexCoords;
+    // true if the vertices have normals
+    unsigned int hasNormals;
+} MioIndexedMesh;
+
+/*
+    Funcion to read in an obj file as an indexed mesh (see "MioIndexedMesh"). The
+    index triples of the face-vertices are hashed while the faces are parsed, so that
+    no per-kind index arrays are built. Texcoords or normals are only part of the
+    vertices if the file has them, and a face-vertex without a texcoord or normal id
+    uses the first one. The file is read on a single thread (unlike "mioReadOBJ").
+*/
+void mioReadOBJIndexed(
+    // absolute path to file
+    const char* fpath,
+    // pointer to the mesh that the file is read into (double coordinates)
+    MioIndexedMesh* pMesh);
+
+/*
+    Funcion to read in an obj file like "mioReadOBJIndexed", but with single precision
+    (float) coordinates.
+*/
+void mioReadOBJIndexedf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to the mesh that the file is read into (float coordinates)
+    MioIndexedMesh* pMesh);
+
+// Function to free the arrays of a mesh from "mioReadOBJIndexed" (or "mioReadOBJIndexedf")
+void mioFreeIndexedMesh(MioIndexedMesh* pMesh);
+
+// A section of an obj file, i.e. a run of faces with the same object ("o"), group ("g") and
+// material ("usemtl") names
+typedef struct MioObjSection
+{
+    // offsets of the object, group and material names in the "pNames" of the index (the offset
+    // 0 is the empty name, which faces have before the first "o", "g" or "usemtl" line)
+    unsigned int object;
+    unsigned int group;
+    unsigned int material;
+    // range of the faces of the section in the mesh that "mioReadOBJ" reads from the file
+    unsigned int firstFace;
+    unsigned int numFaces;
+    // number of vertices, texture coordinates and normals before the section in the file
+    unsigned int numPrecedingVertices;
+    unsigned int numPrecedingTexCoords;
+    unsigned int numPrecedingNormals;
+    // byte range of the lines of the section in the file
+    unsigned long long byteBegin;
+    unsigned long long byteEnd;
+} MioObjSection;
+
+// A run of lines in an obj file that holds consecutive vertices (texture coordinates, normals)
+typedef struct MioObjElementRun
+{
+    // byte offset of the line of the first element in the file
+    unsigned long long byteBegin;
+    // index of the first element in the file, and number of elements in the run
+    unsigned int first;
+    unsigned int count;
+} MioObjElementRun;
+
+// An index of the sections of an obj file, which is used to read only some of the sections
+// (see "mioReadOBJSections")
+typedef struct MioObjIndex
+{
+    // the sections with at least one face, in the order of the file
+    MioObjSection* pSections;
+    unsigned int numSections;
+    // the null-terminated names of the sections, stored back to back
+    char* pNames;
+    unsigned int namesSize;
+    // the runs of vertices (0), texture coordinates (1) and normals (2) in the file
+    MioObjElementRun* pRuns[3];
+    unsigned int numRuns[3];
+    // number of elements in the whole file
+    unsigned int numVertices;
+    unsigned int numTexCoords;
+    unsigned int numNormals;
+    unsigned int numFaces;
+    // size of the file in bytes
+    unsigned long long fileSize;
+} MioObjIndex;
+
+/*
+    Funcion to build the section index of an obj file (see "MioObjIndex"). The file is
+    scanned line by line without parsing any numbers, so this is much faster than
+    reading the file.
+*/
+void mioBuildOBJIndex(
+    // absolute path to file
+    const char* fpath,
+    // pointer to the index that is built
+    MioObjIndex* pIndex);
+
+/*
+    Funcion to get the section index of an obj file like "mioBuildOBJIndex", but
+    persisted in the file "<fpath>.mioi": the index is read from that file if it was
+    written for the current version of the obj file, and is otherwise built and
+    (re)written to it.
+*/
+void mioLoadOBJIndex(
+    // absolute path to file
+    const char* fpath,
+    // pointer to the index that is loaded
+    MioObjIndex* pIndex);
+
+// Function to free the arrays of an index from "mioBuildOBJIndex" (or "mioLoadOBJIndex")
+void mioFreeOBJIndex(MioObjIndex* pIndex);
+
+/*
+    Funcion to read in some of the sections of an obj file, given its section index.
+    Only the faces of the selected sections are parsed, along with the vertices,
+    texture coordinates and normals that they reference, which are renumbered (in the
+    order of the file) so the output arrays are like those of "mioReadOBJ" for a file
+    with just these sections. The faces are stored in the order of "pSectionIds".
+    NOTE: the file must be a regular (uncompressed) file that matches the index.
+*/
+void mioReadOBJSections(
+    // absolute path to file
+    const char* fpath,
+    // the section index of the file
+    const MioObjIndex* pIndex,
+    // the sections to read (indices into the sections of "pIndex")
+    const unsigned int* pSectionIds,
+    // number of sections in "pSectionIds"
+    unsigned int numSectionIds,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    double** pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    double** pNormals,
+    // pointer to list of texture coordinates list stored as [xy,xy,xy...]
+    double** pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // pointer to list of face-vertex texture-coord indices (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexTexCoordIndices,
+    // pointer to list of face-vertex normal indices (same order as in "pFaceVertexIndices")
+    unsigned int** pFaceVertexNormalIndices,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of vertex normals in "pNormals"
+    unsigned int* numNormals,
+    // number of texture coordinates in "pTexCoords"
+    unsigned int* numTexcoords,
+    // number of faces
+    unsigned int* numFaces);
+
+/*
+    Funcion to read in an obj file in a single pass with constant memory, where the
+    elements are passed to the callbacks of "pVisitor" instead of being stored in
+    arrays (see "MioVisitor"). Face-vertices without a texture-coord or normal id
+    get the id 0 (like in "mioReadOBJ"). Returns the status of the read, where the
+    callbacks may already have been called for the elements before a failure.
+*/
+enum MioStatus mioVisitOBJ(
+    // absolute path to file
+    const char* fpath,
+    // the callbacks that are called for the elements in the file
+    const MioVisitor* pVisitor);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // #ifdef __cplusplus
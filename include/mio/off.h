@@ -21,14 +21,24 @@
 #ifndef __MIO_OFF_H__
 #define __MIO_OFF_H__  1
 
+#include <stddef.h> // size_t
+
+#include "mio/buffers.h"
+#include "mio/status.h"
+#include "mio/visitor.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif // #ifdef __cplusplus
 
 /*
     Funcion to read in an .off file that stores a single 3D mesh object (in ASCII
-    format). The pointer parameters will be allocated inside this function and must
-    be freed by caller.
+    format, or in the binary format of an "OFF BINARY" header). The pointer parameters
+    will be allocated inside this function and must be freed by caller. The vertex
+    normals, colours and texture coordinates of the NOFF, COFF and STOFF variants are
+    skipped (see "mioReadOFFWithAttributes"). NOTE: this function (like the other
+    readers of this header that return no status) ends the program if the file
+    cannot be read (see "mioTryReadMesh" for a read that returns the error).
 */
 void mioReadOFF(
     // absolute path to file
@@ -44,6 +54,54 @@ void mioReadOFF(
     // number of faces (number of elements in "pFaceSizes")
     unsigned int* numFaces);
 
+/*
+    Funcion to read in an .off file like "mioReadOFF", but with the per-vertex attributes
+    of the [ST][C][N]OFF variants of the format: the normals ("N"), colours ("C") and
+    texture coordinates ("ST"), one of each per vertex. An attribute array is NULL if the
+    file does not have the attribute, and an attribute is skipped if its parameter is NULL.
+*/
+void mioReadOFFWithAttributes(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    double** pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...] (NULL if the file has none)
+    double** pNormals,
+    // pointer to list of vertex colours stored as [rgba,rgba,rgba...] (NULL if the file has
+    // none), where the values are those of the file (i.e. usually in [0, 1], but some files
+    // have integers in [0, 255]) and the alpha is 1 if the file only has RGB
+    double** pColors,
+    // pointer to list of texture coordinates stored as [xy,xy,xy...] (NULL if the file has none)
+    double** pTexCoords,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // number of vertices in "pVertices" (and of elements in each attribute array)
+    unsigned int* numVertices,
+    // number of faces (number of elements in "pFaceSizes")
+    unsigned int* numFaces);
+
+/*
+    Funcion to read in an .off file like "mioReadOFF", but from the contents of the
+    file in memory, which are parsed in place (the buffer is not modified).
+*/
+void mioReadOFFFromMemory(
+    // the contents of an .off file (which do not need to be null-terminated)
+    const void* pData,
+    // number of bytes at "pData"
+    size_t dataSize,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    double** pVertices,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of faces (number of elements in "pFaceSizes")
+    unsigned int* numFaces);
+
 /*
     Funcion to write out a .obj file that stores a single 3D mesh object (in ASCII
     format). 
@@ -67,6 +125,140 @@ void mioWriteOFF(
     // number of edges (number of elements in "pEdgeVertexIndices" divided by 2)
     unsigned int numEdges);
 
+/*
+    Funcion to write out an .off file in the same way as "mioWriteOFF", but with the
+    vertex and face lines split into chunks that are formatted on multiple threads,
+    each into a buffer of its own. The buffers are written out in order, so the
+    file is identical to that of "mioWriteOFF".
+*/
+void mioWriteOFFParallel(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    double* pVertices,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int* pFaceVertexIndices,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int* pFaceSizes,
+    // pointer to list of edge-vertex indices stored as [ij,ij,ij,ij,ij,...]
+    unsigned int* pEdgeVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of faces (number of elements in "pFaceSizes")
+    unsigned int numFaces,
+    // number of edges (number of elements in "pEdgeVertexIndices" divided by 2)
+    unsigned int numEdges,
+    // number of threads to use (0 = number of hardware threads)
+    unsigned int numThreads);
+
+/*
+    Funcion to read in an .off file like "mioReadOFF", but with the vertex
+    coordinates parsed straight into a single precision (float) array.
+*/
+void mioReadOFFf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    float** pVertices,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of faces (number of elements in "pFaceSizes")
+    unsigned int* numFaces);
+
+/*
+    Funcion to read in an .off file into the caller-owned arrays of "pBuffers" instead
+    of allocating them (see "MioMeshBuffers"). Each element is parsed straight into its
+    place, so nothing is allocated (except for the rest of a file that cannot be mapped,
+    e.g. a compressed file, which is held in memory to be counted). The normals and
+    texture coordinates of a NOFF or STOFF file are per vertex, so their face-vertex
+    indices are the vertex indices. Returns MIO_STATUS_BUFFER_TOO_SMALL (after logging
+    an error) if an array is too small (see "MioMeshBuffers"), and the status of the
+    failure (with zero counts) if the file cannot be read.
+*/
+enum MioStatus mioReadOFFInto(
+    // absolute path to file
+    const char* fpath,
+    // the arrays to read the vertex coordinates (double) and faces into
+    const MioMeshBuffers* pBuffers,
+    // the element counts of the file
+    MioMeshCounts* pCounts);
+
+/*
+    Funcion to read in an .off file like "mioReadOFFInto", but with the vertex
+    coordinates parsed straight into single precision (float) points.
+*/
+enum MioStatus mioReadOFFIntof(
+    // absolute path to file
+    const char* fpath,
+    // the arrays to read the vertex coordinates (float) and faces into
+    const MioMeshBuffers* pBuffers,
+    // the element counts of the file
+    MioMeshCounts* pCounts);
+
+/*
+    Funcion to write out an .off file like "mioWriteOFF", but from single precision
+    (float) vertex coordinates.
+*/
+void mioWriteOFFf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    float* pVertices,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int* pFaceVertexIndices,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int* pFaceSizes,
+    // pointer to list of edge-vertex indices stored as [ij,ij,ij,ij,ij,...]
+    unsigned int* pEdgeVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of faces (number of elements in "pFaceSizes")
+    unsigned int numFaces,
+    // number of edges (number of elements in "pEdgeVertexIndices" divided by 2)
+    unsigned int numEdges);
+
+/*
+    Funcion to write out an .off file like "mioWriteOFFParallel", but from single
+    precision (float) vertex coordinates.
+*/
+void mioWriteOFFParallelf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    float* pVertices,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int* pFaceVertexIndices,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int* pFaceSizes,
+    // pointer to list of edge-vertex indices stored as [ij,ij,ij,ij,ij,...]
+    unsigned int* pEdgeVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of faces (number of elements in "pFaceSizes")
+    unsigned int numFaces,
+    // number of edges (number of elements in "pEdgeVertexIndices" divided by 2)
+    unsigned int numEdges,
+    // number of threads to use (0 = number of hardware threads)
+    unsigned int numThreads);
+
+/*
+    Funcion to read in an .off file in a single pass with constant memory, where the
+    elements are passed to the callbacks of "pVisitor" instead of being stored in
+    arrays (see "MioVisitor"). The normal and texture coordinate of a vertex (NOFF and
+    STOFF files) are visited right after its position, and have the index of the vertex.
+    Returns the status of the read, where the callbacks may already have been called
+    for the elements before a failure.
+*/
+enum MioStatus mioVisitOFF(
+    // absolute path to file
+    const char* fpath,
+    // the callbacks that are called for the elements in the file
+    const MioVisitor* pVisitor);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // #ifdef __cplusplus
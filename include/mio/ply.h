@@ -0,0 +1,202 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_PLY_H__
+#define __MIO_PLY_H__  1
+
+#include <stddef.h> // size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+/*
+    Funcion to read in a .ply file that stores a single 3D mesh object (in ASCII,
+    binary little-endian or binary big-endian format). Vertex positions, normals
+    (nx, ny, nz) and texture coordinates (u, v or s, t) of the "vertex" element and
+    the vertex indices of the "face" element are read, and any other elements and
+    properties (e.g. colors) are skipped. The pointer parameters will be allocated
+    inside this function and must be freed by caller. NOTE: this function (like the
+    other readers of this header) ends the program if the file cannot be read (see
+    "mioTryReadMesh" for a read that returns the error).
+*/
+void mioReadPLY(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    double** pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...] (NULL if the file has none)
+    // NOTE: there is one normal per vertex
+    double** pNormals,
+    // pointer to list of texture coordinates stored as [xy,xy,xy...] (NULL if the file has none)
+    // NOTE: there is one texture coordinate per vertex
+    double** pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of faces (number of elements in "pFaceSizes")
+    unsigned int* numFaces);
+
+/*
+    Funcion to read in a .ply file like "mioReadPLY", but from the contents of the
+    file in memory, which are parsed in place (the buffer is not modified).
+*/
+void mioReadPLYFromMemory(
+    // the contents of a .ply file (which do not need to be null-terminated)
+    const void* pData,
+    // number of bytes at "pData"
+    size_t dataSize,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    double** pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...] (NULL if the file has none)
+    double** pNormals,
+    // pointer to list of texture coordinates stored as [xy,xy,xy...] (NULL if the file has none)
+    double** pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of faces (number of elements in "pFaceSizes")
+    unsigned int* numFaces);
+
+/*
+    Funcion to write out a .ply file that stores a single 3D mesh object (in ASCII
+    format). The normals and texture coordinates (one per vertex) can be NULL, in
+    which case they are not written.
+*/
+void mioWritePLY(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    const double* pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    const double* pNormals,
+    // pointer to list of texture coordinates stored as [xy,xy,xy...]
+    const double* pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    // NOTE: can be NULL if all faces are triangles
+    const unsigned int* pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    const unsigned int* pFaceVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of faces
+    unsigned int numFaces);
+
+/*
+    Funcion to write out a binary (little-endian) .ply file like "mioWritePLY". The
+    coordinates are stored as doubles, so no precision is lost.
+*/
+void mioWritePLYBinary(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    const double* pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    const double* pNormals,
+    // pointer to list of texture coordinates stored as [xy,xy,xy...]
+    const double* pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    // NOTE: can be NULL if all faces are triangles
+    const unsigned int* pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    const unsigned int* pFaceVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of faces
+    unsigned int numFaces);
+
+/*
+    Funcion to read in a .ply file like "mioReadPLY", but with single precision
+    (float) coordinates. Binary files that store the positions as floats (and
+    nothing else per vertex) are copied without any conversion.
+*/
+void mioReadPLYf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    float** pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...] (NULL if the file has none)
+    float** pNormals,
+    // pointer to list of texture coordinates stored as [xy,xy,xy...] (NULL if the file has none)
+    float** pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    unsigned int** pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    unsigned int** pFaceVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int* numVertices,
+    // number of faces (number of elements in "pFaceSizes")
+    unsigned int* numFaces);
+
+/*
+    Funcion to write out a .ply file like "mioWritePLY", but from single precision
+    (float) coordinates.
+*/
+void mioWritePLYf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    const float* pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    const float* pNormals,
+    // pointer to list of texture coordinates stored as [xy,xy,xy...]
+    const float* pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    const unsigned int* pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    const unsigned int* pFaceVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of faces
+    unsigned int numFaces);
+
+/*
+    Funcion to write out a binary (little-endian) .ply file like "mioWritePLYBinary",
+    but from single precision (float) coordinates, which are stored as floats.
+*/
+void mioWritePLYBinaryf(
+    // absolute path to file
+    const char* fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+    const float* pVertices,
+    // pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+    const float* pNormals,
+    // pointer to list of texture coordinates stored as [xy,xy,xy...]
+    const float* pTexCoords,
+    // pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+    const unsigned int* pFaceSizes,
+    // pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+    const unsigned int* pFaceVertexIndices,
+    // number of vertices in "pVertices"
+    unsigned int numVertices,
+    // number of faces
+    unsigned int numFaces);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __MIO_PLY_H__
@@ -0,0 +1,56 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_STATUS_H__
+#define __MIO_STATUS_H__  1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+// status of a read that returns errors instead of ending the program (see "mioTryReadMesh",
+// "mioReadBatch", the "mioRead*Into" functions and the "mioVisit*" functions)
+enum MioStatus
+{
+    // the file was read
+    MIO_STATUS_OK,
+    // the file could not be opened
+    MIO_STATUS_OPEN_FAILED,
+    // the format is known neither from the extension nor from the contents of the file, or
+    // the file uses a variant of its format that mio does not support
+    MIO_STATUS_UNSUPPORTED_FORMAT,
+    // the contents of the file are invalid (e.g. a face index refers to no vertex, or the file
+    // ends in the middle of an element)
+    MIO_STATUS_MALFORMED,
+    // the file has too many elements for 32-bit counts and indices (see "mioReadMesh64")
+    MIO_STATUS_TOO_LARGE,
+    // memory could not be allocated
+    MIO_STATUS_OUT_OF_MEMORY,
+    // the system failed (e.g. a thread could not be created)
+    MIO_STATUS_SYSTEM_ERROR,
+    // an array of the "MioMeshBuffers" of a "mioRead*Into" function is too small for the file
+    MIO_STATUS_BUFFER_TOO_SMALL
+};
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __MIO_STATUS_H__
@@ -21,14 +21,22 @@
 #ifndef __MIO_STL_H__
 #define __MIO_STL_H__  1
 
+#include <stddef.h> // size_t
+
+#include "mio/buffers.h"
+#include "mio/status.h"
+#include "mio/visitor.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif // #ifdef __cplusplus
 
 /*
     Funcion to read in a [.stl|.stl-ascii] file that stores a single 3D mesh object (in ASCII
-    format). The pointer parameters will be allocated inside this function and must
-    be freed by caller.
+    or binary format, which is detected automatically). The pointer parameters will be
+    allocated inside this function and must be freed by caller. NOTE: this function (like
+    the other readers of this header that return no status) ends the program if the file
+    cannot be read (see "mioTryReadMesh" for a read that returns the error).
 */
 void mioReadSTL(
 	// absolute path to file
@@ -41,6 +49,50 @@ void mioReadSTL(
 	// number of vertices (which can be used to deduce the number of vertices)
 	unsigned int* numVertices);
 
+/*
+    Funcion to read in a [.stl|.stl-ascii] file like "mioReadSTL", but from the contents
+    of the file in memory, which are parsed in place (the buffer is not modified).
+*/
+void mioReadSTLFromMemory(
+	// the contents of an .stl file (which do not need to be null-terminated)
+	const void* pData,
+	// number of bytes at "pData"
+	size_t dataSize,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	double** pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	double** pNormals,
+	// number of vertices (which can be used to deduce the number of vertices)
+	unsigned int* numVertices);
+
+/*
+    Funcion to read in a [.stl|.stl-ascii] file (like "mioReadSTL") and weld the
+    triangle corners that share a position, which gives an indexed mesh with unique
+    vertices (like the OBJ/OFF readers). With "epsilon" > 0, positions are snapped to
+    a grid with cells of that size, and vertices that fall into the same cell are
+    welded (NOTE: vertices closer than "epsilon" that straddle a cell boundary are not).
+    The pointer parameters will be allocated inside this function and must be freed
+    by caller.
+*/
+void mioReadSTLWelded(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of (unique) vertex coordinates stored as [xyz,xyz,xyz,...]
+	double** pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	double** pNormals,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int** pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijk,ijk,ijk,...]
+	unsigned int** pFaceVertexIndices,
+	// number of vertices in "pVertices"
+	unsigned int* numVertices,
+	// number of faces
+	unsigned int* numFaces,
+	// vertices whose coordinates snap to the same grid cell of this size are welded (0 = exact)
+	double epsilon);
+
 /*
     Funcion to write out a [.stl|.stl-ascii] file that stores a single 3D mesh object (in ASCII
     format).
@@ -56,6 +108,115 @@ void mioWriteSTL(
     // number of triangles (which can be used to deduce the number of vertices) 
     const unsigned int numVertices);
 
+/*
+    Funcion to write out a binary .stl file that stores a single 3D mesh object. The
+    coordinates are stored as 32-bit floats. The normals can be NULL, in which case
+    zero normals are written.
+*/
+void mioWriteSTLBinary(
+    // absolute path to file
+	const char* const fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	const double* const pVertices,
+    // pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+    // NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	const double* const pNormals,
+    // number of vertices (which can be used to deduce the number of triangles)
+    const unsigned int numVertices);
+
+/*
+    Funcion to read in a [.stl|.stl-ascii] file like "mioReadSTL", but with single
+    precision (float) coordinates. Binary files store floats, which are then copied
+    without any conversion.
+*/
+void mioReadSTLf(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	float** pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	float** pNormals,
+	// number of vertices (which can be used to deduce the number of vertices)
+	unsigned int* numVertices);
+
+/*
+    Funcion to read in a [.stl|.stl-ascii] file into the caller-owned arrays of
+    "pBuffers" instead of allocating them (see "MioMeshBuffers"). Nothing is allocated
+    (except for the rest of an ASCII file that cannot be mapped, e.g. a compressed file,
+    which is held in memory to be counted). As with "mioReadSTL", the vertices are the
+    corners of the triangles (three per triangle) and there is one normal per triangle.
+    The face arrays, if any, receive the implicit triangles: face i has size 3, the
+    vertex indices 3i, 3i+1 and 3i+2, and the normal index i. The file has no texture
+    coordinates. Returns MIO_STATUS_BUFFER_TOO_SMALL (after logging an error) if an
+    array is too small (see "MioMeshBuffers"), and the status of the failure (with zero
+    counts) if the file cannot be read.
+*/
+enum MioStatus mioReadSTLInto(
+    // absolute path to file
+    const char* fpath,
+    // the arrays to read the coordinates (double) and triangles into
+    const MioMeshBuffers* pBuffers,
+    // the element counts of the file
+    MioMeshCounts* pCounts);
+
+/*
+    Funcion to read in a [.stl|.stl-ascii] file like "mioReadSTLInto", but with single
+    precision (float) coordinates.
+*/
+enum MioStatus mioReadSTLIntof(
+    // absolute path to file
+    const char* fpath,
+    // the arrays to read the coordinates (float) and triangles into
+    const MioMeshBuffers* pBuffers,
+    // the element counts of the file
+    MioMeshCounts* pCounts);
+
+/*
+    Funcion to write out a [.stl|.stl-ascii] file like "mioWriteSTL", but from single
+    precision (float) coordinates.
+*/
+void mioWriteSTLf(
+    // absolute path to file
+	const char* const fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	const float* const pVertices,
+    // pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+    // NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	const float* const pNormals,
+    // number of triangles (which can be used to deduce the number of vertices) 
+    const unsigned int numVertices);
+
+/*
+    Funcion to write out a binary .stl file like "mioWriteSTLBinary", but from single
+    precision (float) coordinates.
+*/
+void mioWriteSTLBinaryf(
+    // absolute path to file
+	const char* const fpath,
+    // pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	const float* const pVertices,
+    // pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+    // NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	const float* const pNormals,
+    // number of vertices (which can be used to deduce the number of triangles)
+    const unsigned int numVertices);
+
+/*
+    Funcion to read in a [.stl|.stl-ascii] file in a single pass with constant
+    memory, where the elements are passed to the callbacks of "pVisitor" instead of
+    being stored in arrays (see "MioVisitor"). Each triangle gives a normal, three
+    vertices and a face (in that order) whose corners refer to these vertices i.e.
+    face i has the vertex indices [3i, 3i+1, 3i+2] and normal indices [i, i, i].
+    Returns the status of the read, where the callbacks may already have been called
+    for the elements before a failure.
+*/
+enum MioStatus mioVisitSTL(
+    // absolute path to file
+    const char* fpath,
+    // the callbacks that are called for the elements in the file
+    const MioVisitor* pVisitor);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // #ifdef __cplusplus
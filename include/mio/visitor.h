@@ -0,0 +1,58 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_VISITOR_H__
+#define __MIO_VISITOR_H__  1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+/*
+    Callbacks that are called for each element of a mesh file, in the order in which
+    the elements are found in the file, by the "mioVisit*" functions. These read the
+    file in a single pass with constant memory (no mesh arrays are allocated). Any
+    callback can be NULL, in which case the corresponding elements are skipped. All
+    pointers passed to a callback are only valid for the duration of the call.
+*/
+typedef struct MioVisitor
+{
+    // called for each vertex position, stored as [xyz]
+    void (*onVertex)(const double* pCoords, void* pUserData);
+    // called for each normal, stored as [xyz]
+    void (*onNormal)(const double* pCoords, void* pUserData);
+    // called for each texture coordinate, stored as [xy]
+    void (*onTexCoord)(const double* pCoords, void* pUserData);
+    // called for each face with the (zero-based) vertex indices of its "count" face-vertices,
+    // and the texture-coord and normal indices of each face-vertex (NULL if the face has none)
+    void (*onFace)(const unsigned int* pVertexIndices,
+                   const unsigned int* pTexCoordIndices,
+                   const unsigned int* pNormalIndices,
+                   unsigned int count,
+                   void* pUserData);
+    // passed as the last parameter to each callback
+    void* pUserData;
+} MioVisitor;
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __MIO_VISITOR_H__
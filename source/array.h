@@ -0,0 +1,225 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_ARRAY_H__
+#define __MIO_ARRAY_H__ 1
+
+#include "fail.h"
+#include "log.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Functions to allocate, resize and free memory with the allocator that is set with
+// "mioSetAllocator". All memory that mio allocates goes through these (see mio.c).
+void* mioMemAlloc(size_t size);
+void* mioMemRealloc(void* ptr, size_t size);
+void mioMemFree(void* ptr);
+
+// Function to allocate an (uninitialised) array of "count" elements of "elemSize" bytes, for when
+// the number of elements is known up front. Aborts if the memory cannot be allocated (an
+// allocator may return NULL for an empty array).
+static inline void* mioAllocate(size_t count, size_t elemSize)
+{
+	void* ptr = NULL;
+
+	if(count <= ((size_t)-1) / elemSize)
+	{
+		ptr = mioMemAlloc(count * elemSize);
+	}
+
+	if(ptr == NULL && count != 0)
+	{
+		mioLogError("error: failed to allocate %zu elements of %zu bytes\n", count, elemSize);
+		mioFail(MIO_STATUS_OUT_OF_MEMORY);
+	}
+
+	return ptr;
+}
+
+// growable array used by the readers to accumulate parsed elements while a file is read in a
+// single pass. The number of elements in a file is generally not known up front, so arrays grow
+// geometrically and are trimmed to their final size once parsing completes.
+typedef struct MioArray
+{
+	void* pData;
+	// number of elements currently stored
+	size_t size;
+	// number of elements that "pData" can hold
+	size_t capacity;
+} MioArray;
+
+// Function to ensure that "pArray" can hold at least "minCapacity" elements of "elemSize" bytes
+static inline void mioArrayReserve(MioArray* pArray, size_t elemSize, size_t minCapacity)
+{
+	if(minCapacity <= pArray->capacity)
+	{
+		return;
+	}
+
+	size_t newCapacity = pArray->capacity + (pArray->capacity >> 1); // grow by 1.5x
+
+	if(newCapacity < minCapacity)
+	{
+		newCapacity = minCapacity;
+	}
+
+	if(newCapacity < 64)
+	{
+		newCapacity = 64;
+	}
+
+	void* pNewData = NULL;
+
+	if(newCapacity <= ((size_t)-1) / elemSize)
+	{
+		pNewData = mioMemRealloc(pArray->pData, newCapacity * elemSize);
+	}
+
+	if(pNewData == NULL)
+	{
+		mioLogError("error: failed to allocate %zu bytes\n", newCapacity * elemSize);
+		mioFail(MIO_STATUS_OUT_OF_MEMORY);
+	}
+
+	pArray->pData = pNewData;
+	pArray->capacity = newCapacity;
+}
+
+// Function to grow "pArray" to "newSize" elements, where the new elements are initialised to zero
+static inline void mioArrayResizeZeroed(MioArray* pArray, size_t elemSize, size_t newSize)
+{
+	if(newSize <= pArray->size)
+	{
+		return;
+	}
+
+	mioArrayReserve(pArray, elemSize, newSize);
+	memset((char*)pArray->pData + pArray->size * elemSize, 0, (newSize - pArray->size) * elemSize);
+	pArray->size = newSize;
+}
+
+static inline void mioArrayPushDoubles(MioArray* pArray, const double* pValues, size_t count)
+{
+	mioArrayReserve(pArray, sizeof(double), pArray->size + count);
+	memcpy((double*)pArray->pData + pArray->size, pValues, count * sizeof(double));
+	pArray->size += count;
+}
+
+static inline void mioArrayPushFloats(MioArray* pArray, const float* pValues, size_t count)
+{
+	mioArrayReserve(pArray, sizeof(float), pArray->size + count);
+	memcpy((float*)pArray->pData + pArray->size, pValues, count * sizeof(float));
+	pArray->size += count;
+}
+
+static inline void mioArrayPushUint(MioArray* pArray, unsigned int value)
+{
+	mioArrayReserve(pArray, sizeof(unsigned int), pArray->size + 1);
+	((unsigned int*)pArray->pData)[pArray->size++] = value;
+}
+
+// Function to store "value" at position "index" of "pArray", zero-filling any gap before it
+static inline void mioArraySetUint(MioArray* pArray, size_t index, unsigned int value)
+{
+	mioArrayResizeZeroed(pArray, sizeof(unsigned int), index + 1);
+	((unsigned int*)pArray->pData)[index] = value;
+}
+
+static inline void mioArrayPushUint64(MioArray* pArray, uint64_t value)
+{
+	mioArrayReserve(pArray, sizeof(uint64_t), pArray->size + 1);
+	((uint64_t*)pArray->pData)[pArray->size++] = value;
+}
+
+// Function to store "value" at position "index" of "pArray", zero-filling any gap before it
+static inline void mioArraySetUint64(MioArray* pArray, size_t index, uint64_t value)
+{
+	mioArrayResizeZeroed(pArray, sizeof(uint64_t), index + 1);
+	((uint64_t*)pArray->pData)[index] = value;
+}
+
+// Function to convert the "count" 32-bit unsigned integers at "pData" to 64 bits in place, where
+// the memory is resized to hold "capacity" (>= "count") 64-bit integers. Returns the resized
+// memory. Aborts if the memory cannot be allocated.
+static inline void* mioWidenUints(void* pData, size_t count, size_t capacity)
+{
+	if(capacity == 0)
+	{
+		return pData;
+	}
+
+	void* pWide = NULL;
+
+	if(capacity <= ((size_t)-1) / sizeof(uint64_t))
+	{
+		pWide = mioMemRealloc(pData, capacity * sizeof(uint64_t));
+	}
+
+	if(pWide == NULL)
+	{
+		mioLogError("error: failed to allocate %zu bytes\n", capacity * sizeof(uint64_t));
+		mioFail(MIO_STATUS_OUT_OF_MEMORY);
+	}
+
+	// NOTE: converting from the back means that no element is overwritten before it is read
+	const uint32_t* pSrc = (const uint32_t*)pWide;
+	uint64_t* pDst = (uint64_t*)pWide;
+
+	for(size_t i = count; i-- > 0;)
+	{
+		pDst[i] = pSrc[i];
+	}
+
+	return pWide;
+}
+
+// Function to convert the 32-bit unsigned integers of "pArray" to 64 bits
+static inline void mioArrayWidenUints(MioArray* pArray)
+{
+	pArray->pData = mioWidenUints(pArray->pData, pArray->size, pArray->capacity);
+}
+
+// Function to trim the allocation of "pArray" to its size and hand the memory over to the caller.
+// Returns NULL (after freeing any memory) if the array is empty.
+static inline void* mioArrayRelease(MioArray* pArray, size_t elemSize)
+{
+	void* pOut = NULL;
+
+	if(pArray->size == 0)
+	{
+		mioMemFree(pArray->pData);
+	}
+	else
+	{
+		void* pTrimmed = mioMemRealloc(pArray->pData, pArray->size * elemSize);
+		pOut = (pTrimmed != NULL) ? pTrimmed : pArray->pData;
+	}
+
+	pArray->pData = NULL;
+	pArray->size = 0;
+	pArray->capacity = 0;
+
+	return pOut;
+}
+
+#endif // #ifndef __MIO_ARRAY_H__
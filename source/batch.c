@@ -0,0 +1,168 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#include "mio/mio.h"
+
+#include "array.h"
+#include "fail.h"
+#include "format.h"
+#include "input.h"
+#include "miob.h"
+#include "thread.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// state that is shared by the threads of "mioReadBatch"
+typedef struct BatchState
+{
+	const char* const* pPaths;
+	size_t numFiles;
+	MioMesh* pMeshes;
+	enum MioStatus* pStatuses;
+	unsigned int flags;
+	// distance from the file that a thread starts to read to the file that is prefetched, such
+	// that the next file of each thread is read from disk while the current one is parsed
+	size_t prefetchDistance;
+	// the index of the next file to read, which the threads increment atomically
+	volatile size_t nextFile;
+} BatchState;
+
+typedef struct BatchThread
+{
+	BatchState* pState;
+} BatchThread;
+
+// Function to read the file at "fpath" into "pMesh" (see "mioReadBatch")
+static enum MioStatus readBatchFile(const char* fpath, MioMesh* pMesh, unsigned int flags)
+{
+	memset(pMesh, 0, sizeof(MioMesh));
+
+	FILE* file = fopen(fpath, "rb");
+
+	if(file == NULL)
+	{
+		return MIO_STATUS_OPEN_FAILED;
+	}
+
+	enum MioFormat format = mioGetFormatFromExtension(fpath);
+
+	if(format == MIO_FORMAT_UNKNOWN)
+	{
+		char head[MIO_FORMAT_HEAD_SIZE];
+		const size_t headSize = fread(head, 1, sizeof(head), file);
+		MioSourceStamp stamp;
+
+		if(mioGetSourceStamp(fpath, &stamp))
+		{
+			format = mioGetFormatFromContents(head, headSize, stamp.size);
+		}
+	}
+
+	fclose(file);
+
+	if(format == MIO_FORMAT_UNKNOWN)
+	{
+		return MIO_STATUS_UNSUPPORTED_FORMAT;
+	}
+
+	// a file that cannot be read fails on its own, without ending the batch
+	MioFailScope scope;
+
+	mioFailScopeBegin(&scope);
+
+	if(setjmp(scope.jump) == 0)
+	{
+		mioReadMeshFormat(fpath, format, pMesh, flags);
+	}
+	else
+	{
+		memset(pMesh, 0, sizeof(MioMesh));
+	}
+
+	return mioFailScopeEnd(&scope);
+}
+
+static void readBatchTask(void* pArg)
+{
+	BatchState* pState = ((BatchThread*)pArg)->pState;
+
+	for(;;)
+	{
+		const size_t i = mioAtomicFetchAdd(&pState->nextFile, 1);
+
+		if(i >= pState->numFiles)
+		{
+			break;
+		}
+
+		if(pState->prefetchDistance < pState->numFiles - i)
+		{
+			mioInputPrefetchFile(pState->pPaths[i + pState->prefetchDistance]);
+		}
+
+		pState->pStatuses[i] = readBatchFile(pState->pPaths[i], &pState->pMeshes[i], pState->flags);
+	}
+}
+
+void mioReadBatch(const char* const* pPaths,
+				  size_t numFiles,
+				  MioMesh* pMeshes,
+				  enum MioStatus* pStatuses,
+				  unsigned int numThreads,
+				  unsigned int flags)
+{
+	assert(pPaths != NULL || numFiles == 0);
+
+	if(numThreads == 0)
+	{
+		numThreads = mioGetHardwareThreadCount();
+	}
+
+	if(numThreads > numFiles)
+	{
+		numThreads = (numFiles > 0) ? (unsigned int)numFiles : 1u;
+	}
+
+	BatchState state;
+
+	state.pPaths = pPaths;
+	state.numFiles = numFiles;
+	state.pMeshes = pMeshes;
+	state.pStatuses = pStatuses;
+	state.flags = flags;
+	state.prefetchDistance = numThreads;
+	state.nextFile = 0;
+
+	BatchThread* pThreads = (BatchThread*)mioAllocate(numThreads, sizeof(BatchThread));
+
+	for(unsigned int i = 0; i < numThreads; ++i)
+	{
+		pThreads[i].pState = &state;
+	}
+
+	// NOTE: the calling thread reads files too
+	mioRunTasks(readBatchTask, pThreads, sizeof(BatchThread), numThreads);
+
+	mioMemFree(pThreads);
+}
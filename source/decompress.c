@@ -0,0 +1,455 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#include "decompress.h"
+
+#include "array.h"
+#include "fail.h"
+#include "log.h"
+#include "thread.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(MIO_HAS_ZLIB)
+#	include <zlib.h>
+#endif
+
+#if defined(MIO_HAS_ZSTD)
+#	include <zstd.h>
+#endif
+
+// size of the blocks of decompressed data, and number of blocks in the ring
+#define MIO_DECOMPRESS_BLOCK_SIZE (1u << 20)
+#define MIO_DECOMPRESS_NUM_BLOCKS 4
+
+// size of the reads from the compressed file
+#define MIO_DECOMPRESS_INPUT_SIZE (1u << 18)
+
+typedef struct DecompressBlock
+{
+	char* pData;
+	size_t size;
+} DecompressBlock;
+
+struct MioDecompressor
+{
+	enum MioCompression compression;
+	MioThread thread;
+
+	// state of the decompression thread: the compressed file and the last block read from it
+	FILE* file;
+	char* pInput;
+	size_t inputSize;
+	bool inputEnded; // no more bytes can be read from "file"
+	bool atEnd; // all data has been decompressed
+	bool failed; // the data is corrupt or truncated
+#if defined(MIO_HAS_ZLIB)
+	z_stream zlibStream;
+#endif
+#if defined(MIO_HAS_ZSTD)
+	ZSTD_DStream* pZstdStream;
+	ZSTD_inBuffer zstdInput;
+	size_t zstdResult; // the last result of ZSTD_decompressStream that made progress
+#endif
+
+	// the ring of blocks, where the "numFull" blocks from "readIndex" on hold decompressed data.
+	// NOTE: full blocks are only accessed by the reader, and the others only by the thread
+	DecompressBlock blocks[MIO_DECOMPRESS_NUM_BLOCKS];
+	size_t readIndex;
+	size_t readPos; // position of the reader in the block at "readIndex"
+	size_t numFull;
+	bool finished; // the thread has added its last block
+	bool stop; // the decompressor is being destroyed
+	MioMutex mutex; // guards "readIndex", "numFull", "finished" and "stop"
+	MioCondition condition; // signalled when a block is added or released, or on "stop"
+};
+
+enum MioCompression mioGetCompression(const void* pHead, size_t size)
+{
+	const unsigned char* pBytes = (const unsigned char*)pHead;
+
+	if(size >= 2 && pBytes[0] == 0x1f && pBytes[1] == 0x8b)
+	{
+		return MIO_COMPRESSION_GZIP;
+	}
+
+	if(size >= 4 && pBytes[0] == 0x28 && pBytes[1] == 0xb5 && pBytes[2] == 0x2f &&
+	   pBytes[3] == 0xfd)
+	{
+		return MIO_COMPRESSION_ZSTD;
+	}
+
+	return MIO_COMPRESSION_NONE;
+}
+
+const char* mioGetCompressionName(enum MioCompression compression)
+{
+	switch(compression)
+	{
+	case MIO_COMPRESSION_GZIP:
+		return "gzip";
+	case MIO_COMPRESSION_ZSTD:
+		return "zstd";
+	default:
+		return "uncompressed";
+	}
+}
+
+// Function to read the next block of compressed data
+static void readInput(MioDecompressor* pDecompressor)
+{
+	pDecompressor->inputSize =
+		fread(pDecompressor->pInput, 1, MIO_DECOMPRESS_INPUT_SIZE, pDecompressor->file);
+	pDecompressor->inputEnded = (pDecompressor->inputSize == 0);
+}
+
+#if defined(MIO_HAS_ZLIB)
+
+// Function to decompress up to "capacity" bytes of gzip data into "pOut". Returns the number of
+// bytes that were decompressed.
+static size_t inflateBlock(MioDecompressor* pDecompressor, char* pOut, size_t capacity)
+{
+	z_stream* pStream = &pDecompressor->zlibStream;
+
+	pStream->next_out = (Bytef*)pOut;
+	pStream->avail_out = (uInt)capacity;
+
+	while(pStream->avail_out > 0 && !pDecompressor->atEnd && !pDecompressor->failed)
+	{
+		if(pStream->avail_in == 0 && !pDecompressor->inputEnded)
+		{
+			readInput(pDecompressor);
+			pStream->next_in = (Bytef*)pDecompressor->pInput;
+			pStream->avail_in = (uInt)pDecompressor->inputSize;
+		}
+
+		const int result = inflate(pStream, Z_NO_FLUSH);
+
+		if(result == Z_STREAM_END)
+		{
+			if(pStream->avail_in == 0 && !pDecompressor->inputEnded)
+			{
+				readInput(pDecompressor);
+				pStream->next_in = (Bytef*)pDecompressor->pInput;
+				pStream->avail_in = (uInt)pDecompressor->inputSize;
+			}
+
+			if(pStream->avail_in == 0)
+			{
+				pDecompressor->atEnd = true;
+			}
+			else
+			{
+				inflateReset(pStream); // the file holds another gzip member (e.g. from "cat")
+			}
+		}
+		else if(result != Z_OK && (result != Z_BUF_ERROR || pDecompressor->inputEnded))
+		{
+			pDecompressor->failed = true; // corrupt, or truncated (no progress without input)
+		}
+	}
+
+	return capacity - pStream->avail_out;
+}
+
+#endif // #if defined(MIO_HAS_ZLIB)
+
+#if defined(MIO_HAS_ZSTD)
+
+// Function to decompress up to "capacity" bytes of zstd data into "pOut". Returns the number of
+// bytes that were decompressed.
+static size_t zstdBlock(MioDecompressor* pDecompressor, char* pOut, size_t capacity)
+{
+	ZSTD_inBuffer* pInput = &pDecompressor->zstdInput;
+	ZSTD_outBuffer output = {pOut, capacity, 0};
+
+	while(output.pos < output.size && !pDecompressor->atEnd && !pDecompressor->failed)
+	{
+		if(pInput->pos == pInput->size && !pDecompressor->inputEnded)
+		{
+			readInput(pDecompressor);
+			pInput->src = pDecompressor->pInput;
+			pInput->size = pDecompressor->inputSize;
+			pInput->pos = 0;
+		}
+
+		const size_t inputPos = pInput->pos;
+		const size_t outputPos = output.pos;
+		const size_t result = ZSTD_decompressStream(pDecompressor->pZstdStream, &output, pInput);
+
+		if(ZSTD_isError(result))
+		{
+			pDecompressor->failed = true;
+		}
+		else if(pInput->pos != inputPos || output.pos != outputPos)
+		{
+			pDecompressor->zstdResult = result;
+		}
+		else if(pDecompressor->inputEnded)
+		{
+			// no more progress, which is the end if the last frame was completed (result 0)
+			pDecompressor->atEnd = (pDecompressor->zstdResult == 0);
+			pDecompressor->failed = !pDecompressor->atEnd;
+		}
+	}
+
+	return output.pos;
+}
+
+#endif // #if defined(MIO_HAS_ZSTD)
+
+// Function to decompress up to "capacity" bytes into "pOut". Returns the number of bytes that
+// were decompressed.
+static size_t decompressBlock(MioDecompressor* pDecompressor, char* pOut, size_t capacity)
+{
+	switch(pDecompressor->compression)
+	{
+#if defined(MIO_HAS_ZLIB)
+	case MIO_COMPRESSION_GZIP:
+		return inflateBlock(pDecompressor, pOut, capacity);
+#endif
+#if defined(MIO_HAS_ZSTD)
+	case MIO_COMPRESSION_ZSTD:
+		return zstdBlock(pDecompressor, pOut, capacity);
+#endif
+	default:
+		pDecompressor->failed = true;
+		return 0;
+	}
+}
+
+static void decompressTask(void* pArg)
+{
+	MioDecompressor* pDecompressor = (MioDecompressor*)pArg;
+	size_t writeIndex = 0;
+	bool finished = false;
+
+	while(!finished)
+	{
+		// wait for a free block
+		mioMutexLock(&pDecompressor->mutex);
+
+		while(pDecompressor->numFull == MIO_DECOMPRESS_NUM_BLOCKS && !pDecompressor->stop)
+		{
+			mioConditionWait(&pDecompressor->condition, &pDecompressor->mutex);
+		}
+
+		const bool stop = pDecompressor->stop;
+
+		mioMutexUnlock(&pDecompressor->mutex);
+
+		if(stop)
+		{
+			break;
+		}
+
+		DecompressBlock* pBlock = &pDecompressor->blocks[writeIndex];
+
+		pBlock->size = decompressBlock(pDecompressor, pBlock->pData, MIO_DECOMPRESS_BLOCK_SIZE);
+		finished = pDecompressor->atEnd || pDecompressor->failed;
+		writeIndex = (writeIndex + 1) % MIO_DECOMPRESS_NUM_BLOCKS;
+
+		mioMutexLock(&pDecompressor->mutex);
+		pDecompressor->numFull++;
+		pDecompressor->finished = finished;
+		mioConditionBroadcast(&pDecompressor->condition);
+		mioMutexUnlock(&pDecompressor->mutex);
+	}
+}
+
+MioDecompressor* mioDecompressorCreate(FILE* file,
+									   enum MioCompression compression,
+									   const void* pPrefix,
+									   size_t prefixSize)
+{
+	assert(prefixSize <= MIO_DECOMPRESS_INPUT_SIZE);
+
+	bool supported = false;
+#if defined(MIO_HAS_ZLIB)
+	supported = supported || (compression == MIO_COMPRESSION_GZIP);
+#endif
+#if defined(MIO_HAS_ZSTD)
+	supported = supported || (compression == MIO_COMPRESSION_ZSTD);
+#endif
+
+	if(!supported)
+	{
+		return NULL;
+	}
+
+	MioDecompressor* pDecompressor =
+		(MioDecompressor*)mioAllocate(1, sizeof(MioDecompressor));
+
+	memset(pDecompressor, 0, sizeof(MioDecompressor));
+
+	pDecompressor->compression = compression;
+	pDecompressor->file = file;
+	pDecompressor->pInput = (char*)mioAllocate(MIO_DECOMPRESS_INPUT_SIZE, 1);
+	pDecompressor->inputSize = prefixSize;
+
+	if(prefixSize > 0)
+	{
+		memcpy(pDecompressor->pInput, pPrefix, prefixSize);
+	}
+
+	for(int i = 0; i < MIO_DECOMPRESS_NUM_BLOCKS; ++i)
+	{
+		pDecompressor->blocks[i].pData = (char*)mioAllocate(MIO_DECOMPRESS_BLOCK_SIZE, 1);
+	}
+
+#if defined(MIO_HAS_ZLIB)
+	if(compression == MIO_COMPRESSION_GZIP)
+	{
+		pDecompressor->zlibStream.next_in = (Bytef*)pDecompressor->pInput;
+		pDecompressor->zlibStream.avail_in = (uInt)prefixSize;
+
+		if(inflateInit2(&pDecompressor->zlibStream, 15 + 16) != Z_OK) // 16: gzip header
+		{
+			mioLogError("error: failed to initialise zlib\n");
+			mioFail(MIO_STATUS_SYSTEM_ERROR);
+		}
+	}
+#endif
+
+#if defined(MIO_HAS_ZSTD)
+	if(compression == MIO_COMPRESSION_ZSTD)
+	{
+		pDecompressor->pZstdStream = ZSTD_createDStream();
+
+		if(pDecompressor->pZstdStream == NULL)
+		{
+			mioLogError("error: failed to initialise zstd\n");
+			mioFail(MIO_STATUS_SYSTEM_ERROR);
+		}
+
+		pDecompressor->zstdInput.src = pDecompressor->pInput;
+		pDecompressor->zstdInput.size = prefixSize;
+		pDecompressor->zstdInput.pos = 0;
+		pDecompressor->zstdResult = 1; // no frame has been decompressed yet
+	}
+#endif
+
+	mioMutexInit(&pDecompressor->mutex);
+	mioConditionInit(&pDecompressor->condition);
+
+	if(!mioThreadCreate(&pDecompressor->thread, decompressTask, pDecompressor))
+	{
+		mioLogError("error: failed to create thread\n");
+		mioFail(MIO_STATUS_SYSTEM_ERROR);
+	}
+
+	return pDecompressor;
+}
+
+size_t mioDecompressorRead(MioDecompressor* pDecompressor, void* pOut, size_t capacity)
+{
+	size_t count = 0;
+
+	mioMutexLock(&pDecompressor->mutex);
+
+	while(count < capacity)
+	{
+		if(pDecompressor->numFull == 0)
+		{
+			if(pDecompressor->finished)
+			{
+				break;
+			}
+
+			mioConditionWait(&pDecompressor->condition, &pDecompressor->mutex);
+			continue;
+		}
+
+		// NOTE: a full block is not touched by the thread, so it is copied without the lock
+		const DecompressBlock* pBlock = &pDecompressor->blocks[pDecompressor->readIndex];
+		const size_t available = pBlock->size - pDecompressor->readPos;
+		const size_t n = (available < capacity - count) ? available : capacity - count;
+
+		mioMutexUnlock(&pDecompressor->mutex);
+
+		memcpy((char*)pOut + count, pBlock->pData + pDecompressor->readPos, n);
+		count += n;
+		pDecompressor->readPos += n;
+
+		mioMutexLock(&pDecompressor->mutex);
+
+		if(pDecompressor->readPos == pBlock->size)
+		{
+			pDecompressor->readIndex = (pDecompressor->readIndex + 1) % MIO_DECOMPRESS_NUM_BLOCKS;
+			pDecompressor->readPos = 0;
+			pDecompressor->numFull--;
+			mioConditionBroadcast(&pDecompressor->condition);
+		}
+	}
+
+	const bool failed =
+		pDecompressor->finished && pDecompressor->numFull == 0 && pDecompressor->failed;
+
+	mioMutexUnlock(&pDecompressor->mutex);
+
+	if(failed)
+	{
+		mioLogError("error: failed to decompress %s data (the file is corrupt or truncated)\n",
+					mioGetCompressionName(pDecompressor->compression));
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	return count;
+}
+
+void mioDecompressorDestroy(MioDecompressor* pDecompressor)
+{
+	mioMutexLock(&pDecompressor->mutex);
+	pDecompressor->stop = true;
+	mioConditionBroadcast(&pDecompressor->condition);
+	mioMutexUnlock(&pDecompressor->mutex);
+
+	mioThreadJoin(&pDecompressor->thread);
+
+	mioConditionDestroy(&pDecompressor->condition);
+	mioMutexDestroy(&pDecompressor->mutex);
+
+#if defined(MIO_HAS_ZLIB)
+	if(pDecompressor->compression == MIO_COMPRESSION_GZIP)
+	{
+		inflateEnd(&pDecompressor->zlibStream);
+	}
+#endif
+
+#if defined(MIO_HAS_ZSTD)
+	if(pDecompressor->compression == MIO_COMPRESSION_ZSTD)
+	{
+		ZSTD_freeDStream(pDecompressor->pZstdStream);
+	}
+#endif
+
+	for(int i = 0; i < MIO_DECOMPRESS_NUM_BLOCKS; ++i)
+	{
+		mioMemFree(pDecompressor->blocks[i].pData);
+	}
+
+	mioMemFree(pDecompressor->pInput);
+	fclose(pDecompressor->file);
+	mioMemFree(pDecompressor);
+}
@@ -0,0 +1,65 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#ifndef __MIO_DECOMPRESS_H__
+#define __MIO_DECOMPRESS_H__ 1
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Internal streaming decompression of compressed inputs (see input.c).
+//
+// A compressed file is decompressed on a separate thread into a small ring of fixed-size blocks,
+// which the parser consumes while the next blocks are decompressed. Only the blocks in the ring
+// are ever held in memory (never the whole decompressed file).
+
+enum MioCompression
+{
+	MIO_COMPRESSION_NONE,
+	MIO_COMPRESSION_GZIP, // supported if mio is built with zlib (MIO_HAS_ZLIB)
+	MIO_COMPRESSION_ZSTD // supported if mio is built with libzstd (MIO_HAS_ZSTD)
+};
+
+typedef struct MioDecompressor MioDecompressor;
+
+// Function to get the compression of a file from its first "size" bytes "pHead" (magic bytes)
+enum MioCompression mioGetCompression(const void* pHead, size_t size);
+
+// Function to get the name of "compression" (for messages)
+const char* mioGetCompressionName(enum MioCompression compression);
+
+// Function to start decompressing "file" with "compression", where the "prefixSize" bytes at
+// "pPrefix" have already been read from the file. The decompressor takes ownership of "file".
+// Returns NULL (and leaves "file" open) if the compression is not supported by this build.
+MioDecompressor* mioDecompressorCreate(FILE* file,
+									   enum MioCompression compression,
+									   const void* pPrefix,
+									   size_t prefixSize);
+
+// Function to copy up to "capacity" decompressed bytes to "pOut", waiting for the decompression
+// thread if needed. Returns the number of bytes that were copied, which is less than "capacity"
+// only at the end of the data. Ends the program if the data is corrupt or truncated.
+size_t mioDecompressorRead(MioDecompressor* pDecompressor, void* pOut, size_t capacity);
+
+// Function to stop the decompression thread and to release all resources (including the file)
+void mioDecompressorDestroy(MioDecompressor* pDecompressor);
+
+#endif // #ifndef __MIO_DECOMPRESS_H__
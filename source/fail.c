@@ -0,0 +1,437 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#include "fail.h"
+
+#include "array.h"
+#include "log.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the innermost failure scope of the calling thread
+static MIO_THREAD_LOCAL MioFailScope* pThreadScope = NULL;
+
+MioFailScope* mioGetFailScope(void)
+{
+	return pThreadScope;
+}
+
+void mioFailScopeBegin(MioFailScope* pScope)
+{
+	memset(pScope, 0, sizeof(MioFailScope));
+
+	pScope->status = MIO_STATUS_OK;
+	pScope->pOuter = pThreadScope;
+	pThreadScope = pScope;
+}
+
+// Function to resize the array "ppArray" to "count" pointers, where the memory of the array is not
+// tracked by any scope (it is the bookkeeping of a scope)
+static void** resizePointers(void** ppArray, size_t count)
+{
+	MioFailScope* pScope = pThreadScope;
+
+	pThreadScope = NULL;
+	void** ppNew = (void**)mioMemRealloc(ppArray, count * sizeof(void*));
+	pThreadScope = pScope;
+
+	if(ppNew == NULL)
+	{
+		mioLogError("error: failed to allocate %zu bytes\n", count * sizeof(void*));
+		mioFail(MIO_STATUS_OUT_OF_MEMORY);
+	}
+
+	return ppNew;
+}
+
+// Function to free memory that is not tracked by any scope (see "resizePointers")
+static void freeUntracked(void* ptr)
+{
+	MioFailScope* pScope = pThreadScope;
+
+	pThreadScope = NULL;
+	mioMemFree(ptr);
+	pThreadScope = pScope;
+}
+
+// Function to append "ptr" to the array "*pppArray" of "*pCount" pointers (with room for
+// "*pCapacity")
+static void appendPointer(void*** pppArray, size_t* pCount, size_t* pCapacity, void* ptr)
+{
+	if(*pCount == *pCapacity)
+	{
+		*pCapacity = (*pCapacity > 0) ? *pCapacity * 2 : 16;
+		*pppArray = resizePointers(*pppArray, *pCapacity);
+	}
+
+	(*pppArray)[(*pCount)++] = ptr;
+}
+
+// Function to get the first slot that "ptr" is looked for in, among "numSlots" (a power of two)
+static size_t getHomeSlot(const void* ptr, size_t numSlots)
+{
+	const uint64_t key = (uint64_t)(uintptr_t)ptr;
+
+	return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (numSlots - 1);
+}
+
+// Function to get the slot of the allocations of "pScope" that holds "ptr", or the empty slot that
+// it belongs in
+static size_t findAllocationSlot(const MioFailScope* pScope, const void* ptr)
+{
+	const size_t mask = pScope->numAllocationSlots - 1;
+	size_t slot = getHomeSlot(ptr, pScope->numAllocationSlots);
+
+	while(pScope->ppAllocations[slot] != NULL && pScope->ppAllocations[slot] != ptr)
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+static void addAllocation(MioFailScope* pScope, void* ptr)
+{
+	// NOTE: the set is kept at most half full, so that the probe sequences stay short
+	if((pScope->numAllocations + 1) * 2 > pScope->numAllocationSlots)
+	{
+		void** ppOld = pScope->ppAllocations;
+		const size_t numOldSlots = pScope->numAllocationSlots;
+		const size_t numSlots = (numOldSlots > 0) ? numOldSlots * 2 : 64;
+
+		pScope->ppAllocations = resizePointers(NULL, numSlots);
+		pScope->numAllocationSlots = numSlots;
+		memset(pScope->ppAllocations, 0, numSlots * sizeof(void*));
+
+		for(size_t i = 0; i < numOldSlots; ++i)
+		{
+			if(ppOld[i] != NULL)
+			{
+				pScope->ppAllocations[findAllocationSlot(pScope, ppOld[i])] = ppOld[i];
+			}
+		}
+
+		freeUntracked(ppOld);
+	}
+
+	const size_t slot = findAllocationSlot(pScope, ptr);
+
+	if(pScope->ppAllocations[slot] == NULL)
+	{
+		pScope->ppAllocations[slot] = ptr;
+		pScope->numAllocations++;
+	}
+}
+
+// Function to remove "ptr" from the allocations of "pScope". Returns false if it is not one of
+// them.
+static bool removeAllocation(MioFailScope* pScope, const void* ptr)
+{
+	if(pScope->numAllocations == 0)
+	{
+		return false;
+	}
+
+	const size_t mask = pScope->numAllocationSlots - 1;
+	size_t slot = findAllocationSlot(pScope, ptr);
+
+	if(pScope->ppAllocations[slot] == NULL)
+	{
+		return false;
+	}
+
+	// the later entries of the probe sequence are shifted back to fill the gap (there are no
+	// "deleted" markers)
+	size_t next = slot;
+
+	for(;;)
+	{
+		next = (next + 1) & mask;
+
+		void* pNext = pScope->ppAllocations[next];
+
+		if(pNext == NULL)
+		{
+			break;
+		}
+
+		const size_t home = getHomeSlot(pNext, pScope->numAllocationSlots);
+		const bool stays = (slot <= next) ? (slot < home && home <= next)
+										  : (slot < home || home <= next);
+
+		if(!stays)
+		{
+			pScope->ppAllocations[slot] = pNext;
+			slot = next;
+		}
+	}
+
+	pScope->ppAllocations[slot] = NULL;
+	pScope->numAllocations--;
+
+	return true;
+}
+
+void mioFailScopeTrack(void* ptr)
+{
+	if(pThreadScope != NULL && ptr != NULL)
+	{
+		addAllocation(pThreadScope, ptr);
+	}
+}
+
+void mioFailScopeUntrack(void* ptr)
+{
+	MioFailScope* pScope = pThreadScope;
+
+	if(pScope == NULL || ptr == NULL || removeAllocation(pScope, ptr))
+	{
+		return;
+	}
+
+	// the memory was allocated before the scope began, so the scope that it belongs to has to
+	// forget it when this scope ends
+	if(pScope->pOuter != NULL || pScope->keepOnFailure)
+	{
+		appendPointer(
+			&pScope->ppOuterFrees, &pScope->numOuterFrees, &pScope->outerFreeCapacity, ptr);
+	}
+}
+
+void mioFailScopeTrackInput(MioInput* pInput)
+{
+	MioFailScope* pScope = pThreadScope;
+
+	if(pScope != NULL)
+	{
+		appendPointer(
+			(void***)&pScope->ppInputs, &pScope->numInputs, &pScope->inputCapacity, pInput);
+	}
+}
+
+void mioFailScopeUntrackInput(MioInput* pInput)
+{
+	for(MioFailScope* pScope = pThreadScope; pScope != NULL; pScope = pScope->pOuter)
+	{
+		// NOTE: inputs are usually closed in the reverse order of opening
+		for(size_t i = pScope->numInputs; i > 0; --i)
+		{
+			if(pScope->ppInputs[i - 1] == pInput)
+			{
+				memmove(&pScope->ppInputs[i - 1],
+						&pScope->ppInputs[i],
+						(pScope->numInputs - i) * sizeof(MioInput*));
+				pScope->numInputs--;
+				return;
+			}
+		}
+	}
+}
+
+// Function to hand the allocations and inputs of "pFrom" over to "pTo" (or to no scope if it is
+// NULL), which also frees the bookkeeping of "pFrom"
+static void handOver(MioFailScope* pFrom, MioFailScope* pTo)
+{
+	MioFailScope* pScope = pThreadScope;
+
+	pThreadScope = pTo; // so that "pTo" records the frees that are not its own
+
+	for(size_t i = 0; pTo != NULL && i < pFrom->numOuterFrees; ++i)
+	{
+		mioFailScopeUntrack(pFrom->ppOuterFrees[i]);
+	}
+
+	for(size_t i = 0; pTo != NULL && i < pFrom->numAllocationSlots; ++i)
+	{
+		if(pFrom->ppAllocations[i] != NULL)
+		{
+			addAllocation(pTo, pFrom->ppAllocations[i]);
+		}
+	}
+
+	for(size_t i = 0; pTo != NULL && i < pFrom->numInputs; ++i)
+	{
+		mioFailScopeTrackInput(pFrom->ppInputs[i]);
+	}
+
+	pThreadScope = pScope;
+
+	freeUntracked(pFrom->ppAllocations);
+	freeUntracked(pFrom->ppOuterFrees);
+	freeUntracked((void*)pFrom->ppInputs);
+
+	pFrom->ppAllocations = NULL;
+	pFrom->numAllocationSlots = 0;
+	pFrom->numAllocations = 0;
+	pFrom->ppOuterFrees = NULL;
+	pFrom->numOuterFrees = 0;
+	pFrom->outerFreeCapacity = 0;
+	pFrom->ppInputs = NULL;
+	pFrom->numInputs = 0;
+	pFrom->inputCapacity = 0;
+}
+
+// Function to close the inputs and free the allocations of the (failed) scope "pScope"
+static void releaseScope(MioFailScope* pScope)
+{
+	mioLoadCancel();
+
+	while(pScope->numInputs > 0)
+	{
+		mioInputClose(pScope->ppInputs[pScope->numInputs - 1]); // ... which untracks the input
+	}
+
+	for(size_t i = 0; i < pScope->numAllocationSlots; ++i)
+	{
+		if(pScope->ppAllocations[i] != NULL)
+		{
+			freeUntracked(pScope->ppAllocations[i]);
+			pScope->ppAllocations[i] = NULL;
+		}
+	}
+
+	pScope->numAllocations = 0;
+}
+
+enum MioStatus mioFailScopeEnd(MioFailScope* pScope)
+{
+	assert(pThreadScope == pScope);
+
+	pThreadScope = pScope->pOuter;
+	handOver(pScope, pScope->pOuter);
+
+	return pScope->status;
+}
+
+void mioFail(enum MioStatus status)
+{
+	MioFailScope* pScope = pThreadScope;
+
+	if(pScope == NULL)
+	{
+		exit(1);
+	}
+
+	pScope->status = status;
+
+	if(!pScope->keepOnFailure)
+	{
+		releaseScope(pScope);
+	}
+
+	longjmp(pScope->jump, 1);
+}
+
+enum MioStatus mioCallInFailScope(MioThreadFunc pfnCall, void* pArg)
+{
+	MioFailScope scope;
+
+	mioFailScopeBegin(&scope);
+
+	if(setjmp(scope.jump) == 0)
+	{
+		pfnCall(pArg);
+	}
+
+	return mioFailScopeEnd(&scope);
+}
+
+// a task of "mioRunTasks", which runs in a failure scope of its own
+typedef struct TaskRun
+{
+	MioThread thread;
+	bool started;
+	MioThreadFunc pfnTask;
+	void* pTask;
+	MioFailScope scope;
+} TaskRun;
+
+static void runTask(void* pArg)
+{
+	TaskRun* pRun = (TaskRun*)pArg;
+
+	mioFailScopeBegin(&pRun->scope);
+
+	// NOTE: the other tasks may still use what this one allocated, so a failure keeps it all for
+	// the scope of the thread that runs the tasks
+	pRun->scope.keepOnFailure = true;
+
+	if(setjmp(pRun->scope.jump) == 0)
+	{
+		pRun->pfnTask(pRun->pTask);
+	}
+
+	pThreadScope = pRun->scope.pOuter; // (handed over in "mioRunTasks")
+}
+
+void mioRunTasks(MioThreadFunc pfnTask, void* pTasks, size_t taskSize, size_t numTasks)
+{
+	TaskRun* pRuns = (TaskRun*)mioAllocate(numTasks, sizeof(TaskRun));
+
+	for(size_t i = 0; i < numTasks; ++i)
+	{
+		pRuns[i].started = false;
+		pRuns[i].pfnTask = pfnTask;
+		pRuns[i].pTask = (char*)pTasks + i * taskSize;
+	}
+
+	for(size_t i = 1; i < numTasks; ++i)
+	{
+		pRuns[i].started = mioThreadCreate(&pRuns[i].thread, runTask, &pRuns[i]);
+	}
+
+	runTask(&pRuns[0]); // the calling thread runs the first task
+
+	for(size_t i = 1; i < numTasks; ++i)
+	{
+		if(pRuns[i].started)
+		{
+			mioThreadJoin(&pRuns[i].thread);
+		}
+		else
+		{
+			runTask(&pRuns[i]); // ... as its thread could not be started
+		}
+	}
+
+	enum MioStatus status = MIO_STATUS_OK;
+
+	for(size_t i = 0; i < numTasks; ++i)
+	{
+		if(status == MIO_STATUS_OK)
+		{
+			status = pRuns[i].scope.status;
+		}
+
+		handOver(&pRuns[i].scope, pThreadScope);
+	}
+
+	mioMemFree(pRuns);
+
+	if(status != MIO_STATUS_OK)
+	{
+		mioFail(status);
+	}
+}
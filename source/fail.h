@@ -0,0 +1,120 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#ifndef __MIO_FAIL_H__
+#define __MIO_FAIL_H__ 1
+
+#include "mio/mio.h"
+
+#include "input.h"
+#include "thread.h"
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Internal error handling of the readers.
+//
+// A reader that cannot go on (e.g. because of malformed input) logs an error and calls "mioFail".
+// Outside of a failure scope this ends the program (which is what the readers of the public API
+// with no status do). Inside a failure scope, everything that was allocated (see "mioMemAlloc")
+// and every input that was opened on the calling thread since the scope began is released, and
+// execution jumps back to the scope with the status of the failure. Scopes are per thread, so
+// loads on different threads never see each other's failures.
+//
+// Usage:
+//
+//	MioFailScope scope;
+//
+//	mioFailScopeBegin(&scope);
+//
+//	if(setjmp(scope.jump) == 0)
+//	{
+//		... // read a file
+//	}
+//
+//	return mioFailScopeEnd(&scope);
+//
+// NOTE: the function that calls "setjmp" must not return before "mioFailScopeEnd".
+
+#if defined(_MSC_VER)
+#	define MIO_NORETURN __declspec(noreturn)
+#else
+#	define MIO_NORETURN __attribute__((noreturn))
+#endif
+
+typedef struct MioFailScope
+{
+	// where "mioFail" jumps to
+	jmp_buf jump;
+	// MIO_STATUS_OK, or the status of the failure
+	enum MioStatus status;
+	// the scope that was active on the calling thread when this one began (or NULL)
+	struct MioFailScope* pOuter;
+	// true if a failure keeps the allocations and inputs of the scope (for "mioRunTasks")
+	bool keepOnFailure;
+	// the allocations of the scope, as an open-addressing set of pointers (NULL = empty slot)
+	void** ppAllocations;
+	size_t numAllocationSlots;
+	size_t numAllocations;
+	// the allocations of outer scopes that were freed in the scope (see "mioFailScopeUntrack")
+	void** ppOuterFrees;
+	size_t numOuterFrees;
+	size_t outerFreeCapacity;
+	// the inputs that were opened in the scope and are still open
+	MioInput** ppInputs;
+	size_t numInputs;
+	size_t inputCapacity;
+} MioFailScope;
+
+// Function to begin the failure scope "pScope" on the calling thread (see above)
+void mioFailScopeBegin(MioFailScope* pScope);
+
+// Function to end the failure scope "pScope" (after it succeeded or failed). The allocations and
+// inputs of a scope that succeeded become those of the outer scope (if any). Returns the status of
+// the scope.
+enum MioStatus mioFailScopeEnd(MioFailScope* pScope);
+
+// Function to get the failure scope of the calling thread (NULL if there is none)
+MioFailScope* mioGetFailScope(void);
+
+// Function to end the current read with "status" (see above), after an error has been logged
+MIO_NORETURN void mioFail(enum MioStatus status);
+
+// Function to call "pfnCall" with "pArg" in a failure scope of its own (see above). Returns the
+// status of the scope, so that a public function can return the failure of a reader that would
+// otherwise end the program.
+enum MioStatus mioCallInFailScope(MioThreadFunc pfnCall, void* pArg);
+
+// Functions to tell the failure scope of the calling thread (if any) about an allocation that was
+// made or freed, and about an input that was opened or closed. NOTE: called by the memory and
+// input layers only.
+void mioFailScopeTrack(void* ptr);
+void mioFailScopeUntrack(void* ptr);
+void mioFailScopeTrackInput(MioInput* pInput);
+void mioFailScopeUntrackInput(MioInput* pInput);
+
+// Function to run "pfnTask" on each of the "numTasks" tasks of "taskSize" bytes at "pTasks" on a
+// thread of its own, where the calling thread runs the first task and any task whose thread cannot
+// be started. A failure in a task fails the calling thread once all the tasks have finished.
+void mioRunTasks(MioThreadFunc pfnTask, void* pTasks, size_t taskSize, size_t numTasks);
+
+#endif // #ifndef __MIO_FAIL_H__
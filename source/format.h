@@ -0,0 +1,59 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#ifndef __MIO_FORMAT_H__
+#define __MIO_FORMAT_H__ 1
+
+#include "mio/mio.h"
+
+#include "input.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Internal dispatch of "mioReadMesh" and "mioProbe" (see mio.c) on the format of a mesh file.
+
+// Function to get the format of the file at "fpath" from its extension
+enum MioFormat mioGetFormatFromExtension(const char* fpath);
+
+// number of bytes at the start of a file that its format is guessed from (see
+// "mioGetFormatFromContents")
+#define MIO_FORMAT_HEAD_SIZE 512
+
+// Function to guess the format of a file of "fileSize" bytes from its first "headSize" bytes
+// "pHead" (e.g. for a file without an extension). Returns MIO_FORMAT_UNKNOWN if no format fits.
+enum MioFormat mioGetFormatFromContents(const char* pHead, size_t headSize, uint64_t fileSize);
+
+// Function to read the file at "fpath" in the format "format" into "pMesh" (see "mioReadMesh")
+void mioReadMeshFormat(const char* fpath,
+					   enum MioFormat format,
+					   MioMesh* pMesh,
+					   unsigned int flags);
+
+// Functions to count the elements of the file that is read from "pInput" into "pInfo" (see
+// "mioProbe"), where the file is known to have the format of the function
+void mioProbeOBJ(MioInput* pInput, MioMeshInfo* pInfo);
+void mioProbeOFF(MioInput* pInput, MioMeshInfo* pInfo);
+void mioProbePLY(MioInput* pInput, MioMeshInfo* pInfo);
+void mioProbeSTL(MioInput* pInput, MioMeshInfo* pInfo);
+void mioProbeMIOB(MioInput* pInput, MioMeshInfo* pInfo);
+
+#endif // #ifndef __MIO_FORMAT_H__
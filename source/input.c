@@ -0,0 +1,407 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "input.h"
+
+#include "array.h"
+#include "decompress.h"
+#include "fail.h"
+#include "log.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+// size of the blocks in which streamed inputs are read
+#define MIO_INPUT_BLOCK_SIZE (1u << 20)
+
+static void resetInput(MioInput* pInput)
+{
+	memset(pInput, 0, sizeof(MioInput));
+}
+
+static bool openStream(MioInput* pInput, FILE* file)
+{
+	pInput->kind = MIO_INPUT_STREAM;
+	pInput->file = file;
+	pInput->bufferCapacity = MIO_INPUT_BLOCK_SIZE;
+	pInput->pBuffer = (char*)mioMemAlloc(pInput->bufferCapacity);
+
+	if(pInput->pBuffer == NULL)
+	{
+		fclose(file);
+		resetInput(pInput);
+		return false;
+	}
+
+	// NOTE: the magic bytes of a compressed file are read ahead (and kept if it is not compressed)
+	const size_t headSize = fread(pInput->pBuffer, 1, 4, file);
+	const enum MioCompression compression = mioGetCompression(pInput->pBuffer, headSize);
+
+	pInput->pCur = pInput->pBuffer;
+	pInput->pEnd = pInput->pBuffer + headSize;
+	pInput->atEnd = false;
+	pInput->numBytes = headSize;
+
+	if(compression != MIO_COMPRESSION_NONE)
+	{
+		pInput->pDecompressor =
+			mioDecompressorCreate(file, compression, pInput->pBuffer, headSize);
+
+		if(pInput->pDecompressor == NULL)
+		{
+			mioLogError("error: %s compressed files are not supported by this build of mio\n",
+						mioGetCompressionName(compression));
+			fclose(file);
+			mioMemFree(pInput->pBuffer);
+			resetInput(pInput);
+			return false;
+		}
+
+		pInput->file = NULL; // owned by the decompressor
+		pInput->pEnd = pInput->pBuffer;
+		pInput->numBytes = 0;
+	}
+
+	return true;
+}
+
+static void openMapped(MioInput* pInput, void* pMapping, size_t mappingSize)
+{
+	pInput->kind = MIO_INPUT_MAPPED;
+	pInput->pMapping = pMapping;
+	pInput->mappingSize = mappingSize;
+	pInput->pCur = (const char*)pMapping;
+	pInput->pEnd = pInput->pCur + mappingSize;
+	pInput->atEnd = true;
+	pInput->numBytes = mappingSize;
+}
+
+void mioInputOpenRange(MioInput* pInput, const char* pBegin, const char* pEnd)
+{
+	resetInput(pInput);
+
+	pInput->kind = MIO_INPUT_RANGE;
+	pInput->pCur = pBegin;
+	pInput->pEnd = pEnd;
+	pInput->atEnd = true;
+	pInput->numBytes = (size_t)(pEnd - pBegin);
+}
+
+#if defined(_WIN32)
+
+static bool openFile(MioInput* pInput, const char* fpath, bool copyOnWrite)
+{
+	resetInput(pInput);
+
+	HANDLE hFile = CreateFileA(fpath,
+							   GENERIC_READ,
+							   FILE_SHARE_READ,
+							   NULL,
+							   OPEN_EXISTING,
+							   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+							   NULL);
+
+	if(hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if(GetFileType(hFile) == FILE_TYPE_DISK && GetFileSizeEx(hFile, &fileSize) &&
+	   (unsigned long long)fileSize.QuadPart <= (size_t)-1)
+	{
+		if(fileSize.QuadPart == 0)
+		{
+			CloseHandle(hFile);
+			openMapped(pInput, NULL, 0); // nothing to map
+			return true;
+		}
+
+		HANDLE hMapping = CreateFileMappingA(
+			hFile, NULL, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+
+		if(hMapping != NULL)
+		{
+			void* pView =
+				MapViewOfFile(hMapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+
+			if(pView != NULL &&
+			   mioGetCompression(pView, (size_t)fileSize.QuadPart) == MIO_COMPRESSION_NONE)
+			{
+				openMapped(pInput, pView, (size_t)fileSize.QuadPart);
+				pInput->hFile = hFile;
+				pInput->hMapping = hMapping;
+				return true;
+			}
+
+			if(pView != NULL)
+			{
+				UnmapViewOfFile(pView); // a compressed file is streamed (see "openStream")
+			}
+
+			CloseHandle(hMapping);
+		}
+	}
+
+	CloseHandle(hFile);
+
+	// fallback to buffered reads
+	FILE* file = fopen(fpath, "rb");
+
+	return (file != NULL) && openStream(pInput, file);
+}
+
+void mioInputPrefetchFile(const char* fpath)
+{
+	(void)fpath; // NOTE: not supported (the reads of a mapped file are still read ahead)
+}
+
+// Function to release the resources of "pInput" (see "mioInputClose")
+static void closeInput(MioInput* pInput)
+{
+	if(pInput->pMapping != NULL)
+	{
+		UnmapViewOfFile(pInput->pMapping);
+		CloseHandle((HANDLE)pInput->hMapping);
+		CloseHandle((HANDLE)pInput->hFile);
+	}
+
+	if(pInput->pDecompressor != NULL)
+	{
+		mioDecompressorDestroy(pInput->pDecompressor);
+	}
+
+	if(pInput->file != NULL)
+	{
+		fclose(pInput->file);
+	}
+
+	mioMemFree(pInput->pBuffer);
+
+	resetInput(pInput);
+}
+
+#else // #if defined(_WIN32)
+
+static bool openFile(MioInput* pInput, const char* fpath, bool copyOnWrite)
+{
+	resetInput(pInput);
+
+	const int fd = open(fpath, O_RDONLY);
+
+	if(fd < 0)
+	{
+		return false;
+	}
+
+	struct stat fileInfo;
+
+	if(fstat(fd, &fileInfo) == 0 && S_ISREG(fileInfo.st_mode) &&
+	   (unsigned long long)fileInfo.st_size <= (size_t)-1)
+	{
+		const size_t fileSize = (size_t)fileInfo.st_size;
+
+		if(fileSize == 0)
+		{
+			close(fd);
+			openMapped(pInput, NULL, 0); // nothing to map
+			return true;
+		}
+
+		const int protection = copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+		void* pMapping = mmap(NULL, fileSize, protection, MAP_PRIVATE, fd, 0);
+
+		if(pMapping != MAP_FAILED && mioGetCompression(pMapping, fileSize) != MIO_COMPRESSION_NONE)
+		{
+			munmap(pMapping, fileSize); // a compressed file is streamed (see "openStream")
+		}
+		else if(pMapping != MAP_FAILED)
+		{
+			close(fd); // the mapping keeps a reference to the file
+#	if defined(MADV_SEQUENTIAL)
+			madvise(pMapping, fileSize, MADV_SEQUENTIAL);
+#	endif
+			openMapped(pInput, pMapping, fileSize);
+			return true;
+		}
+	}
+
+	// fallback to buffered reads (e.g. pipes)
+	FILE* file = fdopen(fd, "rb");
+
+	if(file == NULL)
+	{
+		close(fd);
+		return false;
+	}
+
+	return openStream(pInput, file);
+}
+
+void mioInputPrefetchFile(const char* fpath)
+{
+#	if defined(POSIX_FADV_WILLNEED)
+	const int fd = open(fpath, O_RDONLY);
+
+	if(fd >= 0)
+	{
+		posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED); // starts the reads in the background
+		close(fd);
+	}
+#	else
+	(void)fpath;
+#	endif
+}
+
+// Function to release the resources of "pInput" (see "mioInputClose")
+static void closeInput(MioInput* pInput)
+{
+	if(pInput->pMapping != NULL)
+	{
+		munmap(pInput->pMapping, pInput->mappingSize);
+	}
+
+	if(pInput->pDecompressor != NULL)
+	{
+		mioDecompressorDestroy(pInput->pDecompressor);
+	}
+
+	if(pInput->file != NULL)
+	{
+		fclose(pInput->file);
+	}
+
+	mioMemFree(pInput->pBuffer);
+
+	resetInput(pInput);
+}
+
+#endif // #if defined(_WIN32)
+
+// Function to open the file at "fpath" (see "openFile"), adding the time it takes to the load
+// statistics
+static bool openFileTimed(MioInput* pInput, const char* fpath, bool copyOnWrite)
+{
+	MioLoadStats* pStats = mioGetActiveLoadStats();
+	const double startTime = (pStats != NULL) ? mioGetTime() : 0.0;
+	const bool opened = openFile(pInput, fpath, copyOnWrite);
+
+	if(pStats != NULL)
+	{
+		pStats->ioSeconds += mioGetTime() - startTime;
+	}
+
+	if(opened)
+	{
+		mioFailScopeTrackInput(pInput); // (closed if the load fails)
+	}
+
+	return opened;
+}
+
+void mioInputClose(MioInput* pInput)
+{
+	mioFailScopeUntrackInput(pInput);
+	closeInput(pInput);
+}
+
+bool mioInputOpenFile(MioInput* pInput, const char* fpath)
+{
+	return openFileTimed(pInput, fpath, false);
+}
+
+bool mioInputOpenFileCopyOnWrite(MioInput* pInput, const char* fpath)
+{
+	return openFileTimed(pInput, fpath, true);
+}
+
+bool mioInputRefill(MioInput* pInput)
+{
+	if(pInput->atEnd)
+	{
+		return false;
+	}
+
+	assert(pInput->kind == MIO_INPUT_STREAM);
+
+	// move the bytes that have not been consumed yet to the front of the buffer
+	size_t pending = (size_t)(pInput->pEnd - pInput->pCur);
+
+	if(pending > 0 && pInput->pCur != pInput->pBuffer)
+	{
+		memmove(pInput->pBuffer, pInput->pCur, pending);
+	}
+
+	// grow the buffer if it is full (i.e. if a single line is longer than the buffer)
+	if(pending == pInput->bufferCapacity)
+	{
+		const size_t newCapacity = pInput->bufferCapacity * 2;
+		char* pNewBuffer = (char*)mioMemRealloc(pInput->pBuffer, newCapacity);
+
+		if(pNewBuffer == NULL)
+		{
+			mioLogError("error: failed to allocate %zu bytes\n", newCapacity);
+			mioFail(MIO_STATUS_OUT_OF_MEMORY);
+		}
+
+		pInput->pBuffer = pNewBuffer;
+		pInput->bufferCapacity = newCapacity;
+	}
+
+	MioLoadStats* pStats = mioGetActiveLoadStats();
+	const double startTime = (pStats != NULL) ? mioGetTime() : 0.0;
+	char* pFree = pInput->pBuffer + pending;
+	const size_t freeSize = pInput->bufferCapacity - pending;
+	const size_t nread = (pInput->pDecompressor != NULL)
+							 ? mioDecompressorRead(pInput->pDecompressor, pFree, freeSize)
+							 : fread(pFree, 1, freeSize, pInput->file);
+
+	if(pStats != NULL)
+	{
+		pStats->ioSeconds += mioGetTime() - startTime;
+	}
+
+	pInput->numBytes += nread;
+
+	pInput->pCur = pInput->pBuffer;
+	pInput->pEnd = pInput->pBuffer + pending + nread;
+	pInput->pNewlineBlock = NULL; // the bytes have moved
+
+	if(nread == 0)
+	{
+		pInput->atEnd = true;
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,202 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_INPUT_H__
+#define __MIO_INPUT_H__ 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "scan.h"
+
+// Internal input layer shared by the readers.
+//
+// Regular files are memory-mapped so that the parsers can walk the file contents in place as a
+// single [pCur, pEnd) byte range. Inputs that cannot be mapped (e.g. pipes) are read through a
+// block buffer, where "pCur" and "pEnd" describe the window of bytes that is currently buffered.
+// Compressed files (gzip or zstd, recognised by their magic bytes) are decompressed into the block
+// buffer as they are read.
+// In both cases the parsers only ever see byte ranges, which are NOT null-terminated.
+
+enum MioInputKind
+{
+	MIO_INPUT_MAPPED,
+	MIO_INPUT_RANGE, // a byte range that is owned by someone else
+	MIO_INPUT_STREAM
+};
+
+typedef struct MioInput
+{
+	// current read position
+	const char* pCur;
+	// end of the bytes that are currently available to the parser
+	const char* pEnd;
+	// true once "pEnd" is the end of the input (always the case for mapped and range inputs)
+	bool atEnd;
+
+	enum MioInputKind kind;
+
+	// number of bytes that have been made available so far, and number of lines that have been
+	// returned by "mioInputNextLine"
+	size_t numBytes;
+	size_t numLines;
+
+	// the mask of the newlines in the block of bytes at "pNewlineBlock" (see scan.h), which is kept
+	// by "mioInputNextLine" for the next lines in the block
+	const char* pNewlineBlock;
+	uint64_t newlineMask;
+
+	// MIO_INPUT_MAPPED: the mapped view of the file
+	void* pMapping;
+	size_t mappingSize;
+#if defined(_WIN32)
+	void* hFile; // HANDLE
+	void* hMapping; // HANDLE
+#endif
+
+	// MIO_INPUT_STREAM: the file stream and the buffer that holds the current window, where a
+	// compressed file is read through "pDecompressor" instead (see decompress.h)
+	FILE* file;
+	struct MioDecompressor* pDecompressor;
+	char* pBuffer;
+	size_t bufferCapacity;
+} MioInput;
+
+// Function to open the file at "fpath" for reading. Returns false if the file cannot be opened.
+bool mioInputOpenFile(MioInput* pInput, const char* fpath);
+
+// Function to open the file at "fpath" like "mioInputOpenFile", except that a mapped file can also
+// be written to through "pMapping" (private copy-on-write pages, which never reach the file)
+bool mioInputOpenFileCopyOnWrite(MioInput* pInput, const char* fpath);
+
+// Function to ask the operating system to start reading the file at "fpath" into its cache, without
+// waiting for the reads to complete (so that a later read of the file does not wait for the disk)
+void mioInputPrefetchFile(const char* fpath);
+
+// Function to read from the byte range [pBegin, pEnd), which must remain valid while it is read
+void mioInputOpenRange(MioInput* pInput, const char* pBegin, const char* pEnd);
+
+// Function to release all resources associated with "pInput"
+void mioInputClose(MioInput* pInput);
+
+// Function to refill the window of a streamed input. The bytes in [pCur, pEnd) are kept and
+// more data is appended after them. Returns false if no more data could be read.
+bool mioInputRefill(MioInput* pInput);
+
+// Function to make at least "count" bytes available in [pCur, pEnd) (refilling the window of a
+// streamed input if needed). Returns false if the input ends before that.
+static inline bool mioInputRequire(MioInput* pInput, size_t count)
+{
+	while((size_t)(pInput->pEnd - pInput->pCur) < count)
+	{
+		if(pInput->atEnd || !mioInputRefill(pInput))
+		{
+			return (size_t)(pInput->pEnd - pInput->pCur) >= count;
+		}
+	}
+
+	return true;
+}
+
+// Function to get a pointer to the first '\n' in [pCur, pEnd), or NULL if there is none
+static inline const char* mioInputFindNewline(MioInput* pInput)
+{
+	const char* p = pInput->pCur;
+	const char* pBlock = pInput->pNewlineBlock;
+
+	for(;;)
+	{
+		if(pBlock != NULL && p >= pBlock && p < pBlock + MIO_SCAN_BLOCK_SIZE)
+		{
+			const uint64_t mask = pInput->newlineMask & (~(uint64_t)0 << (p - pBlock));
+
+			if(mask != 0)
+			{
+				return pBlock + mioCountTrailingZeros64(mask);
+			}
+
+			p = pBlock + MIO_SCAN_BLOCK_SIZE; // ... the line continues in the next block
+		}
+
+		const size_t available = (size_t)(pInput->pEnd - p);
+
+		if(available < MIO_SCAN_BLOCK_SIZE)
+		{
+			// NOTE: the bytes at the end of the window are not a complete block
+			return (available > 0) ? (const char*)memchr(p, '\n', available) : NULL;
+		}
+
+		pBlock = p;
+		pInput->pNewlineBlock = pBlock;
+		pInput->newlineMask = mioScanNewlines(pBlock);
+	}
+}
+
+// Function to get the next line of the input as the byte range [*ppLineBegin, *ppLineEnd). The
+// range excludes the line terminator ("\n" or "\r\n"). The range is valid until the next call.
+// Returns false when there are no more lines.
+static inline bool
+mioInputNextLine(MioInput* pInput, const char** ppLineBegin, const char** ppLineEnd)
+{
+	for(;;)
+	{
+		const char* pLineBegin = pInput->pCur;
+		const char* pNewline = mioInputFindNewline(pInput);
+		const char* pLineEnd = pNewline;
+
+		if(pNewline != NULL)
+		{
+			pInput->pCur = pNewline + 1;
+		}
+		else if(pInput->atEnd || !mioInputRefill(pInput))
+		{
+			pLineBegin = pInput->pCur; // NOTE: a failed refill can still move the window
+
+			if(pLineBegin == pInput->pEnd)
+			{
+				return false; // no more data
+			}
+
+			// last line of the input has no line terminator
+			pLineEnd = pInput->pEnd;
+			pInput->pCur = pInput->pEnd;
+		}
+		else
+		{
+			continue; // try again with the refilled window
+		}
+
+		if(pLineEnd != pLineBegin && pLineEnd[-1] == '\r')
+		{
+			pLineEnd--;
+		}
+
+		*ppLineBegin = pLineBegin;
+		*ppLineEnd = pLineEnd;
+		pInput->numLines++;
+
+		return true;
+	}
+}
+
+#endif // #ifndef __MIO_INPUT_H__
@@ -0,0 +1,157 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#include "into.h"
+
+#include "fail.h"
+#include "log.h"
+
+#include <stdint.h>
+#include <string.h>
+
+// Function to check one array of points (see "mioCheckBuffers")
+static bool checkCoordBuffer(const MioCoordBuffer* pBuffer,
+							 size_t count,
+							 size_t numCoords,
+							 size_t coordSize,
+							 const char* name)
+{
+	if(pBuffer->pData == NULL)
+	{
+		return true; // the points are not stored
+	}
+
+	if(mioCoordBufferStride(pBuffer, numCoords, coordSize) < numCoords * coordSize)
+	{
+		mioLogError("error: stride of %s array is smaller than a point (%zu bytes)\n",
+					name,
+					pBuffer->stride);
+		return false;
+	}
+
+	if(pBuffer->capacity < count)
+	{
+		mioLogError("error: %s array holds %zu elements, but the file has %zu\n",
+					name,
+					pBuffer->capacity,
+					count);
+		return false;
+	}
+
+	return true;
+}
+
+// Function to check one array of indices (see "mioCheckBuffers")
+static bool checkIndexBuffer(const MioIndexBuffer* pBuffer, size_t count, const char* name)
+{
+	if(pBuffer->pData != NULL && pBuffer->capacity < count)
+	{
+		mioLogError("error: %s array holds %zu elements, but the file has %zu\n",
+					name,
+					pBuffer->capacity,
+					count);
+		return false;
+	}
+
+	return true;
+}
+
+bool mioCheckBuffers(const MioMeshBuffers* pBuffers,
+					 const MioMeshCounts* pCounts,
+					 size_t coordSize)
+{
+	const size_t numTexCoordIndices = (pCounts->numTexCoords > 0) ? pCounts->numFaceVertices : 0;
+	const size_t numNormalIndices = (pCounts->numNormals > 0) ? pCounts->numFaceVertices : 0;
+
+	return checkCoordBuffer(&pBuffers->vertices, pCounts->numVertices, 3, coordSize, "vertex") &&
+		   checkCoordBuffer(&pBuffers->normals, pCounts->numNormals, 3, coordSize, "normal") &&
+		   checkCoordBuffer(
+			   &pBuffers->texCoords, pCounts->numTexCoords, 2, coordSize, "texture-coord") &&
+		   checkIndexBuffer(&pBuffers->faceSizes, pCounts->numFaces, "face size") &&
+		   checkIndexBuffer(
+			   &pBuffers->faceVertexIndices, pCounts->numFaceVertices, "face-vertex index") &&
+		   checkIndexBuffer(&pBuffers->faceVertexTexCoordIndices,
+							numTexCoordIndices,
+							"face-vertex texture-coord index") &&
+		   checkIndexBuffer(
+			   &pBuffers->faceVertexNormalIndices, numNormalIndices, "face-vertex normal index");
+}
+
+void mioCountInput(MioInput* pInput,
+				   void (*pfnProbe)(MioInput* pInput, MioMeshInfo* pInfo),
+				   MioMeshCounts* pCounts)
+{
+	MioInput rest;
+	MioMeshInfo info;
+
+	mioInputRequire(pInput, SIZE_MAX); // ... i.e. the whole input
+	mioInputOpenRange(&rest, pInput->pCur, pInput->pEnd);
+	memset(&info, 0, sizeof(MioMeshInfo));
+
+	pfnProbe(&rest, &info);
+
+	mioInputClose(&rest);
+
+	pCounts->numVertices = (size_t)info.numVertices;
+	pCounts->numNormals = (size_t)info.numNormals;
+	pCounts->numTexCoords = (size_t)info.numTexCoords;
+	pCounts->numFaces = (size_t)info.numFaces;
+	pCounts->numFaceVertices = (size_t)info.numFaceVertices;
+}
+
+// the arguments and result of a call of "mioTryReadInto"
+typedef struct ReadIntoCall
+{
+	MioReadIntoFunc pfnRead;
+	const char* fpath;
+	unsigned int numThreads;
+	size_t coordSize;
+	const MioMeshBuffers* pBuffers;
+	MioMeshCounts* pCounts;
+	bool fits;
+} ReadIntoCall;
+
+static void callReadInto(void* pArg)
+{
+	ReadIntoCall* pCall = (ReadIntoCall*)pArg;
+
+	pCall->fits = pCall->pfnRead(
+		pCall->fpath, pCall->numThreads, pCall->coordSize, pCall->pBuffers, pCall->pCounts);
+}
+
+enum MioStatus mioTryReadInto(MioReadIntoFunc pfnRead,
+							  const char* fpath,
+							  unsigned int numThreads,
+							  size_t coordSize,
+							  const MioMeshBuffers* pBuffers,
+							  MioMeshCounts* pCounts)
+{
+	ReadIntoCall call = {pfnRead, fpath, numThreads, coordSize, pBuffers, pCounts, false};
+	const enum MioStatus status = mioCallInFailScope(callReadInto, &call);
+
+	if(status != MIO_STATUS_OK)
+	{
+		memset(pCounts, 0, sizeof(MioMeshCounts));
+		return status;
+	}
+
+	return call.fits ? MIO_STATUS_OK : MIO_STATUS_BUFFER_TOO_SMALL;
+}
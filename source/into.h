@@ -0,0 +1,87 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#ifndef __MIO_INTO_H__
+#define __MIO_INTO_H__ 1
+
+#include "mio/buffers.h"
+#include "mio/mio.h"
+#include "mio/status.h"
+
+#include "input.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Internal side of the "mioRead*Into" functions, which write the elements of a file into the
+// caller-owned arrays of "MioMeshBuffers" instead of allocating them.
+
+// Function to get the number of bytes from one point of "pBuffer" to the next, for points with
+// "numCoords" coordinates of "coordSize" bytes
+static inline size_t mioCoordBufferStride(const MioCoordBuffer* pBuffer,
+										  size_t numCoords,
+										  size_t coordSize)
+{
+	return (pBuffer->stride != 0) ? pBuffer->stride : numCoords * coordSize;
+}
+
+// Function to get the address of point "i" of "pBuffer", whose points are "stride" bytes apart
+static inline void* mioCoordBufferAt(const MioCoordBuffer* pBuffer, size_t stride, size_t i)
+{
+	return (char*)pBuffer->pData + i * stride;
+}
+
+// Function to check that the elements of a file with the counts "pCounts" fit into the arrays of
+// "pBuffers", for points with coordinates of "coordSize" bytes. Logs an error and returns false
+// for the first array that is too small, or whose stride is smaller than a point. NOTE: the
+// strides can be checked before the file is read by passing zero counts.
+bool mioCheckBuffers(const MioMeshBuffers* pBuffers,
+					 const MioMeshCounts* pCounts,
+					 size_t coordSize);
+
+// Function to count the elements of the file that is read from "pInput" with "pfnProbe" (one of
+// the probes of format.h) into "pCounts", without consuming any of "pInput", so that the arrays
+// can be checked before anything is written to them (see "MioMeshBuffers"). NOTE: a streamed
+// input is read to its end first, so that its rest is in memory as a whole.
+void mioCountInput(MioInput* pInput,
+				   void (*pfnProbe)(MioInput* pInput, MioMeshInfo* pInfo),
+				   MioMeshCounts* pCounts);
+
+// a reader of the "mioRead*Into" functions, which reads the file at "fpath" on up to "numThreads"
+// threads into "pBuffers" for points with coordinates of "coordSize" bytes, and returns false
+// (after logging an error) if an array is too small
+typedef bool (*MioReadIntoFunc)(const char* fpath,
+								unsigned int numThreads,
+								size_t coordSize,
+								const MioMeshBuffers* pBuffers,
+								MioMeshCounts* pCounts);
+
+// Function to call "pfnRead" in a failure scope (see "mioCallInFailScope"). Returns
+// MIO_STATUS_BUFFER_TOO_SMALL if an array is too small (in which case "pCounts" has the counts of
+// the file), and sets "pCounts" to zero counts if the file cannot be read.
+enum MioStatus mioTryReadInto(MioReadIntoFunc pfnRead,
+							  const char* fpath,
+							  unsigned int numThreads,
+							  size_t coordSize,
+							  const MioMeshBuffers* pBuffers,
+							  MioMeshCounts* pCounts);
+
+#endif // #ifndef __MIO_INTO_H__
@@ -0,0 +1,66 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "log.h"
+
+#include "mio/mio.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+static enum MioLogLevel logLevel = MIO_LOG_LEVEL_ALL;
+
+void mioSetLogLevel(enum MioLogLevel level)
+{
+	logLevel = level;
+}
+
+void mioLogInfo(const char* format, ...)
+{
+	if(logLevel == MIO_LOG_LEVEL_ALL)
+	{
+		va_list args;
+		va_start(args, format);
+		vfprintf(stdout, format, args);
+		va_end(args);
+	}
+}
+
+void mioLogNote(const char* format, ...)
+{
+	if(logLevel == MIO_LOG_LEVEL_ALL)
+	{
+		va_list args;
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+	}
+}
+
+void mioLogError(const char* format, ...)
+{
+	if(logLevel != MIO_LOG_LEVEL_NONE)
+	{
+		va_list args;
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+	}
+}
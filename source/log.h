@@ -0,0 +1,43 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_LOG_H__
+#define __MIO_LOG_H__ 1
+
+// Internal logging layer: all output of the library goes through these functions, so that it can
+// be turned off with "mioSetLogLevel".
+
+#if defined(__GNUC__)
+#	define MIO_PRINTF_FORMAT(formatIndex)                                                        \
+		__attribute__((format(printf, formatIndex, formatIndex + 1)))
+#else
+#	define MIO_PRINTF_FORMAT(formatIndex)
+#endif
+
+// Function to write progress information to stdout (e.g. "read .obj file: ...")
+void mioLogInfo(const char* format, ...) MIO_PRINTF_FORMAT(1);
+
+// Function to write a note about the input to stderr (e.g. a line that is skipped)
+void mioLogNote(const char* format, ...) MIO_PRINTF_FORMAT(1);
+
+// Function to write an error to stderr (the caller then fails with "mioFail", see fail.h)
+void mioLogError(const char* format, ...) MIO_PRINTF_FORMAT(1);
+
+#endif // #ifndef __MIO_LOG_H__
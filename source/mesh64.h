@@ -0,0 +1,31 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#ifndef __MIO_MESH64_H__
+#define __MIO_MESH64_H__ 1
+
+#include "mio/mio.h"
+
+// Function to read the .obj file at "fpath" into "pMesh" (see "mioReadMesh64"), on up to the
+// number of hardware threads. The face indices are 32-bit unless an index does not fit.
+void mioReadOBJMesh64(const char* fpath, MioMesh64* pMesh);
+
+#endif // #ifndef __MIO_MESH64_H__
@@ -20,8 +20,21 @@
 
 #include "mio/mio.h"
 
+#include "array.h"
+#include "fail.h"
+#include "format.h"
+#include "log.h"
+#include "mesh64.h"
+#include "miob.h"
+#include "stats.h"
+#include "triangulate.h"
+
 #include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #if defined(_WIN32)
 #	include <stdlib.h> // https://stackoverflow.com/questions/44504429/c-write-access-violation
@@ -122,18 +135,704 @@ void mioWrite(
 
 #endif // #if defined (_WIN32)
 
-void mioFree(void* pMemPtr)
+// alignment of each array in a mesh arena (a cache line, which is also enough for SIMD loads)
+#define MIO_ARENA_ALIGNMENT 64
+
+static void* defaultMalloc(size_t size, void* pUserData)
+{
+	(void)pUserData;
+	return malloc(size);
+}
+
+static void* defaultRealloc(void* ptr, size_t size, void* pUserData)
+{
+	(void)pUserData;
+	return realloc(ptr, size);
+}
+
+static void defaultFree(void* ptr, void* pUserData)
+{
+	(void)pUserData;
+	free(ptr);
+}
+
+static const MioAllocator defaultAllocator = {defaultMalloc, defaultRealloc, defaultFree, NULL};
+
+// the functions that mio allocates memory with (see "mioSetAllocator")
+static MioAllocator allocator = {defaultMalloc, defaultRealloc, defaultFree, NULL};
+
+void mioSetAllocator(const MioAllocator* pAllocator)
+{
+	if(pAllocator == NULL)
+	{
+		allocator = defaultAllocator;
+		return;
+	}
+
+	assert(pAllocator->pfnMalloc != NULL);
+	assert(pAllocator->pfnRealloc != NULL);
+	assert(pAllocator->pfnFree != NULL);
+
+	allocator = *pAllocator;
+}
+
+// Function to add the time since "startTime" to the allocation time of the load statistics
+static void addAllocTime(MioLoadStats* pStats, double startTime)
+{
+	if(pStats != NULL)
+	{
+		pStats->allocSeconds += mioGetTime() - startTime;
+	}
+}
+
+void* mioMemAlloc(size_t size)
+{
+	MioLoadStats* pStats = mioGetActiveLoadStats();
+	const double startTime = (pStats != NULL) ? mioGetTime() : 0.0;
+	void* ptr = allocator.pfnMalloc(size, allocator.pUserData);
+
+	addAllocTime(pStats, startTime);
+	mioFailScopeTrack(ptr);
+
+	return ptr;
+}
+
+void* mioMemRealloc(void* ptr, size_t size)
+{
+	MioLoadStats* pStats = mioGetActiveLoadStats();
+	const double startTime = (pStats != NULL) ? mioGetTime() : 0.0;
+	void* pNew = allocator.pfnRealloc(ptr, size, allocator.pUserData);
+
+	addAllocTime(pStats, startTime);
+
+	if(pNew != ptr && pNew != NULL)
+	{
+		mioFailScopeUntrack(ptr);
+		mioFailScopeTrack(pNew);
+	}
+
+	return pNew;
+}
+
+void mioMemFree(void* ptr)
+{
+	if(ptr != NULL)
+	{
+		MioLoadStats* pStats = mioGetActiveLoadStats();
+		const double startTime = (pStats != NULL) ? mioGetTime() : 0.0;
+
+		allocator.pfnFree(ptr, allocator.pUserData);
+		addAllocTime(pStats, startTime);
+		mioFailScopeUntrack(ptr);
+	}
+}
+
+// Function to check whether the first "pathLen" characters of "fpath" end with "extension"
+// (ignoring case)
+static bool hasExtension(const char* fpath, size_t pathLen, const char* extension)
+{
+	const size_t extensionLen = strlen(extension);
+
+	if(pathLen < extensionLen)
+	{
+		return false;
+	}
+
+	const char* pSuffix = fpath + (pathLen - extensionLen);
+
+	for(size_t i = 0; i < extensionLen; ++i)
+	{
+		const char c = pSuffix[i];
+		const char lower = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+
+		if(lower != extension[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Function to allocate a copy of the "count" indices at "pIndices"
+static unsigned int* copyArray(const unsigned int* pIndices, size_t count)
+{
+	unsigned int* pCopy = (unsigned int*)mioAllocate(count, sizeof(unsigned int));
+
+	if(count > 0)
+	{
+		memcpy(pCopy, pIndices, count * sizeof(unsigned int));
+	}
+
+	return pCopy;
+}
+
+static size_t alignArenaSize(size_t size)
+{
+	return (size + (MIO_ARENA_ALIGNMENT - 1)) & ~(size_t)(MIO_ARENA_ALIGNMENT - 1);
+}
+
+// Function to move "pArray" ("size" bytes) to "*ppCur" in an arena and free the original
+static void* moveToArena(unsigned char** ppCur, void* pArray, size_t size)
+{
+	if(pArray == NULL)
+	{
+		return NULL;
+	}
+
+	void* pOut = *ppCur;
+
+	memcpy(pOut, pArray, size);
+	mioMemFree(pArray);
+	*ppCur += alignArenaSize(size);
+
+	return pOut;
+}
+
+// Function to move the (separately allocated) arrays of "pMesh" into a single block. The layout
+// of the block is known only once the whole file has been parsed, so the arrays are copied.
+static void packMesh(MioMesh* pMesh)
 {
-	if(pMemPtr != NULL)
+	size_t numFaceVertices = 0;
+
+	for(unsigned int i = 0; i < pMesh->numFaces; ++i)
+	{
+		numFaceVertices += pMesh->pFaceSizes[i];
+	}
+
+	const size_t verticesSize = (size_t)pMesh->numVertices * 3 * sizeof(double);
+	const size_t normalsSize = (size_t)pMesh->numNormals * 3 * sizeof(double);
+	const size_t texCoordsSize = (size_t)pMesh->numTexCoords * 2 * sizeof(double);
+	const size_t faceSizesSize = (size_t)pMesh->numFaces * sizeof(unsigned int);
+	const size_t indicesSize = numFaceVertices * sizeof(unsigned int);
+	// NOTE: arrays that the mesh does not have take no space (see "moveToArena")
+	const size_t texCoordIndicesSize =
+		(pMesh->pFaceVertexTexCoordIndices != NULL) ? indicesSize : 0;
+	const size_t normalIndicesSize = (pMesh->pFaceVertexNormalIndices != NULL) ? indicesSize : 0;
+	const size_t sourceFacesSize =
+		(pMesh->pSourceFaces != NULL) ? (size_t)pMesh->numFaces * sizeof(unsigned int) : 0;
+
+	// extra space to align the first array
+	size_t arenaSize = MIO_ARENA_ALIGNMENT - 1;
+
+	arenaSize += alignArenaSize(verticesSize);
+	arenaSize += alignArenaSize(normalsSize);
+	arenaSize += alignArenaSize(texCoordsSize);
+	arenaSize += alignArenaSize(faceSizesSize);
+	arenaSize += alignArenaSize(indicesSize);
+	arenaSize += alignArenaSize(texCoordIndicesSize);
+	arenaSize += alignArenaSize(normalIndicesSize);
+	arenaSize += alignArenaSize(sourceFacesSize);
+
+	unsigned char* pArena = (unsigned char*)mioAllocate(arenaSize, 1);
+	const size_t misalignment = (size_t)((uintptr_t)pArena & (MIO_ARENA_ALIGNMENT - 1));
+	unsigned char* pCur = pArena + ((MIO_ARENA_ALIGNMENT - misalignment) & (MIO_ARENA_ALIGNMENT - 1));
+
+	pMesh->pVertices = (double*)moveToArena(&pCur, pMesh->pVertices, verticesSize);
+	pMesh->pNormals = (double*)moveToArena(&pCur, pMesh->pNormals, normalsSize);
+	pMesh->pTexCoords = (double*)moveToArena(&pCur, pMesh->pTexCoords, texCoordsSize);
+	pMesh->pFaceSizes = (unsigned int*)moveToArena(&pCur, pMesh->pFaceSizes, faceSizesSize);
+	pMesh->pFaceVertexIndices =
+		(unsigned int*)moveToArena(&pCur, pMesh->pFaceVertexIndices, indicesSize);
+	pMesh->pFaceVertexTexCoordIndices =
+		(unsigned int*)moveToArena(&pCur, pMesh->pFaceVertexTexCoordIndices, texCoordIndicesSize);
+	pMesh->pFaceVertexNormalIndices =
+		(unsigned int*)moveToArena(&pCur, pMesh->pFaceVertexNormalIndices, normalIndicesSize);
+	pMesh->pSourceFaces =
+		(unsigned int*)moveToArena(&pCur, pMesh->pSourceFaces, sourceFacesSize);
+	pMesh->pArena = pArena;
+}
+
+enum MioFormat mioGetFormatFromExtension(const char* fpath)
+{
+	static const struct
+	{
+		const char* pExtension;
+		enum MioFormat format;
+	} formats[] = {{".obj", MIO_FORMAT_OBJ},
+				   {".off", MIO_FORMAT_OFF},
+				   {".ply", MIO_FORMAT_PLY},
+				   {".stl", MIO_FORMAT_STL},
+				   {".miob", MIO_FORMAT_MIOB}};
+
+	size_t pathLen = strlen(fpath);
+
+	// NOTE: compressed files are read transparently (see input.h) i.e. "mesh.obj.gz" is .obj
+	static const char* const compressionExtensions[] = {".gz", ".zst"};
+
+	for(size_t i = 0; i < sizeof(compressionExtensions) / sizeof(compressionExtensions[0]); ++i)
+	{
+		if(hasExtension(fpath, pathLen, compressionExtensions[i]))
+		{
+			pathLen -= strlen(compressionExtensions[i]);
+			break;
+		}
+	}
+
+	for(size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i)
 	{
-		free(pMemPtr);
+		if(hasExtension(fpath, pathLen, formats[i].pExtension))
+		{
+			return formats[i].format;
+		}
 	}
+
+	return MIO_FORMAT_UNKNOWN;
+}
+
+static bool startsWith(const char* pHead, size_t headSize, const char* pPrefix)
+{
+	const size_t prefixLen = strlen(pPrefix);
+
+	return headSize >= prefixLen && memcmp(pHead, pPrefix, prefixLen) == 0;
+}
+
+enum MioFormat mioGetFormatFromContents(const char* pHead, size_t headSize, uint64_t fileSize)
+{
+	if(startsWith(pHead, headSize, "MIOB"))
+	{
+		return MIO_FORMAT_MIOB;
+	}
+
+	if(startsWith(pHead, headSize, "ply\n") || startsWith(pHead, headSize, "ply\r"))
+	{
+		return MIO_FORMAT_PLY;
+	}
+
+	// a binary .stl file has an 80-byte header, a 32-bit triangle count and 50 bytes per triangle
+	if(headSize >= 84)
+	{
+		const unsigned char* pCount = (const unsigned char*)pHead + 80;
+		const uint64_t numTriangles = (uint64_t)pCount[0] | ((uint64_t)pCount[1] << 8) |
+									  ((uint64_t)pCount[2] << 16) | ((uint64_t)pCount[3] << 24);
+
+		if(fileSize == 84 + numTriangles * 50)
+		{
+			return MIO_FORMAT_STL;
+		}
+	}
+
+	// the remaining formats are text, where .off and .stl files start with a keyword
+	size_t pos = 0;
+
+	while(pos < headSize && (pHead[pos] == ' ' || pHead[pos] == '\t' || pHead[pos] == '\r' ||
+							 pHead[pos] == '\n'))
+	{
+		pos++;
+	}
+
+	// the keyword of an .off file can have the prefixes of its variant, e.g. "NOFF" or "STCOFF"
+	size_t offPos = pos;
+
+	offPos += startsWith(pHead + offPos, headSize - offPos, "ST") ? 2 : 0;
+	offPos += startsWith(pHead + offPos, headSize - offPos, "C") ? 1 : 0;
+	offPos += startsWith(pHead + offPos, headSize - offPos, "N") ? 1 : 0;
+
+	if(startsWith(pHead + offPos, headSize - offPos, "OFF"))
+	{
+		return MIO_FORMAT_OFF;
+	}
+
+	if(startsWith(pHead + pos, headSize - pos, "solid"))
+	{
+		return MIO_FORMAT_STL;
+	}
+
+	if(memchr(pHead, '\0', headSize) != NULL)
+	{
+		return MIO_FORMAT_UNKNOWN; // binary
+	}
+
+	// .obj files start with a comment or a command e.g. "v", "vn", "f", "o", "g" or "mtllib"
+	return (pos < headSize && strchr("#vfogsmu", pHead[pos]) != NULL) ? MIO_FORMAT_OBJ
+																	 : MIO_FORMAT_UNKNOWN;
+}
+
+void mioReadMesh(const char* fpath, MioMesh* pMesh, unsigned int flags)
+{
+	assert(fpath != NULL);
+
+	const enum MioFormat format = mioGetFormatFromExtension(fpath);
+
+	if(format == MIO_FORMAT_UNKNOWN)
+	{
+		mioLogError("error: unsupported mesh file format: %s\n", fpath);
+		mioFail(MIO_STATUS_UNSUPPORTED_FORMAT);
+	}
+
+	mioReadMeshFormat(fpath, format, pMesh, flags);
+}
+
+enum MioStatus mioTryReadMesh(const char* fpath, MioMesh* pMesh, unsigned int flags)
+{
+	assert(pMesh != NULL);
+
+	MioFailScope scope;
+
+	mioFailScopeBegin(&scope);
+
+	if(setjmp(scope.jump) == 0)
+	{
+		mioReadMesh(fpath, pMesh, flags);
+	}
+	else
+	{
+		memset(pMesh, 0, sizeof(MioMesh));
+	}
+
+	return mioFailScopeEnd(&scope);
+}
+
+// Function to set the counts and face-vertex indices of the normals and texture coordinates of
+// "pMesh" (if any) for a file where they are per vertex, so that they have the vertex indices
+static void setPerVertexAttributeIndices(MioMesh* pMesh)
+{
+	size_t numFaceVertices = 0;
+
+	for(unsigned int i = 0; i < pMesh->numFaces; ++i)
+	{
+		numFaceVertices += pMesh->pFaceSizes[i];
+	}
+
+	if(pMesh->pNormals != NULL)
+	{
+		pMesh->numNormals = pMesh->numVertices;
+		pMesh->pFaceVertexNormalIndices = copyArray(pMesh->pFaceVertexIndices, numFaceVertices);
+	}
+
+	if(pMesh->pTexCoords != NULL)
+	{
+		pMesh->numTexCoords = pMesh->numVertices;
+		pMesh->pFaceVertexTexCoordIndices = copyArray(pMesh->pFaceVertexIndices, numFaceVertices);
+	}
+}
+
+// Function to read the file at "fpath", which is not a .miob file, in the format "format" into
+// "pMesh" with the reader of the format
+static void readMeshFile(const char* fpath, enum MioFormat format, MioMesh* pMesh)
+{
+	if(format == MIO_FORMAT_OBJ)
+	{
+		mioReadOBJ(fpath,
+				   &pMesh->pVertices,
+				   &pMesh->pNormals,
+				   &pMesh->pTexCoords,
+				   &pMesh->pFaceSizes,
+				   &pMesh->pFaceVertexIndices,
+				   &pMesh->pFaceVertexTexCoordIndices,
+				   &pMesh->pFaceVertexNormalIndices,
+				   &pMesh->numVertices,
+				   &pMesh->numNormals,
+				   &pMesh->numTexCoords,
+				   &pMesh->numFaces);
+	}
+	else if(format == MIO_FORMAT_OFF)
+	{
+		mioReadOFFWithAttributes(fpath,
+								 &pMesh->pVertices,
+								 &pMesh->pNormals,
+								 NULL, // (a "MioMesh" has no colours)
+								 &pMesh->pTexCoords,
+								 &pMesh->pFaceVertexIndices,
+								 &pMesh->pFaceSizes,
+								 &pMesh->numVertices,
+								 &pMesh->numFaces);
+
+		setPerVertexAttributeIndices(pMesh);
+	}
+	else if(format == MIO_FORMAT_PLY)
+	{
+		mioReadPLY(fpath,
+				   &pMesh->pVertices,
+				   &pMesh->pNormals,
+				   &pMesh->pTexCoords,
+				   &pMesh->pFaceSizes,
+				   &pMesh->pFaceVertexIndices,
+				   &pMesh->numVertices,
+				   &pMesh->numFaces);
+
+		setPerVertexAttributeIndices(pMesh);
+	}
+	else // MIO_FORMAT_STL
+	{
+		mioReadSTLWelded(fpath,
+						 &pMesh->pVertices,
+						 &pMesh->pNormals,
+						 &pMesh->pFaceSizes,
+						 &pMesh->pFaceVertexIndices,
+						 &pMesh->numVertices,
+						 &pMesh->numFaces,
+						 0.0);
+
+		// one normal per triangle, which is shared by its three corners
+		pMesh->numNormals = pMesh->numFaces;
+		pMesh->pFaceVertexNormalIndices =
+			(unsigned int*)mioAllocate((size_t)pMesh->numFaces * 3, sizeof(unsigned int));
+
+		for(size_t i = 0; i < (size_t)pMesh->numFaces * 3; ++i)
+		{
+			pMesh->pFaceVertexNormalIndices[i] = (unsigned int)(i / 3);
+		}
+	}
+}
+
+void mioReadMeshFormat(const char* fpath, enum MioFormat format, MioMesh* pMesh, unsigned int flags)
+{
+	assert(fpath != NULL);
+	assert(pMesh != NULL);
+
+	memset(pMesh, 0, sizeof(MioMesh));
+
+	MioSourceStamp stamp;
+	const bool useCache = format != MIO_FORMAT_MIOB && (flags & MIO_MESH_CACHE) != 0 &&
+						  mioGetSourceStamp(fpath, &stamp);
+
+	if(format == MIO_FORMAT_MIOB)
+	{
+		mioReadMIOB(fpath, pMesh); // NOTE: the arrays are already in a single block
+	}
+	else if(!useCache || !mioCacheLoad(fpath, &stamp, pMesh))
+	{
+		readMeshFile(fpath, format, pMesh);
+
+		if(useCache)
+		{
+			mioCacheStore(fpath, &stamp, pMesh);
+		}
+	}
+
+	if((flags & MIO_MESH_TRIANGULATE) != 0)
+	{
+		mioTriangulateMesh(pMesh);
+	}
+
+	if((flags & MIO_MESH_ARENA) != 0 && pMesh->pMapping == NULL)
+	{
+		packMesh(pMesh);
+	}
+}
+
+// Function to probe the file at "fpath" into "pInfo" (see "mioProbe"), where a malformed file fails
+// the current failure scope
+static enum MioStatus probeFile(const char* fpath, MioMeshInfo* pInfo)
+{
+	MioInput input;
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		return MIO_STATUS_OPEN_FAILED;
+	}
+
+	enum MioFormat format = mioGetFormatFromExtension(fpath);
+	MioSourceStamp stamp;
+
+	if(format == MIO_FORMAT_UNKNOWN && mioGetSourceStamp(fpath, &stamp))
+	{
+		// NOTE: a file that is smaller than the head is sniffed as a whole
+		mioInputRequire(&input, MIO_FORMAT_HEAD_SIZE);
+
+		size_t headSize = (size_t)(input.pEnd - input.pCur);
+
+		if(headSize > MIO_FORMAT_HEAD_SIZE)
+		{
+			headSize = MIO_FORMAT_HEAD_SIZE;
+		}
+
+		format = mioGetFormatFromContents(input.pCur, headSize, stamp.size);
+	}
+
+	switch(format)
+	{
+	case MIO_FORMAT_OBJ:
+		mioProbeOBJ(&input, pInfo);
+		break;
+	case MIO_FORMAT_OFF:
+		mioProbeOFF(&input, pInfo);
+		break;
+	case MIO_FORMAT_PLY:
+		mioProbePLY(&input, pInfo);
+		break;
+	case MIO_FORMAT_STL:
+		mioProbeSTL(&input, pInfo);
+		break;
+	case MIO_FORMAT_MIOB:
+		mioProbeMIOB(&input, pInfo);
+		break;
+	default:
+		break;
+	}
+
+	mioInputClose(&input);
+
+	if(format == MIO_FORMAT_UNKNOWN)
+	{
+		return MIO_STATUS_UNSUPPORTED_FORMAT;
+	}
+
+	pInfo->format = format;
+
+	return MIO_STATUS_OK;
+}
+
+enum MioStatus mioProbe(const char* fpath, MioMeshInfo* pInfo)
+{
+	assert(fpath != NULL);
+	assert(pInfo != NULL);
+
+	memset(pInfo, 0, sizeof(MioMeshInfo));
+
+	MioFailScope scope;
+
+	mioFailScopeBegin(&scope);
+
+	if(setjmp(scope.jump) == 0)
+	{
+		const enum MioStatus status = probeFile(fpath, pInfo);
+
+		mioFailScopeEnd(&scope);
+
+		return status;
+	}
+
+	memset(pInfo, 0, sizeof(MioMeshInfo));
+
+	return mioFailScopeEnd(&scope);
+}
+
+// Function to take over the array "pArray" ("size" bytes) of "pMesh", which is copied if it is part
+// of the mapping of a .miob file
+static void* takeArray(const MioMesh* pMesh, void* pArray, size_t size)
+{
+	if(pArray == NULL || pMesh->pMapping == NULL)
+	{
+		return pArray;
+	}
+
+	void* pCopy = mioAllocate(size, 1);
+	memcpy(pCopy, pArray, size);
+
+	return pCopy;
+}
+
+// Function to convert the face index array "pIndices" of "pMesh" to 64-bit elements
+static void* widenIndices(const MioMesh64* pMesh, void* pIndices)
+{
+	const size_t count = (size_t)pMesh->numFaceVertices;
+
+	return (pIndices != NULL) ? mioWidenUints(pIndices, count, count) : NULL;
+}
+
+void mioReadMesh64(const char* fpath, MioMesh64* pMesh, unsigned int flags)
+{
+	assert(fpath != NULL);
+	assert(pMesh != NULL);
+
+	if(mioGetFormatFromExtension(fpath) == MIO_FORMAT_OBJ)
+	{
+		mioReadOBJMesh64(fpath, pMesh);
+	}
+	else
+	{
+		// the other formats cannot hold more elements than a "MioMesh"
+		MioMesh mesh;
+
+		mioReadMesh(fpath, &mesh, 0);
+
+		memset(pMesh, 0, sizeof(MioMesh64));
+
+		for(unsigned int i = 0; i < mesh.numFaces; ++i)
+		{
+			pMesh->numFaceVertices += mesh.pFaceSizes[i];
+		}
+
+		const size_t indicesSize = (size_t)pMesh->numFaceVertices * sizeof(unsigned int);
+
+		pMesh->pVertices = (double*)takeArray(
+			&mesh, mesh.pVertices, (size_t)mesh.numVertices * 3 * sizeof(double));
+		pMesh->pNormals =
+			(double*)takeArray(&mesh, mesh.pNormals, (size_t)mesh.numNormals * 3 * sizeof(double));
+		pMesh->pTexCoords = (double*)takeArray(
+			&mesh, mesh.pTexCoords, (size_t)mesh.numTexCoords * 2 * sizeof(double));
+		pMesh->pFaceSizes = (unsigned int*)takeArray(
+			&mesh, mesh.pFaceSizes, (size_t)mesh.numFaces * sizeof(unsigned int));
+		pMesh->pFaceVertexIndices = takeArray(&mesh, mesh.pFaceVertexIndices, indicesSize);
+		pMesh->pFaceVertexTexCoordIndices =
+			takeArray(&mesh, mesh.pFaceVertexTexCoordIndices, indicesSize);
+		pMesh->pFaceVertexNormalIndices =
+			takeArray(&mesh, mesh.pFaceVertexNormalIndices, indicesSize);
+
+		pMesh->indexSize = sizeof(uint32_t);
+		pMesh->numVertices = mesh.numVertices;
+		pMesh->numNormals = mesh.numNormals;
+		pMesh->numTexCoords = mesh.numTexCoords;
+		pMesh->numFaces = mesh.numFaces;
+
+		if(mesh.pMapping != NULL)
+		{
+			mioFreeMesh(&mesh); // the arrays were copied
+		}
+	}
+
+	if((flags & MIO_MESH_64BIT_INDICES) != 0 && pMesh->indexSize == sizeof(uint32_t))
+	{
+		pMesh->pFaceVertexIndices = widenIndices(pMesh, pMesh->pFaceVertexIndices);
+		pMesh->pFaceVertexTexCoordIndices = widenIndices(pMesh, pMesh->pFaceVertexTexCoordIndices);
+		pMesh->pFaceVertexNormalIndices = widenIndices(pMesh, pMesh->pFaceVertexNormalIndices);
+		pMesh->indexSize = sizeof(uint64_t);
+	}
+}
+
+enum MioStatus mioTryReadMesh64(const char* fpath, MioMesh64* pMesh, unsigned int flags)
+{
+	assert(pMesh != NULL);
+
+	MioFailScope scope;
+
+	mioFailScopeBegin(&scope);
+
+	if(setjmp(scope.jump) == 0)
+	{
+		mioReadMesh64(fpath, pMesh, flags);
+	}
+	else
+	{
+		memset(pMesh, 0, sizeof(MioMesh64));
+	}
+
+	return mioFailScopeEnd(&scope);
+}
+
+void mioFree(void* pMemPtr)
+{
+	mioMemFree(pMemPtr);
 }
 
 void mioFreeMesh(MioMesh* pMeshPtr)
 {
 	assert(pMeshPtr != NULL);
 
+	if(pMeshPtr->pArena != NULL || pMeshPtr->pMapping != NULL)
+	{
+		// the arrays are part of the arena or the mapping
+		mioMemFree(pMeshPtr->pArena);
+		pMeshPtr->pArena = NULL;
+
+		if(pMeshPtr->pMapping != NULL)
+		{
+			mioReleaseMapping(pMeshPtr->pMapping);
+			pMeshPtr->pMapping = NULL;
+		}
+
+		pMeshPtr->pVertices = NULL;
+		pMeshPtr->pNormals = NULL;
+		pMeshPtr->pTexCoords = NULL;
+		pMeshPtr->pFaceSizes = NULL;
+		pMeshPtr->pFaceVertexIndices = NULL;
+		pMeshPtr->pFaceVertexTexCoordIndices = NULL;
+		pMeshPtr->pFaceVertexNormalIndices = NULL;
+		pMeshPtr->pSourceFaces = NULL;
+	}
+
 	mioFree(pMeshPtr->pVertices);
 	pMeshPtr->pVertices = NULL;
 	mioFree(pMeshPtr->pNormals);
@@ -148,6 +847,8 @@ void mioFreeMesh(MioMesh* pMeshPtr)
 	pMeshPtr->pFaceVertexTexCoordIndices = NULL;
 	mioFree(pMeshPtr->pFaceVertexNormalIndices);
 	pMeshPtr->pFaceVertexNormalIndices = NULL;
+	mioFree(pMeshPtr->pSourceFaces);
+	pMeshPtr->pSourceFaces = NULL;
 
 	pMeshPtr->numVertices = 0;
 	pMeshPtr->numNormals = 0;
@@ -155,3 +856,28 @@ void mioFreeMesh(MioMesh* pMeshPtr)
 	pMeshPtr->numFaces = 0;
 }
 
+void mioFreeMesh64(MioMesh64* pMesh)
+{
+	assert(pMesh != NULL);
+
+	mioFree(pMesh->pVertices);
+	pMesh->pVertices = NULL;
+	mioFree(pMesh->pNormals);
+	pMesh->pNormals = NULL;
+	mioFree(pMesh->pTexCoords);
+	pMesh->pTexCoords = NULL;
+	mioFree(pMesh->pFaceSizes);
+	pMesh->pFaceSizes = NULL;
+	mioFree(pMesh->pFaceVertexIndices);
+	pMesh->pFaceVertexIndices = NULL;
+	mioFree(pMesh->pFaceVertexTexCoordIndices);
+	pMesh->pFaceVertexTexCoordIndices = NULL;
+	mioFree(pMesh->pFaceVertexNormalIndices);
+	pMesh->pFaceVertexNormalIndices = NULL;
+
+	pMesh->numVertices = 0;
+	pMesh->numNormals = 0;
+	pMesh->numTexCoords = 0;
+	pMesh->numFaces = 0;
+	pMesh->numFaceVertices = 0;
+}
@@ -0,0 +1,497 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "miob.h"
+
+#include "array.h"
+#include "fail.h"
+#include "format.h"
+#include "input.h"
+#include "log.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// .miob is mio's native binary mesh format, which stores the arrays of a "MioMesh" exactly as
+// they are in memory: a fixed-size header followed by each array at a 64-byte aligned offset. The
+// file is mapped and the arrays of the mesh point into the mapping, so nothing is parsed or copied
+// when it is read. Integers and doubles have the byte order of the host that wrote the file.
+
+// version of the layout, which is increased whenever the layout changes
+#define MIO_MIOB_VERSION 1
+
+// alignment of each array in the file (the same as the arrays of a mesh arena)
+#define MIO_MIOB_ALIGNMENT 64
+
+// stored as a host integer to detect files that were written on a host with another byte order
+#define MIO_MIOB_BYTE_ORDER 0x01020304u
+
+// the arrays of a mesh in the order in which they are stored
+enum MiobArray
+{
+	MIOB_VERTICES,
+	MIOB_NORMALS,
+	MIOB_TEX_COORDS,
+	MIOB_FACE_SIZES,
+	MIOB_FACE_VERTEX_INDICES,
+	MIOB_FACE_VERTEX_TEX_COORD_INDICES,
+	MIOB_FACE_VERTEX_NORMAL_INDICES,
+	MIOB_NUM_ARRAYS
+};
+
+typedef struct MiobHeader
+{
+	char magic[4]; // "MIOB"
+	uint32_t byteOrder;
+	uint32_t version;
+	uint32_t headerSize;
+	uint32_t numVertices;
+	uint32_t numNormals;
+	uint32_t numTexCoords;
+	uint32_t numFaces;
+	// number of elements in each of the face-vertex index arrays
+	uint64_t numFaceVertices;
+	// size of the whole file (including the padding after the last array)
+	uint64_t fileSize;
+	// stamp of the file that the mesh was read from (zero if the file is not a cache)
+	uint64_t sourceSize;
+	int64_t sourceMTime;
+	int64_t sourceMTimeNsec;
+	// offset of each array from the start of the file (zero if the array is absent)
+	uint64_t offsets[MIOB_NUM_ARRAYS];
+} MiobHeader;
+
+static uint64_t alignMiobOffset(uint64_t offset)
+{
+	return (offset + (MIO_MIOB_ALIGNMENT - 1)) & ~(uint64_t)(MIO_MIOB_ALIGNMENT - 1);
+}
+
+static void getArraySizes(const MiobHeader* pHeader, uint64_t sizes[MIOB_NUM_ARRAYS])
+{
+	sizes[MIOB_VERTICES] = (uint64_t)pHeader->numVertices * 3 * sizeof(double);
+	sizes[MIOB_NORMALS] = (uint64_t)pHeader->numNormals * 3 * sizeof(double);
+	sizes[MIOB_TEX_COORDS] = (uint64_t)pHeader->numTexCoords * 2 * sizeof(double);
+	sizes[MIOB_FACE_SIZES] = (uint64_t)pHeader->numFaces * sizeof(unsigned int);
+	sizes[MIOB_FACE_VERTEX_INDICES] = pHeader->numFaceVertices * sizeof(unsigned int);
+	sizes[MIOB_FACE_VERTEX_TEX_COORD_INDICES] = sizes[MIOB_FACE_VERTEX_INDICES];
+	sizes[MIOB_FACE_VERTEX_NORMAL_INDICES] = sizes[MIOB_FACE_VERTEX_INDICES];
+}
+
+static bool writePadding(FILE* file, uint64_t count)
+{
+	static const char padding[MIO_MIOB_ALIGNMENT] = {0};
+
+	assert(count < MIO_MIOB_ALIGNMENT);
+
+	return fwrite(padding, 1, (size_t)count, file) == (size_t)count;
+}
+
+// Function to write "pMesh" to the file at "fpath" with the source stamp "pStamp" (or NULL).
+// Returns MIO_STATUS_OPEN_FAILED if the file cannot be opened, and MIO_STATUS_SYSTEM_ERROR if it
+// cannot be written.
+static enum MioStatus writeMIOB(const char* fpath, const MioMesh* pMesh, const MioSourceStamp* pStamp)
+{
+	MiobHeader header;
+
+	memset(&header, 0, sizeof(MiobHeader));
+	memcpy(header.magic, "MIOB", 4);
+	header.byteOrder = MIO_MIOB_BYTE_ORDER;
+	header.version = MIO_MIOB_VERSION;
+	header.headerSize = (uint32_t)sizeof(MiobHeader);
+	header.numVertices = pMesh->numVertices;
+	header.numNormals = pMesh->numNormals;
+	header.numTexCoords = pMesh->numTexCoords;
+	header.numFaces = pMesh->numFaces;
+
+	for(unsigned int i = 0; pMesh->pFaceSizes != NULL && i < pMesh->numFaces; ++i)
+	{
+		header.numFaceVertices += pMesh->pFaceSizes[i];
+	}
+
+	if(pStamp != NULL)
+	{
+		header.sourceSize = pStamp->size;
+		header.sourceMTime = pStamp->mtime;
+		header.sourceMTimeNsec = pStamp->mtimeNsec;
+	}
+
+	const void* pArrays[MIOB_NUM_ARRAYS] = {pMesh->pVertices,
+											pMesh->pNormals,
+											pMesh->pTexCoords,
+											pMesh->pFaceSizes,
+											pMesh->pFaceVertexIndices,
+											pMesh->pFaceVertexTexCoordIndices,
+											pMesh->pFaceVertexNormalIndices};
+	uint64_t sizes[MIOB_NUM_ARRAYS];
+
+	getArraySizes(&header, sizes);
+
+	uint64_t offset = alignMiobOffset(sizeof(MiobHeader));
+
+	for(int i = 0; i < MIOB_NUM_ARRAYS; ++i)
+	{
+		if(pArrays[i] != NULL && sizes[i] > 0)
+		{
+			header.offsets[i] = offset;
+			offset = alignMiobOffset(offset + sizes[i]);
+		}
+	}
+
+	header.fileSize = offset;
+
+	FILE* file = fopen(fpath, "wb");
+
+	if(file == NULL)
+	{
+		return MIO_STATUS_OPEN_FAILED;
+	}
+
+	bool ok = fwrite(&header, sizeof(MiobHeader), 1, file) == 1;
+	uint64_t written = sizeof(MiobHeader);
+
+	for(int i = 0; ok && i < MIOB_NUM_ARRAYS; ++i)
+	{
+		if(header.offsets[i] != 0)
+		{
+			ok = writePadding(file, header.offsets[i] - written) &&
+				 fwrite(pArrays[i], 1, (size_t)sizes[i], file) == (size_t)sizes[i];
+			written = header.offsets[i] + sizes[i];
+		}
+	}
+
+	ok = ok && writePadding(file, header.fileSize - written);
+	ok = (fclose(file) == 0) && ok;
+
+	return ok ? MIO_STATUS_OK : MIO_STATUS_SYSTEM_ERROR;
+}
+
+// Function to check that the "size" bytes at "pData" are a valid .miob file (with the source
+// stamp "pStamp" unless it is NULL). Returns NULL if so, or else the reason why not.
+static const char*
+checkMIOB(const unsigned char* pData, size_t size, const MioSourceStamp* pStamp)
+{
+	MiobHeader header;
+
+	if(size < sizeof(MiobHeader))
+	{
+		return "not a .miob file";
+	}
+
+	memcpy(&header, pData, sizeof(MiobHeader));
+
+	if(memcmp(header.magic, "MIOB", 4) != 0)
+	{
+		return "not a .miob file";
+	}
+
+	if(header.byteOrder != MIO_MIOB_BYTE_ORDER)
+	{
+		return ".miob file was written on a host with another byte order";
+	}
+
+	if(header.version != MIO_MIOB_VERSION || header.headerSize != sizeof(MiobHeader))
+	{
+		return "unsupported .miob version";
+	}
+
+	if(header.fileSize != size)
+	{
+		return "truncated .miob file";
+	}
+
+	if(pStamp != NULL &&
+	   (header.sourceSize != pStamp->size || header.sourceMTime != pStamp->mtime ||
+		header.sourceMTimeNsec != pStamp->mtimeNsec))
+	{
+		return ".miob file is out of date";
+	}
+
+	// the arrays are used in place
+	if(((uintptr_t)pData & (sizeof(double) - 1)) != 0)
+	{
+		return "misaligned .miob data";
+	}
+
+	if(header.numFaceVertices > header.fileSize)
+	{
+		return "corrupt .miob file";
+	}
+
+	uint64_t sizes[MIOB_NUM_ARRAYS];
+
+	getArraySizes(&header, sizes);
+
+	for(int i = 0; i < MIOB_NUM_ARRAYS; ++i)
+	{
+		const uint64_t offset = header.offsets[i];
+		// the positions and faces are always stored (if there are any), whereas the other arrays
+		// have an offset of 0 if the mesh does not have them
+		const bool isRequired =
+			(i == MIOB_VERTICES || i == MIOB_FACE_SIZES || i == MIOB_FACE_VERTEX_INDICES);
+
+		if(offset == 0 && isRequired && sizes[i] > 0)
+		{
+			return "corrupt .miob file";
+		}
+
+		if(offset != 0 &&
+		   ((offset % MIO_MIOB_ALIGNMENT) != 0 || offset < sizeof(MiobHeader) ||
+			sizes[i] > header.fileSize || offset > header.fileSize - sizes[i]))
+		{
+			return "corrupt .miob file";
+		}
+	}
+
+	return NULL;
+}
+
+// the reason of "openMIOB" for a file that cannot be opened
+static const char* const openFailed = "failed to open file";
+
+// Function to map the .miob file at "fpath" into "pMesh" (see "checkMIOB" for "pStamp"). Returns
+// NULL on success, or else the reason why the file cannot be used.
+static const char* openMIOB(const char* fpath, const MioSourceStamp* pStamp, MioMesh* pMesh)
+{
+	MioInput* pInput = (MioInput*)mioAllocate(1, sizeof(MioInput));
+
+	mioLoadBegin();
+
+	// copy-on-write, so that the arrays can be modified like those of any other mesh
+	if(!mioInputOpenFileCopyOnWrite(pInput, fpath))
+	{
+		mioLoadEnd(pInput);
+		mioMemFree(pInput);
+		return openFailed;
+	}
+
+	if(pInput->kind == MIO_INPUT_STREAM)
+	{
+		// the file cannot be mapped (e.g. a pipe), so it is read into the buffer as a whole
+		while(mioInputRefill(pInput))
+		{
+		}
+	}
+
+	// NOTE: both a copy-on-write mapping and the buffer of a stream can be written to
+	unsigned char* pData = (unsigned char*)pInput->pCur;
+	const char* pError = checkMIOB(pData, (size_t)(pInput->pEnd - pInput->pCur), pStamp);
+
+	mioLoadEnd(pInput);
+
+	if(pError != NULL)
+	{
+		mioInputClose(pInput);
+		mioMemFree(pInput);
+		return pError;
+	}
+
+	MiobHeader header;
+
+	memcpy(&header, pData, sizeof(MiobHeader));
+
+	void* pArrays[MIOB_NUM_ARRAYS];
+
+	for(int i = 0; i < MIOB_NUM_ARRAYS; ++i)
+	{
+		pArrays[i] = (header.offsets[i] != 0) ? (void*)(pData + header.offsets[i]) : NULL;
+	}
+
+	memset(pMesh, 0, sizeof(MioMesh));
+
+	pMesh->pVertices = (double*)pArrays[MIOB_VERTICES];
+	pMesh->pNormals = (double*)pArrays[MIOB_NORMALS];
+	pMesh->pTexCoords = (double*)pArrays[MIOB_TEX_COORDS];
+	pMesh->pFaceSizes = (unsigned int*)pArrays[MIOB_FACE_SIZES];
+	pMesh->pFaceVertexIndices = (unsigned int*)pArrays[MIOB_FACE_VERTEX_INDICES];
+	pMesh->pFaceVertexTexCoordIndices = (unsigned int*)pArrays[MIOB_FACE_VERTEX_TEX_COORD_INDICES];
+	pMesh->pFaceVertexNormalIndices = (unsigned int*)pArrays[MIOB_FACE_VERTEX_NORMAL_INDICES];
+	pMesh->numVertices = header.numVertices;
+	pMesh->numNormals = header.numNormals;
+	pMesh->numTexCoords = header.numTexCoords;
+	pMesh->numFaces = header.numFaces;
+	pMesh->pMapping = pInput;
+
+	return NULL;
+}
+
+void mioReleaseMapping(void* pMapping)
+{
+	MioInput* pInput = (MioInput*)pMapping;
+
+	mioInputClose(pInput);
+	mioMemFree(pInput);
+}
+
+bool mioGetSourceStamp(const char* fpath, MioSourceStamp* pStamp)
+{
+#if defined(_WIN32)
+	struct _stat64 info;
+
+	if(_stat64(fpath, &info) != 0)
+	{
+		return false;
+	}
+
+	pStamp->mtimeNsec = 0; // not available
+#else
+	struct stat info;
+
+	if(stat(fpath, &info) != 0)
+	{
+		return false;
+	}
+
+#	if defined(__APPLE__)
+	pStamp->mtimeNsec = (int64_t)info.st_mtimespec.tv_nsec;
+#	else
+	pStamp->mtimeNsec = (int64_t)info.st_mtim.tv_nsec;
+#	endif
+#endif // #if defined(_WIN32)
+
+	pStamp->size = (uint64_t)info.st_size;
+	pStamp->mtime = (int64_t)info.st_mtime;
+
+	return true;
+}
+
+char* mioAppendSuffix(const char* fpath, const char* suffix)
+{
+	const size_t pathLen = strlen(fpath);
+	const size_t suffixLen = strlen(suffix);
+	char* pOut = (char*)mioAllocate(pathLen + suffixLen + 1, 1);
+
+	memcpy(pOut, fpath, pathLen);
+	memcpy(pOut + pathLen, suffix, suffixLen + 1);
+
+	return pOut;
+}
+
+bool mioCacheLoad(const char* fpath, const MioSourceStamp* pStamp, MioMesh* pMesh)
+{
+	char* pCachePath = mioAppendSuffix(fpath, ".miob");
+	MioMesh mesh;
+	const bool loaded = openMIOB(pCachePath, pStamp, &mesh) == NULL;
+
+	if(loaded)
+	{
+		mioLogInfo("read .miob cache: %s\n", pCachePath);
+		*pMesh = mesh;
+	}
+
+	mioMemFree(pCachePath);
+
+	return loaded;
+}
+
+void mioCacheStore(const char* fpath, const MioSourceStamp* pStamp, const MioMesh* pMesh)
+{
+	char* pCachePath = mioAppendSuffix(fpath, ".miob");
+	char* pTempPath = mioAppendSuffix(pCachePath, ".tmp");
+
+	// the cache is written to a temporary file first so that it is never read half-written
+	if(writeMIOB(pTempPath, pMesh, pStamp) == MIO_STATUS_OK)
+	{
+#if defined(_WIN32)
+		remove(pCachePath); // "rename" does not replace an existing file on Windows
+#endif
+		if(rename(pTempPath, pCachePath) != 0)
+		{
+			remove(pTempPath);
+		}
+	}
+	else
+	{
+		remove(pTempPath);
+	}
+
+	mioMemFree(pTempPath);
+	mioMemFree(pCachePath);
+}
+
+void mioReadMIOB(const char* fpath, MioMesh* pMesh)
+{
+	assert(fpath != NULL);
+	assert(pMesh != NULL);
+
+	mioLogInfo("read .miob file: %s\n", fpath);
+
+	const char* pError = openMIOB(fpath, NULL, pMesh);
+
+	if(pError != NULL)
+	{
+		mioLogError("error: %s '%s'\n", pError, fpath);
+		mioFail((pError == openFailed) ? MIO_STATUS_OPEN_FAILED : MIO_STATUS_MALFORMED);
+	}
+
+	mioLogInfo("done.\n");
+}
+
+void mioWriteMIOB(const char* fpath, const MioMesh* pMesh)
+{
+	assert(fpath != NULL);
+	assert(pMesh != NULL);
+
+	mioLogInfo("write .miob file: %s\n", fpath);
+
+	const enum MioStatus status = writeMIOB(fpath, pMesh, NULL);
+
+	if(status != MIO_STATUS_OK)
+	{
+		mioLogError("error: failed to write file '%s'\n", fpath);
+		mioFail(status);
+	}
+
+	mioLogInfo("done.\n");
+}
+
+void mioProbeMIOB(MioInput* pInput, MioMeshInfo* pInfo)
+{
+	if(pInput->kind == MIO_INPUT_STREAM)
+	{
+		// the file cannot be mapped (e.g. a pipe), so it is read as a whole to be checked
+		while(mioInputRefill(pInput))
+		{
+		}
+	}
+
+	const unsigned char* pData = (const unsigned char*)pInput->pCur;
+	const char* pError = checkMIOB(pData, (size_t)(pInput->pEnd - pInput->pCur), NULL);
+
+	if(pError != NULL)
+	{
+		mioLogError("error: %s\n", pError);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	MiobHeader header;
+
+	memcpy(&header, pData, sizeof(MiobHeader));
+
+	pInfo->numVertices = header.numVertices;
+	pInfo->numNormals = header.numNormals;
+	pInfo->numTexCoords = header.numTexCoords;
+	pInfo->numFaces = header.numFaces;
+	pInfo->numFaceVertices = header.numFaceVertices;
+}
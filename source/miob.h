@@ -0,0 +1,57 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_MIOB_H__
+#define __MIO_MIOB_H__ 1
+
+#include "mio/mio.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Internal side of the .miob format (see miob.c), which is used for the sidecar cache of
+// "mioReadMesh" ("MIO_MESH_CACHE").
+
+// size and modification time of a source file, which tell whether its cache is up to date
+typedef struct MioSourceStamp
+{
+	uint64_t size;
+	int64_t mtime; // seconds
+	int64_t mtimeNsec;
+} MioSourceStamp;
+
+// Function to get the stamp of the file at "fpath". Returns false if the file cannot be queried.
+bool mioGetSourceStamp(const char* fpath, MioSourceStamp* pStamp);
+
+// Function to allocate the string "<fpath><suffix>" (e.g. the path of the sidecar file of "fpath")
+char* mioAppendSuffix(const char* fpath, const char* suffix);
+
+// Function to read "<fpath>.miob" into "pMesh" if it exists and was written for a source file
+// with the stamp "pStamp". Returns false (leaving "pMesh" untouched) otherwise.
+bool mioCacheLoad(const char* fpath, const MioSourceStamp* pStamp, MioMesh* pMesh);
+
+// Function to (re)write "<fpath>.miob" for "pMesh", which was read from a source file with the
+// stamp "pStamp". A cache that cannot be written is skipped (the mesh itself is unaffected).
+void mioCacheStore(const char* fpath, const MioSourceStamp* pStamp, const MioMesh* pMesh);
+
+// Function to release the file mapping of a mesh that was read from a .miob file
+void mioReleaseMapping(void* pMapping);
+
+#endif // #ifndef __MIO_MIOB_H__
@@ -20,8 +20,23 @@
 
 #include "mio/obj.h"
 
+#include "array.h"
+#include "fail.h"
+#include "format.h"
+#include "input.h"
+#include "into.h"
+#include "log.h"
+#include "mesh64.h"
+#include "miob.h"
+#include "parse.h"
+#include "stats.h"
+#include "thread.h"
+#include "writer.h"
+
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -77,598 +92,3207 @@ enum ObjFileCmdType
 	UNKNOWN = 0xFFFFFFFF
 };
 
-// Funcion to read in an obj file that stores a single 3D mesh object (in ASCII
-// format). The pointer parameters will be allocated inside this function and must
-// be freed by caller. The function only handles polygonal faces, so commands like
-// "vp" command (which is used to specify control points of the surface or curve)
-// are ignored if encountered in file.
-void mioReadOBJ(
-	// absolute path to file
-	const char* fpath,
-	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
-	double** pVertices,
-	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
-	double** pNormals,
-	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
-	double** pTexCoords,
-	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
-	unsigned int** pFaceSizes,
-	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
-	unsigned int** pFaceVertexIndices,
-	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
-	unsigned int** pFaceVertexTexCoordIndices,
-	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
-	unsigned int** pFaceVertexNormalIndices,
-	// number of vertices in "pVertices"
-	unsigned int* numVertices,
-	// number of vertex normals in "pNormals"
-	unsigned int* numNormals,
-	// number of texture coordinates in "pTexCoords"
-	unsigned int* numTexcoords,
-	// number of faces
-	unsigned int* numFaces)
+// elements parsed from (a range of lines of) an .obj file
+typedef struct ObjChunk
 {
+	MioArray vertices;
+	MioArray normals;
+	MioArray texCoords;
+	MioArray faceSizes;
+	MioArray faceVertexIndices;
+	// NOTE: these two arrays are zero-filled up to the last face-vertex that references a
+	// texcoord/normal, and must be padded to the full face-index count after parsing (if needed).
+	MioArray faceVertexTexCoordIndices;
+	MioArray faceVertexNormalIndices;
+	// the face indices of relative (negative) ids, as 64-bit "position * 3 + array" entries where
+	// array 0, 1 and 2 are the vertex, texcoord and normal indices (see "setWideFaceVertex")
+	MioArray relativeIndices;
+	// the distinct face-vertices of an indexed mesh (see "parseIndexedFace"), or NULL
+	struct ObjVertexTable* pVertexTable;
+
+	size_t nVertices; // number of vertex coordinates found
+	size_t nNormals; // number of vertex normals found
+	size_t nTexCoords; // number of vertex vertex texture coordnates found
+	size_t nFaces; // number of faces found
+	size_t nFaceIndices; // total number of face indices found
+
+	size_t coordSize; // size of a coordinate i.e. sizeof(double) or sizeof(float)
+	// size of an element of the face index arrays i.e. sizeof(uint32_t), or sizeof(uint64_t) once
+	// an index does not fit in 32 bits
+	size_t indexSize;
+} ObjChunk;
+
+static void initChunk(ObjChunk* pChunk, size_t coordSize)
+{
+	memset(pChunk, 0, sizeof(ObjChunk));
+	pChunk->coordSize = coordSize;
+	pChunk->indexSize = sizeof(uint32_t);
+}
 
-	fprintf(stdout, "read .obj file: %s\n", fpath);
-
-	FILE* file = fopen(fpath, "rb"); // open our file
+// Function to parse "count" coordinates from the line [p, pEnd) and append them to "pArray", in
+// double or single precision (depending on the coordinate size of "pChunk"). Returns the number
+// of coordinates that were found.
+static size_t
+parseCoords(const ObjChunk* pChunk, MioArray* pArray, const char* p, const char* pEnd, size_t count)
+{
+	size_t nread = 0;
 
-	if(file == NULL)
+	if(pChunk->coordSize == sizeof(double))
 	{
-		fprintf(stderr, "error: failed to open file '%s'", fpath);
-		exit(1);
+		double values[3] = {0.0, 0.0, 0.0};
+		nread = mioParseDoubles(p, pEnd, values, count);
+		mioArrayPushDoubles(pArray, values, count);
 	}
+	else
+	{
+		float values[3] = {0.0f, 0.0f, 0.0f};
+		nread = mioParseFloats(p, pEnd, values, count);
+		mioArrayPushFloats(pArray, values, count);
+	}
+
+	return nread;
+}
 
-	fpos_t startOfFile;
+// Function to parse the face-vertex token that starts at "pToken" i.e. "v", "v/t", "v//n" or
+// "v/t/n", where "pIds" receives the vertex, texcoord and normal id, and bit i of "*pFound" is set
+// if id i was found (NOTE: elements can be empty, like the texcoord in "5//3"). Returns the end of
+// the token.
+static const char*
+parseFaceVertex(const char* pToken, const char* pLineEnd, int64_t* pIds, unsigned int* pFound)
+{
+	const char* pTokenEnd = pToken;
 
-	if(fgetpos(file, &startOfFile) != 0) /* current position: start of file */
+	while(pTokenEnd != pLineEnd && !mioIsBlank(*pTokenEnd))
 	{
-		perror("fgetpos()");
-		fprintf(stderr, "error fgetpos() failed in file %s at line # %d\n", __FILE__, __LINE__ - 3);
-		exit(EXIT_FAILURE);
+		pTokenEnd++;
 	}
 
-	// buffer used to store the contents of a line read from the file.
-	char* lineBuf = NULL;
-	// current length of the line buffer (in characters read)
-	size_t lineBufLen = 0;
+	const char* pElem = pToken;
+	int faceVertexDataIt = 0; // vertex id/texcoord id/normal id
 
-	// counts the number of passes we have made over the file to parse contents.
-	// this is needed because multiple passes are required e.g. to determine how
-	// much memory to allocate before actually copying data into pointers.
-	//
-	// The first pass is a survey of the file, counting the number of elements
-	// (vertices, faces etc) and allocating the respective memory.
-	// The second pass actually copies the data from file and into the allocated arrays
-	// (most of them). Also count the total number of face indices.
-	// The third pass is specifically for copying face index data after knowing the total
-	// number of face indices.
-	int passIterator = 0;
+	*pFound = 0;
 
-	int nFaceIndices = 0; // total number of face indices found in file
+	// for each data element of a face-vertex
+	for(faceVertexDataIt = 0; faceVertexDataIt < 3; ++faceVertexDataIt)
+	{
+		// extract face vertex data index
+		if(mioParseInt64(&pElem, pTokenEnd, &pIds[faceVertexDataIt]))
+		{
+			*pFound |= (1u << faceVertexDataIt);
+		}
+		else if(faceVertexDataIt == 0)
+		{
+			break; // token without a vertex id (e.g. made up of separators only)
+		}
 
-	do
-	{ // each iteration will parse the file in full
+		if(pElem == pTokenEnd || *pElem != '/')
+		{
+			break; // no more elements
+		}
 
-		// these variables are defined after having parsed the full file
-		int nVertices = 0; // number of vertex coordinates found in file
-		int nNormals = 0; // number of vertex normals found in file
-		int nTexCoords = 0; // number of vertex vertex texture coordnates found in file
-		int nFaces = 0; // number of faces found in file
+		pElem++; // skip "/"
+	}
 
-		int faceIndicesCounter = 0; // running offset into pFaceVertexIndices (final value
-			// will be same as nFaceIndices)
+	return pTokenEnd;
+}
 
-		// number of characters read on a lineBuf
-		size_t nread = 0;
+// Function to convert the (one-based) id of an element to a (zero-based) index, where a relative
+// (negative) id counts back from the "count" elements of its kind that precede it, i.e. -1 is the
+// last of them. Ends the program for the id 0, which refers to no element.
+static int64_t toIndex(int64_t id, size_t count)
+{
+	if(id == 0)
+	{
+		mioLogError("error: invalid face index 0\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
 
-		while((nread = getline(&lineBuf, &lineBufLen, file)) != (((size_t)0) - 1) /*-1*/)
-		{ // each iteration will parse a line in the file
-			//printf("line : ");
-			//printf(lineBuf);
+	return (id > 0) ? id - 1 : (int64_t)count + id;
+}
 
-			lineBuf[strcspn(lineBuf, "\r\n")] = '\0'; // strip newline and carriage return
+// Function to convert the face index arrays of "pChunk" to 64-bit elements
+static void widenChunkIndices(ObjChunk* pChunk)
+{
+	MioArray* pArrays[3] = {&pChunk->faceVertexIndices,
+							&pChunk->faceVertexTexCoordIndices,
+							&pChunk->faceVertexNormalIndices};
 
-			const size_t lineLen = strlen(lineBuf);
+	for(int i = 0; i < 3; ++i)
+	{
+		mioArrayWidenUints(pArrays[i]);
+	}
 
-			assert(lineLen <= nread);
+	// the relative indices can be negative (see "setWideFaceVertex"), so they are sign-extended
+	const uint64_t* pEntries = (const uint64_t*)pChunk->relativeIndices.pData;
 
-			const bool lineIsEmpty = (lineLen == 0);
+	for(size_t i = 0; i < pChunk->relativeIndices.size; ++i)
+	{
+		uint64_t* pIndex = (uint64_t*)pArrays[pEntries[i] % 3]->pData + pEntries[i] / 3;
+		*pIndex = (uint64_t)(int64_t)(int32_t)(uint32_t)*pIndex;
+	}
 
-			if(lineIsEmpty)
-			{
-				continue; // .. skip to next line
-			}
+	pChunk->indexSize = sizeof(uint64_t);
+}
 
-			const bool lineIsComment = lineBuf[0] == '#';
+// Function to store "index" at position "pos" of the face index array "pArray" of "pChunk", where
+// the index can be negative if it is relative (see "setWideFaceVertex")
+static void setIndex(ObjChunk* pChunk, MioArray* pArray, size_t pos, int64_t index, bool isRelative)
+{
+	if(pChunk->indexSize == sizeof(uint32_t))
+	{
+		const bool fits = isRelative ? (index >= INT32_MIN && index <= INT32_MAX)
+									 : (index <= (int64_t)UINT32_MAX);
 
-			if(lineIsComment)
-			{
-				continue; // ... skip to next line
-			}
+		if(fits)
+		{
+			mioArraySetUint(pArray, pos, (uint32_t)index);
+			return;
+		}
 
-			//
-			// In the following, we determine the type of "command" in the object
-			// file that is contained on the current line.
-			//
+		widenChunkIndices(pChunk);
+	}
 
-			enum ObjFileCmdType cmdType = UNKNOWN;
+	mioArraySetUint64(pArray, pos, (uint64_t)index);
+}
 
-			if(lineBuf[0] == 'v' && lineBuf[1] == ' ')
-			{
-				cmdType = VERTEX;
-			}
-			else if(lineBuf[0] == 'v' && lineBuf[1] == 'n' && lineBuf[2] == ' ')
-			{
-				cmdType = NORMAL;
-			}
-			else if(lineBuf[0] == 'v' && lineBuf[1] == 't' && lineBuf[2] == ' ')
-			{
-				cmdType = TEXCOORD;
-			}
-			else if(lineBuf[0] == 'f' && lineBuf[1] == ' ')
-			{
-				cmdType = FACE;
-			}
-			else
-			{
-				assert(cmdType == UNKNOWN);
-				//fprintf(stderr, "note: skipping unrecognised command in line '%s'\n", lineBuf);
-				continue; // ... to next lineBuf
-			}
+// Function to append the face-vertex with the ids "pIds" (where bit i of "found" is set if id i was
+// found) to the face arrays of "pChunk", for ids that are relative or do not fit in 32 bits, or
+// arrays that already have 64-bit elements. A relative id is counted back from the elements of
+// the chunk, so its index can be negative (i.e. refer to an element of a previous chunk) until the
+// chunk's offsets are known (see "resolveRelativeIndices").
+static void setWideFaceVertex(ObjChunk* pChunk, const int64_t* pIds, unsigned int found)
+{
+	MioArray* pArrays[3] = {&pChunk->faceVertexIndices,
+							&pChunk->faceVertexTexCoordIndices,
+							&pChunk->faceVertexNormalIndices};
+	const size_t counts[3] = {pChunk->nVertices, pChunk->nTexCoords, pChunk->nNormals};
 
-			//
-			// Now that we know the type of command whose data is on the current line,
-			// we can go ahead and parse the line in a command-specific way
-			//
-			switch(cmdType)
-			{
-			case VERTEX: { // parsing vertex coordinates
-				const int vertexId = nVertices++; // incremental vertex count in file
+	for(int i = 0; i < 3; ++i)
+	{
+		if(((found >> i) & 1u) == 0)
+		{
+			continue;
+		}
 
-				if(passIterator == 1)
-				{
+		const bool isRelative = pIds[i] < 0;
 
-					double x = 0.0;
-					double y = 0.0;
-					double z = 0.0;
+		if(isRelative)
+		{
+			mioArrayPushUint64(&pChunk->relativeIndices, pChunk->nFaceIndices * 3 + (uint64_t)i);
+		}
 
-					nread = sscanf(lineBuf + 2, "%lf %lf %lf", &x, &y, &z);
+		setIndex(pChunk, pArrays[i], pChunk->nFaceIndices, toIndex(pIds[i], counts[i]), isRelative);
+	}
+}
 
-					(*pVertices)[vertexId * 3 + 0] = x;
-					(*pVertices)[vertexId * 3 + 1] = y;
-					(*pVertices)[vertexId * 3 + 2] = z;
+// Function to make the relative indices of "pChunk" (see "setWideFaceVertex") absolute, where
+// "pOffsets" holds the number of vertices, texcoords and normals before the chunk, and to store
+// them from element "faceIndexOffset" on in the face index arrays "ppDst" (with elements of
+// "dstIndexSize" bytes). An array of "ppDst" can be the chunk's own array (with an offset of 0),
+// or NULL for indices that are not stored.
+static void resolveRelativeIndices(const ObjChunk* pChunk,
+								   void* const* ppDst,
+								   size_t dstIndexSize,
+								   size_t faceIndexOffset,
+								   const size_t* pOffsets)
+{
+	const MioArray* pArrays[3] = {&pChunk->faceVertexIndices,
+								  &pChunk->faceVertexTexCoordIndices,
+								  &pChunk->faceVertexNormalIndices};
+	const uint64_t* pEntries = (const uint64_t*)pChunk->relativeIndices.pData;
 
-					if(nread != 3)
-					{
-						fprintf(stderr, "error: have %zu components for v%d\n", nread, vertexId);
-						abort();
-					}
-				}
-			}
-			break;
-			case NORMAL: { // parsing normal coordinates
-				const int normalId = nNormals++; // incremental vertex-normal count in file
+	for(size_t e = 0; e < pChunk->relativeIndices.size; ++e)
+	{
+		const int i = (int)(pEntries[e] % 3);
+		const size_t pos = (size_t)(pEntries[e] / 3);
+		const int64_t relative = (pChunk->indexSize == sizeof(uint32_t))
+									 ? (int64_t)(int32_t)((const uint32_t*)pArrays[i]->pData)[pos]
+									 : (int64_t)((const uint64_t*)pArrays[i]->pData)[pos];
+		const int64_t index = (int64_t)pOffsets[i] + relative;
+
+		if(index < 0)
+		{
+			mioLogError("error: relative face index refers to no element\n");
+			mioFail(MIO_STATUS_MALFORMED);
+		}
 
-				if(passIterator == 1)
-				{
+		if(ppDst[i] == NULL)
+		{
+			continue; // ... the indices of this array are not stored
+		}
 
-					double x = 0.0;
-					double y = 0.0;
-					double z = 0.0;
+		if(dstIndexSize == sizeof(uint32_t))
+		{
+			((uint32_t*)ppDst[i])[faceIndexOffset + pos] = (uint32_t)index;
+		}
+		else
+		{
+			((uint64_t*)ppDst[i])[faceIndexOffset + pos] = (uint64_t)index;
+		}
+	}
+}
 
-					nread = sscanf(lineBuf + 2, "%lf %lf %lf", &x, &y, &z);
+// hash table of the distinct (vertex, texcoord, normal) index triples of the face-vertices of an
+// indexed mesh (see "mioReadOBJIndexed"), where each distinct triple becomes one vertex
+typedef struct ObjVertexTable
+{
+	// the distinct triples, stored as [ijk,ijk,...] in the order in which they are found
+	MioArray triples;
+	// open-addressing slots that hold the (one-based) number of a triple, or 0 if the slot is empty
+	uint32_t* pSlots;
+	// number of slots (a power of two)
+	size_t numSlots;
+} ObjVertexTable;
+
+// Function to get the slot of "pTable" that holds the triple "pTriple", or the empty slot that the
+// triple belongs in if it is not in the table
+static size_t findVertexSlot(const ObjVertexTable* pTable, const uint32_t* pTriple)
+{
+	const uint32_t* pTriples = (const uint32_t*)pTable->triples.pData;
+	const uint64_t key = (((uint64_t)pTriple[0] << 32) | pTriple[1]) ^
+						 ((uint64_t)pTriple[2] * 0x9E3779B97F4A7C15ull);
+	size_t slot = (size_t)((key * 0xFF51AFD7ED558CCDull) >> 32) & (pTable->numSlots - 1);
 
-					(*pNormals)[normalId * 3 + 0] = x;
-					(*pNormals)[normalId * 3 + 1] = y;
-					(*pNormals)[normalId * 3 + 2] = z;
+	while(pTable->pSlots[slot] != 0)
+	{
+		const uint32_t* pOther = pTriples + (size_t)(pTable->pSlots[slot] - 1) * 3;
 
-					if(nread != 3)
-					{
-						fprintf(stderr, "error: have %zu components for vn%d\n", nread, normalId);
-						abort();
-					}
-				}
-			}
+		if(pOther[0] == pTriple[0] && pOther[1] == pTriple[1] && pOther[2] == pTriple[2])
+		{
 			break;
-			case TEXCOORD: { // parsing texture coordinates
-				const int texCoordId = nTexCoords++; // incremental tex coord count in file
+		}
 
-				if(passIterator == 1)
-				{
+		slot = (slot + 1) & (pTable->numSlots - 1);
+	}
 
-					double x = 0.0;
-					double y = 0.0;
-					nread = sscanf(lineBuf + 2, "%lf %lf", &x, &y);
+	return slot;
+}
 
-					(*pTexCoords)[texCoordId * 2 + 0] = x;
-					(*pTexCoords)[texCoordId * 2 + 1] = y;
+// Function to resize the slots of "pTable" to "numSlots", where the triples are inserted again
+static void resizeVertexTable(ObjVertexTable* pTable, size_t numSlots)
+{
+	mioMemFree(pTable->pSlots);
 
-					if(nread != 2)
-					{
-						fprintf(stderr, "error: have %zu components for vt%d\n", nread, texCoordId);
-						abort();
-					}
-				}
-			}
-			break;
-			case FACE: { // parsing faces
-				const int faceId = (nFaces++); // incremental face count in file
+	pTable->pSlots = (uint32_t*)mioAllocate(numSlots, sizeof(uint32_t));
+	pTable->numSlots = numSlots;
+	memset(pTable->pSlots, 0, numSlots * sizeof(uint32_t));
 
-				if(passIterator == 1)
-				{ // second pass
-					//
-					// count the number of vertices in face
-					//
-					char* pch = strtok(lineBuf + 2, " ");
-					unsigned int faceVertexCount = 0;
+	const uint32_t* pTriples = (const uint32_t*)pTable->triples.pData;
 
-					while(pch != NULL)
-					{
-						faceVertexCount++; // track number of vertices found in face
-						pch = strtok(NULL, " ");
-					}
+	for(size_t i = 0; i < pTable->triples.size / 3; ++i)
+	{
+		pTable->pSlots[findVertexSlot(pTable, pTriples + i * 3)] = (uint32_t)(i + 1);
+	}
+}
 
-					assert(pFaceSizes != NULL);
+// Function to get the (zero-based) number of the triple "pTriple" in "pTable", where the triple is
+// added if it is not in the table yet
+static uint32_t findOrAddVertex(ObjVertexTable* pTable, const uint32_t* pTriple)
+{
+	const size_t slot = findVertexSlot(pTable, pTriple);
 
-					(*pFaceSizes)[faceId] = faceVertexCount;
+	if(pTable->pSlots[slot] != 0)
+	{
+		return pTable->pSlots[slot] - 1;
+	}
 
-					nFaceIndices += faceVertexCount;
-				}
-				else if(passIterator == 2) // third pass
-				{
+	const size_t numVertices = pTable->triples.size / 3;
 
-					//
-					// allocate mem for the number of vertices in face
-					//
-
-					assert(pFaceSizes != NULL);
-
-					const unsigned int faceVertexCount = (*pFaceSizes)[faceId];
-					//printf("lineBuf = %s\n", lineBuf);
-					int iter = 0; // incremented per vertex of face
-
-					char* token = NULL;
-					char* tokenElem = NULL;
-					char* buf = NULL; // char buf[512];
-
-					// for each vertex in face
-					for(token = strtok(lineBuf, " "); token != NULL;
-						token = strtok(token + strlen(token) + 1, " "))
-					{
-
-						token[strcspn(token, "\r\n")] =
-							'\0'; // strip newline and carriage return (issue on windows)
-
-						//printf("token: %s\n", token);
-
-						const size_t tokenLen = strlen(token) + 1; // +1 for null terminator character
-
-						if(tokenLen == 0)
-						{
-							break; // done
-						}
-
-						// allocate enough to accomodate all characters on the line since a face can be defined by an
-						// arbitrary number of vertices whose indices typically require several digits.
-						buf = (char*)realloc(buf, sizeof(char) * tokenLen);
-
-						memset(buf, '\0', tokenLen);
-
-						strncpy(buf, token, tokenLen);
-
-						if(buf[0] == 'f')
-						{
-							continue;
-						}
-
-						iter++;
-						int faceVertexDataIt = 0; // vertex id/texcoord id/normal id
-
-						// printf("buf: %s\n", buf);
-
-						// for each data element of a face-vertex
-						for(
-							tokenElem = strtok(buf, "/"); 
-							tokenElem != NULL;
-							tokenElem = strtok(tokenElem + strlen(tokenElem), "/"))
-						{
-
-							// distance from the beginning of "buf", where "buf" contains a small string
-							// about the current face-vectex e.g. "3/5" or "3" or "2/1/5" or "5//3"
-							ptrdiff_t distFromBufStart = (tokenElem - buf);
-							//printf("\tdistFromBufStart: %td\n", distFromBufStart);
-
-							if(distFromBufStart >= tokenLen) // TODO: test this!!!
-							{
-								// NOTE: "tokenElem + strlen(tokenElem) + 1" can point to some undefined region of mem if "tokenElem" is the last element).
-								break;
-							}
-
-							//printf("\ttokenElem: %s\n", tokenElem);
-
-							const bool haveTexCoords = (nTexCoords > 0);
-
-							if(faceVertexDataIt == 1 && !haveTexCoords)
-							{
-								faceVertexDataIt = 2;
-							}
-
-							int val;
-							int sscanfRet =
-								sscanf(tokenElem, "%d", &val); // extract face vertex data index
-
-							switch(faceVertexDataIt)
-							{
-							case 0: // vertex id
-								(*pFaceVertexIndices)[faceIndicesCounter] = (unsigned int)(val - 1);
-								break;
-							case 1: // texcooord id
-								(*pFaceVertexTexCoordIndices)[faceIndicesCounter] =
-									(unsigned int)(val - 1);
-								break;
-							case 2: // normal id
-								(*pFaceVertexNormalIndices)[faceIndicesCounter] =
-									(unsigned int)(val - 1);
-								break;
-							default:
-								break;
-							}
-
-							faceVertexDataIt++;
-						}
-						faceIndicesCounter += 1;
-					}
-
-					if(buf != NULL)
-					{
-						free(buf);
-						buf = NULL;
-					}
-
-					if(iter != (int)faceVertexCount)
-					{
-						fprintf(stderr,
-								"error: have %d vertices when there should be =%d\n",
-								iter,
-								faceVertexCount);
-						abort();
-					}
-				}
-			}
-			break;
-			default:
-				break;
-			} // switch (cmdType) {
-		}
+	if(numVertices >= UINT32_MAX - 1)
+	{
+		mioLogError("error: too many distinct face-vertices for 32-bit indices\n");
+		mioFail(MIO_STATUS_TOO_LARGE);
+	}
 
-		if(passIterator == 0) // first pass
-		{
+	mioArrayReserve(&pTable->triples, sizeof(uint32_t), pTable->triples.size + 3);
+	memcpy((uint32_t*)pTable->triples.pData + pTable->triples.size, pTriple, 3 * sizeof(uint32_t));
+	pTable->triples.size += 3;
+	pTable->pSlots[slot] = (uint32_t)(numVertices + 1);
+
+	// NOTE: the table is kept at most half full, so that the probe sequences stay short
+	if((numVertices + 1) * 2 > pTable->numSlots)
+	{
+		resizeVertexTable(pTable, pTable->numSlots * 2);
+	}
 
-			printf("\t%d positions\n", nVertices);
+	return (uint32_t)numVertices;
+}
 
-			if(nVertices > 0)
-			{
-				*pVertices = (double*)malloc(nVertices * sizeof(double) * 3);
-				memset(*pVertices, 0, nVertices * sizeof(unsigned int));
-			}
+// Function to parse the face-vertex data on a face line (starting after the "f" command) of an
+// indexed mesh, where the index triple of each face-vertex is looked up in the vertex table of
+// "pChunk" and the number of the triple is appended to the face-vertex indices (as the only face
+// index). NOTE: indexed meshes are parsed serially from the start of the file, so that relative
+// ids are made absolute as they are parsed.
+static void parseIndexedFace(ObjChunk* pChunk, const char* pLine, const char* pLineEnd)
+{
+	const size_t counts[3] = {pChunk->nVertices, pChunk->nTexCoords, pChunk->nNormals};
+	unsigned int faceVertexCount = 0;
+	const char* pToken = mioSkipBlanks(pLine, pLineEnd);
 
-			printf("\t%d normals\n", nNormals);
+	while(pToken != pLineEnd)
+	{
+		int64_t ids[3] = {1, 1, 1}; // NOTE: ids that are not found keep the smallest valid id
+		unsigned int found = 0;
+		const char* pTokenEnd = parseFaceVertex(pToken, pLineEnd, ids, &found);
 
-			if(nNormals > 0)
-			{
-				*pNormals = (double*)malloc(nNormals * sizeof(double) * 3);
-				memset(*pNormals, 0, nNormals * sizeof(unsigned int));
-			}
+		pToken = mioSkipBlanks(pTokenEnd, pLineEnd);
 
-			printf("\t%d texture-coords\n", nTexCoords);
+		if((found & 1u) == 0)
+		{
+			continue; // ... skip to next token
+		}
 
-			if(nTexCoords > 0)
-			{
-				*pTexCoords = (double*)malloc(nTexCoords * sizeof(double) * 2);
-				memset(*pTexCoords, 0, nTexCoords * sizeof(unsigned int));
-			}
+		uint32_t triple[3] = {0, 0, 0};
 
-			printf("\t%d face(s)\n", nFaces);
+		for(int i = 0; i < 3; ++i)
+		{
+			const int64_t index = toIndex(ids[i], counts[i]);
 
-			if(nFaces > 0)
+			if(index < 0 || index > (int64_t)UINT32_MAX)
 			{
-				*pFaceSizes = (unsigned int*)malloc(nFaces * sizeof(unsigned int));
-				memset(*pFaceSizes, 0, nFaces * sizeof(unsigned int));
+				mioLogError("error: face index %lld is out of range\n", (long long)ids[i]);
+				mioFail(MIO_STATUS_MALFORMED);
 			}
 
-			*numVertices = nVertices;
-			*numNormals = nNormals;
-			*numTexcoords = nTexCoords, *numFaces = nFaces;
+			triple[i] = (uint32_t)index;
 		}
 
-		if(passIterator == 1) // second pass
-		{
-			printf("\t%d face indices\n", nFaceIndices);
+		mioArrayPushUint(&pChunk->faceVertexIndices, findOrAddVertex(pChunk->pVertexTable, triple));
 
-			if(nFaceIndices == 0)
-			{
-				fprintf(stderr, "error: invalid face index count %d\n", nFaceIndices);
-				abort();
-			}
+		pChunk->nFaceIndices++;
+		faceVertexCount++;
+	}
 
-			*pFaceVertexIndices = (unsigned int*)malloc(nFaceIndices * sizeof(unsigned int));
-			memset(*pFaceVertexIndices, 0, nFaceIndices * sizeof(unsigned int));
+	mioArrayPushUint(&pChunk->faceSizes, faceVertexCount);
+	pChunk->nFaces++;
+}
 
-			if(nTexCoords > 0)
-			{
-				printf("\t%d tex-coord indices\n", nFaceIndices);
+// Function to parse the face-vertex data on a face line (starting after the "f" command) and
+// append it to the face arrays of "pChunk"
+static void parseFace(ObjChunk* pChunk, const char* pLine, const char* pLineEnd)
+{
+	if(pChunk->pVertexTable != NULL)
+	{
+		parseIndexedFace(pChunk, pLine, pLineEnd);
+		return;
+	}
 
-				*pFaceVertexTexCoordIndices =
-					(unsigned int*)malloc(nFaceIndices * sizeof(unsigned int));
-				memset(*pFaceVertexTexCoordIndices, 0, nFaceIndices * sizeof(unsigned int));
-			}
+	unsigned int faceVertexCount = 0;
+	const char* pToken = mioSkipBlanks(pLine, pLineEnd);
 
-			if(nNormals > 0)
-			{
-				printf("\t%d normal indices\n", nFaceIndices);
+	// for each vertex in face
+	while(pToken != pLineEnd)
+	{
+		int64_t ids[3] = {1, 1, 1}; // NOTE: ids that are not found keep the smallest valid id
+		unsigned int found = 0;
+		const char* pTokenEnd = parseFaceVertex(pToken, pLineEnd, ids, &found);
 
-				*pFaceVertexNormalIndices =
-					(unsigned int*)malloc(nFaceIndices * sizeof(unsigned int));
-				memset(*pFaceVertexNormalIndices, 0, nFaceIndices * sizeof(unsigned int));
-			}
+		pToken = mioSkipBlanks(pTokenEnd, pLineEnd);
+
+		if((found & 1u) == 0)
+		{
+			continue; // ... skip to next token
 		}
 
-		if(fsetpos(file, &startOfFile) != 0) /* reset current position to start of file */
+		// NOTE: the ids are absolute and 1 to 2^32 in all but the rarest of files, while relative
+		// (negative) and larger ids are stored by "setWideFaceVertex"
+		if(pChunk->indexSize != sizeof(uint32_t) ||
+		   (uint64_t)((ids[0] - 1) | (ids[1] - 1) | (ids[2] - 1)) > UINT32_MAX)
 		{
-			if(ferror(file))
+			setWideFaceVertex(pChunk, ids, found);
+		}
+		else
+		{
+			mioArrayPushUint(&pChunk->faceVertexIndices, (unsigned int)(ids[0] - 1));
+
+			if((found & 2u) != 0) // texcooord id
+			{
+				mioArraySetUint(&pChunk->faceVertexTexCoordIndices,
+								pChunk->nFaceIndices,
+								(unsigned int)(ids[1] - 1));
+			}
+
+			if((found & 4u) != 0) // normal id
 			{
-				perror("fsetpos()");
-				fprintf(stderr,
-						"fsetpos() failed in file %s at lineBuf # %d\n",
-						__FILE__,
-						__LINE__ - 5);
-				exit(EXIT_FAILURE);
+				mioArraySetUint(&pChunk->faceVertexNormalIndices,
+								pChunk->nFaceIndices,
+								(unsigned int)(ids[2] - 1));
 			}
 		}
-	} while(++passIterator < 3);
 
-	//
-	// finish, and free up memory
-	//
-	if(lineBuf != NULL)
-	{
-		free(lineBuf);
+		pChunk->nFaceIndices++;
+		faceVertexCount++; // track number of vertices found in face
 	}
 
-	fclose(file);
-
-	printf("done.\n");
+	mioArrayPushUint(&pChunk->faceSizes, faceVertexCount);
+	pChunk->nFaces++;
 }
 
-void mioWriteOBJ(
-	// absolute path to file
-	const char* fpath,
-	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
-	double* pVertices,
-	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
-	double* pNormals,
-	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
-	double* pTexCoords,
-	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
-	unsigned int* pFaceSizes,
-	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
-	unsigned int* pFaceVertexIndices,
-	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
-	unsigned int* pFaceVertexTexCoordIndices,
-	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
-	unsigned int* pFaceVertexNormalIndices,
-	// number of vertices in "pVertices"
-	unsigned int numVertices,
-	// number of vertex normals in "pNormals"
-	unsigned int numNormals,
-	// number of texture coordinates in "pTexCoords"
-	unsigned int numTexcoords,
-	// number of faces
-	unsigned int numFaces)
+// Function to determine the type of "command" in the object file that is contained on the line
+// [pLine, pLineEnd). Empty lines, comments and unrecognised commands give UNKNOWN.
+static enum ObjFileCmdType parseCmdType(const char* pLine, const char* pLineEnd)
 {
-	fprintf(stdout, "write .obj file: %s\n", fpath);
+	const size_t lineLen = (size_t)(pLineEnd - pLine);
 
-	FILE* file = fopen(fpath, "w"); // open our file
+	const bool lineIsEmpty = (lineLen == 0);
 
-	if(file == NULL)
+	if(lineIsEmpty)
 	{
-		fprintf(stderr, "error: failed to open file '%s'", fpath);
-		return; // exit(1);
+		return UNKNOWN;
 	}
 
-	printf("vertices %u\n", numVertices);
+	const bool lineIsComment = pLine[0] == '#';
 
-	// for each position
-	for(unsigned int i = 0; i < (unsigned int)numVertices; ++i)
+	if(lineIsComment)
 	{
-
-		const double x = pVertices[i * 3u + 0u];
-		const double y = pVertices[i * 3u + 1u];
-		const double z = pVertices[i * 3u + 2u];
-
-		fprintf(file, "v %f %f %f\n", x, y, z);
+		return UNKNOWN;
 	}
 
-	printf("normals %u\n", numNormals);
+	enum ObjFileCmdType cmdType = UNKNOWN;
 
-	// for each normal
-	for(unsigned int i = 0; i < (unsigned int)numNormals; ++i)
+	if(lineLen >= 2 && pLine[0] == 'v' && pLine[1] == ' ')
 	{
-
-		const double x = pNormals[i * 3u + 0u];
-		const double y = pNormals[i * 3u + 1u];
-		const double z = pNormals[i * 3u + 2u];
-
-		fprintf(file, "vn %f %f %f\n", x, y, z);
+		cmdType = VERTEX;
 	}
-
-	printf("texcoords %u\n", numTexcoords);
-
-	// for each texcoord
-	for(unsigned int i = 0; i < (unsigned int)numTexcoords; ++i)
+	else if(lineLen >= 3 && pLine[0] == 'v' && pLine[1] == 'n' && pLine[2] == ' ')
 	{
-
-		const double s = pTexCoords[i * 2u + 0u];
-		const double t = pTexCoords[i * 2u + 1u];
-
-		fprintf(file, "vt %f %f\n", s, t);
+		cmdType = NORMAL;
+	}
+	else if(lineLen >= 3 && pLine[0] == 'v' && pLine[1] == 't' && pLine[2] == ' ')
+	{
+		cmdType = TEXCOORD;
+	}
+	else if(lineLen >= 2 && pLine[0] == 'f' && pLine[1] == ' ')
+	{
+		cmdType = FACE;
+	}
+	else
+	{
+		assert(cmdType == UNKNOWN);
+		//mioLogNote("note: skipping unrecognised command '%.*s'\n", (int)lineLen, pLine);
 	}
 
-	unsigned int base = 0;
+	return cmdType;
+}
 
-	printf("faces %u\n", numFaces);
+// Function to parse all lines of "pInput" into "pChunk"
+static void parseLines(MioInput* pInput, ObjChunk* pChunk)
+{
+	// the current line (excluding the line terminator)
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
 
-	// for each face
-	for(unsigned int f = 0; f < numFaces; ++f)
-	{
+	while(mioInputNextLine(pInput, &pLine, &pLineEnd))
+	{ // each iteration will parse a line in the file
 
-		int faceSize = pFaceSizes[f];
+		//
+		// In the following, we determine the type of "command" in the object
+		// file that is contained on the current line.
+		//
 
-		fprintf(file, "f ");
+		const enum ObjFileCmdType cmdType = parseCmdType(pLine, pLineEnd);
 
-		// for each vertex in face
-		for(int v = 0; v < faceSize; v++)
+		//
+		// Now that we know the type of command whose data is on the current line,
+		// we can go ahead and parse the line in a command-specific way
+		//
+		switch(cmdType)
 		{
-			// Note: obj file indices start from 1
-			const unsigned int vertexIdx = pFaceVertexIndices[base + v] + 1;
+		case VERTEX: { // parsing vertex coordinates
+			const size_t vertexId = pChunk->nVertices++; // incremental vertex count
 
-			const bool isLastVertex = (v == (faceSize - 1));
+			const size_t nread = parseCoords(pChunk, &pChunk->vertices, pLine + 2, pLineEnd, 3);
 
-			if(numNormals > 0 && numTexcoords > 0)
-			{
-				const unsigned int normalIdx = pFaceVertexNormalIndices[base + v] + 1;
-				const unsigned int texCoordIdx = pFaceVertexTexCoordIndices[base + v] + 1;
-				fprintf(file, "%u/%u/%u", vertexIdx, texCoordIdx, normalIdx);
-			}
-			else if(numNormals > 0)
-			{
-				const unsigned int normalIdx = pFaceVertexNormalIndices[base + v] + 1;
-				fprintf(file, "%u//%u", vertexIdx, normalIdx);
-			}
-			else if(numTexcoords > 0)
+			if(nread != 3)
 			{
-				const unsigned int texCoordIdx = pFaceVertexTexCoordIndices[base + v] + 1;
-				fprintf(file, "%u/%u", vertexIdx, texCoordIdx);
+				mioLogError("error: have %zu components for v%zu\n", nread, vertexId);
+				mioFail(MIO_STATUS_MALFORMED);
 			}
-			else
+		}
+		break;
+		case NORMAL: { // parsing normal coordinates
+			const size_t normalId = pChunk->nNormals++; // incremental vertex-normal count
+
+			const size_t nread = parseCoords(pChunk, &pChunk->normals, pLine + 3, pLineEnd, 3);
+
+			if(nread != 3)
 			{
-				fprintf(file, "%u", vertexIdx);
+				mioLogError("error: have %zu components for vn%zu\n", nread, normalId);
+				mioFail(MIO_STATUS_MALFORMED);
 			}
+		}
+		break;
+		case TEXCOORD: { // parsing texture coordinates
+			const size_t texCoordId = pChunk->nTexCoords++; // incremental tex coord count
 
-			if(!isLastVertex)
+			const size_t nread = parseCoords(pChunk, &pChunk->texCoords, pLine + 3, pLineEnd, 2);
+
+			if(nread != 2)
 			{
-				fprintf(file,
-						" "); // add space between face-vertex components i.e. a/b/c d/e/f g/h/i
+				mioLogError("error: have %zu components for vt%zu\n", nread, texCoordId);
+				mioFail(MIO_STATUS_MALFORMED);
 			}
 		}
+		break;
+		case FACE: { // parsing faces
+			parseFace(pChunk, pLine + 2, pLineEnd);
+		}
+		break;
+		default:
+			break;
+		} // switch (cmdType) {
+	}
+}
+
+// Function to parse "count" coordinates from the line [p, pEnd) and pass them to "onCoords" (if
+// any), where "pCmd" and "id" identify the element in error messages
+static void visitCoords(void (*onCoords)(const double*, void*),
+						void* pUserData,
+						const char* p,
+						const char* pEnd,
+						size_t count,
+						const char* pCmd,
+						size_t id)
+{
+	if(onCoords == NULL)
+	{
+		return; // nothing to parse
+	}
 
-		fprintf(file, "\n");
+	double values[3] = {0.0, 0.0, 0.0};
+	const size_t nread = mioParseDoubles(p, pEnd, values, count);
 
-		base += faceSize;
+	if(nread != count)
+	{
+		mioLogError("error: have %zu components for %s%zu\n", nread, pCmd, id);
+		mioFail(MIO_STATUS_MALFORMED);
 	}
 
-	fclose(file);
+	onCoords(values, pUserData);
+}
+
+// Function to parse the face-vertex data on a face line (starting after the "f" command) and pass
+// it to the "onFace" callback of "pVisitor". The indices of a face are gathered in "pIndices"
+// (three arrays for the vertex, texcoord and normal ids), which are reused from face to face.
+// "pCounts" holds the number of vertices, texcoords and normals that precede the face.
+static void visitFace(const MioVisitor* pVisitor,
+					  MioArray* pIndices,
+					  const size_t* pCounts,
+					  const char* pLine,
+					  const char* pLineEnd)
+{
+	unsigned int faceVertexCount = 0;
+	unsigned int foundAny = 0; // bitwise-or of the ids that were found in the face
+	const char* pToken = mioSkipBlanks(pLine, pLineEnd);
+
+	// for each vertex in face
+	while(pToken != pLineEnd)
+	{
+		int64_t ids[3] = {0, 0, 0};
+		unsigned int found = 0;
+		const char* pTokenEnd = parseFaceVertex(pToken, pLineEnd, ids, &found);
+
+		pToken = mioSkipBlanks(pTokenEnd, pLineEnd);
 
-	printf("done.\n");
-}
\ No newline at end of file
+		if((found & 1u) == 0)
+		{
+			continue; // ... skip to next token
+		}
+
+		for(int i = 0; i < 3; ++i)
+		{
+			// NOTE: like the array readers, a missing texcoord/normal id is stored as 0
+			const int64_t id = ((found >> i) & 1u) ? toIndex(ids[i], pCounts[i]) : 0;
+
+			if(id < 0 || id > (int64_t)UINT32_MAX)
+			{
+				mioLogError("error: face index %lld does not fit in 32 bits\n", (long long)id);
+				mioFail(MIO_STATUS_TOO_LARGE);
+			}
+
+			mioArraySetUint(&pIndices[i], faceVertexCount, (unsigned int)id);
+		}
+
+		foundAny |= found;
+		faceVertexCount++; // track number of vertices found in face
+	}
+
+	pVisitor->onFace((const unsigned int*)pIndices[0].pData,
+					 (foundAny & 2u) ? (const unsigned int*)pIndices[1].pData : NULL,
+					 (foundAny & 4u) ? (const unsigned int*)pIndices[2].pData : NULL,
+					 faceVertexCount,
+					 pVisitor->pUserData);
+
+	for(int i = 0; i < 3; ++i)
+	{
+		pIndices[i].size = 0; // keep the memory for the next face
+	}
+}
+
+// Function to parse all lines of "pInput" and pass the elements to the callbacks of "pVisitor"
+static void visitLines(MioInput* pInput, const MioVisitor* pVisitor)
+{
+	// the current line (excluding the line terminator)
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
+
+	size_t nVertices = 0;
+	size_t nNormals = 0;
+	size_t nTexCoords = 0;
+	size_t nFaces = 0;
+
+	MioArray indices[3] = {{NULL, 0, 0}, {NULL, 0, 0}, {NULL, 0, 0}};
+
+	while(mioInputNextLine(pInput, &pLine, &pLineEnd))
+	{ // each iteration will parse a line in the file
+		const enum ObjFileCmdType cmdType = parseCmdType(pLine, pLineEnd);
+
+		switch(cmdType)
+		{
+		case VERTEX: {
+			visitCoords(
+				pVisitor->onVertex, pVisitor->pUserData, pLine + 2, pLineEnd, 3, "v", nVertices++);
+		}
+		break;
+		case NORMAL: {
+			visitCoords(
+				pVisitor->onNormal, pVisitor->pUserData, pLine + 3, pLineEnd, 3, "vn", nNormals++);
+		}
+		break;
+		case TEXCOORD: {
+			visitCoords(pVisitor->onTexCoord,
+						pVisitor->pUserData,
+						pLine + 3,
+						pLineEnd,
+						2,
+						"vt",
+						nTexCoords++);
+		}
+		break;
+		case FACE: {
+			if(pVisitor->onFace != NULL)
+			{
+				const size_t counts[3] = {nVertices, nTexCoords, nNormals};
+				visitFace(pVisitor, indices, counts, pLine + 2, pLineEnd);
+			}
+			nFaces++;
+		}
+		break;
+		default:
+			break;
+		} // switch (cmdType) {
+	}
+
+	mioLogInfo("\t%zu positions\n", nVertices);
+	mioLogInfo("\t%zu normals\n", nNormals);
+	mioLogInfo("\t%zu texture-coords\n", nTexCoords);
+	mioLogInfo("\t%zu face(s)\n", nFaces);
+
+	for(int i = 0; i < 3; ++i)
+	{
+		mioMemFree(indices[i].pData);
+	}
+}
+
+static void freeChunk(ObjChunk* pChunk)
+{
+	mioMemFree(pChunk->vertices.pData);
+	mioMemFree(pChunk->normals.pData);
+	mioMemFree(pChunk->texCoords.pData);
+	mioMemFree(pChunk->faceSizes.pData);
+	mioMemFree(pChunk->faceVertexIndices.pData);
+	mioMemFree(pChunk->faceVertexTexCoordIndices.pData);
+	mioMemFree(pChunk->faceVertexNormalIndices.pData);
+	mioMemFree(pChunk->relativeIndices.pData);
+
+	initChunk(pChunk, pChunk->coordSize);
+}
+
+static void printCounts(size_t nVertices,
+						size_t nNormals,
+						size_t nTexCoords,
+						size_t nFaces,
+						size_t nFaceIndices)
+{
+	mioLogInfo("\t%zu positions\n", nVertices);
+	mioLogInfo("\t%zu normals\n", nNormals);
+	mioLogInfo("\t%zu texture-coords\n", nTexCoords);
+	mioLogInfo("\t%zu face(s)\n", nFaces);
+	mioLogInfo("\t%zu face indices\n", nFaceIndices);
+
+	if(nFaceIndices == 0)
+	{
+		mioLogError("error: invalid face index count %zu\n", nFaceIndices);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	if(nTexCoords > 0)
+	{
+		mioLogInfo("\t%zu tex-coord indices\n", nFaceIndices);
+	}
+
+	if(nNormals > 0)
+	{
+		mioLogInfo("\t%zu normal indices\n", nFaceIndices);
+	}
+}
+
+// Funcion to read in an obj file that stores a single 3D mesh object (in ASCII
+// format). The pointer parameters will be allocated inside this function and must
+// be freed by caller. The function only handles polygonal faces, so commands like
+// "vp" command (which is used to specify control points of the surface or curve)
+// are ignored if encountered in file.
+void mioReadOBJ(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	double** pVertices,
+	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+	double** pNormals,
+	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
+	double** pTexCoords,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int** pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+	unsigned int** pFaceVertexIndices,
+	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexTexCoordIndices,
+	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexNormalIndices,
+	// number of vertices in "pVertices"
+	unsigned int* numVertices,
+	// number of vertex normals in "pNormals"
+	unsigned int* numNormals,
+	// number of texture coordinates in "pTexCoords"
+	unsigned int* numTexcoords,
+	// number of faces
+	unsigned int* numFaces)
+{
+	mioReadOBJParallel(fpath,
+					   pVertices,
+					   pNormals,
+					   pTexCoords,
+					   pFaceSizes,
+					   pFaceVertexIndices,
+					   pFaceVertexTexCoordIndices,
+					   pFaceVertexNormalIndices,
+					   numVertices,
+					   numNormals,
+					   numTexcoords,
+					   numFaces,
+					   1);
+}
+
+// smallest number of bytes that is worth parsing on a separate thread
+#define MIN_BYTES_PER_CHUNK (1u << 20)
+
+// state of a worker thread in "readOBJ"
+typedef struct ObjChunkTask
+{
+	// the range of lines to parse
+	const char* pBegin;
+	const char* pEnd;
+	ObjChunk chunk;
+	// number of lines in the chunk
+	size_t numLines;
+	// offsets of the chunk's elements in the output arrays (set after all chunks are parsed)
+	size_t vertexOffset;
+	size_t normalOffset;
+	size_t texCoordOffset;
+	size_t faceOffset;
+	size_t faceIndexOffset;
+	// the output arrays (where the coordinate arrays hold doubles or floats, and the face index
+	// arrays hold elements of "indexSize" bytes). Arrays that are NULL are not written.
+	char* pVertices;
+	char* pNormals;
+	char* pTexCoords;
+	// number of bytes from one point of the output coordinate arrays to the next
+	size_t vertexStride;
+	size_t normalStride;
+	size_t texCoordStride;
+	unsigned int* pFaceSizes;
+	void* pFaceVertexIndices;
+	void* pFaceVertexTexCoordIndices;
+	void* pFaceVertexNormalIndices;
+	size_t indexSize;
+} ObjChunkTask;
+
+static void parseChunkTask(void* pArg)
+{
+	ObjChunkTask* pTask = (ObjChunkTask*)pArg;
+	MioInput input;
+
+	mioInputOpenRange(&input, pTask->pBegin, pTask->pEnd);
+	parseLines(&input, &pTask->chunk);
+	pTask->numLines = input.numLines;
+	mioInputClose(&input);
+}
+
+// Function to copy "count" indices of "pArray" (which may hold fewer, of "srcIndexSize" bytes) to
+// element "offset" of "pDst" (with elements of "dstIndexSize" bytes), zero-filling the remainder
+static void copyIndicesZeroFilled(void* pDst,
+								  size_t dstIndexSize,
+								  size_t offset,
+								  const MioArray* pArray,
+								  size_t srcIndexSize,
+								  size_t count)
+{
+	const size_t available = (pArray->size < count) ? pArray->size : count;
+	char* pDstBegin = (char*)pDst + offset * dstIndexSize;
+
+	if(dstIndexSize == srcIndexSize)
+	{
+		if(available > 0)
+		{
+			memcpy(pDstBegin, pArray->pData, available * srcIndexSize);
+		}
+	}
+	else // NOTE: indices are only ever widened
+	{
+		const uint32_t* pSrc = (const uint32_t*)pArray->pData;
+		uint64_t* pWide = (uint64_t*)pDstBegin;
+
+		for(size_t i = 0; i < available; ++i)
+		{
+			pWide[i] = pSrc[i];
+		}
+	}
+
+	memset(pDstBegin + available * dstIndexSize, 0, (count - available) * dstIndexSize);
+}
+
+// Function to copy the "count" points of "pArray" (of "pointSize" bytes each) to point "offset" of
+// "pDst", whose points are "dstStride" bytes apart
+static void copyCoords(char* pDst,
+					   size_t dstStride,
+					   size_t offset,
+					   const MioArray* pArray,
+					   size_t count,
+					   size_t pointSize)
+{
+	if(pDst == NULL || count == 0)
+	{
+		return;
+	}
+
+	char* pDstBegin = pDst + offset * dstStride;
+
+	if(dstStride == pointSize)
+	{
+		memcpy(pDstBegin, pArray->pData, count * pointSize);
+		return;
+	}
+
+	const char* pSrc = (const char*)pArray->pData;
+
+	for(size_t i = 0; i < count; ++i)
+	{
+		memcpy(pDstBegin + i * dstStride, pSrc + i * pointSize, pointSize);
+	}
+}
+
+static void copyChunkTask(void* pArg)
+{
+	ObjChunkTask* pTask = (ObjChunkTask*)pArg;
+	ObjChunk* pChunk = &pTask->chunk;
+	const size_t coordSize = pChunk->coordSize;
+
+	copyCoords(pTask->pVertices,
+			   pTask->vertexStride,
+			   pTask->vertexOffset,
+			   &pChunk->vertices,
+			   pChunk->nVertices,
+			   3 * coordSize);
+	copyCoords(pTask->pNormals,
+			   pTask->normalStride,
+			   pTask->normalOffset,
+			   &pChunk->normals,
+			   pChunk->nNormals,
+			   3 * coordSize);
+	copyCoords(pTask->pTexCoords,
+			   pTask->texCoordStride,
+			   pTask->texCoordOffset,
+			   &pChunk->texCoords,
+			   pChunk->nTexCoords,
+			   2 * coordSize);
+
+	if(pChunk->nFaces > 0 && pTask->pFaceSizes != NULL)
+	{
+		memcpy(pTask->pFaceSizes + pTask->faceOffset,
+			   pChunk->faceSizes.pData,
+			   pChunk->nFaces * sizeof(unsigned int));
+	}
+
+	if(pChunk->nFaces > 0 && pTask->pFaceVertexIndices != NULL)
+	{
+		copyIndicesZeroFilled(pTask->pFaceVertexIndices,
+							  pTask->indexSize,
+							  pTask->faceIndexOffset,
+							  &pChunk->faceVertexIndices,
+							  pChunk->indexSize,
+							  pChunk->nFaceIndices);
+	}
+
+	if(pTask->pFaceVertexTexCoordIndices != NULL)
+	{
+		copyIndicesZeroFilled(pTask->pFaceVertexTexCoordIndices,
+							  pTask->indexSize,
+							  pTask->faceIndexOffset,
+							  &pChunk->faceVertexTexCoordIndices,
+							  pChunk->indexSize,
+							  pChunk->nFaceIndices);
+	}
+
+	if(pTask->pFaceVertexNormalIndices != NULL)
+	{
+		copyIndicesZeroFilled(pTask->pFaceVertexNormalIndices,
+							  pTask->indexSize,
+							  pTask->faceIndexOffset,
+							  &pChunk->faceVertexNormalIndices,
+							  pChunk->indexSize,
+							  pChunk->nFaceIndices);
+	}
+
+	void* const pDst[3] = {pTask->pFaceVertexIndices,
+						   pTask->pFaceVertexTexCoordIndices,
+						   pTask->pFaceVertexNormalIndices};
+	const size_t offsets[3] = {pTask->vertexOffset, pTask->texCoordOffset, pTask->normalOffset};
+
+	resolveRelativeIndices(pChunk, pDst, pTask->indexSize, pTask->faceIndexOffset, offsets);
+
+	freeChunk(pChunk);
+}
+
+// the arrays that are read from an .obj file, where the coordinates are doubles or floats, the
+// face indices are 32- or 64-bit (and arrays without elements are NULL)
+typedef struct ObjMesh
+{
+	void* pVertices;
+	void* pNormals;
+	void* pTexCoords;
+	unsigned int* pFaceSizes;
+	void* pFaceVertexIndices;
+	void* pFaceVertexTexCoordIndices;
+	void* pFaceVertexNormalIndices;
+
+	size_t nVertices;
+	size_t nNormals;
+	size_t nTexCoords;
+	size_t nFaces;
+	size_t nFaceIndices;
+	size_t indexSize; // sizeof(uint32_t) or sizeof(uint64_t)
+} ObjMesh;
+
+// Function to get the number of chunks that the lines of "pInput" are split into, to be parsed on
+// up to "numThreads" threads (0 = number of hardware threads). A streamed input is only available
+// one window at a time, so it can only be parsed serially (as a single chunk). Otherwise, the file
+// is split at line boundaries into chunks of at least MIN_BYTES_PER_CHUNK.
+static size_t getChunkCount(const MioInput* pInput, unsigned int numThreads)
+{
+	if(numThreads == 0)
+	{
+		numThreads = mioGetHardwareThreadCount();
+	}
+
+	const size_t inputSize = (size_t)(pInput->pEnd - pInput->pCur);
+	size_t numChunks = 1;
+
+	if(numThreads > 1 && pInput->atEnd)
+	{
+		numChunks = inputSize / MIN_BYTES_PER_CHUNK;
+		numChunks = (numChunks < numThreads) ? numChunks : numThreads;
+		numChunks = (numChunks > 0) ? numChunks : 1;
+	}
+
+	return numChunks;
+}
+
+// Function to split the lines of "pInput" into "numChunks" chunks (see "getChunkCount") and to
+// parse them into the chunks of the returned tasks, each on its own thread. A single chunk is
+// parsed straight from "pInput" (which can then be streamed).
+static ObjChunkTask* parseChunks(MioInput* pInput, size_t numChunks, size_t coordSize)
+{
+	ObjChunkTask* pTasks = (ObjChunkTask*)mioAllocate(numChunks, sizeof(ObjChunkTask));
+	memset(pTasks, 0, numChunks * sizeof(ObjChunkTask));
+
+	if(numChunks == 1)
+	{
+		initChunk(&pTasks[0].chunk, coordSize);
+		parseLines(pInput, &pTasks[0].chunk);
+		return pTasks;
+	}
+
+	const size_t inputSize = (size_t)(pInput->pEnd - pInput->pCur);
+	const char* pChunkBegin = pInput->pCur;
+
+	for(size_t i = 0; i < numChunks; ++i)
+	{
+		// each chunk ends after the first newline at (or after) its nominal end
+		const char* pChunkEnd = pInput->pEnd;
+
+		if(i + 1 < numChunks)
+		{
+			const char* pNominalEnd = pInput->pCur + (inputSize / numChunks) * (i + 1);
+
+			if(pNominalEnd < pChunkBegin)
+			{
+				pNominalEnd = pChunkBegin;
+			}
+
+			const char* pNewline =
+				(const char*)memchr(pNominalEnd, '\n', (size_t)(pInput->pEnd - pNominalEnd));
+			pChunkEnd = (pNewline != NULL) ? pNewline + 1 : pInput->pEnd;
+		}
+
+		pTasks[i].pBegin = pChunkBegin;
+		pTasks[i].pEnd = pChunkEnd;
+		initChunk(&pTasks[i].chunk, coordSize);
+		pChunkBegin = pChunkEnd;
+	}
+
+	// NOTE: the calling thread parses the first chunk
+	mioRunTasks(parseChunkTask, pTasks, sizeof(ObjChunkTask), numChunks);
+
+	return pTasks;
+}
+
+// Function to compute the offset of each chunk's elements in the output arrays with a prefix sum
+// over the per-chunk counts, where the total counts (and the index size of the output arrays) are
+// stored in "pMesh" (whose arrays are not touched)
+static void sumChunkCounts(ObjChunkTask* pTasks, size_t numChunks, MioInput* pInput, ObjMesh* pMesh)
+{
+	size_t nVertices = 0;
+	size_t nNormals = 0;
+	size_t nTexCoords = 0;
+	size_t nFaces = 0;
+	size_t nFaceIndices = 0;
+	size_t indexSize = sizeof(uint32_t); // the largest index size of any chunk
+
+	for(size_t i = 0; i < numChunks; ++i)
+	{
+		pTasks[i].vertexOffset = nVertices;
+		pTasks[i].normalOffset = nNormals;
+		pTasks[i].texCoordOffset = nTexCoords;
+		pTasks[i].faceOffset = nFaces;
+		pTasks[i].faceIndexOffset = nFaceIndices;
+
+		nVertices += pTasks[i].chunk.nVertices;
+		nNormals += pTasks[i].chunk.nNormals;
+		nTexCoords += pTasks[i].chunk.nTexCoords;
+		nFaces += pTasks[i].chunk.nFaces;
+		nFaceIndices += pTasks[i].chunk.nFaceIndices;
+
+		if(pTasks[i].chunk.indexSize > indexSize)
+		{
+			indexSize = pTasks[i].chunk.indexSize;
+		}
+
+		pInput->numLines += pTasks[i].numLines; // for the load statistics
+	}
+
+	// NOTE: a relative index can only be made absolute while its chunk is copied, so the
+	// indices are 64-bit if any of them could be outside the 32-bit range
+	if(nVertices > UINT32_MAX || nTexCoords > UINT32_MAX || nNormals > UINT32_MAX)
+	{
+		indexSize = sizeof(uint64_t);
+	}
+
+	pMesh->nVertices = nVertices;
+	pMesh->nNormals = nNormals;
+	pMesh->nTexCoords = nTexCoords;
+	pMesh->nFaces = nFaces;
+	pMesh->nFaceIndices = nFaceIndices;
+	pMesh->indexSize = indexSize;
+}
+
+// Function to copy the elements of each chunk to the output arrays of its task (see
+// "copyChunkTask") on the same threads that parsed the chunks, which frees the chunks
+static void copyChunks(ObjChunkTask* pTasks, size_t numChunks)
+{
+	mioRunTasks(copyChunkTask, pTasks, sizeof(ObjChunkTask), numChunks);
+}
+
+// Function to check that the "count" face indices at "pIndices" (of "indexSize" bytes) refer to
+// one of "numElements" elements (of the kind "pElementName"), where NULL indices are not checked
+static void checkFaceIndices(const void* pIndices,
+							 size_t indexSize,
+							 size_t count,
+							 size_t numElements,
+							 const char* pElementName)
+{
+	for(size_t i = 0; pIndices != NULL && i < count; ++i)
+	{
+		const uint64_t index = (indexSize == sizeof(uint32_t)) ? ((const uint32_t*)pIndices)[i]
+															   : ((const uint64_t*)pIndices)[i];
+
+		if(index >= numElements)
+		{
+			mioLogError("error: face index %llu refers to no %s (of %zu)\n",
+						(unsigned long long)index + 1,
+						pElementName,
+						numElements);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+	}
+}
+
+// Function to check the face indices of "pMesh" (see "checkFaceIndices"), where the texcoord and
+// normal indices are only checked if the file has texcoords and normals (see "handOverFaces")
+static void checkMeshFaceIndices(const ObjMesh* pMesh)
+{
+	const size_t count = pMesh->nFaceIndices;
+
+	checkFaceIndices(
+		pMesh->pFaceVertexIndices, pMesh->indexSize, count, pMesh->nVertices, "vertex");
+
+	if(pMesh->nTexCoords > 0)
+	{
+		checkFaceIndices(pMesh->pFaceVertexTexCoordIndices,
+						 pMesh->indexSize,
+						 count,
+						 pMesh->nTexCoords,
+						 "texcoord");
+	}
+
+	if(pMesh->nNormals > 0)
+	{
+		checkFaceIndices(
+			pMesh->pFaceVertexNormalIndices, pMesh->indexSize, count, pMesh->nNormals, "normal");
+	}
+}
+
+// Function to read the contents of an .obj file from "pInput" with coordinates of "coordSize"
+// bytes (i.e. sizeof(double) or sizeof(float)). The lines of the file are split into chunks that
+// are parsed on up to "numThreads" threads. Each chunk is parsed into its own arrays, which are
+// then copied into the output arrays at offsets given by a prefix sum over the per-chunk element
+// counts.
+static void readOBJ(MioInput* pInput, unsigned int numThreads, size_t coordSize, ObjMesh* pMesh)
+{
+	memset(pMesh, 0, sizeof(ObjMesh));
+
+	const size_t numChunks = getChunkCount(pInput, numThreads);
+
+	if(numChunks == 1)
+	{ // The file is parsed on the calling thread
+		ObjChunk chunk;
+		initChunk(&chunk, coordSize);
+
+		parseLines(pInput, &chunk);
+
+		printCounts(
+			chunk.nVertices, chunk.nNormals, chunk.nTexCoords, chunk.nFaces, chunk.nFaceIndices);
+
+		if(chunk.nTexCoords > 0)
+		{
+			mioArrayResizeZeroed(
+				&chunk.faceVertexTexCoordIndices, chunk.indexSize, chunk.nFaceIndices);
+		}
+
+		if(chunk.nNormals > 0)
+		{
+			mioArrayResizeZeroed(
+				&chunk.faceVertexNormalIndices, chunk.indexSize, chunk.nFaceIndices);
+		}
+
+		// NOTE: the chunk starts at the first element, so its indices are only validated
+		MioArray* pTexCoordIndices = &chunk.faceVertexTexCoordIndices;
+		MioArray* pNormalIndices = &chunk.faceVertexNormalIndices;
+		void* const pDst[3] = {chunk.faceVertexIndices.pData,
+							   (chunk.nTexCoords > 0) ? pTexCoordIndices->pData : NULL,
+							   (chunk.nNormals > 0) ? pNormalIndices->pData : NULL};
+		const size_t offsets[3] = {0, 0, 0};
+
+		resolveRelativeIndices(&chunk, pDst, chunk.indexSize, 0, offsets);
+		mioMemFree(chunk.relativeIndices.pData);
+
+		pMesh->pVertices = mioArrayRelease(&chunk.vertices, coordSize);
+		pMesh->pNormals = mioArrayRelease(&chunk.normals, coordSize);
+		pMesh->pTexCoords = mioArrayRelease(&chunk.texCoords, coordSize);
+		pMesh->pFaceSizes =
+			(unsigned int*)mioArrayRelease(&chunk.faceSizes, sizeof(unsigned int));
+		pMesh->pFaceVertexIndices = mioArrayRelease(&chunk.faceVertexIndices, chunk.indexSize);
+		pMesh->pFaceVertexTexCoordIndices =
+			mioArrayRelease(&chunk.faceVertexTexCoordIndices, chunk.indexSize);
+		pMesh->pFaceVertexNormalIndices =
+			mioArrayRelease(&chunk.faceVertexNormalIndices, chunk.indexSize);
+
+		pMesh->nVertices = chunk.nVertices;
+		pMesh->nNormals = chunk.nNormals;
+		pMesh->nTexCoords = chunk.nTexCoords;
+		pMesh->nFaces = chunk.nFaces;
+		pMesh->nFaceIndices = chunk.nFaceIndices;
+		pMesh->indexSize = chunk.indexSize;
+	}
+	else
+	{ // The chunks are parsed (and then copied to the output arrays) in parallel
+		ObjChunkTask* pTasks = parseChunks(pInput, numChunks, coordSize);
+
+		sumChunkCounts(pTasks, numChunks, pInput, pMesh);
+
+		const size_t nVertices = pMesh->nVertices;
+		const size_t nNormals = pMesh->nNormals;
+		const size_t nTexCoords = pMesh->nTexCoords;
+		const size_t nFaces = pMesh->nFaces;
+		const size_t nFaceIndices = pMesh->nFaceIndices;
+		const size_t indexSize = pMesh->indexSize;
+
+		printCounts(nVertices, nNormals, nTexCoords, nFaces, nFaceIndices);
+
+		char* pVertexData = (nVertices > 0) ? (char*)mioAllocate(nVertices * 3, coordSize) : NULL;
+		char* pNormalData = (nNormals > 0) ? (char*)mioAllocate(nNormals * 3, coordSize) : NULL;
+		char* pTexCoordData =
+			(nTexCoords > 0) ? (char*)mioAllocate(nTexCoords * 2, coordSize) : NULL;
+		unsigned int* pFaceSizeData =
+			(nFaces > 0) ? (unsigned int*)mioAllocate(nFaces, sizeof(unsigned int)) : NULL;
+		void* pFaceVertexIndexData = mioAllocate(nFaceIndices, indexSize);
+		void* pFaceVertexTexCoordIndexData =
+			(nTexCoords > 0) ? mioAllocate(nFaceIndices, indexSize) : NULL;
+		void* pFaceVertexNormalIndexData =
+			(nNormals > 0) ? mioAllocate(nFaceIndices, indexSize) : NULL;
+
+		for(size_t i = 0; i < numChunks; ++i)
+		{
+			pTasks[i].pVertices = pVertexData;
+			pTasks[i].pNormals = pNormalData;
+			pTasks[i].pTexCoords = pTexCoordData;
+			pTasks[i].vertexStride = 3 * coordSize;
+			pTasks[i].normalStride = 3 * coordSize;
+			pTasks[i].texCoordStride = 2 * coordSize;
+			pTasks[i].pFaceSizes = pFaceSizeData;
+			pTasks[i].pFaceVertexIndices = pFaceVertexIndexData;
+			pTasks[i].pFaceVertexTexCoordIndices = pFaceVertexTexCoordIndexData;
+			pTasks[i].pFaceVertexNormalIndices = pFaceVertexNormalIndexData;
+			pTasks[i].indexSize = indexSize;
+		}
+
+		copyChunks(pTasks, numChunks);
+
+		mioMemFree(pTasks);
+
+		pMesh->pVertices = pVertexData;
+		pMesh->pNormals = pNormalData;
+		pMesh->pTexCoords = pTexCoordData;
+		pMesh->pFaceSizes = pFaceSizeData;
+		pMesh->pFaceVertexIndices = pFaceVertexIndexData;
+		pMesh->pFaceVertexTexCoordIndices = pFaceVertexTexCoordIndexData;
+		pMesh->pFaceVertexNormalIndices = pFaceVertexNormalIndexData;
+	}
+
+	// NOTE: faces may refer to elements that come after them, so the indices are checked last
+	checkMeshFaceIndices(pMesh);
+}
+
+// Function to read the .obj file at "fpath" (see "readOBJ")
+static void
+readOBJFile(const char* fpath, unsigned int numThreads, size_t coordSize, ObjMesh* pMesh)
+{
+	mioLogInfo("read .obj file: %s\n", fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	readOBJ(&input, numThreads, coordSize, pMesh);
+
+	//
+	// finish, and free up memory
+	//
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+}
+
+// Function to check that the elements of "pMesh" can be handed over with 32-bit indices and counts
+static void checkIndexRange(const ObjMesh* pMesh)
+{
+	// NOTE: larger meshes can only be read with "mioReadMesh64"
+	if(pMesh->indexSize != sizeof(uint32_t) || pMesh->nVertices > UINT_MAX ||
+	   pMesh->nNormals > UINT_MAX || pMesh->nTexCoords > UINT_MAX || pMesh->nFaces > UINT_MAX)
+	{
+		mioLogError("error: the mesh has too many elements for 32-bit indices and counts\n");
+		mioFail(MIO_STATUS_TOO_LARGE);
+	}
+}
+
+// Function to read the contents of an .obj file from "pInput" like "readOBJ", but into the
+// caller-owned arrays of "pBuffers" (see "mioReadOBJInto"). The chunks are still parsed into arrays
+// of their own (as the counts are only known at the end), which are then copied straight into the
+// caller's arrays, so no output arrays are allocated and the single-threaded case has one copy
+// instead of the two of reading into allocated arrays and copying those over.
+static bool readOBJInto(MioInput* pInput,
+						unsigned int numThreads,
+						size_t coordSize,
+						const MioMeshBuffers* pBuffers,
+						MioMeshCounts* pCounts)
+{
+	memset(pCounts, 0, sizeof(MioMeshCounts));
+
+	if(!mioCheckBuffers(pBuffers, pCounts, coordSize))
+	{
+		return false;
+	}
+
+	const size_t numChunks = getChunkCount(pInput, numThreads);
+	ObjChunkTask* pTasks = parseChunks(pInput, numChunks, coordSize);
+	ObjMesh mesh;
+
+	memset(&mesh, 0, sizeof(ObjMesh));
+	sumChunkCounts(pTasks, numChunks, pInput, &mesh);
+
+	printCounts(mesh.nVertices, mesh.nNormals, mesh.nTexCoords, mesh.nFaces, mesh.nFaceIndices);
+	checkIndexRange(&mesh);
+
+	pCounts->numVertices = mesh.nVertices;
+	pCounts->numNormals = mesh.nNormals;
+	pCounts->numTexCoords = mesh.nTexCoords;
+	pCounts->numFaces = mesh.nFaces;
+	pCounts->numFaceVertices = mesh.nFaceIndices;
+
+	if(!mioCheckBuffers(pBuffers, pCounts, coordSize))
+	{
+		for(size_t i = 0; i < numChunks; ++i)
+		{
+			freeChunk(&pTasks[i].chunk);
+		}
+
+		mioMemFree(pTasks);
+		return false;
+	}
+
+	// NOTE: faces can reference texcoords/normals that the file does not have, whose indices
+	// are not stored
+	for(size_t i = 0; i < numChunks; ++i)
+	{
+		pTasks[i].pVertices = (char*)pBuffers->vertices.pData;
+		pTasks[i].pNormals = (char*)pBuffers->normals.pData;
+		pTasks[i].pTexCoords = (char*)pBuffers->texCoords.pData;
+		pTasks[i].vertexStride = mioCoordBufferStride(&pBuffers->vertices, 3, coordSize);
+		pTasks[i].normalStride = mioCoordBufferStride(&pBuffers->normals, 3, coordSize);
+		pTasks[i].texCoordStride = mioCoordBufferStride(&pBuffers->texCoords, 2, coordSize);
+		pTasks[i].pFaceSizes = pBuffers->faceSizes.pData;
+		pTasks[i].pFaceVertexIndices = pBuffers->faceVertexIndices.pData;
+		pTasks[i].pFaceVertexTexCoordIndices =
+			(mesh.nTexCoords > 0) ? pBuffers->faceVertexTexCoordIndices.pData : NULL;
+		pTasks[i].pFaceVertexNormalIndices =
+			(mesh.nNormals > 0) ? pBuffers->faceVertexNormalIndices.pData : NULL;
+		pTasks[i].indexSize = sizeof(uint32_t);
+	}
+
+	copyChunks(pTasks, numChunks);
+
+	mioMemFree(pTasks);
+
+	// the buffers hold all of the face indices (see "mioCheckBuffers")
+	mesh.pFaceVertexIndices = pBuffers->faceVertexIndices.pData;
+	mesh.pFaceVertexTexCoordIndices = pBuffers->faceVertexTexCoordIndices.pData;
+	mesh.pFaceVertexNormalIndices = pBuffers->faceVertexNormalIndices.pData;
+
+	checkMeshFaceIndices(&mesh);
+
+	return true;
+}
+
+// Function to read the .obj file at "fpath" into "pBuffers" (see "readOBJInto")
+static bool readOBJFileInto(const char* fpath,
+							unsigned int numThreads,
+							size_t coordSize,
+							const MioMeshBuffers* pBuffers,
+							MioMeshCounts* pCounts)
+{
+	mioLogInfo("read .obj file: %s\n", fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	const bool ok = readOBJInto(&input, numThreads, coordSize, pBuffers, pCounts);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+
+	return ok;
+}
+
+// Function to hand over the (coordinate-type independent) face arrays and the element counts of
+// "pMesh" to the caller. Arrays without elements are not handed over (but freed).
+static void handOverFaces(const ObjMesh* pMesh,
+						  unsigned int** pFaceSizes,
+						  unsigned int** pFaceVertexIndices,
+						  unsigned int** pFaceVertexTexCoordIndices,
+						  unsigned int** pFaceVertexNormalIndices,
+						  unsigned int* numVertices,
+						  unsigned int* numNormals,
+						  unsigned int* numTexcoords,
+						  unsigned int* numFaces)
+{
+	checkIndexRange(pMesh);
+
+	if(pMesh->nFaces > 0)
+	{
+		*pFaceSizes = pMesh->pFaceSizes;
+	}
+
+	*pFaceVertexIndices = (unsigned int*)pMesh->pFaceVertexIndices;
+
+	// NOTE: faces can reference texcoords/normals that the file does not have
+	if(pMesh->nTexCoords > 0)
+	{
+		*pFaceVertexTexCoordIndices = (unsigned int*)pMesh->pFaceVertexTexCoordIndices;
+	}
+	else
+	{
+		mioMemFree(pMesh->pFaceVertexTexCoordIndices);
+	}
+
+	if(pMesh->nNormals > 0)
+	{
+		*pFaceVertexNormalIndices = (unsigned int*)pMesh->pFaceVertexNormalIndices;
+	}
+	else
+	{
+		mioMemFree(pMesh->pFaceVertexNormalIndices);
+	}
+
+	*numVertices = (unsigned int)pMesh->nVertices;
+	*numNormals = (unsigned int)pMesh->nNormals;
+	*numTexcoords = (unsigned int)pMesh->nTexCoords;
+	*numFaces = (unsigned int)pMesh->nFaces;
+}
+
+// Function to hand over all arrays of "pMesh" (with double coordinates) to the caller
+static void handOverMesh(const ObjMesh* pMesh,
+						 double** pVertices,
+						 double** pNormals,
+						 double** pTexCoords,
+						 unsigned int** pFaceSizes,
+						 unsigned int** pFaceVertexIndices,
+						 unsigned int** pFaceVertexTexCoordIndices,
+						 unsigned int** pFaceVertexNormalIndices,
+						 unsigned int* numVertices,
+						 unsigned int* numNormals,
+						 unsigned int* numTexcoords,
+						 unsigned int* numFaces)
+{
+	if(pMesh->nVertices > 0)
+	{
+		*pVertices = (double*)pMesh->pVertices;
+	}
+
+	if(pMesh->nNormals > 0)
+	{
+		*pNormals = (double*)pMesh->pNormals;
+	}
+
+	if(pMesh->nTexCoords > 0)
+	{
+		*pTexCoords = (double*)pMesh->pTexCoords;
+	}
+
+	handOverFaces(pMesh,
+				  pFaceSizes,
+				  pFaceVertexIndices,
+				  pFaceVertexTexCoordIndices,
+				  pFaceVertexNormalIndices,
+				  numVertices,
+				  numNormals,
+				  numTexcoords,
+				  numFaces);
+}
+
+// Funcion to read in an obj file like "mioReadOBJ", with the lines of the file split into
+// chunks that are parsed on up to "numThreads" threads.
+void mioReadOBJParallel(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	double** pVertices,
+	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+	double** pNormals,
+	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
+	double** pTexCoords,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int** pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+	unsigned int** pFaceVertexIndices,
+	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexTexCoordIndices,
+	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexNormalIndices,
+	// number of vertices in "pVertices"
+	unsigned int* numVertices,
+	// number of vertex normals in "pNormals"
+	unsigned int* numNormals,
+	// number of texture coordinates in "pTexCoords"
+	unsigned int* numTexcoords,
+	// number of faces
+	unsigned int* numFaces,
+	// number of threads to parse the file with (0 = number of hardware threads)
+	unsigned int numThreads)
+{
+	ObjMesh mesh;
+
+	readOBJFile(fpath, numThreads, sizeof(double), &mesh);
+
+	handOverMesh(&mesh,
+				 pVertices,
+				 pNormals,
+				 pTexCoords,
+				 pFaceSizes,
+				 pFaceVertexIndices,
+				 pFaceVertexTexCoordIndices,
+				 pFaceVertexNormalIndices,
+				 numVertices,
+				 numNormals,
+				 numTexcoords,
+				 numFaces);
+}
+
+enum MioStatus mioReadOBJInto(const char* fpath,
+							  const MioMeshBuffers* pBuffers,
+							  MioMeshCounts* pCounts,
+							  unsigned int numThreads)
+{
+	return mioTryReadInto(readOBJFileInto, fpath, numThreads, sizeof(double), pBuffers, pCounts);
+}
+
+enum MioStatus mioReadOBJIntof(const char* fpath,
+							   const MioMeshBuffers* pBuffers,
+							   MioMeshCounts* pCounts,
+							   unsigned int numThreads)
+{
+	return mioTryReadInto(readOBJFileInto, fpath, numThreads, sizeof(float), pBuffers, pCounts);
+}
+
+void mioReadOBJMesh64(const char* fpath, MioMesh64* pMesh)
+{
+	ObjMesh mesh;
+
+	readOBJFile(fpath, 0, sizeof(double), &mesh);
+
+	memset(pMesh, 0, sizeof(MioMesh64));
+
+	pMesh->pVertices = (double*)mesh.pVertices;
+	pMesh->pNormals = (double*)mesh.pNormals;
+	pMesh->pTexCoords = (double*)mesh.pTexCoords;
+	pMesh->pFaceSizes = mesh.pFaceSizes;
+	pMesh->pFaceVertexIndices = mesh.pFaceVertexIndices;
+
+	// NOTE: faces can reference texcoords/normals that the file does not have
+	if(mesh.nTexCoords > 0)
+	{
+		pMesh->pFaceVertexTexCoordIndices = mesh.pFaceVertexTexCoordIndices;
+	}
+	else
+	{
+		mioMemFree(mesh.pFaceVertexTexCoordIndices);
+	}
+
+	if(mesh.nNormals > 0)
+	{
+		pMesh->pFaceVertexNormalIndices = mesh.pFaceVertexNormalIndices;
+	}
+	else
+	{
+		mioMemFree(mesh.pFaceVertexNormalIndices);
+	}
+
+	pMesh->indexSize = mesh.indexSize;
+	pMesh->numVertices = mesh.nVertices;
+	pMesh->numNormals = mesh.nNormals;
+	pMesh->numTexCoords = mesh.nTexCoords;
+	pMesh->numFaces = mesh.nFaces;
+	pMesh->numFaceVertices = mesh.nFaceIndices;
+}
+
+// Funcion to read in the contents of an obj file from the "dataSize" bytes at "pData" (like
+// "mioReadOBJ")
+void mioReadOBJFromMemory(
+	// the contents of an obj file (which do not need to be null-terminated)
+	const void* pData,
+	// number of bytes at "pData"
+	size_t dataSize,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	double** pVertices,
+	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+	double** pNormals,
+	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
+	double** pTexCoords,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int** pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+	unsigned int** pFaceVertexIndices,
+	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexTexCoordIndices,
+	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexNormalIndices,
+	// number of vertices in "pVertices"
+	unsigned int* numVertices,
+	// number of vertex normals in "pNormals"
+	unsigned int* numNormals,
+	// number of texture coordinates in "pTexCoords"
+	unsigned int* numTexcoords,
+	// number of faces
+	unsigned int* numFaces)
+{
+	mioLogInfo("read .obj file from memory: %zu bytes\n", dataSize);
+
+	MioInput input;
+
+	mioLoadBegin();
+	mioInputOpenRange(&input, (const char*)pData, (const char*)pData + dataSize);
+
+	ObjMesh mesh;
+
+	readOBJ(&input, 1, sizeof(double), &mesh);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+
+	handOverMesh(&mesh,
+				 pVertices,
+				 pNormals,
+				 pTexCoords,
+				 pFaceSizes,
+				 pFaceVertexIndices,
+				 pFaceVertexTexCoordIndices,
+				 pFaceVertexNormalIndices,
+				 numVertices,
+				 numNormals,
+				 numTexcoords,
+				 numFaces);
+}
+
+// Funcion to read in an obj file like "mioReadOBJ", but with single precision coordinates
+void mioReadOBJf(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	float** pVertices,
+	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+	float** pNormals,
+	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
+	float** pTexCoords,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int** pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+	unsigned int** pFaceVertexIndices,
+	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexTexCoordIndices,
+	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexNormalIndices,
+	// number of vertices in "pVertices"
+	unsigned int* numVertices,
+	// number of vertex normals in "pNormals"
+	unsigned int* numNormals,
+	// number of texture coordinates in "pTexCoords"
+	unsigned int* numTexcoords,
+	// number of faces
+	unsigned int* numFaces)
+{
+	mioReadOBJParallelf(fpath,
+						pVertices,
+						pNormals,
+						pTexCoords,
+						pFaceSizes,
+						pFaceVertexIndices,
+						pFaceVertexTexCoordIndices,
+						pFaceVertexNormalIndices,
+						numVertices,
+						numNormals,
+						numTexcoords,
+						numFaces,
+						1);
+}
+
+// Funcion to read in an obj file like "mioReadOBJParallel", but with single precision
+// coordinates
+void mioReadOBJParallelf(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	float** pVertices,
+	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+	float** pNormals,
+	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
+	float** pTexCoords,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int** pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+	unsigned int** pFaceVertexIndices,
+	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexTexCoordIndices,
+	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int** pFaceVertexNormalIndices,
+	// number of vertices in "pVertices"
+	unsigned int* numVertices,
+	// number of vertex normals in "pNormals"
+	unsigned int* numNormals,
+	// number of texture coordinates in "pTexCoords"
+	unsigned int* numTexcoords,
+	// number of faces
+	unsigned int* numFaces,
+	// number of threads to parse the file with (0 = number of hardware threads)
+	unsigned int numThreads)
+{
+	ObjMesh mesh;
+
+	readOBJFile(fpath, numThreads, sizeof(float), &mesh);
+
+	//
+	// hand over the parsed data to the caller
+	//
+	if(mesh.nVertices > 0)
+	{
+		*pVertices = (float*)mesh.pVertices;
+	}
+
+	if(mesh.nNormals > 0)
+	{
+		*pNormals = (float*)mesh.pNormals;
+	}
+
+	if(mesh.nTexCoords > 0)
+	{
+		*pTexCoords = (float*)mesh.pTexCoords;
+	}
+
+	handOverFaces(&mesh,
+				  pFaceSizes,
+				  pFaceVertexIndices,
+				  pFaceVertexTexCoordIndices,
+				  pFaceVertexNormalIndices,
+				  numVertices,
+				  numNormals,
+				  numTexcoords,
+				  numFaces);
+}
+
+// the vertex positions, normals or texture coordinates that "formatCoordRows" writes, as lines of
+// "numComponents" coordinates after "pPrefix" (e.g. "v ")
+typedef struct ObjCoordRows
+{
+	const char* pPrefix;
+	const void* pCoords;
+	size_t coordSize;
+	unsigned int numComponents;
+} ObjCoordRows;
+
+static void formatCoordRows(
+	MioWriter* pWriter, const void* pContext, size_t beginRow, size_t endRow, size_t offset)
+{
+	const ObjCoordRows* pRows = (const ObjCoordRows*)pContext;
+	const size_t numComponents = pRows->numComponents;
+
+	(void)offset;
+
+	for(size_t i = beginRow; i < endRow; ++i)
+	{
+		mioWriterPutString(pWriter, pRows->pPrefix);
+
+		for(size_t k = 0; k < numComponents; ++k)
+		{
+			mioWriterPutCoord(pWriter, pRows->pCoords, i * numComponents + k, pRows->coordSize);
+			mioWriterPutChar(pWriter, (k + 1 < numComponents) ? ' ' : '\n');
+		}
+	}
+}
+
+// the faces that "formatFaceRows" writes
+typedef struct ObjFaceRows
+{
+	const unsigned int* pFaceSizes;
+	const unsigned int* pFaceVertexIndices;
+	const unsigned int* pFaceVertexTexCoordIndices;
+	const unsigned int* pFaceVertexNormalIndices;
+	bool hasNormals;
+	bool hasTexCoords;
+} ObjFaceRows;
+
+// Function to write the faces "[beginRow, endRow)", where "offset" is the index of the first
+// face-vertex of face "beginRow"
+static void formatFaceRows(
+	MioWriter* pWriter, const void* pContext, size_t beginRow, size_t endRow, size_t offset)
+{
+	const ObjFaceRows* pRows = (const ObjFaceRows*)pContext;
+
+	size_t base = offset;
+
+	// for each face
+	for(size_t f = beginRow; f < endRow; ++f)
+	{
+
+		int faceSize = pRows->pFaceSizes[f];
+
+		mioWriterPutString(pWriter, "f ");
+
+		// for each vertex in face
+		for(int v = 0; v < faceSize; v++)
+		{
+			// Note: obj file indices start from 1
+			const unsigned int vertexIdx = pRows->pFaceVertexIndices[base + v] + 1;
+
+			const bool isLastVertex = (v == (faceSize - 1));
+
+			mioWriterPutUint(pWriter, vertexIdx);
+
+			if(pRows->hasNormals && pRows->hasTexCoords)
+			{
+				const unsigned int normalIdx = pRows->pFaceVertexNormalIndices[base + v] + 1;
+				const unsigned int texCoordIdx = pRows->pFaceVertexTexCoordIndices[base + v] + 1;
+				mioWriterPutChar(pWriter, '/'); // i.e. "%u/%u/%u"
+				mioWriterPutUint(pWriter, texCoordIdx);
+				mioWriterPutChar(pWriter, '/');
+				mioWriterPutUint(pWriter, normalIdx);
+			}
+			else if(pRows->hasNormals)
+			{
+				const unsigned int normalIdx = pRows->pFaceVertexNormalIndices[base + v] + 1;
+				mioWriterPutString(pWriter, "//"); // i.e. "%u//%u"
+				mioWriterPutUint(pWriter, normalIdx);
+			}
+			else if(pRows->hasTexCoords)
+			{
+				const unsigned int texCoordIdx = pRows->pFaceVertexTexCoordIndices[base + v] + 1;
+				mioWriterPutChar(pWriter, '/'); // i.e. "%u/%u"
+				mioWriterPutUint(pWriter, texCoordIdx);
+			}
+
+			if(!isLastVertex)
+			{
+				// add space between face-vertex components i.e. a/b/c d/e/f g/h/i
+				mioWriterPutChar(pWriter, ' ');
+			}
+		}
+
+		mioWriterPutChar(pWriter, '\n');
+
+		base += faceSize;
+	}
+}
+
+// Function to write an .obj file with coordinate arrays of "coordSize" bytes per element (i.e.
+// sizeof(double) or sizeof(float)), where the lines are formatted on up to "numThreads" threads
+// (see "mioWriterPutRows")
+static void writeOBJ(const char* fpath,
+					 const void* pVertices,
+					 const void* pNormals,
+					 const void* pTexCoords,
+					 size_t coordSize,
+					 const unsigned int* pFaceSizes,
+					 const unsigned int* pFaceVertexIndices,
+					 const unsigned int* pFaceVertexTexCoordIndices,
+					 const unsigned int* pFaceVertexNormalIndices,
+					 unsigned int numVertices,
+					 unsigned int numNormals,
+					 unsigned int numTexcoords,
+					 unsigned int numFaces,
+					 unsigned int numThreads)
+{
+	mioLogInfo("write .obj file: %s\n", fpath);
+
+	MioWriter writer;
+
+	if(!mioWriterOpen(&writer, fpath, "w")) // open our file
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		return; // exit(1);
+	}
+
+	mioLogInfo("vertices %u\n", numVertices);
+
+	const ObjCoordRows vertexRows = {"v ", pVertices, coordSize, 3};
+	mioWriterPutRows(&writer, formatCoordRows, &vertexRows, numVertices, NULL, 3, numThreads);
+
+	mioLogInfo("normals %u\n", numNormals);
+
+	const ObjCoordRows normalRows = {"vn ", pNormals, coordSize, 3};
+	mioWriterPutRows(&writer, formatCoordRows, &normalRows, numNormals, NULL, 3, numThreads);
+
+	mioLogInfo("texcoords %u\n", numTexcoords);
+
+	const ObjCoordRows texCoordRows = {"vt ", pTexCoords, coordSize, 2};
+	mioWriterPutRows(&writer, formatCoordRows, &texCoordRows, numTexcoords, NULL, 2, numThreads);
+
+	mioLogInfo("faces %u\n", numFaces);
+
+	const ObjFaceRows faceRows = {pFaceSizes,
+								  pFaceVertexIndices,
+								  pFaceVertexTexCoordIndices,
+								  pFaceVertexNormalIndices,
+								  numNormals > 0,
+								  numTexcoords > 0};
+	mioWriterPutRows(&writer, formatFaceRows, &faceRows, numFaces, pFaceSizes, 0, numThreads);
+
+	if(!mioWriterClose(&writer))
+	{
+		mioLogError("error: failed to write file '%s'\n", fpath);
+	}
+
+	mioLogInfo("done.\n");
+}
+
+void mioWriteOBJ(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	double* pVertices,
+	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+	double* pNormals,
+	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
+	double* pTexCoords,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int* pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+	unsigned int* pFaceVertexIndices,
+	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int* pFaceVertexTexCoordIndices,
+	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int* pFaceVertexNormalIndices,
+	// number of vertices in "pVertices"
+	unsigned int numVertices,
+	// number of vertex normals in "pNormals"
+	unsigned int numNormals,
+	// number of texture coordinates in "pTexCoords"
+	unsigned int numTexcoords,
+	// number of faces
+	unsigned int numFaces)
+{
+	writeOBJ(fpath,
+			 pVertices,
+			 pNormals,
+			 pTexCoords,
+			 sizeof(double),
+			 pFaceSizes,
+			 pFaceVertexIndices,
+			 pFaceVertexTexCoordIndices,
+			 pFaceVertexNormalIndices,
+			 numVertices,
+			 numNormals,
+			 numTexcoords,
+			 numFaces,
+			 1);
+}
+
+void mioWriteOBJf(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	float* pVertices,
+	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+	float* pNormals,
+	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
+	float* pTexCoords,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int* pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+	unsigned int* pFaceVertexIndices,
+	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int* pFaceVertexTexCoordIndices,
+	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int* pFaceVertexNormalIndices,
+	// number of vertices in "pVertices"
+	unsigned int numVertices,
+	// number of vertex normals in "pNormals"
+	unsigned int numNormals,
+	// number of texture coordinates in "pTexCoords"
+	unsigned int numTexcoords,
+	// number of faces
+	unsigned int numFaces)
+{
+	writeOBJ(fpath,
+			 pVertices,
+			 pNormals,
+			 pTexCoords,
+			 sizeof(float),
+			 pFaceSizes,
+			 pFaceVertexIndices,
+			 pFaceVertexTexCoordIndices,
+			 pFaceVertexNormalIndices,
+			 numVertices,
+			 numNormals,
+			 numTexcoords,
+			 numFaces,
+			 1);
+}
+
+void mioWriteOBJParallel(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	double* pVertices,
+	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+	double* pNormals,
+	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
+	double* pTexCoords,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int* pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+	unsigned int* pFaceVertexIndices,
+	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int* pFaceVertexTexCoordIndices,
+	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int* pFaceVertexNormalIndices,
+	// number of vertices in "pVertices"
+	unsigned int numVertices,
+	// number of vertex normals in "pNormals"
+	unsigned int numNormals,
+	// number of texture coordinates in "pTexCoords"
+	unsigned int numTexcoords,
+	// number of faces
+	unsigned int numFaces,
+	// number of threads to format the lines with (0 = number of hardware threads)
+	unsigned int numThreads)
+{
+	writeOBJ(fpath,
+			 pVertices,
+			 pNormals,
+			 pTexCoords,
+			 sizeof(double),
+			 pFaceSizes,
+			 pFaceVertexIndices,
+			 pFaceVertexTexCoordIndices,
+			 pFaceVertexNormalIndices,
+			 numVertices,
+			 numNormals,
+			 numTexcoords,
+			 numFaces,
+			 numThreads);
+}
+
+void mioWriteOBJParallelf(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	float* pVertices,
+	// pointer to list of vertex normals stored as [xyz,xyz,xyz...]
+	float* pNormals,
+	// pointer to list of texture coordinates list stored as [xy,xy,xy...]
+	float* pTexCoords,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int* pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...]
+	unsigned int* pFaceVertexIndices,
+	// pointer to list of face-vertex texture-coord indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int* pFaceVertexTexCoordIndices,
+	// pointer to list of face texture coordvertex-normal indices stored as [ijkl,ijk,ijkl,ijklmn,ijk,...] (same order as in "pFaceVertexIndices")
+	unsigned int* pFaceVertexNormalIndices,
+	// number of vertices in "pVertices"
+	unsigned int numVertices,
+	// number of vertex normals in "pNormals"
+	unsigned int numNormals,
+	// number of texture coordinates in "pTexCoords"
+	unsigned int numTexcoords,
+	// number of faces
+	unsigned int numFaces,
+	// number of threads to format the lines with (0 = number of hardware threads)
+	unsigned int numThreads)
+{
+	writeOBJ(fpath,
+			 pVertices,
+			 pNormals,
+			 pTexCoords,
+			 sizeof(float),
+			 pFaceSizes,
+			 pFaceVertexIndices,
+			 pFaceVertexTexCoordIndices,
+			 pFaceVertexNormalIndices,
+			 numVertices,
+			 numNormals,
+			 numTexcoords,
+			 numFaces,
+			 numThreads);
+}
+
+// Function to read the contents of an .obj file from "pInput" into the indexed mesh "pMesh" with
+// coordinates of "coordSize" bytes (see "mioReadOBJIndexed"). The distinct face-vertices are found
+// while the faces are parsed, so that only one face index array is ever built, and the
+// interleaved vertices are assembled from the coordinate arrays at the end.
+static void readOBJIndexed(MioInput* pInput, size_t coordSize, MioIndexedMesh* pMesh)
+{
+	ObjChunk chunk;
+	ObjVertexTable table;
+
+	initChunk(&chunk, coordSize);
+	memset(&table, 0, sizeof(ObjVertexTable));
+	resizeVertexTable(&table, 1024);
+	chunk.pVertexTable = &table;
+
+	parseLines(pInput, &chunk);
+
+	printCounts(
+		chunk.nVertices, chunk.nNormals, chunk.nTexCoords, chunk.nFaces, chunk.nFaceIndices);
+
+	const size_t numVertices = table.triples.size / 3;
+
+	mioLogInfo("\t%zu distinct face-vertices\n", numVertices);
+
+	if(chunk.nFaces > UINT_MAX)
+	{
+		mioLogError("error: the mesh has too many faces for 32-bit counts\n");
+		mioFail(MIO_STATUS_TOO_LARGE);
+	}
+
+	// NOTE: faces can reference texcoords/normals that the file does not have, which are left out
+	const bool hasTexCoords = (chunk.nTexCoords > 0);
+	const bool hasNormals = (chunk.nNormals > 0);
+	const size_t numCoords = 3 + (hasTexCoords ? 2 : 0) + (hasNormals ? 3 : 0);
+	const size_t counts[3] = {chunk.nVertices, chunk.nTexCoords, chunk.nNormals};
+	const char* pSources[3] = {(const char*)chunk.vertices.pData,
+							   (const char*)chunk.texCoords.pData,
+							   (const char*)chunk.normals.pData};
+	const size_t sizes[3] = {3 * coordSize, 2 * coordSize, 3 * coordSize};
+	const bool used[3] = {true, hasTexCoords, hasNormals};
+
+	char* pVertices = (char*)mioAllocate(numVertices * numCoords, coordSize);
+	const uint32_t* pTriples = (const uint32_t*)table.triples.pData;
+
+	for(size_t v = 0; v < numVertices; ++v)
+	{
+		char* pVertex = pVertices + v * numCoords * coordSize;
+
+		for(int i = 0; i < 3; ++i)
+		{
+			if(!used[i])
+			{
+				continue;
+			}
+
+			const uint32_t index = pTriples[v * 3 + i];
+
+			if(index >= counts[i])
+			{
+				mioLogError("error: face index %u refers to no element\n", index + 1);
+				mioFail(MIO_STATUS_MALFORMED);
+			}
+
+			memcpy(pVertex, pSources[i] + (size_t)index * sizes[i], sizes[i]);
+			pVertex += sizes[i];
+		}
+	}
+
+	pMesh->pVertices = pVertices;
+	pMesh->pFaceSizes = (unsigned int*)mioArrayRelease(&chunk.faceSizes, sizeof(unsigned int));
+	pMesh->pFaceVertexIndices =
+		(unsigned int*)mioArrayRelease(&chunk.faceVertexIndices, sizeof(unsigned int));
+	pMesh->numCoords = (unsigned int)numCoords;
+	pMesh->numVertices = (unsigned int)numVertices;
+	pMesh->numFaces = (unsigned int)chunk.nFaces;
+	pMesh->hasTexCoords = hasTexCoords ? 1 : 0;
+	pMesh->hasNormals = hasNormals ? 1 : 0;
+
+	mioMemFree(table.triples.pData);
+	mioMemFree(table.pSlots);
+	freeChunk(&chunk);
+}
+
+// Function to read the .obj file at "fpath" (see "readOBJIndexed")
+static void readOBJIndexedFile(const char* fpath, size_t coordSize, MioIndexedMesh* pMesh)
+{
+	assert(pMesh != NULL);
+
+	mioLogInfo("read .obj file: %s\n", fpath);
+
+	memset(pMesh, 0, sizeof(MioIndexedMesh));
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	readOBJIndexed(&input, coordSize, pMesh);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+}
+
+void mioReadOBJIndexed(const char* fpath, MioIndexedMesh* pMesh)
+{
+	readOBJIndexedFile(fpath, sizeof(double), pMesh);
+}
+
+void mioReadOBJIndexedf(const char* fpath, MioIndexedMesh* pMesh)
+{
+	readOBJIndexedFile(fpath, sizeof(float), pMesh);
+}
+
+void mioFreeIndexedMesh(MioIndexedMesh* pMesh)
+{
+	assert(pMesh != NULL);
+
+	mioMemFree(pMesh->pVertices);
+	mioMemFree(pMesh->pFaceSizes);
+	mioMemFree(pMesh->pFaceVertexIndices);
+
+	memset(pMesh, 0, sizeof(MioIndexedMesh));
+}
+
+// version of the layout of .mioi (obj section index) files, which is increased whenever the layout
+// changes
+#define MIO_MIOI_VERSION 1
+
+// stored as a host integer to detect files that were written on a host with another byte order
+#define MIO_MIOI_BYTE_ORDER 0x01020304u
+
+// kinds of the lines that start a section of an .obj file
+enum ObjSectionCmdType
+{
+	SECTION_NONE,
+	SECTION_OBJECT, // "o <name>"
+	SECTION_GROUP, // "g <name>"
+	SECTION_MATERIAL // "usemtl <name>"
+};
+
+// Function to determine whether the line [pLine, pLineEnd) starts a section, where the name on
+// the line (without surrounding blanks) is returned in [*ppName, *ppNameEnd)
+static enum ObjSectionCmdType parseSectionCmdType(const char* pLine,
+												  const char* pLineEnd,
+												  const char** ppName,
+												  const char** ppNameEnd)
+{
+	const size_t lineLen = (size_t)(pLineEnd - pLine);
+	enum ObjSectionCmdType cmdType = SECTION_NONE;
+	size_t cmdLen = 0;
+
+	if(lineLen >= 1 && (pLine[0] == 'o' || pLine[0] == 'g') &&
+	   (lineLen == 1 || mioIsBlank(pLine[1])))
+	{
+		cmdType = (pLine[0] == 'o') ? SECTION_OBJECT : SECTION_GROUP;
+		cmdLen = 1;
+	}
+	else if(lineLen >= 6 && memcmp(pLine, "usemtl", 6) == 0 &&
+			(lineLen == 6 || mioIsBlank(pLine[6])))
+	{
+		cmdType = SECTION_MATERIAL;
+		cmdLen = 6;
+	}
+
+	if(cmdType != SECTION_NONE)
+	{
+		const char* pName = mioSkipBlanks(pLine + cmdLen, pLineEnd);
+		const char* pNameEnd = pLineEnd;
+
+		while(pNameEnd != pName && mioIsBlank(pNameEnd[-1]))
+		{
+			pNameEnd--;
+		}
+
+		*ppName = pName;
+		*ppNameEnd = pNameEnd;
+	}
+
+	return cmdType;
+}
+
+// state of "buildOBJIndex" while it scans the lines of a file
+typedef struct ObjIndexBuilder
+{
+	// the finished sections (MioObjSection), names (char) and element runs (MioObjElementRun)
+	MioArray sections;
+	MioArray names;
+	MioArray runs[3];
+	// the section that the current line belongs to
+	MioObjSection section;
+	// number of vertices, texcoords and normals so far, and whether the last of each kind is in
+	// the current run of that kind
+	size_t counts[3];
+	bool inRun[3];
+	size_t nFaces;
+} ObjIndexBuilder;
+
+// Function to add the name [pName, pNameEnd) to the names of "pBuilder". Returns its offset.
+static unsigned int
+addSectionName(ObjIndexBuilder* pBuilder, const char* pName, const char* pNameEnd)
+{
+	const size_t nameLen = (size_t)(pNameEnd - pName);
+
+	if(nameLen == 0)
+	{
+		return 0; // the empty name
+	}
+
+	const size_t offset = pBuilder->names.size;
+
+	if(offset + nameLen + 1 > UINT_MAX)
+	{
+		mioLogError("error: too many section names for the section index\n");
+		mioFail(MIO_STATUS_TOO_LARGE);
+	}
+
+	mioArrayReserve(&pBuilder->names, 1, offset + nameLen + 1);
+	memcpy((char*)pBuilder->names.pData + offset, pName, nameLen);
+	((char*)pBuilder->names.pData)[offset + nameLen] = '\0';
+	pBuilder->names.size += nameLen + 1;
+
+	return (unsigned int)offset;
+}
+
+// Function to end the current section of "pBuilder" at "byteEnd" and start the next one there,
+// where sections without faces are left out of the index
+static void nextSection(ObjIndexBuilder* pBuilder, uint64_t byteEnd)
+{
+	MioObjSection* pSection = &pBuilder->section;
+
+	pSection->byteEnd = byteEnd;
+
+	if(pSection->numFaces > 0)
+	{
+		mioArrayReserve(&pBuilder->sections, sizeof(MioObjSection), pBuilder->sections.size + 1);
+		((MioObjSection*)pBuilder->sections.pData)[pBuilder->sections.size++] = *pSection;
+	}
+
+	// NOTE: counts beyond 32 bits are caught at the end of the scan
+	pSection->firstFace = (unsigned int)pBuilder->nFaces;
+	pSection->numFaces = 0;
+	pSection->numPrecedingVertices = (unsigned int)pBuilder->counts[0];
+	pSection->numPrecedingTexCoords = (unsigned int)pBuilder->counts[1];
+	pSection->numPrecedingNormals = (unsigned int)pBuilder->counts[2];
+	pSection->byteBegin = byteEnd;
+}
+
+// Function to count the element of kind "kind" (vertex, texcoord or normal) on the line at the
+// byte offset "offset", which starts a new run unless the element follows one of the same kind
+static void addElement(ObjIndexBuilder* pBuilder, int kind, uint64_t offset)
+{
+	MioArray* pRuns = &pBuilder->runs[kind];
+
+	if(!pBuilder->inRun[kind])
+	{
+		MioObjElementRun run;
+
+		run.byteBegin = offset;
+		run.first = (unsigned int)pBuilder->counts[kind];
+		run.count = 0;
+
+		mioArrayReserve(pRuns, sizeof(MioObjElementRun), pRuns->size + 1);
+		((MioObjElementRun*)pRuns->pData)[pRuns->size++] = run;
+		pBuilder->inRun[kind] = true;
+	}
+
+	((MioObjElementRun*)pRuns->pData)[pRuns->size - 1].count++;
+	pBuilder->counts[kind]++;
+}
+
+// Function to build the section index of the .obj file in "pInput" (see "mioBuildOBJIndex"). The
+// runs of elements are only broken by faces, so that files which interleave e.g. vertices and
+// normals still have a run per block of elements.
+static void buildOBJIndex(MioInput* pInput, MioObjIndex* pIndex)
+{
+	ObjIndexBuilder builder;
+
+	memset(&builder, 0, sizeof(ObjIndexBuilder));
+	mioArrayReserve(&builder.names, 1, 1);
+	((char*)builder.names.pData)[0] = '\0'; // the empty name (at offset 0)
+	builder.names.size = 1;
+
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
+
+	while(mioInputNextLine(pInput, &pLine, &pLineEnd))
+	{
+		// NOTE: the window of a streamed input ends at the "numBytes" byte of the file
+		const uint64_t offset = (uint64_t)(pInput->numBytes - (size_t)(pInput->pEnd - pLine));
+		const char* pName = NULL;
+		const char* pNameEnd = NULL;
+
+		switch(parseCmdType(pLine, pLineEnd))
+		{
+		case VERTEX:
+			addElement(&builder, 0, offset);
+			break;
+		case TEXCOORD:
+			addElement(&builder, 1, offset);
+			break;
+		case NORMAL:
+			addElement(&builder, 2, offset);
+			break;
+		case FACE: {
+			builder.section.numFaces++;
+			builder.nFaces++;
+			builder.inRun[0] = builder.inRun[1] = builder.inRun[2] = false;
+		}
+		break;
+		default: {
+			const enum ObjSectionCmdType cmdType =
+				parseSectionCmdType(pLine, pLineEnd, &pName, &pNameEnd);
+
+			if(cmdType != SECTION_NONE)
+			{
+				nextSection(&builder, offset);
+
+				const unsigned int name = addSectionName(&builder, pName, pNameEnd);
+
+				if(cmdType == SECTION_OBJECT)
+				{
+					builder.section.object = name;
+				}
+				else if(cmdType == SECTION_GROUP)
+				{
+					builder.section.group = name;
+				}
+				else
+				{
+					builder.section.material = name;
+				}
+			}
+		}
+		break;
+		}
+	}
+
+	nextSection(&builder, (uint64_t)pInput->numBytes);
+
+	if(builder.counts[0] > UINT_MAX || builder.counts[1] > UINT_MAX ||
+	   builder.counts[2] > UINT_MAX || builder.nFaces > UINT_MAX)
+	{
+		mioLogError("error: the file has too many elements for the section index\n");
+		mioFail(MIO_STATUS_TOO_LARGE);
+	}
+
+	memset(pIndex, 0, sizeof(MioObjIndex));
+
+	pIndex->numSections = (unsigned int)builder.sections.size;
+	pIndex->pSections =
+		(MioObjSection*)mioArrayRelease(&builder.sections, sizeof(MioObjSection));
+	pIndex->namesSize = (unsigned int)builder.names.size;
+	pIndex->pNames = (char*)mioArrayRelease(&builder.names, 1);
+
+	for(int i = 0; i < 3; ++i)
+	{
+		pIndex->numRuns[i] = (unsigned int)builder.runs[i].size;
+		pIndex->pRuns[i] =
+			(MioObjElementRun*)mioArrayRelease(&builder.runs[i], sizeof(MioObjElementRun));
+	}
+
+	pIndex->numVertices = (unsigned int)builder.counts[0];
+	pIndex->numTexCoords = (unsigned int)builder.counts[1];
+	pIndex->numNormals = (unsigned int)builder.counts[2];
+	pIndex->numFaces = (unsigned int)builder.nFaces;
+	pIndex->fileSize = (unsigned long long)pInput->numBytes;
+
+	mioLogInfo("\t%u section(s)\n", pIndex->numSections);
+}
+
+void mioBuildOBJIndex(const char* fpath, MioObjIndex* pIndex)
+{
+	assert(pIndex != NULL);
+
+	mioLogInfo("index .obj file: %s\n", fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	buildOBJIndex(&input, pIndex);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+}
+
+// layout of the start of a .mioi file, which is followed by the sections, the names and the runs
+// of vertices, texcoords and normals of the index (in that order)
+typedef struct MioiHeader
+{
+	char magic[4]; // "MIOI"
+	uint32_t byteOrder;
+	uint32_t version;
+	uint32_t headerSize;
+	uint32_t numSections;
+	uint32_t namesSize;
+	uint32_t numRuns[3];
+	uint32_t numVertices;
+	uint32_t numTexCoords;
+	uint32_t numNormals;
+	uint32_t numFaces;
+	uint32_t reserved;
+	// stamp of the .obj file that the index was built for
+	uint64_t sourceSize;
+	int64_t sourceMTime;
+	int64_t sourceMTimeNsec;
+} MioiHeader;
+
+// Functions to write (read) the "count" elements of "elemSize" bytes at "pData" to (from) "file".
+// Return false if not all elements can be written (read).
+static bool writeElements(FILE* file, const void* pData, size_t elemSize, size_t count)
+{
+	return count == 0 || fwrite(pData, elemSize, count, file) == count;
+}
+
+static bool readElements(FILE* file, void* pData, size_t elemSize, size_t count)
+{
+	return count == 0 || fread(pData, elemSize, count, file) == count;
+}
+
+// Function to write "pIndex" to the file at "fpath" for the source file with stamp "pStamp".
+// Returns false if the file cannot be written.
+static bool writeMIOI(const char* fpath, const MioObjIndex* pIndex, const MioSourceStamp* pStamp)
+{
+	MioiHeader header;
+
+	memset(&header, 0, sizeof(MioiHeader));
+	memcpy(header.magic, "MIOI", 4);
+	header.byteOrder = MIO_MIOI_BYTE_ORDER;
+	header.version = MIO_MIOI_VERSION;
+	header.headerSize = (uint32_t)sizeof(MioiHeader);
+	header.numSections = pIndex->numSections;
+	header.namesSize = pIndex->namesSize;
+	header.numVertices = pIndex->numVertices;
+	header.numTexCoords = pIndex->numTexCoords;
+	header.numNormals = pIndex->numNormals;
+	header.numFaces = pIndex->numFaces;
+	header.sourceSize = pStamp->size;
+	header.sourceMTime = pStamp->mtime;
+	header.sourceMTimeNsec = pStamp->mtimeNsec;
+
+	for(int i = 0; i < 3; ++i)
+	{
+		header.numRuns[i] = pIndex->numRuns[i];
+	}
+
+	FILE* file = fopen(fpath, "wb");
+
+	if(file == NULL)
+	{
+		return false;
+	}
+
+	bool ok = writeElements(file, &header, sizeof(MioiHeader), 1) &&
+			  writeElements(file, pIndex->pSections, sizeof(MioObjSection), pIndex->numSections) &&
+			  writeElements(file, pIndex->pNames, 1, pIndex->namesSize);
+
+	for(int i = 0; ok && i < 3; ++i)
+	{
+		ok = writeElements(file, pIndex->pRuns[i], sizeof(MioObjElementRun), pIndex->numRuns[i]);
+	}
+
+	ok = (fclose(file) == 0) && ok;
+
+	return ok;
+}
+
+// Function to read the .mioi file at "fpath" into "pIndex" if it was written for the source file
+// with stamp "pStamp". Returns false (leaving "pIndex" untouched) otherwise.
+static bool readMIOI(const char* fpath, const MioSourceStamp* pStamp, MioObjIndex* pIndex)
+{
+	FILE* file = fopen(fpath, "rb");
+
+	if(file == NULL)
+	{
+		return false;
+	}
+
+	MioiHeader header;
+	bool ok = readElements(file, &header, sizeof(MioiHeader), 1) &&
+			  memcmp(header.magic, "MIOI", 4) == 0 && header.byteOrder == MIO_MIOI_BYTE_ORDER &&
+			  header.version == MIO_MIOI_VERSION && header.headerSize == sizeof(MioiHeader) &&
+			  header.sourceSize == pStamp->size && header.sourceMTime == pStamp->mtime &&
+			  header.sourceMTimeNsec == pStamp->mtimeNsec && header.namesSize > 0;
+
+	MioObjIndex index;
+
+	memset(&index, 0, sizeof(MioObjIndex));
+
+	if(ok)
+	{
+		index.numSections = header.numSections;
+		index.namesSize = header.namesSize;
+		index.pSections = (MioObjSection*)mioAllocate(header.numSections, sizeof(MioObjSection));
+		index.pNames = (char*)mioAllocate(header.namesSize, 1);
+
+		ok = readElements(file, index.pSections, sizeof(MioObjSection), index.numSections) &&
+			 readElements(file, index.pNames, 1, index.namesSize) &&
+			 index.pNames[index.namesSize - 1] == '\0';
+	}
+
+	for(int i = 0; ok && i < 3; ++i)
+	{
+		index.numRuns[i] = header.numRuns[i];
+		index.pRuns[i] =
+			(MioObjElementRun*)mioAllocate(header.numRuns[i], sizeof(MioObjElementRun));
+
+		ok = readElements(file, index.pRuns[i], sizeof(MioObjElementRun), index.numRuns[i]);
+	}
+
+	ok = ok && fgetc(file) == EOF; // ... and nothing after the runs
+
+	for(unsigned int i = 0; ok && i < index.numSections; ++i)
+	{
+		const MioObjSection* pSection = &index.pSections[i];
+
+		ok = pSection->object < index.namesSize && pSection->group < index.namesSize &&
+			 pSection->material < index.namesSize && pSection->byteBegin <= pSection->byteEnd &&
+			 pSection->byteEnd <= header.sourceSize;
+	}
+
+	fclose(file);
+
+	if(ok)
+	{
+		index.numVertices = header.numVertices;
+		index.numTexCoords = header.numTexCoords;
+		index.numNormals = header.numNormals;
+		index.numFaces = header.numFaces;
+		index.fileSize = header.sourceSize;
+
+		*pIndex = index;
+	}
+	else
+	{
+		mioFreeOBJIndex(&index);
+	}
+
+	return ok;
+}
+
+void mioLoadOBJIndex(const char* fpath, MioObjIndex* pIndex)
+{
+	assert(pIndex != NULL);
+
+	MioSourceStamp stamp;
+	char* pIndexPath = mioAppendSuffix(fpath, ".mioi");
+
+	// NOTE: the stamp is taken first, so that an index is never stamped with a newer version
+	if(!mioGetSourceStamp(fpath, &stamp))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	if(readMIOI(pIndexPath, &stamp, pIndex))
+	{
+		mioLogInfo("read .mioi index: %s\n", pIndexPath);
+	}
+	else
+	{
+		mioBuildOBJIndex(fpath, pIndex);
+
+		// the index is written to a temporary file first so that it is never read half-written
+		char* pTempPath = mioAppendSuffix(pIndexPath, ".tmp");
+
+		if(writeMIOI(pTempPath, pIndex, &stamp))
+		{
+#if defined(_WIN32)
+			remove(pIndexPath); // "rename" does not replace an existing file on Windows
+#endif
+			if(rename(pTempPath, pIndexPath) != 0)
+			{
+				remove(pTempPath);
+			}
+		}
+		else
+		{
+			remove(pTempPath);
+		}
+
+		mioMemFree(pTempPath);
+	}
+
+	mioMemFree(pIndexPath);
+}
+
+void mioFreeOBJIndex(MioObjIndex* pIndex)
+{
+	assert(pIndex != NULL);
+
+	mioMemFree(pIndex->pSections);
+	mioMemFree(pIndex->pNames);
+
+	for(int i = 0; i < 3; ++i)
+	{
+		mioMemFree(pIndex->pRuns[i]);
+	}
+
+	memset(pIndex, 0, sizeof(MioObjIndex));
+}
+
+// Function to compare two unsigned ints (for "qsort")
+static int compareUints(const void* pA, const void* pB)
+{
+	const unsigned int a = *(const unsigned int*)pA;
+	const unsigned int b = *(const unsigned int*)pB;
+
+	return (a > b) - (a < b);
+}
+
+// Function to get the position of "value" in the sorted array "pValues" of "count" values, which
+// must hold it
+static size_t findSortedUint(const unsigned int* pValues, size_t count, unsigned int value)
+{
+	size_t first = 0;
+
+	while(count > 0)
+	{
+		const size_t half = count / 2;
+
+		if(pValues[first + half] < value)
+		{
+			first += half + 1;
+			count -= half + 1;
+		}
+		else
+		{
+			count = half;
+		}
+	}
+
+	return first;
+}
+
+// Function to parse the face-vertex data on the face line [pLine, pLineEnd) of a section (see
+// "readOBJSections"), where the ids become indices into the (whole) file with the "pCounts"
+// elements of each kind before the face, and indices of kinds that the file does not have are 0
+static void parseSectionFace(MioArray* pFaceSizes,
+							 MioArray* pIndices,
+							 const size_t* pCounts,
+							 const size_t* pTotals,
+							 const char* pLine,
+							 const char* pLineEnd)
+{
+	unsigned int faceVertexCount = 0;
+	const char* pToken = mioSkipBlanks(pLine, pLineEnd);
+
+	while(pToken != pLineEnd)
+	{
+		int64_t ids[3] = {0, 0, 0};
+		unsigned int found = 0;
+		const char* pTokenEnd = parseFaceVertex(pToken, pLineEnd, ids, &found);
+
+		pToken = mioSkipBlanks(pTokenEnd, pLineEnd);
+
+		if((found & 1u) == 0)
+		{
+			continue; // ... skip to next token
+		}
+
+		for(int i = 0; i < 3; ++i)
+		{
+			// NOTE: like "mioReadOBJ", a missing texcoord/normal id is stored as 0
+			const int64_t index = ((found >> i) & 1u) ? toIndex(ids[i], pCounts[i]) : 0;
+
+			if(pTotals[i] > 0 && (index < 0 || index >= (int64_t)pTotals[i]))
+			{
+				mioLogError("error: face index %lld refers to no element\n", (long long)ids[i]);
+				mioFail(MIO_STATUS_MALFORMED);
+			}
+
+			mioArrayPushUint(&pIndices[i], (unsigned int)index);
+		}
+
+		faceVertexCount++;
+	}
+
+	mioArrayPushUint(pFaceSizes, faceVertexCount);
+}
+
+// Function to read the elements of kind "kind" (vertex, texcoord or normal) with the sorted
+// indices "pUsed" from the mapped file [pData, pData + size) of "pIndex" into "pOut"
+static void readSectionElements(const MioObjIndex* pIndex,
+								const char* pData,
+								int kind,
+								const unsigned int* pUsed,
+								size_t numUsed,
+								double* pOut)
+{
+	static const enum ObjFileCmdType cmdTypes[3] = {VERTEX, TEXCOORD, NORMAL};
+	static const size_t cmdLens[3] = {2, 3, 3};
+	static const size_t dims[3] = {3, 2, 3};
+	static const char* cmdNames[3] = {"v", "vt", "vn"};
+
+	size_t next = 0; // index into "pUsed" of the next element to read
+
+	for(unsigned int r = 0; r < pIndex->numRuns[kind] && next < numUsed; ++r)
+	{
+		const MioObjElementRun* pRun = &pIndex->pRuns[kind][r];
+		const size_t runEnd = (size_t)pRun->first + pRun->count;
+
+		if(pUsed[next] >= runEnd || pRun->byteBegin >= pIndex->fileSize)
+		{
+			continue; // ... no element of the run is needed
+		}
+
+		MioInput input;
+		const char* pLine = NULL;
+		const char* pLineEnd = NULL;
+		size_t elementId = pRun->first;
+
+		mioInputOpenRange(&input, pData + pRun->byteBegin, pData + pIndex->fileSize);
+
+		while(next < numUsed && pUsed[next] < runEnd && mioInputNextLine(&input, &pLine, &pLineEnd))
+		{
+			if(parseCmdType(pLine, pLineEnd) != cmdTypes[kind])
+			{
+				continue;
+			}
+
+			if(elementId == pUsed[next])
+			{
+				double* pCoords = pOut + next * dims[kind];
+				const size_t nread =
+					mioParseDoubles(pLine + cmdLens[kind], pLineEnd, pCoords, dims[kind]);
+
+				if(nread != dims[kind])
+				{
+					mioLogError("error: have %zu components for %s%zu\n",
+								nread,
+								cmdNames[kind],
+								elementId);
+					mioFail(MIO_STATUS_MALFORMED);
+				}
+
+				next++;
+			}
+
+			elementId++;
+		}
+	}
+
+	if(next != numUsed)
+	{
+		mioLogError("error: the section index does not match the file\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+}
+
+// Function to read the sections "pSectionIds" of the mapped .obj file at "pData" into "pMesh"
+// (see "mioReadOBJSections")
+static void readOBJSections(const char* pData,
+							const MioObjIndex* pIndex,
+							const unsigned int* pSectionIds,
+							unsigned int numSectionIds,
+							ObjMesh* pMesh)
+{
+	const size_t totals[3] = {pIndex->numVertices, pIndex->numTexCoords, pIndex->numNormals};
+	MioArray faceSizes = {NULL, 0, 0};
+	MioArray indices[3] = {{NULL, 0, 0}, {NULL, 0, 0}, {NULL, 0, 0}};
+
+	//
+	// parse the faces of the sections
+	//
+	for(unsigned int s = 0; s < numSectionIds; ++s)
+	{
+		if(pSectionIds[s] >= pIndex->numSections)
+		{
+			mioLogError("error: invalid section %u\n", pSectionIds[s]);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+
+		const MioObjSection* pSection = &pIndex->pSections[pSectionIds[s]];
+
+		if(pSection->byteBegin > pSection->byteEnd || pSection->byteEnd > pIndex->fileSize)
+		{
+			mioLogError("error: the section index does not match the file\n");
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+
+		// NOTE: the counts follow the elements within the section for relative ids
+		size_t counts[3] = {pSection->numPrecedingVertices,
+							pSection->numPrecedingTexCoords,
+							pSection->numPrecedingNormals};
+		MioInput input;
+		const char* pLine = NULL;
+		const char* pLineEnd = NULL;
+
+		mioInputOpenRange(&input, pData + pSection->byteBegin, pData + pSection->byteEnd);
+
+		while(mioInputNextLine(&input, &pLine, &pLineEnd))
+		{
+			switch(parseCmdType(pLine, pLineEnd))
+			{
+			case VERTEX:
+				counts[0]++;
+				break;
+			case TEXCOORD:
+				counts[1]++;
+				break;
+			case NORMAL:
+				counts[2]++;
+				break;
+			case FACE:
+				parseSectionFace(&faceSizes, indices, counts, totals, pLine + 2, pLineEnd);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	//
+	// read the elements that the faces reference, which are renumbered in the order of the file
+	//
+	void* pCoords[3] = {NULL, NULL, NULL};
+	size_t numUsed[3] = {0, 0, 0};
+	static const size_t dims[3] = {3, 2, 3};
+
+	for(int i = 0; i < 3; ++i)
+	{
+		if(totals[i] == 0 || indices[i].size == 0)
+		{
+			continue;
+		}
+
+		unsigned int* pIndices = (unsigned int*)indices[i].pData;
+		unsigned int* pUsed = (unsigned int*)mioAllocate(indices[i].size, sizeof(unsigned int));
+
+		memcpy(pUsed, pIndices, indices[i].size * sizeof(unsigned int));
+		qsort(pUsed, indices[i].size, sizeof(unsigned int), compareUints);
+
+		for(size_t j = 0; j < indices[i].size; ++j)
+		{
+			if(numUsed[i] == 0 || pUsed[numUsed[i] - 1] != pUsed[j])
+			{
+				pUsed[numUsed[i]++] = pUsed[j];
+			}
+		}
+
+		for(size_t j = 0; j < indices[i].size; ++j)
+		{
+			pIndices[j] = (unsigned int)findSortedUint(pUsed, numUsed[i], pIndices[j]);
+		}
+
+		pCoords[i] = mioAllocate(numUsed[i] * dims[i], sizeof(double));
+		readSectionElements(pIndex, pData, i, pUsed, numUsed[i], (double*)pCoords[i]);
+
+		mioMemFree(pUsed);
+	}
+
+	printCounts(numUsed[0], numUsed[2], numUsed[1], faceSizes.size, indices[0].size);
+
+	memset(pMesh, 0, sizeof(ObjMesh));
+
+	pMesh->pVertices = pCoords[0];
+	pMesh->pTexCoords = pCoords[1];
+	pMesh->pNormals = pCoords[2];
+	pMesh->nVertices = numUsed[0];
+	pMesh->nTexCoords = numUsed[1];
+	pMesh->nNormals = numUsed[2];
+	pMesh->nFaces = faceSizes.size;
+	pMesh->nFaceIndices = indices[0].size;
+	pMesh->indexSize = sizeof(uint32_t);
+	pMesh->pFaceSizes = (unsigned int*)mioArrayRelease(&faceSizes, sizeof(unsigned int));
+	pMesh->pFaceVertexIndices = mioArrayRelease(&indices[0], sizeof(unsigned int));
+	pMesh->pFaceVertexTexCoordIndices = mioArrayRelease(&indices[1], sizeof(unsigned int));
+	pMesh->pFaceVertexNormalIndices = mioArrayRelease(&indices[2], sizeof(unsigned int));
+}
+
+void mioReadOBJSections(const char* fpath,
+						const MioObjIndex* pIndex,
+						const unsigned int* pSectionIds,
+						unsigned int numSectionIds,
+						double** pVertices,
+						double** pNormals,
+						double** pTexCoords,
+						unsigned int** pFaceSizes,
+						unsigned int** pFaceVertexIndices,
+						unsigned int** pFaceVertexTexCoordIndices,
+						unsigned int** pFaceVertexNormalIndices,
+						unsigned int* numVertices,
+						unsigned int* numNormals,
+						unsigned int* numTexcoords,
+						unsigned int* numFaces)
+{
+	assert(pIndex != NULL);
+
+	mioLogInfo("read %u section(s) of .obj file: %s\n", numSectionIds, fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	// NOTE: the sections are read in place, so the file cannot be a stream (e.g. compressed)
+	if(input.kind != MIO_INPUT_MAPPED || input.mappingSize != pIndex->fileSize)
+	{
+		mioLogError("error: the section index does not match file '%s'\n", fpath);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	ObjMesh mesh;
+
+	readOBJSections(input.pCur, pIndex, pSectionIds, numSectionIds, &mesh);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	handOverMesh(&mesh,
+				 pVertices,
+				 pNormals,
+				 pTexCoords,
+				 pFaceSizes,
+				 pFaceVertexIndices,
+				 pFaceVertexTexCoordIndices,
+				 pFaceVertexNormalIndices,
+				 numVertices,
+				 numNormals,
+				 numTexcoords,
+				 numFaces);
+
+	mioLogInfo("done.\n");
+}
+
+// the arguments of a call of "mioVisitOBJ"
+typedef struct ObjVisitCall
+{
+	const char* fpath;
+	const MioVisitor* pVisitor;
+} ObjVisitCall;
+
+// Function to visit the .obj file of the "ObjVisitCall" at "pArg" (see "mioVisitOBJ")
+static void visitOBJFile(void* pArg)
+{
+	const char* fpath = ((const ObjVisitCall*)pArg)->fpath;
+	const MioVisitor* pVisitor = ((const ObjVisitCall*)pArg)->pVisitor;
+
+	mioLogInfo("visit .obj file: %s\n", fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	visitLines(&input, pVisitor);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+}
+
+enum MioStatus mioVisitOBJ(
+	// absolute path to file
+	const char* fpath,
+	// the callbacks that are called for the elements in the file
+	const MioVisitor* pVisitor)
+{
+	assert(pVisitor != NULL);
+
+	ObjVisitCall call = {fpath, pVisitor};
+
+	return mioCallInFailScope(visitOBJFile, &call);
+}
+
+// Function to load the 8 bytes at "p" as a little-endian integer (a single load on most hosts)
+static inline uint64_t loadWordLE(const unsigned char* p)
+{
+	uint64_t word = 0;
+
+	for(int i = 7; i >= 0; --i)
+	{
+		word = (word << 8) | p[i];
+	}
+
+	return word;
+}
+
+// Function to get the bytes of "word" that are equal to the bytes of "pattern", as the high bit of
+// each byte
+static inline uint64_t matchBytes(uint64_t word, uint64_t pattern)
+{
+	const uint64_t x = word ^ pattern;
+	const uint64_t low7 = 0x7F7F7F7F7F7F7F7Full;
+
+	return ~(((x & low7) + low7) | x | low7);
+}
+
+// Function to count the face-vertices on a face line (starting after the "f" command) like
+// "parseFace", where a face-vertex is a token that starts with a (possibly signed) vertex id. The
+// line is processed 8 bytes at a time, which finds the first byte of each token as a non-blank
+// byte after a blank one.
+static size_t countFaceVertices(const char* pLine, const char* pLineEnd)
+{
+	const uint64_t ones = 0x0101010101010101ull;
+	const uint64_t highBits = ones * 0x80;
+	size_t count = 0;
+	uint64_t blankBefore = highBits >> 56; // ... the byte before the line is the command's blank
+
+	for(const char* p = pLine; p < pLineEnd; p += 8)
+	{
+		unsigned char bytes[8] = {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '};
+		const size_t size = (pLineEnd - p < 8) ? (size_t)(pLineEnd - p) : 8;
+
+		memcpy(bytes, p, size); // NOTE: a partial word at the end of the line is padded with blanks
+
+		const uint64_t word = loadWordLE(bytes);
+		const uint64_t blanks = matchBytes(word, ones * ' ') | matchBytes(word, ones * '\t');
+		const uint64_t starts = ~blanks & ((blanks << 8) | blankBefore) & highBits;
+
+		// a byte is a digit if (byte ^ '0') < 10, where adding 0x76 sets the high bit of 10 or more
+		const uint64_t offsets = word ^ (ones * '0');
+		const uint64_t digits = ~(((offsets & ~highBits) + ones * 0x76) | offsets) & highBits;
+		const uint64_t signs = matchBytes(word, ones * '-') | matchBytes(word, ones * '+');
+		const uint64_t ids = starts & (digits | signs);
+
+		count += (size_t)(((ids >> 7) * ones) >> 56); // sum of the bytes of (ids >> 7)
+		blankBefore = blanks >> 56;
+	}
+
+	return count;
+}
+
+void mioProbeOBJ(MioInput* pInput, MioMeshInfo* pInfo)
+{
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
+
+	while(mioInputNextLine(pInput, &pLine, &pLineEnd))
+	{
+		switch(parseCmdType(pLine, pLineEnd))
+		{
+		case VERTEX:
+			pInfo->numVertices++;
+			break;
+		case NORMAL:
+			pInfo->numNormals++;
+			break;
+		case TEXCOORD:
+			pInfo->numTexCoords++;
+			break;
+		case FACE:
+			pInfo->numFaces++;
+			pInfo->numFaceVertices += countFaceVertices(pLine + 2, pLineEnd);
+			break;
+		default:
+			break;
+		}
+	}
+}
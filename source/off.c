@@ -20,17 +20,29 @@
 
 #include "mio/off.h"
 
+#include "array.h"
+#include "fail.h"
+#include "format.h"
+#include "input.h"
+#include "into.h"
+#include "log.h"
+#include "parse.h"
+#include "stats.h"
+#include "writer.h"
+
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-bool readLine(FILE* file, char** line, size_t* len)
+// Function to get the next line that is neither blank nor a comment
+static bool readLine(MioInput* pInput, const char** ppLine, const char** ppLineEnd)
 {
-	while(getline(line, len, file))
+	while(mioInputNextLine(pInput, ppLine, ppLineEnd))
 	{
-		if(strlen(*line) > 1 && (*line)[0] != '#')
+		if(mioSkipBlanks(*ppLine, *ppLineEnd) != *ppLineEnd && (*ppLine)[0] != '#')
 		{
 			return true;
 		}
@@ -38,215 +50,1231 @@ bool readLine(FILE* file, char** line, size_t* len)
 	return false;
 }
 
-void mioReadOFF(const char* fpath,
-				double** pVertices,
-				unsigned int** pFaceVertexIndices,
-				unsigned int** pFaceSizes,
-				unsigned int* numVertices,
-				unsigned int* numFaces)
+// the header of an .off file, whose keyword "[ST][C][N]OFF [BINARY]" gives the variant of the file
+typedef struct OffHeader
 {
-	printf("read OFF file %s: \n", fpath);
+	unsigned int numVertices;
+	unsigned int numFaces;
+	// the attributes that follow the position of each vertex (in this order)
+	bool hasNormals; // "N"
+	bool hasColors; // "C"
+	bool hasTexCoords; // "ST"
+	// true if the elements after the header line are stored as big-endian 32-bit words
+	bool isBinary;
+} OffHeader;
+
+// the attributes of a vertex of an .off file (see "OffHeader")
+typedef struct OffVertexAttributes
+{
+	double normal[3];
+	// RGBA, where the alpha is 1 if the file only has RGB
+	double color[4];
+	double texCoord[2];
+} OffVertexAttributes;
+
+// Function to read the next "count" words of a binary .off file from "pInput" into "pWords" (in the
+// byte order of this host), or to skip them if "pWords" is NULL
+static void readBinaryWords(MioInput* pInput, uint32_t* pWords, size_t count)
+{
+	if(!mioInputRequire(pInput, count * sizeof(uint32_t)))
+	{
+		mioLogError("error: .off file ends before the end of its binary data\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
 
-	// using "rb" instead of "r" to prevent linefeed conversion
-	// See:
-	// https://stackoverflow.com/questions/27530636/read-text-file-in-c-with-fopen-without-linefeed-conversion
-	FILE* file = fopen(fpath, "rb");
+	const unsigned char* p = (const unsigned char*)pInput->pCur;
 
-	if(file == NULL)
+	for(size_t i = 0; pWords != NULL && i < count; ++i)
 	{
-		fprintf(stderr, "error: failed to open `%s`", fpath);
-		exit(1);
+		pWords[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) |
+					(uint32_t)p[3];
+		p += sizeof(uint32_t);
 	}
 
-	char* line = NULL;
-	size_t lineBufLen = 0;
+	pInput->pCur += count * sizeof(uint32_t);
+}
+
+// Function to check that the element counts of "pHeader" fit into the rest of "pInput" (if all of it
+// is available), so that a corrupt count fails before anything is allocated for it. A text value
+// takes at least 2 bytes (a digit and a separator), and a binary value a word, where each face has
+// at least 3 vertices (and a binary face a colour count).
+static void checkElementCounts(const MioInput* pInput, const OffHeader* pHeader)
+{
+	if(!pInput->atEnd)
+	{
+		return; // the end of a streamed input is not known yet
+	}
+
+	const uint64_t numVertexValues = 3 + (pHeader->hasNormals ? 3 : 0) +
+									 (pHeader->hasColors ? (pHeader->isBinary ? 4 : 3) : 0) +
+									 (pHeader->hasTexCoords ? 2 : 0);
+	const uint64_t numFaceValues = pHeader->isBinary ? 5 : 4;
+	const uint64_t numValues = (uint64_t)pHeader->numVertices * numVertexValues +
+							   (uint64_t)pHeader->numFaces * numFaceValues;
+	const uint64_t numBytes = (uint64_t)(pInput->pEnd - pInput->pCur);
+
+	// NOTE: the last value of a text file may have no newline after it
+	const uint64_t minSize =
+		pHeader->isBinary ? numValues * sizeof(uint32_t) : ((numValues > 0) ? numValues * 2 - 1 : 0);
+
+	if(numBytes < minSize)
+	{
+		mioLogError("error: .off file has %u vertices and %u faces, but only %llu bytes for them\n",
+					pHeader->numVertices,
+					pHeader->numFaces,
+					(unsigned long long)numBytes);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+}
+
+// Function to read the header of an .off file from "pInput" into "pHeader"
+static void readOFFHeader(MioInput* pInput, OffHeader* pHeader)
+{
+	const char* line = NULL;
+	const char* lineEnd = NULL;
 	bool lineOk = true;
-	int i = 0;
+
+	memset(pHeader, 0, sizeof(OffHeader));
 
 	// file header
-	lineOk = readLine(file, &line, &lineBufLen);
+	lineOk = readLine(pInput, &line, &lineEnd);
 
 	if(!lineOk)
 	{
-		fprintf(stderr, "error: .off file header not found\n");
-		exit(1);
+		mioLogError("error: .off file header not found\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	line = mioSkipBlanks(line, lineEnd);
+
+	if(lineEnd - line >= 2 && memcmp(line, "ST", 2) == 0)
+	{
+		pHeader->hasTexCoords = true;
+		line += 2;
+	}
+
+	if(line != lineEnd && *line == 'C')
+	{
+		pHeader->hasColors = true;
+		line++;
+	}
+
+	if(line != lineEnd && *line == 'N')
+	{
+		pHeader->hasNormals = true;
+		line++;
 	}
 
-	if(strstr(line, "OFF") == NULL)
+	if(line != lineEnd && (*line == '4' || *line == 'n'))
 	{
-		fprintf(stderr, "error: unrecognised .off file header\n");
-		exit(1);
+		mioLogError("error: unsupported .off variant (4OFF or nOFF)\n");
+		mioFail(MIO_STATUS_UNSUPPORTED_FORMAT);
+	}
+
+	if(!mioStartsWith(line, lineEnd, "OFF", &line))
+	{
+		mioLogError("error: unrecognised .off file header\n");
+		mioFail(MIO_STATUS_UNSUPPORTED_FORMAT);
+	}
+
+	line = mioSkipBlanks(line, lineEnd);
+	pHeader->isBinary = mioStartsWith(line, lineEnd, "BINARY", &line);
+
+	if(pHeader->isBinary)
+	{
+		// #vertices, #faces, #edges (right after the header line)
+		uint32_t counts[3];
+
+		readBinaryWords(pInput, counts, 3);
+
+		if(counts[0] > INT32_MAX || counts[1] > INT32_MAX)
+		{
+			mioLogError("error: invalid .off element count\n");
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+
+		pHeader->numVertices = counts[0];
+		pHeader->numFaces = counts[1];
+		checkElementCounts(pInput, pHeader);
+		return;
 	}
 
-	// #vertices, #faces, #edges
-	lineOk = readLine(file, &line, &lineBufLen);
+	// #vertices, #faces, #edges (on the header line, or else on the next line)
+	lineOk = mioSkipBlanks(line, lineEnd) != lineEnd || readLine(pInput, &line, &lineEnd);
 
 	if(!lineOk)
 	{
-		fprintf(stderr, "error: .off element count not found\n");
-		exit(1);
+		mioLogError("error: .off element count not found\n");
+		mioFail(MIO_STATUS_MALFORMED);
 	}
 
+	int nvertices = 0;
+	int nfaces = 0;
 	int nedges = 0;
-	sscanf(line, "%d %d %d", numVertices, numFaces, &nedges);
-	*pVertices = (double*)malloc(sizeof(double) * (*numVertices) * 3);
-	*pFaceSizes = (unsigned int*)malloc(sizeof(unsigned int) * (*numFaces));
+
+	if(!mioParseInt(&line, lineEnd, &nvertices) || !mioParseInt(&line, lineEnd, &nfaces) ||
+	   nvertices < 0 || nfaces < 0)
+	{
+		mioLogError("error: invalid .off element count\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	mioParseInt(&line, lineEnd, &nedges); // optional
+
+	pHeader->numVertices = (unsigned int)nvertices;
+	pHeader->numFaces = (unsigned int)nfaces;
+	checkElementCounts(pInput, pHeader);
+}
+
+// Function to parse the attributes of a vertex (see "OffHeader") from [line, lineEnd), which is
+// the rest of the line of the vertex after its position. Returns false if they are incomplete.
+static bool parseVertexAttributes(const char* line,
+								  const char* lineEnd,
+								  const OffHeader* pHeader,
+								  OffVertexAttributes* pAttributes)
+{
+	double values[9]; // at most a normal, an RGBA colour and a texture coordinate
+	size_t count = mioParseDoubles(line, lineEnd, values, 9);
+	const double* pValue = values;
+
+	if(pHeader->hasNormals)
+	{
+		if(count < 3)
+		{
+			return false;
+		}
+
+		memcpy(pAttributes->normal, pValue, 3 * sizeof(double));
+		pValue += 3;
+		count -= 3;
+	}
+
+	if(pHeader->hasColors)
+	{
+		// the alpha is optional, so whether there is one follows from the number of values
+		const size_t numTexCoordValues = pHeader->hasTexCoords ? 2 : 0;
+		const size_t numColorValues = (count >= 4 + numTexCoordValues) ? 4 : 3;
+
+		if(count < numColorValues)
+		{
+			return false;
+		}
+
+		pAttributes->color[3] = 1.0;
+		memcpy(pAttributes->color, pValue, numColorValues * sizeof(double));
+		pValue += numColorValues;
+		count -= numColorValues;
+	}
+
+	if(pHeader->hasTexCoords)
+	{
+		if(count < 2)
+		{
+			return false;
+		}
+
+		memcpy(pAttributes->texCoord, pValue, 2 * sizeof(double));
+	}
+
+	return true;
+}
+
+// Function to read the next vertex of a binary .off file from "pInput" (see "readVertex")
+static void readBinaryVertex(MioInput* pInput,
+							 const OffHeader* pHeader,
+							 size_t coordSize,
+							 void* pPosition,
+							 OffVertexAttributes* pAttributes)
+{
+	// the position, normal, colour (always RGBA) and texture coordinate
+	const size_t count = 3 + (pHeader->hasNormals ? 3 : 0) + (pHeader->hasColors ? 4 : 0) +
+						 (pHeader->hasTexCoords ? 2 : 0);
+	uint32_t words[12];
+	float values[12];
+
+	readBinaryWords(pInput, (pPosition != NULL) ? words : NULL, count);
+
+	if(pPosition == NULL)
+	{
+		return;
+	}
+
+	memcpy(values, words, count * sizeof(float));
+
+	for(size_t k = 0; k < 3; ++k)
+	{
+		if(coordSize == sizeof(double))
+		{
+			((double*)pPosition)[k] = values[k];
+		}
+		else
+		{
+			((float*)pPosition)[k] = values[k];
+		}
+	}
+
+	const float* pValue = values + 3;
+
+	if(pAttributes == NULL)
+	{
+		return;
+	}
+
+	for(size_t k = 0; pHeader->hasNormals && k < 3; ++k)
+	{
+		pAttributes->normal[k] = *pValue++;
+	}
+
+	for(size_t k = 0; pHeader->hasColors && k < 4; ++k)
+	{
+		pAttributes->color[k] = *pValue++;
+	}
+
+	for(size_t k = 0; pHeader->hasTexCoords && k < 2; ++k)
+	{
+		pAttributes->texCoord[k] = *pValue++;
+	}
+}
+
+// Function to read vertex "vertexId" from "pInput", with its position (3 coordinates of
+// "coordSize" bytes) into "pPosition" and its attributes into "pAttributes". The vertex is only
+// skipped if "pPosition" is NULL, and its attributes are not parsed if "pAttributes" is NULL.
+static void readVertex(MioInput* pInput,
+					   const OffHeader* pHeader,
+					   unsigned int vertexId,
+					   size_t coordSize,
+					   void* pPosition,
+					   OffVertexAttributes* pAttributes)
+{
+	if(pHeader->isBinary)
+	{
+		readBinaryVertex(pInput, pHeader, coordSize, pPosition, pAttributes);
+		return;
+	}
+
+	const char* line = NULL;
+	const char* lineEnd = NULL;
+
+	if(!readLine(pInput, &line, &lineEnd))
+	{
+		mioLogError("error: .off vertex not found\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	if(pPosition == NULL)
+	{
+		return; // ... the vertex is only skipped
+	}
+
+	bool ok = true;
+
+	for(size_t k = 0; k < 3 && ok; ++k)
+	{
+		ok = (coordSize == sizeof(double)) ? mioParseDouble(&line, lineEnd, (double*)pPosition + k)
+										   : mioParseFloat(&line, lineEnd, (float*)pPosition + k);
+	}
+
+	if(ok && pAttributes != NULL)
+	{
+		ok = parseVertexAttributes(line, lineEnd, pHeader, pAttributes);
+	}
+
+	if(!ok)
+	{
+		mioLogError("error: invalid .off vertex %u\n", vertexId);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+}
+
+// Function to read the next face from "pInput" up to its vertex count, which is returned. For a
+// text file, "*ppLine" is left at the vertex indices on the line of the face.
+static unsigned int readFaceSize(MioInput* pInput,
+								 const OffHeader* pHeader,
+								 const char** ppLine,
+								 const char** ppLineEnd)
+{
+	unsigned int n = 0; // number of vertices in face
+
+	if(pHeader->isBinary)
+	{
+		uint32_t word = 0;
+
+		readBinaryWords(pInput, &word, 1);
+		n = word;
+	}
+	else
+	{
+		if(!readLine(pInput, ppLine, ppLineEnd))
+		{
+			mioLogError("error: .off file face not found\n");
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+
+		mioParseUint(ppLine, *ppLineEnd, &n);
+	}
+
+	if(n < 3)
+	{
+		mioLogError("error: invalid vertex count in file %u\n", n);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	// the indices must be there before they are stored, so that a corrupt count fails before
+	// room is made for it (a text index takes at least 2 bytes of the line)
+	const bool haveIndices = pHeader->isBinary
+								 ? mioInputRequire(pInput, ((size_t)n + 1) * sizeof(uint32_t))
+								 : (size_t)(*ppLineEnd - *ppLine) >= (size_t)n * 2;
+
+	if(!haveIndices)
+	{
+		mioLogError("error: .off face has fewer than %u indices\n", n);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	return n;
+}
+
+// Function to check that the "n" vertex indices of face "faceId" at "pIndices" (if not NULL) refer
+// to vertices of the file
+static void checkFaceIndices(const OffHeader* pHeader,
+							 unsigned int faceId,
+							 unsigned int n,
+							 const unsigned int* pIndices)
+{
+	for(unsigned int j = 0; pIndices != NULL && j < n; ++j)
+	{
+		if(pIndices[j] >= pHeader->numVertices)
+		{
+			mioLogError("error: .off face %u refers to vertex %u (of %u)\n",
+						faceId,
+						pIndices[j],
+						pHeader->numVertices);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+	}
+}
+
+// Function to read the "n" vertex indices of face "faceId" (see "readFaceSize") into "pIndices",
+// or to skip them if it is NULL. The colour of the face (if any) is skipped.
+static void readFaceIndices(MioInput* pInput,
+							const OffHeader* pHeader,
+							const char* line,
+							const char* lineEnd,
+							unsigned int faceId,
+							unsigned int n,
+							unsigned int* pIndices)
+{
+	if(pHeader->isBinary)
+	{
+		uint32_t numColorValues = 0;
+
+		readBinaryWords(pInput, (uint32_t*)pIndices, n);
+		readBinaryWords(pInput, &numColorValues, 1);
+
+		if(numColorValues > 4)
+		{
+			mioLogError("error: invalid colour of .off face %u\n", faceId);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+
+		readBinaryWords(pInput, NULL, numColorValues);
+		checkFaceIndices(pHeader, faceId, n, pIndices);
+		return;
+	}
+
+	for(unsigned int j = 0; pIndices != NULL && j < n; ++j)
+	{ // parse remaining numbers on line
+		if(!mioParseUint(&line, lineEnd, pIndices + j))
+		{
+			mioLogError("error: .off face %u has fewer than %u indices\n", faceId, n);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+	}
+
+	checkFaceIndices(pHeader, faceId, n, pIndices);
+}
+
+// Function to read face "faceId" from "pInput" and append its vertex indices to "pIndices".
+// Returns the number of vertices in the face.
+static unsigned int
+readFace(MioInput* pInput, const OffHeader* pHeader, unsigned int faceId, MioArray* pIndices)
+{
+	const char* line = NULL;
+	const char* lineEnd = NULL;
+
+	const unsigned int n = readFaceSize(pInput, pHeader, &line, &lineEnd);
+
+	mioArrayReserve(pIndices, sizeof(unsigned int), pIndices->size + n);
+
+	readFaceIndices(pInput,
+					pHeader,
+					line,
+					lineEnd,
+					faceId,
+					n,
+					(unsigned int*)pIndices->pData + pIndices->size);
+
+	pIndices->size += n;
+
+	return n;
+}
+
+// Function to allocate the array of an attribute with "size" values per vertex into "*ppArray",
+// if the file has the attribute ("present") and the caller wants it ("ppArray" is not NULL).
+// Returns the array, or NULL if none was allocated.
+static double*
+allocateAttribute(double** ppArray, bool present, unsigned int numVertices, size_t size)
+{
+	if(ppArray == NULL)
+	{
+		return NULL;
+	}
+
+	*ppArray = present ? (double*)mioAllocate((size_t)numVertices * size, sizeof(double)) : NULL;
+
+	return *ppArray;
+}
+
+// Function to read the contents of an .off file from "pInput" with vertex coordinates of
+// "coordSize" bytes (i.e. sizeof(double) or sizeof(float)). The attributes of the vertices are
+// read into the arrays that are not NULL (see "mioReadOFFWithAttributes").
+static void readOFF(MioInput* pInput,
+					size_t coordSize,
+					void** ppVertices,
+					double** ppNormals,
+					double** ppColors,
+					double** ppTexCoords,
+					unsigned int** pFaceVertexIndices,
+					unsigned int** pFaceSizes,
+					unsigned int* numVertices,
+					unsigned int* numFaces)
+{
+	OffHeader header;
+	unsigned int i = 0;
+
+	readOFFHeader(pInput, &header);
+
+	*numVertices = header.numVertices;
+	*numFaces = header.numFaces;
+	*ppVertices = mioAllocate((size_t)(*numVertices) * 3, coordSize);
+	*pFaceSizes = (unsigned int*)mioAllocate(*numFaces, sizeof(unsigned int));
+
+	double* pNormals = allocateAttribute(ppNormals, header.hasNormals, *numVertices, 3);
+	double* pColors = allocateAttribute(ppColors, header.hasColors, *numVertices, 4);
+	double* pTexCoords = allocateAttribute(ppTexCoords, header.hasTexCoords, *numVertices, 2);
+	const bool readsAttributes = pNormals != NULL || pColors != NULL || pTexCoords != NULL;
 
 	// vertices
-	for(i = 0; i < (double)(*numVertices); ++i)
+	for(i = 0; i < *numVertices; ++i)
 	{
-		lineOk = readLine(file, &line, &lineBufLen);
+		OffVertexAttributes attributes;
 
-		if(!lineOk)
+		readVertex(pInput,
+				   &header,
+				   i,
+				   coordSize,
+				   (char*)(*ppVertices) + (size_t)i * 3 * coordSize,
+				   readsAttributes ? &attributes : NULL);
+
+		if(pNormals != NULL)
 		{
-			fprintf(stderr, "error: .off vertex not found\n");
-			exit(1);
+			memcpy(pNormals + (size_t)i * 3, attributes.normal, sizeof(attributes.normal));
 		}
 
-		double x, y, z;
-		sscanf(line, "%lf %lf %lf", &x, &y, &z);
+		if(pColors != NULL)
+		{
+			memcpy(pColors + (size_t)i * 4, attributes.color, sizeof(attributes.color));
+		}
 
-		(*pVertices)[(i * 3) + 0] = x;
-		(*pVertices)[(i * 3) + 1] = y;
-		(*pVertices)[(i * 3) + 2] = z;
+		if(pTexCoords != NULL)
+		{
+			memcpy(pTexCoords + (size_t)i * 2, attributes.texCoord, sizeof(attributes.texCoord));
+		}
 	}
-#if _WIN64
-	__int64 facesStartOffset = _ftelli64(file);
-#else
-	long int facesStartOffset = ftell(file);
-#endif
-	int numFaceIndices = 0;
 
 	// faces
-	for(i = 0; i < (int)(*numFaces); ++i)
+	//
+	// The face indices are parsed in the same pass as the face sizes, so the index array grows
+	// as faces are read. Most meshes are triangle meshes, which is used as the initial guess for
+	// the number of indices.
+	MioArray faceVertexIndices = {NULL, 0, 0};
+	mioArrayReserve(&faceVertexIndices, sizeof(unsigned int), (size_t)(*numFaces) * 3);
+
+	for(i = 0; i < *numFaces; ++i)
 	{
-		lineOk = readLine(file, &line, &lineBufLen);
+		(*pFaceSizes)[i] = readFace(pInput, &header, i, &faceVertexIndices);
+	}
+
+	(*pFaceVertexIndices) =
+		(unsigned int*)mioArrayRelease(&faceVertexIndices, sizeof(unsigned int));
+}
+
+// Function to store the attribute "pValues" ("numCoords" values) of vertex "i" in "pBuffer"
+// (with coordinates of "coordSize" bytes), if the buffer has room for it
+static void storeAttribute(const MioCoordBuffer* pBuffer,
+						   size_t numCoords,
+						   size_t coordSize,
+						   size_t i,
+						   const double* pValues)
+{
+	if(pBuffer->pData == NULL || i >= pBuffer->capacity)
+	{
+		return;
+	}
 
-		if(!lineOk)
+	const size_t stride = mioCoordBufferStride(pBuffer, numCoords, coordSize);
+	void* pCoords = mioCoordBufferAt(pBuffer, stride, i);
+
+	for(size_t k = 0; k < numCoords; ++k)
+	{
+		if(coordSize == sizeof(double))
+		{
+			((double*)pCoords)[k] = pValues[k];
+		}
+		else
 		{
-			fprintf(stderr, "error: .off file face not found\n");
-			exit(1);
+			((float*)pCoords)[k] = (float)pValues[k];
 		}
+	}
+}
 
-		int n; // number of vertices in face
-		sscanf(line, "%d", &n);
+// Function to check whether "count" indices from index "first" on fit into "pBuffer" (which is
+// not stored if it is NULL)
+static bool hasRoom(const MioIndexBuffer* pBuffer, size_t first, size_t count)
+{
+	return pBuffer != NULL && pBuffer->pData != NULL && first + count <= pBuffer->capacity;
+}
+
+// Function to read the contents of an .off file from "pInput" with vertex coordinates of
+// "coordSize" bytes into the arrays of "pBuffers" (see "mioReadOFFInto"). The elements are counted
+// first (as the number of face-vertices is not in the header), and if they fit, each of them is
+// parsed straight into its place in the arrays.
+static bool readOFFInto(MioInput* pInput,
+						size_t coordSize,
+						const MioMeshBuffers* pBuffers,
+						MioMeshCounts* pCounts)
+{
+	const char* line = NULL;
+	const char* lineEnd = NULL;
+	OffHeader header;
+	unsigned int i = 0;
+
+	memset(pCounts, 0, sizeof(MioMeshCounts));
+
+	if(!mioCheckBuffers(pBuffers, pCounts, coordSize))
+	{
+		return false;
+	}
+
+	mioCountInput(pInput, mioProbeOFF, pCounts);
+
+	if(!mioCheckBuffers(pBuffers, pCounts, coordSize))
+	{
+		return false;
+	}
 
-		if(n < 3)
+	memset(pCounts, 0, sizeof(MioMeshCounts));
+	readOFFHeader(pInput, &header);
+
+	pCounts->numVertices = header.numVertices;
+	pCounts->numNormals = header.hasNormals ? header.numVertices : 0;
+	pCounts->numTexCoords = header.hasTexCoords ? header.numVertices : 0;
+	pCounts->numFaces = header.numFaces;
+
+	const MioCoordBuffer* pVertices = &pBuffers->vertices;
+	const MioCoordBuffer* pNormals = &pBuffers->normals;
+	const MioCoordBuffer* pTexCoords = &pBuffers->texCoords;
+	const size_t vertexStride = mioCoordBufferStride(pVertices, 3, coordSize);
+	const size_t numStoredVertices = (pVertices->pData != NULL) ? pVertices->capacity : 0;
+	const bool storesAttributes = (header.hasNormals && pNormals->pData != NULL) ||
+								  (header.hasTexCoords && pTexCoords->pData != NULL);
+
+	// vertices
+	for(i = 0; i < header.numVertices; ++i)
+	{
+		// NOTE: a vertex that does not fit is parsed anyway if its attributes are stored
+		double position[3];
+		OffVertexAttributes attributes;
+		void* pPosition = (i < numStoredVertices) ? mioCoordBufferAt(pVertices, vertexStride, i)
+												  : (storesAttributes ? position : NULL);
+
+		readVertex(pInput, &header, i, coordSize, pPosition, storesAttributes ? &attributes : NULL);
+
+		if(storesAttributes && header.hasNormals)
 		{
-			fprintf(stderr, "error: invalid vertex count in file %d\n", n);
-			exit(1);
+			storeAttribute(pNormals, 3, coordSize, i, attributes.normal);
 		}
 
-		(*pFaceSizes)[i] = n;
-		numFaceIndices += n;
+		if(storesAttributes && header.hasTexCoords)
+		{
+			storeAttribute(pTexCoords, 2, coordSize, i, attributes.texCoord);
+		}
 	}
 
-	(*pFaceVertexIndices) = (unsigned int*)malloc(sizeof(unsigned int) * numFaceIndices);
+	// faces
+	//
+	// The normal and texture-coord indices of a face-vertex are its vertex index, since the
+	// attributes are per vertex. The indices of a face are parsed into the first of these arrays
+	// that has room for them, and are copied into the others.
+	const MioIndexBuffer* pFaceSizes = &pBuffers->faceSizes;
+	const size_t numStoredFaces = (pFaceSizes->pData != NULL) ? pFaceSizes->capacity : 0;
+	const MioIndexBuffer* pIndexBuffers[3] = {
+		&pBuffers->faceVertexIndices,
+		header.hasNormals ? &pBuffers->faceVertexNormalIndices : NULL,
+		header.hasTexCoords ? &pBuffers->faceVertexTexCoordIndices : NULL};
 
-#if _WIN64
-	int api_err = _fseeki64(file, facesStartOffset, SEEK_SET);
-#else
-	int api_err = fseek(file, facesStartOffset, SEEK_SET);
-#endif
-	if(api_err != 0)
+	for(i = 0; i < header.numFaces; ++i)
 	{
-		fprintf(stderr, "error: fseek failed\n");
-		exit(1);
+		const unsigned int n = readFaceSize(pInput, &header, &line, &lineEnd);
+		const size_t first = pCounts->numFaceVertices;
+		unsigned int* pIndices = NULL;
+
+		if(i < numStoredFaces)
+		{
+			pFaceSizes->pData[i] = n;
+		}
+
+		for(int k = 0; k < 3 && pIndices == NULL; ++k)
+		{
+			pIndices = hasRoom(pIndexBuffers[k], first, n) ? pIndexBuffers[k]->pData + first : NULL;
+		}
+
+		readFaceIndices(pInput, &header, line, lineEnd, i, n, pIndices);
+
+		for(int k = 0; k < 3 && pIndices != NULL; ++k)
+		{
+			if(hasRoom(pIndexBuffers[k], first, n) && pIndexBuffers[k]->pData + first != pIndices)
+			{
+				memcpy(pIndexBuffers[k]->pData + first, pIndices, n * sizeof(unsigned int));
+			}
+		}
+
+		pCounts->numFaceVertices += n;
 	}
 
-	int indexOffset = 0;
-	for(i = 0; i < (int)(*numFaces); ++i)
+	return mioCheckBuffers(pBuffers, pCounts, coordSize);
+}
+
+// Function to read the contents of an .off file from "pInput" and pass the elements to the
+// callbacks of "pVisitor"
+static void visitOFF(MioInput* pInput, const MioVisitor* pVisitor)
+{
+	OffHeader header;
+	unsigned int i = 0;
+
+	readOFFHeader(pInput, &header);
+
+	const bool visitsNormals = header.hasNormals && pVisitor->onNormal != NULL;
+	const bool visitsTexCoords = header.hasTexCoords && pVisitor->onTexCoord != NULL;
+	const bool visitsVertices = pVisitor->onVertex != NULL || visitsNormals || visitsTexCoords;
+
+	// vertices
+	for(i = 0; i < header.numVertices; ++i)
 	{
+		double xyz[3] = {0.0, 0.0, 0.0};
+		OffVertexAttributes attributes;
 
-		lineOk = readLine(file, &line, &lineBufLen);
+		readVertex(pInput,
+				   &header,
+				   i,
+				   sizeof(double),
+				   visitsVertices ? xyz : NULL,
+				   (visitsNormals || visitsTexCoords) ? &attributes : NULL);
 
-		if(!lineOk)
+		if(pVisitor->onVertex != NULL)
 		{
-			fprintf(stderr, "error: .off file face not found\n");
-			exit(1);
+			pVisitor->onVertex(xyz, pVisitor->pUserData);
 		}
 
-		int n; // number of vertices in face
-		sscanf(line, "%d", &n);
+		if(visitsNormals)
+		{
+			pVisitor->onNormal(attributes.normal, pVisitor->pUserData);
+		}
 
-		char* lineBufShifted = line;
-		int j = 0;
+		if(visitsTexCoords)
+		{
+			pVisitor->onTexCoord(attributes.texCoord, pVisitor->pUserData);
+		}
+	}
 
-		while(j < n)
-		{ // parse remaining numbers on line
-			lineBufShifted = strstr(lineBufShifted, " ") + 1; // start of next number
+	if(pVisitor->onFace == NULL)
+	{
+		return; // nothing else to visit
+	}
 
-			int val;
-			sscanf(lineBufShifted, "%d", &val);
+	// faces (the index array is reused from face to face), where the normal and texture-coord
+	// indices are the vertex indices since the attributes are per vertex
+	MioArray faceVertexIndices = {NULL, 0, 0};
 
-			(*pFaceVertexIndices)[indexOffset + j] = val;
-			j++;
-		}
+	for(i = 0; i < header.numFaces; ++i)
+	{
+		faceVertexIndices.size = 0;
 
-		indexOffset += n;
+		const unsigned int n = readFace(pInput, &header, i, &faceVertexIndices);
+		const unsigned int* pIndices = (const unsigned int*)faceVertexIndices.pData;
+
+		pVisitor->onFace(pIndices,
+						 header.hasTexCoords ? pIndices : NULL,
+						 header.hasNormals ? pIndices : NULL,
+						 n,
+						 pVisitor->pUserData);
+	}
+
+	mioMemFree(faceVertexIndices.pData);
+}
+
+// Function to read the .off file at "fpath" (see "readOFF")
+static void readOFFFile(const char* fpath,
+						size_t coordSize,
+						void** ppVertices,
+						double** ppNormals,
+						double** ppColors,
+						double** ppTexCoords,
+						unsigned int** pFaceVertexIndices,
+						unsigned int** pFaceSizes,
+						unsigned int* numVertices,
+						unsigned int* numFaces)
+{
+	mioLogInfo("read OFF file %s: \n", fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open `%s`", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
 	}
 
-	free(line);
+	readOFF(&input,
+			coordSize,
+			ppVertices,
+			ppNormals,
+			ppColors,
+			ppTexCoords,
+			pFaceVertexIndices,
+			pFaceSizes,
+			numVertices,
+			numFaces);
 
-	fclose(file);
+	mioLoadEnd(&input);
+	mioInputClose(&input);
 }
 
-// To ignore edges when writing the output just pass pEdgeVertexIndices = NULL and set numEdges = 0
-void mioWriteOFF(const char* fpath,
-				 double* pVertices,
-				 unsigned int* pFaceVertexIndices,
-				 unsigned int* pFaceSizes,
-				 unsigned int* pEdgeVertexIndices,
-				 unsigned int numVertices,
-				 unsigned int numFaces,
-				 unsigned int numEdges)
+void mioReadOFF(const char* fpath,
+				double** pVertices,
+				unsigned int** pFaceVertexIndices,
+				unsigned int** pFaceSizes,
+				unsigned int* numVertices,
+				unsigned int* numFaces)
+{
+	void* pVertexData = NULL;
+
+	readOFFFile(fpath,
+				sizeof(double),
+				&pVertexData,
+				NULL,
+				NULL,
+				NULL,
+				pFaceVertexIndices,
+				pFaceSizes,
+				numVertices,
+				numFaces);
+
+	*pVertices = (double*)pVertexData;
+}
+
+void mioReadOFFWithAttributes(const char* fpath,
+							  double** pVertices,
+							  double** pNormals,
+							  double** pColors,
+							  double** pTexCoords,
+							  unsigned int** pFaceVertexIndices,
+							  unsigned int** pFaceSizes,
+							  unsigned int* numVertices,
+							  unsigned int* numFaces)
+{
+	void* pVertexData = NULL;
+
+	readOFFFile(fpath,
+				sizeof(double),
+				&pVertexData,
+				pNormals,
+				pColors,
+				pTexCoords,
+				pFaceVertexIndices,
+				pFaceSizes,
+				numVertices,
+				numFaces);
+
+	*pVertices = (double*)pVertexData;
+}
+
+void mioReadOFFFromMemory(const void* pData,
+						  size_t dataSize,
+						  double** pVertices,
+						  unsigned int** pFaceVertexIndices,
+						  unsigned int** pFaceSizes,
+						  unsigned int* numVertices,
+						  unsigned int* numFaces)
+{
+	mioLogInfo("read OFF file from memory: %zu bytes\n", dataSize);
+
+	MioInput input;
+
+	mioLoadBegin();
+	mioInputOpenRange(&input, (const char*)pData, (const char*)pData + dataSize);
+
+	void* pVertexData = NULL;
+
+	readOFF(&input,
+			sizeof(double),
+			&pVertexData,
+			NULL,
+			NULL,
+			NULL,
+			pFaceVertexIndices,
+			pFaceSizes,
+			numVertices,
+			numFaces);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	*pVertices = (double*)pVertexData;
+}
+
+// Function to read the .off file at "fpath" into "pBuffers" (see "readOFFInto")
+static bool readOFFFileInto(const char* fpath,
+							unsigned int numThreads,
+							size_t coordSize,
+							const MioMeshBuffers* pBuffers,
+							MioMeshCounts* pCounts)
 {
-	fprintf(stdout, "write OFF file: %s\n", fpath);
+	(void)numThreads; // .off files are read on the calling thread
+
+	mioLogInfo("read OFF file %s: \n", fpath);
+
+	MioInput input;
 
-	FILE* file = fopen(fpath, "w");
+	mioLoadBegin();
 
-	if(file == NULL)
+	if(!mioInputOpenFile(&input, fpath))
 	{
-		fprintf(stderr, "error: failed to open `%s`", fpath);
-		exit(1);
+		mioLogError("error: failed to open `%s`", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
 	}
 
-	fprintf(file, "OFF\n");
-	fprintf(file, "%d %d %d\n", numVertices, numFaces, numEdges);
+	const bool ok = readOFFInto(&input, coordSize, pBuffers, pCounts);
 
-	int i;
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	return ok;
+}
 
-	for(i = 0; i < (int)numVertices; ++i)
+enum MioStatus
+mioReadOFFInto(const char* fpath, const MioMeshBuffers* pBuffers, MioMeshCounts* pCounts)
+{
+	return mioTryReadInto(readOFFFileInto, fpath, 1, sizeof(double), pBuffers, pCounts);
+}
+
+enum MioStatus
+mioReadOFFIntof(const char* fpath, const MioMeshBuffers* pBuffers, MioMeshCounts* pCounts)
+{
+	return mioTryReadInto(readOFFFileInto, fpath, 1, sizeof(float), pBuffers, pCounts);
+}
+
+void mioReadOFFf(const char* fpath,
+				 float** pVertices,
+				 unsigned int** pFaceVertexIndices,
+				 unsigned int** pFaceSizes,
+				 unsigned int* numVertices,
+				 unsigned int* numFaces)
+{
+	void* pVertexData = NULL;
+
+	readOFFFile(fpath,
+				sizeof(float),
+				&pVertexData,
+				NULL,
+				NULL,
+				NULL,
+				pFaceVertexIndices,
+				pFaceSizes,
+				numVertices,
+				numFaces);
+
+	*pVertices = (float*)pVertexData;
+}
+
+// the vertices or faces that "formatVertexRows" and "formatFaceRows" write
+typedef struct OffRows
+{
+	const void* pVertices;
+	size_t coordSize;
+	const unsigned int* pFaceVertexIndices;
+	const unsigned int* pFaceSizes;
+} OffRows;
+
+static void formatVertexRows(
+	MioWriter* pWriter, const void* pContext, size_t beginRow, size_t endRow, size_t offset)
+{
+	const OffRows* pRows = (const OffRows*)pContext;
+
+	(void)offset;
+
+	for(size_t i = beginRow; i < endRow; ++i)
 	{
-		const double* vptr = pVertices + (i * 3);
-		fprintf(file, "%f %f %f\n", vptr[0], vptr[1], vptr[2]);
+		mioWriterPutCoord(pWriter, pRows->pVertices, i * 3 + 0, pRows->coordSize);
+		mioWriterPutChar(pWriter, ' ');
+		mioWriterPutCoord(pWriter, pRows->pVertices, i * 3 + 1, pRows->coordSize);
+		mioWriterPutChar(pWriter, ' ');
+		mioWriterPutCoord(pWriter, pRows->pVertices, i * 3 + 2, pRows->coordSize);
+		mioWriterPutChar(pWriter, '\n');
 	}
+}
+
+// Function to write the faces "[beginRow, endRow)", where "offset" is the index of the first
+// face-vertex of face "beginRow"
+static void formatFaceRows(
+	MioWriter* pWriter, const void* pContext, size_t beginRow, size_t endRow, size_t offset)
+{
+	const OffRows* pRows = (const OffRows*)pContext;
 
-	int base = 0;
+	size_t base = offset;
 
-	for(i = 0; i < (int)numFaces; ++i)
+	for(size_t i = beginRow; i < endRow; ++i)
 	{
 
-		const unsigned int faceVertexCount = (pFaceSizes != NULL) ? pFaceSizes[i] : 3;
-		fprintf(file, "%d", (int)faceVertexCount);
+		const unsigned int faceVertexCount = (pRows->pFaceSizes != NULL) ? pRows->pFaceSizes[i] : 3;
+		mioWriterPutUint(pWriter, faceVertexCount);
 		int j;
 
 		for(j = 0; j < (int)faceVertexCount; ++j)
 		{
-			const unsigned int* fptr = pFaceVertexIndices + base + j;
-			fprintf(file, " %d", *fptr);
+			const unsigned int* fptr = pRows->pFaceVertexIndices + base + j;
+			mioWriterPutChar(pWriter, ' ');
+			mioWriterPutUint(pWriter, *fptr);
 		}
 
-		fprintf(file, "\n");
+		mioWriterPutChar(pWriter, '\n');
 
 		base += faceVertexCount;
 	}
+}
+
+// Function to write an .off file with vertex coordinates of "coordSize" bytes (i.e. sizeof(double)
+// or sizeof(float)), where the vertex and face lines are formatted on up to "numThreads" threads
+// (see "mioWriterPutRows")
+static void writeOFF(const char* fpath,
+					 const void* pVertices,
+					 size_t coordSize,
+					 const unsigned int* pFaceVertexIndices,
+					 const unsigned int* pFaceSizes,
+					 const unsigned int* pEdgeVertexIndices,
+					 unsigned int numVertices,
+					 unsigned int numFaces,
+					 unsigned int numEdges,
+					 unsigned int numThreads)
+{
+	mioLogInfo("write OFF file: %s\n", fpath);
+
+	MioWriter writer;
+
+	if(!mioWriterOpen(&writer, fpath, "w"))
+	{
+		mioLogError("error: failed to open `%s`", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	mioWriterPutString(&writer, "OFF\n");
+	mioWriterPutUint(&writer, numVertices);
+	mioWriterPutChar(&writer, ' ');
+	mioWriterPutUint(&writer, numFaces);
+	mioWriterPutChar(&writer, ' ');
+	mioWriterPutUint(&writer, numEdges);
+	mioWriterPutChar(&writer, '\n');
+
+	const OffRows rows = {pVertices, coordSize, pFaceVertexIndices, pFaceSizes};
+
+	mioWriterPutRows(&writer, formatVertexRows, &rows, numVertices, NULL, 3, numThreads);
+	mioWriterPutRows(&writer, formatFaceRows, &rows, numFaces, pFaceSizes, 3, numThreads);
+
+	int i;
 
 	for(i = 0; i < (int)numEdges; ++i)
 	{
 		const unsigned int* eptr = pEdgeVertexIndices + (i * 2);
-		fprintf(file, "%u %u\n", eptr[0], eptr[1]);
+		mioWriterPutUint(&writer, eptr[0]);
+		mioWriterPutChar(&writer, ' ');
+		mioWriterPutUint(&writer, eptr[1]);
+		mioWriterPutChar(&writer, '\n');
+	}
+
+	if(!mioWriterClose(&writer))
+	{
+		mioLogError("error: failed to write `%s`\n", fpath);
+	}
+}
+
+// To ignore edges when writing the output just pass pEdgeVertexIndices = NULL and set numEdges = 0
+void mioWriteOFF(const char* fpath,
+				 double* pVertices,
+				 unsigned int* pFaceVertexIndices,
+				 unsigned int* pFaceSizes,
+				 unsigned int* pEdgeVertexIndices,
+				 unsigned int numVertices,
+				 unsigned int numFaces,
+				 unsigned int numEdges)
+{
+	writeOFF(fpath,
+			 pVertices,
+			 sizeof(double),
+			 pFaceVertexIndices,
+			 pFaceSizes,
+			 pEdgeVertexIndices,
+			 numVertices,
+			 numFaces,
+			 numEdges,
+			 1);
+}
+
+void mioWriteOFFf(const char* fpath,
+				  float* pVertices,
+				  unsigned int* pFaceVertexIndices,
+				  unsigned int* pFaceSizes,
+				  unsigned int* pEdgeVertexIndices,
+				  unsigned int numVertices,
+				  unsigned int numFaces,
+				  unsigned int numEdges)
+{
+	writeOFF(fpath,
+			 pVertices,
+			 sizeof(float),
+			 pFaceVertexIndices,
+			 pFaceSizes,
+			 pEdgeVertexIndices,
+			 numVertices,
+			 numFaces,
+			 numEdges,
+			 1);
+}
+
+void mioWriteOFFParallel(const char* fpath,
+						 double* pVertices,
+						 unsigned int* pFaceVertexIndices,
+						 unsigned int* pFaceSizes,
+						 unsigned int* pEdgeVertexIndices,
+						 unsigned int numVertices,
+						 unsigned int numFaces,
+						 unsigned int numEdges,
+						 unsigned int numThreads)
+{
+	writeOFF(fpath,
+			 pVertices,
+			 sizeof(double),
+			 pFaceVertexIndices,
+			 pFaceSizes,
+			 pEdgeVertexIndices,
+			 numVertices,
+			 numFaces,
+			 numEdges,
+			 numThreads);
+}
+
+void mioWriteOFFParallelf(const char* fpath,
+						  float* pVertices,
+						  unsigned int* pFaceVertexIndices,
+						  unsigned int* pFaceSizes,
+						  unsigned int* pEdgeVertexIndices,
+						  unsigned int numVertices,
+						  unsigned int numFaces,
+						  unsigned int numEdges,
+						  unsigned int numThreads)
+{
+	writeOFF(fpath,
+			 pVertices,
+			 sizeof(float),
+			 pFaceVertexIndices,
+			 pFaceSizes,
+			 pEdgeVertexIndices,
+			 numVertices,
+			 numFaces,
+			 numEdges,
+			 numThreads);
+}
+
+// the arguments of a call of "mioVisitOFF"
+typedef struct OffVisitCall
+{
+	const char* fpath;
+	const MioVisitor* pVisitor;
+} OffVisitCall;
+
+// Function to visit the .off file of the "OffVisitCall" at "pArg" (see "mioVisitOFF")
+static void visitOFFFile(void* pArg)
+{
+	const char* fpath = ((const OffVisitCall*)pArg)->fpath;
+	const MioVisitor* pVisitor = ((const OffVisitCall*)pArg)->pVisitor;
+
+	mioLogInfo("visit OFF file %s: \n", fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open `%s`", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	visitOFF(&input, pVisitor);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+}
+
+enum MioStatus mioVisitOFF(
+	// absolute path to file
+	const char* fpath,
+	// the callbacks that are called for the elements in the file
+	const MioVisitor* pVisitor)
+{
+	assert(pVisitor != NULL);
+
+	OffVisitCall call = {fpath, pVisitor};
+
+	return mioCallInFailScope(visitOFFFile, &call);
+}
+
+void mioProbeOFF(MioInput* pInput, MioMeshInfo* pInfo)
+{
+	OffHeader header;
+	const char* line = NULL;
+	const char* lineEnd = NULL;
+
+	readOFFHeader(pInput, &header);
+
+	pInfo->numVertices = header.numVertices;
+	pInfo->numNormals = header.hasNormals ? header.numVertices : 0;
+	pInfo->numTexCoords = header.hasTexCoords ? header.numVertices : 0;
+	pInfo->numFaces = header.numFaces;
+
+	// the vertices are skipped, and only the vertex count of each face is parsed
+	for(unsigned int i = 0; i < header.numVertices; ++i)
+	{
+		readVertex(pInput, &header, i, sizeof(double), NULL, NULL);
 	}
 
-	fclose(file);
+	for(unsigned int i = 0; i < header.numFaces; ++i)
+	{
+		const unsigned int n = readFaceSize(pInput, &header, &line, &lineEnd);
+
+		readFaceIndices(pInput, &header, line, lineEnd, i, n, NULL);
+
+		pInfo->numFaceVertices += n;
+	}
 }
@@ -0,0 +1,625 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "parse.h"
+
+#include "array.h"
+#include "pow5.h"
+
+#include <float.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline bool isDigit(char c)
+{
+	return (unsigned char)(c - '0') < 10;
+}
+
+// Function to parse a floating point number with strtod (into "pDouble"), or with strtof (into
+// "pFloat") if "pDouble" is NULL. The token is copied into a null-terminated buffer first since the
+// input range is not null-terminated.
+// NOTE: strtod depends on the current locale (the decimal point character).
+static bool parseStrtod(const char** ppCur, const char* pEnd, double* pDouble, float* pFloat)
+{
+	const char* p = mioSkipBlanks(*ppCur, pEnd);
+
+	const char* pTokenEnd = p;
+
+	while(pTokenEnd != pEnd && !mioIsBlank(*pTokenEnd))
+	{
+		pTokenEnd++;
+	}
+
+	const size_t tokenLen = (size_t)(pTokenEnd - p);
+
+	if(tokenLen == 0)
+	{
+		return false;
+	}
+
+	char localBuf[128];
+	char* buf = (tokenLen < sizeof(localBuf)) ? localBuf : (char*)mioMemAlloc(tokenLen + 1);
+
+	if(buf == NULL)
+	{
+		return false;
+	}
+
+	memcpy(buf, p, tokenLen);
+	buf[tokenLen] = '\0';
+
+	char* pParseEnd = NULL;
+	double value = 0.0;
+	float valueFloat = 0.0f;
+
+	if(pDouble != NULL)
+	{
+		value = strtod(buf, &pParseEnd);
+	}
+	else
+	{
+		valueFloat = strtof(buf, &pParseEnd);
+	}
+
+	const size_t parsedLen = (size_t)(pParseEnd - buf);
+
+	if(buf != localBuf)
+	{
+		mioMemFree(buf);
+	}
+
+	if(parsedLen == 0)
+	{
+		return false;
+	}
+
+	if(pDouble != NULL)
+	{
+		*pDouble = value;
+	}
+	else
+	{
+		*pFloat = valueFloat;
+	}
+
+	*ppCur = p + parsedLen;
+
+	return true;
+}
+
+#if !defined(MIO_USE_STRTOD)
+
+//
+// Fast and correctly rounded decimal-to-binary conversion (for doubles and floats).
+//
+// The decimal significand (up to 19 digits) and exponent are extracted in a single scan over the
+// characters, and then converted with Clinger's fast path when the result is exactly
+// representable, or with the Eisel-Lemire algorithm otherwise (see D. Lemire, "Number Parsing at
+// a Gigabyte per Second", Software: Practice and Experience 51(8), 2021). The rare inputs that
+// the algorithm cannot round with certainty (and special values like "inf" or hexadecimal floats)
+// are handed over to strtod (or strtof).
+//
+
+
+// exactly representable powers of ten
+static const double exactPowersOfTen[] = {1e0,
+										  1e1,
+										  1e2,
+										  1e3,
+										  1e4,
+										  1e5,
+										  1e6,
+										  1e7,
+										  1e8,
+										  1e9,
+										  1e10,
+										  1e11,
+										  1e12,
+										  1e13,
+										  1e14,
+										  1e15,
+										  1e16,
+										  1e17,
+										  1e18,
+										  1e19,
+										  1e20,
+										  1e21,
+										  1e22};
+
+// parameters of a binary floating point format, for "computeFloat"
+typedef struct BinaryFormat
+{
+	// number of explicitly stored mantissa bits
+	int mantissaBits;
+	int exponentBias;
+	// biased exponent of infinity
+	int infinitePower;
+	// w * 10^q is zero for q < smallestPowerOfTen, and infinity for q > largestPowerOfTen
+	int smallestPowerOfTen;
+	int largestPowerOfTen;
+	// range of q in which w * 10^q can be exactly halfway between two values
+	int minExponentRoundToEven;
+	int maxExponentRoundToEven;
+} BinaryFormat;
+
+static const BinaryFormat binary64 = {52, 1023, 0x7FF, MIO_SMALLEST_POWER_OF_FIVE, 308, -4, 23};
+static const BinaryFormat binary32 = {23, 127, 0xFF, -65, 38, -17, 10};
+
+// Function to compute the binary representation (biased exponent and mantissa bits) of the value
+// in "pFormat" that is nearest to w * 10^q. Returns false if the result cannot be rounded with
+// certainty.
+static bool
+computeFloat(const BinaryFormat* pFormat, int64_t q, uint64_t w, int* pPower2, uint64_t* pMantissa)
+{
+	if(w == 0 || q < pFormat->smallestPowerOfTen)
+	{
+		*pPower2 = 0; // zero
+		*pMantissa = 0;
+		return true;
+	}
+
+	if(q > pFormat->largestPowerOfTen)
+	{
+		*pPower2 = pFormat->infinitePower; // infinity
+		*pMantissa = 0;
+		return true;
+	}
+
+	const int mantissaBits = pFormat->mantissaBits;
+
+	const int lz = mioCountLeadingZeros64(w);
+	w <<= lz;
+
+	// compute the (truncated) product of w and 5^q with enough precision for mantissaBits+3 bits
+	const size_t index = 2 * (size_t)(q - MIO_SMALLEST_POWER_OF_FIVE);
+	uint64_t productHigh = 0;
+	uint64_t productLow = mioMultiply128(w, mioPowersOfFive128[index], &productHigh);
+	const uint64_t precisionMask = 0xFFFFFFFFFFFFFFFFull >> (mantissaBits + 3);
+
+	if((productHigh & precisionMask) == precisionMask)
+	{
+		uint64_t secondHigh = 0;
+		mioMultiply128(w, mioPowersOfFive128[index + 1], &secondHigh);
+		productLow += secondHigh;
+
+		if(secondHigh > productLow)
+		{
+			productHigh++;
+		}
+	}
+
+	if(productLow == 0xFFFFFFFFFFFFFFFFull && (q < -27 || q > 55))
+	{
+		return false; // the truncated product may be too inaccurate to round correctly
+	}
+
+	const int upperBit = (int)(productHigh >> 63);
+	const int shift = upperBit + 64 - mantissaBits - 3;
+	uint64_t mantissa = productHigh >> shift;
+	// floor(log2(10^q)) + 63 + upperBit - lz, relative to the smallest exponent (e.g. -1023)
+	int power2 = (int)((((152170 + 65536) * q) >> 16) + 63) + upperBit - lz + pFormat->exponentBias;
+
+	if(power2 <= 0)
+	{ // subnormal
+		if(-power2 + 1 >= 64)
+		{
+			*pPower2 = 0;
+			*pMantissa = 0;
+			return true;
+		}
+
+		mantissa >>= -power2 + 1;
+		mantissa += (mantissa & 1); // round half up ...
+		mantissa >>= 1;
+		// ... which may turn the subnormal into the smallest normal number
+		*pPower2 = (mantissa < (1ull << mantissaBits)) ? 0 : 1;
+		*pMantissa = mantissa & ((1ull << mantissaBits) - 1);
+		return true;
+	}
+
+	// usually we round up, but exact halfway cases must be rounded to even
+	if(productLow <= 1 && q >= pFormat->minExponentRoundToEven &&
+	   q <= pFormat->maxExponentRoundToEven && (mantissa & 3) == 1)
+	{
+		if((mantissa << shift) == productHigh)
+		{
+			mantissa &= ~1ull;
+		}
+	}
+
+	mantissa += (mantissa & 1);
+	mantissa >>= 1;
+
+	if(mantissa >= (2ull << mantissaBits))
+	{
+		mantissa = (1ull << mantissaBits);
+		power2++;
+	}
+
+	mantissa &= ~(1ull << mantissaBits);
+
+	if(power2 >= pFormat->infinitePower)
+	{
+		power2 = pFormat->infinitePower; // infinity
+		mantissa = 0;
+	}
+
+	*pPower2 = power2;
+	*pMantissa = mantissa;
+	return true;
+}
+
+// Function to check whether the 8 bytes at "p" are all decimal digits
+static inline bool isEightDigits(const char* p, uint64_t* pChunk)
+{
+	uint64_t chunk = 0;
+	memcpy(&chunk, p, sizeof(uint64_t));
+	*pChunk = chunk;
+	return (((chunk & 0xF0F0F0F0F0F0F0F0ull) |
+			 (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+			0x3333333333333333ull);
+}
+
+// Function to convert 8 ASCII digits (loaded as a little-endian word) into their value
+static inline uint32_t parseEightDigits(uint64_t chunk)
+{
+	const uint64_t mask = 0x000000FF000000FFull;
+	const uint64_t mul1 = 0x000F424000000064ull; // 100 + (1000000ULL << 32)
+	const uint64_t mul2 = 0x0000271000000001ull; // 1 + (10000ULL << 32)
+	chunk -= 0x3030303030303030ull;
+	chunk = (chunk * 10) + (chunk >> 8); // chunk = (chunk * 2561) >> 8;
+	chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+	return (uint32_t)chunk;
+}
+
+#	if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+#		define MIO_LITTLE_ENDIAN (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#	elif defined(_WIN32)
+#		define MIO_LITTLE_ENDIAN 1
+#	else
+#		define MIO_LITTLE_ENDIAN 0
+#	endif
+
+// Function to parse a floating point number into "pDouble", or into "pFloat" (with single
+// precision rounding) if "pDouble" is NULL.
+static bool parseDecimal(const char** ppCur, const char* pEnd, double* pDouble, float* pFloat)
+{
+	const char* p = mioSkipBlanks(*ppCur, pEnd);
+
+	const bool isNegative = (p != pEnd && *p == '-');
+
+	if(p != pEnd && (*p == '-' || *p == '+'))
+	{
+		p++;
+	}
+
+	// NOTE: "0x..." (hexadecimal) and letters ("inf", "nan") are left to strtod
+	if(p == pEnd || (!isDigit(*p) && *p != '.') ||
+	   (*p == '0' && p + 1 != pEnd && (p[1] == 'x' || p[1] == 'X')))
+	{
+		return parseStrtod(ppCur, pEnd, pDouble, pFloat);
+	}
+
+	uint64_t mantissa = 0; // the first (up to 19) significant digits
+	int numSignificantDigits = 0;
+	int64_t exponent = 0; // decimal exponent that applies to "mantissa"
+	bool truncated = false; // true if non-zero digits were dropped from "mantissa"
+	bool haveDigits = false;
+
+	// integer part
+	while(p != pEnd && isDigit(*p))
+	{
+		const unsigned int digit = (unsigned int)(*p - '0');
+
+		if(numSignificantDigits < 19)
+		{
+			mantissa = mantissa * 10 + digit;
+			numSignificantDigits += (mantissa != 0); // leading zeros are not significant
+		}
+		else
+		{
+			truncated |= (digit != 0);
+			exponent++;
+		}
+
+		haveDigits = true;
+		p++;
+	}
+
+	// fractional part
+	if(p != pEnd && *p == '.')
+	{
+		p++;
+
+		// consume the digits eight at a time while the mantissa can hold them
+		if(MIO_LITTLE_ENDIAN)
+		{
+			uint64_t chunk = 0;
+
+			while(numSignificantDigits + 8 <= 19 && mantissa != 0 && pEnd - p >= 8 &&
+				  isEightDigits(p, &chunk))
+			{
+				mantissa = mantissa * 100000000 + parseEightDigits(chunk);
+				numSignificantDigits += 8;
+				exponent -= 8;
+				haveDigits = true;
+				p += 8;
+			}
+		}
+
+		while(p != pEnd && isDigit(*p))
+		{
+			const unsigned int digit = (unsigned int)(*p - '0');
+
+			if(numSignificantDigits < 19)
+			{
+				mantissa = mantissa * 10 + digit;
+				numSignificantDigits += (mantissa != 0);
+				exponent--;
+			}
+			else
+			{
+				truncated |= (digit != 0);
+			}
+
+			haveDigits = true;
+			p++;
+		}
+	}
+
+	if(!haveDigits)
+	{
+		return false; // e.g. "." or "-."
+	}
+
+	// exponent part (only consumed if it is well-formed, like strtod)
+	if(p != pEnd && (*p == 'e' || *p == 'E'))
+	{
+		const char* pExp = p + 1;
+		const bool isExpNegative = (pExp != pEnd && *pExp == '-');
+
+		if(pExp != pEnd && (*pExp == '-' || *pExp == '+'))
+		{
+			pExp++;
+		}
+
+		if(pExp != pEnd && isDigit(*pExp))
+		{
+			int64_t explicitExponent = 0;
+
+			while(pExp != pEnd && isDigit(*pExp))
+			{
+				if(explicitExponent < 0x10000) // saturate, the result is zero or infinity anyway
+				{
+					explicitExponent = explicitExponent * 10 + (*pExp - '0');
+				}
+				pExp++;
+			}
+
+			exponent += isExpNegative ? -explicitExponent : explicitExponent;
+			p = pExp;
+		}
+	}
+
+	const BinaryFormat* pFormat = (pDouble != NULL) ? &binary64 : &binary32;
+
+#	if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+	// Clinger's fast path: both the mantissa and the power of ten are exact doubles, so a single
+	// (correctly rounded) multiplication or division gives the correctly rounded result.
+	if(!truncated && exponent >= -22 && exponent <= 22 && mantissa <= (1ull << 53))
+	{
+		double value = (double)mantissa;
+		value = (exponent < 0) ? value / exactPowersOfTen[-exponent]
+							   : value * exactPowersOfTen[exponent];
+
+		if(pDouble != NULL)
+		{
+			*pDouble = isNegative ? -value : value;
+			*ppCur = p;
+			return true;
+		}
+
+		// Rounding the double to a float gives the float that is nearest to the exact value,
+		// unless the double lies exactly halfway between two (normal) floats, where the exact
+		// value may be on either side.
+		uint64_t bits = 0;
+		memcpy(&bits, &value, sizeof(double));
+		const bool isHalfway = (bits & ((1ull << 29) - 1)) == (1ull << 28);
+
+		if(value >= FLT_MIN && value <= FLT_MAX && !isHalfway)
+		{
+			const float valueFloat = (float)value;
+
+			*pFloat = isNegative ? -valueFloat : valueFloat;
+			*ppCur = p;
+			return true;
+		}
+	}
+#	endif
+
+	int power2 = 0;
+	uint64_t mantissaBits = 0;
+
+	if(!computeFloat(pFormat, exponent, mantissa, &power2, &mantissaBits))
+	{
+		return parseStrtod(ppCur, pEnd, pDouble, pFloat);
+	}
+
+	if(truncated)
+	{
+		// the exact value lies between (mantissa) and (mantissa + 1) * 10^exponent, and the
+		// result is only certain if both bounds round to the same value
+		int power2Upper = 0;
+		uint64_t mantissaBitsUpper = 0;
+
+		if(!computeFloat(pFormat, exponent, mantissa + 1, &power2Upper, &mantissaBitsUpper) ||
+		   power2 != power2Upper || mantissaBits != mantissaBitsUpper)
+		{
+			return parseStrtod(ppCur, pEnd, pDouble, pFloat);
+		}
+	}
+
+	if(pDouble != NULL)
+	{
+		const uint64_t bits = mantissaBits | ((uint64_t)power2 << 52) |
+							  ((uint64_t)isNegative << 63);
+		memcpy(pDouble, &bits, sizeof(double));
+	}
+	else
+	{
+		const uint32_t bits = (uint32_t)mantissaBits | ((uint32_t)power2 << 23) |
+							  ((uint32_t)isNegative << 31);
+		memcpy(pFloat, &bits, sizeof(float));
+	}
+
+	*ppCur = p;
+
+	return true;
+}
+
+bool mioParseDouble(const char** ppCur, const char* pEnd, double* pOut)
+{
+	return parseDecimal(ppCur, pEnd, pOut, NULL);
+}
+
+bool mioParseFloat(const char** ppCur, const char* pEnd, float* pOut)
+{
+	return parseDecimal(ppCur, pEnd, NULL, pOut);
+}
+
+#else // #if !defined(MIO_USE_STRTOD)
+
+bool mioParseDouble(const char** ppCur, const char* pEnd, double* pOut)
+{
+	return parseStrtod(ppCur, pEnd, pOut, NULL);
+}
+
+bool mioParseFloat(const char** ppCur, const char* pEnd, float* pOut)
+{
+	return parseStrtod(ppCur, pEnd, NULL, pOut);
+}
+
+#endif // #if !defined(MIO_USE_STRTOD)
+
+// Function to parse the decimal digits at "p" as an unsigned integer of up to 19 digits (which
+// always fits in 64 bits). Returns a pointer to the first character after the digits, or NULL if
+// there are no digits or there are more than 19.
+static inline const char* parseDigits64(const char* p, const char* pEnd, uint64_t* pOut)
+{
+	const char* pDigits = p;
+	uint64_t value = 0;
+
+	// NOTE: the value is accumulated in 64 bits so that overflow only needs to be checked once
+	while(p != pEnd && isDigit(*p) && (p - pDigits) < 19)
+	{
+		value = value * 10u + (unsigned int)(*p - '0');
+		p++;
+	}
+
+	if(p == pDigits || (p != pEnd && isDigit(*p)))
+	{
+		return NULL; // no digits, or overflow
+	}
+
+	*pOut = value;
+	return p;
+}
+
+// Function to parse the decimal digits at "p" as an unsigned integer. Returns a pointer to the
+// first character after the digits, or NULL if there are no digits or the value overflows.
+static inline const char* parseDigits(const char* p, const char* pEnd, unsigned int* pOut)
+{
+	uint64_t value = 0;
+
+	p = parseDigits64(p, pEnd, &value);
+
+	if(p == NULL || value > UINT_MAX)
+	{
+		return NULL; // no digits, or overflow
+	}
+
+	*pOut = (unsigned int)value;
+	return p;
+}
+
+bool mioParseUint(const char** ppCur, const char* pEnd, unsigned int* pOut)
+{
+	const char* p = parseDigits(mioSkipBlanks(*ppCur, pEnd), pEnd, pOut);
+
+	if(p == NULL)
+	{
+		return false;
+	}
+
+	*ppCur = p;
+	return true;
+}
+
+bool mioParseInt(const char** ppCur, const char* pEnd, int* pOut)
+{
+	const char* p = mioSkipBlanks(*ppCur, pEnd);
+	const bool isNegative = (p != pEnd && *p == '-');
+
+	if(p != pEnd && (*p == '-' || *p == '+'))
+	{
+		p++;
+	}
+
+	unsigned int magnitude = 0;
+
+	p = parseDigits(p, pEnd, &magnitude);
+
+	if(p == NULL || magnitude > (unsigned int)INT_MAX + (isNegative ? 1u : 0u))
+	{
+		return false;
+	}
+
+	*pOut = isNegative ? (int)(0u - magnitude) : (int)magnitude;
+	*ppCur = p;
+
+	return true;
+}
+
+bool mioParseInt64(const char** ppCur, const char* pEnd, int64_t* pOut)
+{
+	const char* p = mioSkipBlanks(*ppCur, pEnd);
+	const bool isNegative = (p != pEnd && *p == '-');
+
+	if(p != pEnd && (*p == '-' || *p == '+'))
+	{
+		p++;
+	}
+
+	uint64_t magnitude = 0;
+
+	p = parseDigits64(p, pEnd, &magnitude);
+
+	if(p == NULL || magnitude > (uint64_t)INT64_MAX + (isNegative ? 1u : 0u))
+	{
+		return false;
+	}
+
+	*pOut = isNegative ? (int64_t)(0u - magnitude) : (int64_t)magnitude;
+	*ppCur = p;
+
+	return true;
+}
@@ -0,0 +1,119 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_PARSE_H__
+#define __MIO_PARSE_H__ 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Internal number parsing routines shared by the readers.
+//
+// All functions operate on a byte range [*ppCur, pEnd) that does not need to be null-terminated.
+// Leading blanks (spaces and tabs) are skipped. On success, "*ppCur" is advanced past the parsed
+// characters and true is returned. Otherwise, false is returned and "*ppCur" is left unchanged.
+
+static inline bool mioIsBlank(char c)
+{
+	return c == ' ' || c == '\t';
+}
+
+// Function to get a pointer to the first non-blank character in [p, pEnd)
+static inline const char* mioSkipBlanks(const char* p, const char* pEnd)
+{
+	while(p != pEnd && mioIsBlank(*p))
+	{
+		p++;
+	}
+	return p;
+}
+
+// Function to check whether [p, pEnd) starts with the keyword "str", followed by a blank or the end
+// of the range. If so, "*ppAfter" is set to the first character after the keyword.
+static inline bool
+mioStartsWith(const char* p, const char* pEnd, const char* str, const char** ppAfter)
+{
+	while(*str != '\0')
+	{
+		if(p == pEnd || *p != *str)
+		{
+			return false;
+		}
+		p++;
+		str++;
+	}
+
+	if(p != pEnd && !mioIsBlank(*p))
+	{
+		return false; // "str" is only a prefix of a longer word
+	}
+
+	*ppAfter = p;
+	return true;
+}
+
+// Function to parse a floating point number. The conversion is correctly rounded and does not
+// depend on the current locale (the decimal point is always '.'). Define MIO_USE_STRTOD to use
+// strtod instead, e.g. to verify the parser.
+bool mioParseDouble(const char** ppCur, const char* pEnd, double* pOut);
+
+// Function to parse a floating point number, correctly rounded to single precision (i.e. not via a
+// double, which could round twice). Uses strtof if MIO_USE_STRTOD is defined.
+bool mioParseFloat(const char** ppCur, const char* pEnd, float* pOut);
+
+// Function to parse a (decimal) unsigned integer. Returns false on overflow.
+bool mioParseUint(const char** ppCur, const char* pEnd, unsigned int* pOut);
+
+// Function to parse a (decimal) integer with an optional sign. Returns false on overflow.
+bool mioParseInt(const char** ppCur, const char* pEnd, int* pOut);
+
+// Function to parse a (decimal) 64-bit integer with an optional sign. Returns false on overflow.
+bool mioParseInt64(const char** ppCur, const char* pEnd, int64_t* pOut);
+
+// Function to parse up to "maxCount" blank-separated floating point numbers into "pOut". Returns
+// the number of values that were parsed.
+static inline size_t mioParseDoubles(const char* p, const char* pEnd, double* pOut, size_t maxCount)
+{
+	size_t count = 0;
+
+	while(count < maxCount && mioParseDouble(&p, pEnd, pOut + count))
+	{
+		count++;
+	}
+
+	return count;
+}
+
+// Function to parse up to "maxCount" blank-separated floating point numbers into "pOut", in single
+// precision. Returns the number of values that were parsed.
+static inline size_t mioParseFloats(const char* p, const char* pEnd, float* pOut, size_t maxCount)
+{
+	size_t count = 0;
+
+	while(count < maxCount && mioParseFloat(&p, pEnd, pOut + count))
+	{
+		count++;
+	}
+
+	return count;
+}
+
+#endif // #ifndef __MIO_PARSE_H__
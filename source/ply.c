@@ -0,0 +1,1692 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "mio/ply.h"
+
+#include "array.h"
+#include "fail.h"
+#include "format.h"
+#include "input.h"
+#include "log.h"
+#include "parse.h"
+#include "stats.h"
+#include "writer.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum PlyFormat
+{
+	PLY_ASCII,
+	PLY_BINARY_LITTLE_ENDIAN,
+	PLY_BINARY_BIG_ENDIAN
+};
+
+// the scalar types of .ply properties
+enum PlyType
+{
+	PLY_INT8,
+	PLY_UINT8,
+	PLY_INT16,
+	PLY_UINT16,
+	PLY_INT32,
+	PLY_UINT32,
+	PLY_FLOAT32,
+	PLY_FLOAT64,
+	PLY_TYPE_COUNT
+};
+
+// names of the types in "PlyType" order, where each type has an old and a new name
+static const char* const typeNames[PLY_TYPE_COUNT][2] = {{"char", "int8"},
+														  {"uchar", "uint8"},
+														  {"short", "int16"},
+														  {"ushort", "uint16"},
+														  {"int", "int32"},
+														  {"uint", "uint32"},
+														  {"float", "float32"},
+														  {"double", "float64"}};
+
+// size of the types in "PlyType" order (in bytes)
+static const size_t typeSizes[PLY_TYPE_COUNT] = {1, 1, 2, 2, 4, 4, 4, 8};
+
+// the data that a property holds, where the vertex targets are in the order of a vertex record
+// with positions, normals and texture coordinates
+enum PlyTarget
+{
+	PLY_TARGET_X,
+	PLY_TARGET_Y,
+	PLY_TARGET_Z,
+	PLY_TARGET_NX,
+	PLY_TARGET_NY,
+	PLY_TARGET_NZ,
+	PLY_TARGET_U,
+	PLY_TARGET_V,
+	PLY_TARGET_FACE_INDICES,
+	PLY_TARGET_NONE // the property is skipped
+};
+
+// the elements that are read (all others are skipped)
+enum PlyElementKind
+{
+	PLY_ELEMENT_VERTEX,
+	PLY_ELEMENT_FACE,
+	PLY_ELEMENT_OTHER
+};
+
+typedef struct PlyProperty
+{
+	// type of the value (or of the items of a list)
+	enum PlyType type;
+	// type of the item count of a list
+	enum PlyType countType;
+	bool isList;
+	enum PlyTarget target;
+	// byte offset of the value in a binary record (only for elements without lists)
+	size_t offset;
+} PlyProperty;
+
+typedef struct PlyElement
+{
+	enum PlyElementKind kind;
+	size_t count;
+	MioArray properties; // PlyProperty
+	// size of a binary record, or 0 if the element has list properties (whose size varies)
+	size_t recordSize;
+} PlyElement;
+
+typedef struct PlyHeader
+{
+	enum PlyFormat format;
+	MioArray elements; // PlyElement
+} PlyHeader;
+
+// the data read from a .ply file
+typedef struct PlyMesh
+{
+	size_t coordSize; // size of a coordinate i.e. sizeof(double) or sizeof(float)
+	void* pVertices;
+	void* pNormals;
+	void* pTexCoords;
+	size_t nVertices;
+	MioArray faceSizes;
+	MioArray faceVertexIndices;
+} PlyMesh;
+
+//
+// header
+//
+
+// Function to get the next blank-separated word of [*ppCur, pEnd) as [*ppWord, *ppCur). Returns
+// false if there are no more words.
+static bool nextWord(const char** ppCur, const char* pEnd, const char** ppWord)
+{
+	const char* p = mioSkipBlanks(*ppCur, pEnd);
+
+	*ppWord = p;
+
+	while(p != pEnd && !mioIsBlank(*p))
+	{
+		p++;
+	}
+
+	*ppCur = p;
+
+	return p != *ppWord;
+}
+
+static bool wordEquals(const char* pWord, const char* pWordEnd, const char* str)
+{
+	const size_t len = strlen(str);
+	return (size_t)(pWordEnd - pWord) == len && memcmp(pWord, str, len) == 0;
+}
+
+// Function to parse the type name that is the next word of [*ppCur, pEnd)
+static bool parseType(const char** ppCur, const char* pEnd, enum PlyType* pType)
+{
+	const char* pWord = NULL;
+
+	if(!nextWord(ppCur, pEnd, &pWord))
+	{
+		return false;
+	}
+
+	for(int t = 0; t < PLY_TYPE_COUNT; ++t)
+	{
+		if(wordEquals(pWord, *ppCur, typeNames[t][0]) || wordEquals(pWord, *ppCur, typeNames[t][1]))
+		{
+			*pType = (enum PlyType)t;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Function to get the data that the property "[pName, pNameEnd)" of an element holds
+static enum PlyTarget
+getTarget(enum PlyElementKind kind, const char* pName, const char* pNameEnd, bool isList)
+{
+	// vertex property names and their targets (where texture coordinates have several names)
+	static const struct
+	{
+		const char* name;
+		enum PlyTarget target;
+	} vertexNames[] = {{"x", PLY_TARGET_X},
+					   {"y", PLY_TARGET_Y},
+					   {"z", PLY_TARGET_Z},
+					   {"nx", PLY_TARGET_NX},
+					   {"ny", PLY_TARGET_NY},
+					   {"nz", PLY_TARGET_NZ},
+					   {"u", PLY_TARGET_U},
+					   {"v", PLY_TARGET_V},
+					   {"s", PLY_TARGET_U},
+					   {"t", PLY_TARGET_V},
+					   {"texture_u", PLY_TARGET_U},
+					   {"texture_v", PLY_TARGET_V},
+					   {"texture_s", PLY_TARGET_U},
+					   {"texture_t", PLY_TARGET_V}};
+
+	if(kind == PLY_ELEMENT_VERTEX && !isList)
+	{
+		for(size_t i = 0; i < sizeof(vertexNames) / sizeof(vertexNames[0]); ++i)
+		{
+			if(wordEquals(pName, pNameEnd, vertexNames[i].name))
+			{
+				return vertexNames[i].target;
+			}
+		}
+	}
+	else if(kind == PLY_ELEMENT_FACE && isList &&
+			(wordEquals(pName, pNameEnd, "vertex_indices") ||
+			 wordEquals(pName, pNameEnd, "vertex_index")))
+	{
+		return PLY_TARGET_FACE_INDICES;
+	}
+
+	return PLY_TARGET_NONE;
+}
+
+static void freeHeader(PlyHeader* pHeader)
+{
+	PlyElement* pElements = (PlyElement*)pHeader->elements.pData;
+
+	for(size_t i = 0; i < pHeader->elements.size; ++i)
+	{
+		mioMemFree(pElements[i].properties.pData);
+	}
+
+	mioMemFree(pHeader->elements.pData);
+	memset(pHeader, 0, sizeof(PlyHeader));
+}
+
+// Function to parse the header of a .ply file (up to and including the "end_header" line), after
+// which "pInput" points to the element data
+static void parseHeader(MioInput* pInput, PlyHeader* pHeader)
+{
+	memset(pHeader, 0, sizeof(PlyHeader));
+
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
+	const char* pWord = NULL;
+	const char* pCur = NULL;
+
+	bool isPly = mioInputNextLine(pInput, &pLine, &pLineEnd);
+
+	if(isPly)
+	{
+		pCur = pLine;
+		isPly = nextWord(&pCur, pLineEnd, &pWord) && wordEquals(pWord, pCur, "ply");
+	}
+
+	if(!isPly)
+	{
+		mioLogError("error: unrecognised .ply file header\n");
+		mioFail(MIO_STATUS_UNSUPPORTED_FORMAT);
+	}
+
+	bool haveFormat = false;
+	bool haveVertexElement = false;
+	bool haveFaceElement = false;
+	PlyElement* pElement = NULL; // the element whose properties are declared
+
+	for(;;)
+	{
+		if(!mioInputNextLine(pInput, &pLine, &pLineEnd))
+		{
+			mioLogError("error: .ply file header has no \"end_header\"\n");
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+
+		pCur = pLine;
+
+		if(!nextWord(&pCur, pLineEnd, &pWord))
+		{
+			continue; // empty line
+		}
+
+		if(wordEquals(pWord, pCur, "end_header"))
+		{
+			break;
+		}
+		else if(wordEquals(pWord, pCur, "comment") || wordEquals(pWord, pCur, "obj_info"))
+		{
+			continue; // ... skip to next line
+		}
+		else if(wordEquals(pWord, pCur, "format"))
+		{
+			nextWord(&pCur, pLineEnd, &pWord);
+
+			if(wordEquals(pWord, pCur, "ascii"))
+			{
+				pHeader->format = PLY_ASCII;
+			}
+			else if(wordEquals(pWord, pCur, "binary_little_endian"))
+			{
+				pHeader->format = PLY_BINARY_LITTLE_ENDIAN;
+			}
+			else if(wordEquals(pWord, pCur, "binary_big_endian"))
+			{
+				pHeader->format = PLY_BINARY_BIG_ENDIAN;
+			}
+			else
+			{
+				mioLogError("error: unsupported .ply format '%.*s'\n", (int)(pCur - pWord), pWord);
+				mioFail(MIO_STATUS_UNSUPPORTED_FORMAT);
+			}
+
+			haveFormat = true;
+		}
+		else if(wordEquals(pWord, pCur, "element"))
+		{
+			const char* pName = NULL;
+			unsigned int count = 0;
+
+			if(!nextWord(&pCur, pLineEnd, &pName))
+			{
+				mioLogError("error: .ply element without a name\n");
+				mioFail(MIO_STATUS_MALFORMED);
+			}
+
+			const char* pNameEnd = pCur;
+
+			if(!mioParseUint(&pCur, pLineEnd, &count))
+			{
+				mioLogError("error: invalid .ply element count\n");
+				mioFail(MIO_STATUS_MALFORMED);
+			}
+
+			mioArrayReserve(&pHeader->elements, sizeof(PlyElement), pHeader->elements.size + 1);
+
+			pElement = (PlyElement*)pHeader->elements.pData + pHeader->elements.size++;
+			memset(pElement, 0, sizeof(PlyElement));
+
+			pElement->kind = PLY_ELEMENT_OTHER;
+			pElement->count = count;
+
+			// NOTE: only the first vertex and face elements are read
+			if(!haveVertexElement && wordEquals(pName, pNameEnd, "vertex"))
+			{
+				pElement->kind = PLY_ELEMENT_VERTEX;
+				haveVertexElement = true;
+			}
+			else if(!haveFaceElement && wordEquals(pName, pNameEnd, "face"))
+			{
+				pElement->kind = PLY_ELEMENT_FACE;
+				haveFaceElement = true;
+			}
+		}
+		else if(wordEquals(pWord, pCur, "property"))
+		{
+			if(pElement == NULL)
+			{
+				mioLogError("error: .ply property before the first element\n");
+				mioFail(MIO_STATUS_MALFORMED);
+			}
+
+			PlyProperty property;
+			memset(&property, 0, sizeof(PlyProperty));
+
+			const char* pListWord = pCur;
+			const char* pAfterList = pCur;
+
+			nextWord(&pAfterList, pLineEnd, &pListWord);
+
+			if(wordEquals(pListWord, pAfterList, "list"))
+			{
+				property.isList = true;
+				pCur = pAfterList;
+
+				if(!parseType(&pCur, pLineEnd, &property.countType))
+				{
+					mioLogError("error: invalid .ply list count type\n");
+					mioFail(MIO_STATUS_MALFORMED);
+				}
+
+				if(property.countType == PLY_FLOAT32 || property.countType == PLY_FLOAT64)
+				{
+					mioLogError("error: .ply list count type must be an integer\n");
+					mioFail(MIO_STATUS_MALFORMED);
+				}
+			}
+
+			if(!parseType(&pCur, pLineEnd, &property.type))
+			{
+				mioLogError("error: invalid .ply property type\n");
+				mioFail(MIO_STATUS_MALFORMED);
+			}
+
+			const char* pName = NULL;
+
+			if(!nextWord(&pCur, pLineEnd, &pName))
+			{
+				mioLogError("error: .ply property without a name\n");
+				mioFail(MIO_STATUS_MALFORMED);
+			}
+
+			property.target = getTarget(pElement->kind, pName, pCur, property.isList);
+
+			mioArrayReserve(
+				&pElement->properties, sizeof(PlyProperty), pElement->properties.size + 1);
+			((PlyProperty*)pElement->properties.pData)[pElement->properties.size++] = property;
+		}
+		else
+		{
+			mioLogNote("note: skipping unrecognised .ply header line '%.*s'\n",
+					   (int)(pLineEnd - pLine),
+					   pLine);
+		}
+	}
+
+	if(!haveFormat)
+	{
+		mioLogError("error: .ply file header has no format\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	// the byte offsets of the values in the binary records of elements without lists
+	PlyElement* pElements = (PlyElement*)pHeader->elements.pData;
+
+	for(size_t i = 0; i < pHeader->elements.size; ++i)
+	{
+		PlyProperty* pProperties = (PlyProperty*)pElements[i].properties.pData;
+		size_t offset = 0;
+
+		for(size_t j = 0; j < pElements[i].properties.size && offset != SIZE_MAX; ++j)
+		{
+			pProperties[j].offset = offset;
+			offset = pProperties[j].isList ? SIZE_MAX : offset + typeSizes[pProperties[j].type];
+		}
+
+		pElements[i].recordSize = (offset == SIZE_MAX) ? 0 : offset;
+	}
+}
+
+//
+// element data
+//
+
+static bool isHostLittleEndian(void)
+{
+	const uint16_t one = 1;
+	unsigned char firstByte = 0;
+	memcpy(&firstByte, &one, 1);
+	return firstByte == 1;
+}
+
+// Function to reverse the byte order of the "count" values of "valueSize" bytes at "pData"
+static void swapBytes(void* pData, size_t count, size_t valueSize)
+{
+	unsigned char* p = (unsigned char*)pData;
+
+	for(size_t i = 0; i < count; ++i)
+	{
+		for(size_t j = 0; j < valueSize / 2; ++j)
+		{
+			const unsigned char tmp = p[j];
+			p[j] = p[valueSize - 1 - j];
+			p[valueSize - 1 - j] = tmp;
+		}
+
+		p += valueSize;
+	}
+}
+
+// Function to load the binary value of "type" at "p", whose bytes are reversed if "swap" is true
+static double loadValue(const unsigned char* p, enum PlyType type, bool swap)
+{
+	unsigned char bytes[8];
+	const size_t size = typeSizes[type];
+
+	memcpy(bytes, p, size);
+
+	if(swap)
+	{
+		swapBytes(bytes, 1, size);
+	}
+
+	switch(type)
+	{
+	case PLY_INT8:
+		return (double)(int8_t)bytes[0];
+	case PLY_UINT8:
+		return (double)bytes[0];
+	case PLY_INT16: {
+		int16_t value;
+		memcpy(&value, bytes, sizeof(value));
+		return (double)value;
+	}
+	case PLY_UINT16: {
+		uint16_t value;
+		memcpy(&value, bytes, sizeof(value));
+		return (double)value;
+	}
+	case PLY_INT32: {
+		int32_t value;
+		memcpy(&value, bytes, sizeof(value));
+		return (double)value;
+	}
+	case PLY_UINT32: {
+		uint32_t value;
+		memcpy(&value, bytes, sizeof(value));
+		return (double)value;
+	}
+	case PLY_FLOAT32: {
+		float value;
+		memcpy(&value, bytes, sizeof(value));
+		return (double)value;
+	}
+	case PLY_FLOAT64: {
+		double value;
+		memcpy(&value, bytes, sizeof(value));
+		return value;
+	}
+	default:
+		assert(false);
+		return 0.0;
+	}
+}
+
+// Function to load a binary list count or face-vertex index of "type" at "p"
+static unsigned int loadIndex(const unsigned char* p, enum PlyType type, bool swap)
+{
+	const double value = loadValue(p, type, swap);
+
+	if(!(value >= 0.0 && value <= (double)UINT_MAX))
+	{
+		mioLogError("error: invalid .ply index or count %g\n", value);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	return (unsigned int)value;
+}
+
+// Function to get the location of the coordinate of "target" of the vertex "vertexId"
+static void* getCoordPtr(const PlyMesh* pMesh, enum PlyTarget target, size_t vertexId)
+{
+	void* pArray = NULL;
+	size_t index = 0;
+
+	if(target <= PLY_TARGET_Z)
+	{
+		pArray = pMesh->pVertices;
+		index = vertexId * 3 + (size_t)(target - PLY_TARGET_X);
+	}
+	else if(target <= PLY_TARGET_NZ)
+	{
+		pArray = pMesh->pNormals;
+		index = vertexId * 3 + (size_t)(target - PLY_TARGET_NX);
+	}
+	else
+	{
+		assert(target <= PLY_TARGET_V);
+		pArray = pMesh->pTexCoords;
+		index = vertexId * 2 + (size_t)(target - PLY_TARGET_U);
+	}
+
+	return (char*)pArray + index * pMesh->coordSize;
+}
+
+static void storeCoord(const PlyMesh* pMesh, enum PlyTarget target, size_t vertexId, double value)
+{
+	void* pCoord = getCoordPtr(pMesh, target, vertexId);
+
+	if(pMesh->coordSize == sizeof(double))
+	{
+		*(double*)pCoord = value;
+	}
+	else
+	{
+		*(float*)pCoord = (float)value;
+	}
+}
+
+// Function to make "count" bytes available at the read position of "pInput"
+static void requireBytes(MioInput* pInput, size_t count)
+{
+	if(!mioInputRequire(pInput, count))
+	{
+		mioLogError("error: .ply file ends before the end of its element data\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+}
+
+// Function to copy (or skip, if "pOut" is NULL) the next "size" bytes of "pInput"
+static void copyBytes(MioInput* pInput, void* pOut, size_t size)
+{
+	while(size > 0)
+	{
+		requireBytes(pInput, 1);
+
+		size_t count = (size_t)(pInput->pEnd - pInput->pCur);
+
+		if(count > size)
+		{
+			count = size;
+		}
+
+		if(pOut != NULL)
+		{
+			memcpy(pOut, pInput->pCur, count);
+			pOut = (char*)pOut + count;
+		}
+
+		pInput->pCur += count;
+		size -= count;
+	}
+}
+
+// Function to check whether the binary vertex records are [xyz] in the coordinate type of
+// "pMesh" (e.g. float32 for single precision), which can be copied as they are
+static bool isPackedXYZ(const PlyElement* pElement, const PlyMesh* pMesh)
+{
+	const PlyProperty* pProperties = (const PlyProperty*)pElement->properties.pData;
+	const enum PlyType coordType = (pMesh->coordSize == sizeof(double)) ? PLY_FLOAT64 : PLY_FLOAT32;
+
+	if(pElement->properties.size != 3)
+	{
+		return false;
+	}
+
+	for(int i = 0; i < 3; ++i)
+	{
+		if(pProperties[i].type != coordType || (int)pProperties[i].target != PLY_TARGET_X + i)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Function to read the binary records of the vertex element
+static void
+readBinaryVertices(MioInput* pInput, const PlyElement* pElement, bool swap, PlyMesh* pMesh)
+{
+	const PlyProperty* pProperties = (const PlyProperty*)pElement->properties.pData;
+	const size_t recordSize = pElement->recordSize;
+
+	if(recordSize == 0)
+	{
+		mioLogError("error: .ply vertex element with list properties is not supported\n");
+		mioFail(MIO_STATUS_UNSUPPORTED_FORMAT);
+	}
+
+	if(isPackedXYZ(pElement, pMesh))
+	{
+		// the records have the layout of the vertex array
+		copyBytes(pInput, pMesh->pVertices, pElement->count * recordSize);
+
+		if(swap)
+		{
+			swapBytes(pMesh->pVertices, pElement->count * 3, pMesh->coordSize);
+		}
+
+		return;
+	}
+
+	size_t vertexId = 0;
+
+	while(vertexId < pElement->count)
+	{
+		requireBytes(pInput, recordSize);
+
+		// convert all of the records that are currently available in one go
+		size_t count = (size_t)(pInput->pEnd - pInput->pCur) / recordSize;
+
+		if(count > pElement->count - vertexId)
+		{
+			count = pElement->count - vertexId;
+		}
+
+		const unsigned char* pRecord = (const unsigned char*)pInput->pCur;
+
+		for(size_t i = 0; i < count; ++i)
+		{
+			for(size_t j = 0; j < pElement->properties.size; ++j)
+			{
+				const PlyProperty* pProperty = pProperties + j;
+
+				if(pProperty->target != PLY_TARGET_NONE)
+				{
+					const double value =
+						loadValue(pRecord + pProperty->offset, pProperty->type, swap);
+					storeCoord(pMesh, pProperty->target, vertexId, value);
+				}
+			}
+
+			pRecord += recordSize;
+			vertexId++;
+		}
+
+		pInput->pCur = (const char*)pRecord;
+	}
+}
+
+// Function to read the binary records of a face element that only has the face-vertex indices as a
+// list with a one-byte count and 32-bit indices in host byte order (i.e. the layout of nearly all
+// binary files), which are copied as they are
+static void readBinaryPackedFaces(MioInput* pInput, const PlyElement* pElement, PlyMesh* pMesh)
+{
+	MioArray* pIndices = &pMesh->faceVertexIndices;
+	size_t recordId = 0;
+
+	while(recordId < pElement->count)
+	{
+		requireBytes(pInput, 1);
+
+		const unsigned char* p = (const unsigned char*)pInput->pCur;
+		const unsigned char* pEnd = (const unsigned char*)pInput->pEnd;
+		size_t n = 0;
+
+		// each iteration copies one record that is completely available
+		while(recordId < pElement->count)
+		{
+			n = (p != pEnd) ? *p : 0;
+
+			if(p == pEnd || (size_t)(pEnd - p - 1) < n * sizeof(unsigned int))
+			{
+				break;
+			}
+
+			mioArrayPushUint(&pMesh->faceSizes, (unsigned int)n);
+			mioArrayReserve(pIndices, sizeof(unsigned int), pIndices->size + n);
+
+			unsigned int* pOut = (unsigned int*)pIndices->pData + pIndices->size;
+
+			// NOTE: fixed-size copies (i.e. unaligned loads) are much faster than a memcpy call
+			// for the few bytes of a face
+			for(size_t k = 0; k < n; ++k)
+			{
+				memcpy(pOut + k, p + 1 + k * sizeof(unsigned int), sizeof(unsigned int));
+			}
+
+			pIndices->size += n;
+
+			p += 1 + n * sizeof(unsigned int);
+			recordId++;
+		}
+
+		pInput->pCur = (const char*)p;
+
+		if(recordId < pElement->count)
+		{
+			requireBytes(pInput, 1 + n * sizeof(unsigned int)); // a record across the window end
+		}
+	}
+}
+
+// Function to read the binary records of an element with list properties (e.g. the faces). The
+// face-vertex indices are appended to the face arrays of "pMesh", and all other data is skipped.
+static void
+readBinaryRecords(MioInput* pInput, const PlyElement* pElement, bool swap, PlyMesh* pMesh)
+{
+	const PlyProperty* pProperties = (const PlyProperty*)pElement->properties.pData;
+
+	for(size_t recordId = 0; recordId < pElement->count; ++recordId)
+	{
+		for(size_t j = 0; j < pElement->properties.size; ++j)
+		{
+			const PlyProperty* pProperty = pProperties + j;
+			const size_t valueSize = typeSizes[pProperty->type];
+
+			if(!pProperty->isList)
+			{
+				copyBytes(pInput, NULL, valueSize);
+				continue;
+			}
+
+			const size_t countSize = typeSizes[pProperty->countType];
+
+			requireBytes(pInput, countSize);
+
+			const unsigned int n =
+				loadIndex((const unsigned char*)pInput->pCur, pProperty->countType, swap);
+
+			pInput->pCur += countSize;
+
+			if(pProperty->target != PLY_TARGET_FACE_INDICES)
+			{
+				copyBytes(pInput, NULL, (size_t)n * valueSize);
+				continue;
+			}
+
+			MioArray* pIndices = &pMesh->faceVertexIndices;
+
+			mioArrayPushUint(&pMesh->faceSizes, n);
+			mioArrayReserve(pIndices, sizeof(unsigned int), pIndices->size + n);
+
+			unsigned int* pOut = (unsigned int*)pIndices->pData + pIndices->size;
+
+			if(!swap && (pProperty->type == PLY_INT32 || pProperty->type == PLY_UINT32))
+			{
+				copyBytes(pInput, pOut, (size_t)n * sizeof(unsigned int)); // same layout
+			}
+			else
+			{
+				requireBytes(pInput, (size_t)n * valueSize);
+
+				const unsigned char* pValue = (const unsigned char*)pInput->pCur;
+
+				for(unsigned int k = 0; k < n; ++k)
+				{
+					pOut[k] = loadIndex(pValue, pProperty->type, swap);
+					pValue += valueSize;
+				}
+
+				pInput->pCur = (const char*)pValue;
+			}
+
+			pIndices->size += n;
+		}
+	}
+}
+
+// Function to get the next line of the element data of an ASCII file (which is not empty)
+static void readAsciiRecord(MioInput* pInput, const char** ppLine, const char** ppLineEnd)
+{
+	while(mioInputNextLine(pInput, ppLine, ppLineEnd))
+	{
+		if(mioSkipBlanks(*ppLine, *ppLineEnd) != *ppLineEnd)
+		{
+			return;
+		}
+	}
+
+	mioLogError("error: .ply file ends before the end of its element data\n");
+	mioFail(MIO_STATUS_MALFORMED);
+}
+
+// Function to parse (and drop) the next value of [*ppCur, pEnd)
+static void skipAsciiValue(const char** ppCur, const char* pEnd)
+{
+	const char* pWord = NULL;
+
+	if(!nextWord(ppCur, pEnd, &pWord))
+	{
+		mioLogError("error: .ply record has too few values\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+}
+
+// Function to parse the records of an ASCII element (one per line). The vertex data and the
+// face-vertex indices are stored in "pMesh", and all other data is skipped.
+static void readAsciiRecords(MioInput* pInput, const PlyElement* pElement, PlyMesh* pMesh)
+{
+	const PlyProperty* pProperties = (const PlyProperty*)pElement->properties.pData;
+	const bool isPackedVertex =
+		pElement->kind == PLY_ELEMENT_VERTEX && pElement->properties.size == 3 &&
+		pProperties[0].target == PLY_TARGET_X && pProperties[1].target == PLY_TARGET_Y &&
+		pProperties[2].target == PLY_TARGET_Z;
+
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
+
+	for(size_t recordId = 0; recordId < pElement->count; ++recordId)
+	{
+		readAsciiRecord(pInput, &pLine, &pLineEnd);
+
+		if(isPackedVertex)
+		{
+			// the common case of vertices that only have a position
+			void* pCoords = getCoordPtr(pMesh, PLY_TARGET_X, recordId);
+			const size_t nread = (pMesh->coordSize == sizeof(double))
+									 ? mioParseDoubles(pLine, pLineEnd, (double*)pCoords, 3)
+									 : mioParseFloats(pLine, pLineEnd, (float*)pCoords, 3);
+
+			if(nread != 3)
+			{
+				mioLogError("error: invalid .ply vertex %zu\n", recordId);
+				mioFail(MIO_STATUS_MALFORMED);
+			}
+
+			continue;
+		}
+
+		for(size_t j = 0; j < pElement->properties.size; ++j)
+		{
+			const PlyProperty* pProperty = pProperties + j;
+
+			if(pProperty->isList)
+			{
+				unsigned int n = 0;
+
+				if(!mioParseUint(&pLine, pLineEnd, &n))
+				{
+					mioLogError("error: invalid .ply list count in record %zu\n", recordId);
+					mioFail(MIO_STATUS_MALFORMED);
+				}
+
+				if(pProperty->target != PLY_TARGET_FACE_INDICES)
+				{
+					for(unsigned int k = 0; k < n; ++k)
+					{
+						skipAsciiValue(&pLine, pLineEnd);
+					}
+					continue;
+				}
+
+				MioArray* pIndices = &pMesh->faceVertexIndices;
+
+				mioArrayPushUint(&pMesh->faceSizes, n);
+				mioArrayReserve(pIndices, sizeof(unsigned int), pIndices->size + n);
+
+				unsigned int* pOut = (unsigned int*)pIndices->pData + pIndices->size;
+
+				for(unsigned int k = 0; k < n; ++k)
+				{
+					if(!mioParseUint(&pLine, pLineEnd, pOut + k))
+					{
+						mioLogError("error: .ply face %zu has fewer than %u indices\n",
+									recordId,
+									n);
+						mioFail(MIO_STATUS_MALFORMED);
+					}
+				}
+
+				pIndices->size += n;
+			}
+			else if(pProperty->target != PLY_TARGET_NONE)
+			{
+				void* pCoord = getCoordPtr(pMesh, pProperty->target, recordId);
+				const bool ok = (pMesh->coordSize == sizeof(double))
+									? mioParseDouble(&pLine, pLineEnd, (double*)pCoord)
+									: mioParseFloat(&pLine, pLineEnd, (float*)pCoord);
+
+				if(!ok)
+				{
+					mioLogError("error: invalid .ply vertex %zu\n", recordId);
+					mioFail(MIO_STATUS_MALFORMED);
+				}
+			}
+			else
+			{
+				skipAsciiValue(&pLine, pLineEnd);
+			}
+		}
+	}
+}
+
+// Function to check which coordinates the properties of the vertex element "pElement" give, where
+// the positions are required and the normals and texture coordinates are optional
+static void getVertexTargets(const PlyElement* pElement, bool* pHaveNormals, bool* pHaveTexCoords)
+{
+	const PlyProperty* pProperties = (const PlyProperty*)pElement->properties.pData;
+	bool haveTarget[PLY_TARGET_NONE] = {false};
+
+	for(size_t j = 0; j < pElement->properties.size; ++j)
+	{
+		if(pProperties[j].target != PLY_TARGET_NONE)
+		{
+			haveTarget[pProperties[j].target] = true;
+		}
+	}
+
+	if(!haveTarget[PLY_TARGET_X] || !haveTarget[PLY_TARGET_Y] || !haveTarget[PLY_TARGET_Z])
+	{
+		mioLogError("error: .ply vertex element has no x, y and z properties\n");
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	*pHaveNormals =
+		haveTarget[PLY_TARGET_NX] && haveTarget[PLY_TARGET_NY] && haveTarget[PLY_TARGET_NZ];
+	*pHaveTexCoords = haveTarget[PLY_TARGET_U] && haveTarget[PLY_TARGET_V];
+}
+
+// Function to skip over the records of the element "pElement" of a file in the format "format".
+// Returns the number of face-vertex indices in the records (i.e. zero unless it is the face
+// element), where only the item counts of the lists are parsed.
+static uint64_t
+skipRecords(MioInput* pInput, const PlyElement* pElement, enum PlyFormat format, bool swap)
+{
+	const PlyProperty* pProperties = (const PlyProperty*)pElement->properties.pData;
+	const bool isAscii = (format == PLY_ASCII);
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
+
+	if(pElement->recordSize != 0 || pElement->properties.size == 0)
+	{
+		for(size_t recordId = 0; isAscii && recordId < pElement->count; ++recordId)
+		{
+			readAsciiRecord(pInput, &pLine, &pLineEnd);
+		}
+
+		if(!isAscii)
+		{
+			copyBytes(pInput, NULL, pElement->count * pElement->recordSize);
+		}
+
+		return 0;
+	}
+
+	uint64_t numFaceVertices = 0;
+
+	for(size_t recordId = 0; recordId < pElement->count; ++recordId)
+	{
+		if(isAscii)
+		{
+			readAsciiRecord(pInput, &pLine, &pLineEnd);
+		}
+
+		for(size_t j = 0; j < pElement->properties.size; ++j)
+		{
+			const PlyProperty* pProperty = pProperties + j;
+			unsigned int n = 1; // number of values
+
+			if(pProperty->isList && isAscii && !mioParseUint(&pLine, pLineEnd, &n))
+			{
+				mioLogError("error: invalid .ply list count in record %zu\n", recordId);
+				mioFail(MIO_STATUS_MALFORMED);
+			}
+			else if(pProperty->isList && !isAscii)
+			{
+				const size_t countSize = typeSizes[pProperty->countType];
+
+				requireBytes(pInput, countSize);
+
+				n = loadIndex((const unsigned char*)pInput->pCur, pProperty->countType, swap);
+				pInput->pCur += countSize;
+			}
+
+			if(pProperty->target == PLY_TARGET_FACE_INDICES)
+			{
+				numFaceVertices += n;
+			}
+
+			for(unsigned int k = 0; isAscii && k < n; ++k)
+			{
+				skipAsciiValue(&pLine, pLineEnd);
+			}
+
+			if(!isAscii)
+			{
+				copyBytes(pInput, NULL, (size_t)n * typeSizes[pProperty->type]);
+			}
+		}
+	}
+
+	return numFaceVertices;
+}
+
+// Function to check that the element counts of "pHeader" fit into the rest of "pInput" (if all of it
+// is available), so that a corrupt count fails before anything is allocated for it. An ASCII value
+// takes at least 2 bytes (a digit and a separator), and a binary list at least its item count.
+static void checkElementCounts(const MioInput* pInput, const PlyHeader* pHeader)
+{
+	if(!pInput->atEnd)
+	{
+		return; // the end of a streamed input is not known yet
+	}
+
+	const PlyElement* pElements = (const PlyElement*)pHeader->elements.pData;
+	const uint64_t numBytes = (uint64_t)(pInput->pEnd - pInput->pCur);
+	uint64_t minSize = 0;
+
+	for(size_t i = 0; i < pHeader->elements.size; ++i)
+	{
+		const PlyProperty* pProperties = (const PlyProperty*)pElements[i].properties.pData;
+		uint64_t minRecordSize = 0;
+
+		for(size_t j = 0; j < pElements[i].properties.size; ++j)
+		{
+			if(pHeader->format == PLY_ASCII)
+			{
+				minRecordSize += 2;
+			}
+			else
+			{
+				const enum PlyType type =
+					pProperties[j].isList ? pProperties[j].countType : pProperties[j].type;
+
+				minRecordSize += typeSizes[type];
+			}
+		}
+
+		minSize += (uint64_t)pElements[i].count * minRecordSize;
+	}
+
+	// NOTE: the last value of an ASCII file may have no newline after it
+	if(pHeader->format == PLY_ASCII && minSize > 0)
+	{
+		minSize -= 1;
+	}
+
+	if(numBytes < minSize)
+	{
+		mioLogError("error: the .ply elements need at least %llu bytes, but the file has %llu\n",
+					(unsigned long long)minSize,
+					(unsigned long long)numBytes);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+}
+
+// Function to read the contents of a .ply file from "pInput" with coordinates of "coordSize"
+// bytes (i.e. sizeof(double) or sizeof(float))
+static void readPLY(MioInput* pInput, size_t coordSize, PlyMesh* pMesh)
+{
+	memset(pMesh, 0, sizeof(PlyMesh));
+	pMesh->coordSize = coordSize;
+
+	PlyHeader header;
+
+	parseHeader(pInput, &header);
+	checkElementCounts(pInput, &header);
+
+	// binary data in the byte order of the host is loaded as it is
+	const bool swap = (header.format == PLY_BINARY_LITTLE_ENDIAN && !isHostLittleEndian()) ||
+					  (header.format == PLY_BINARY_BIG_ENDIAN && isHostLittleEndian());
+
+	PlyElement* pElements = (PlyElement*)header.elements.pData;
+
+	for(size_t i = 0; i < header.elements.size; ++i)
+	{
+		PlyElement* pElement = pElements + i;
+
+		if(pElement->kind == PLY_ELEMENT_FACE)
+		{
+			// most meshes are triangle meshes, which is used as the initial guess for the number
+			// of indices
+			mioArrayReserve(&pMesh->faceSizes, sizeof(unsigned int), pElement->count);
+			mioArrayReserve(&pMesh->faceVertexIndices, sizeof(unsigned int), pElement->count * 3);
+		}
+
+		if(pElement->kind == PLY_ELEMENT_VERTEX)
+		{
+			PlyProperty* pProperties = (PlyProperty*)pElement->properties.pData;
+			bool haveNormals = false;
+			bool haveTexCoords = false;
+
+			getVertexTargets(pElement, &haveNormals, &haveTexCoords);
+
+			// incomplete normals or texture coordinates are skipped
+			for(size_t j = 0; j < pElement->properties.size; ++j)
+			{
+				const enum PlyTarget target = pProperties[j].target;
+
+				if((!haveNormals && target >= PLY_TARGET_NX && target <= PLY_TARGET_NZ) ||
+				   (!haveTexCoords && (target == PLY_TARGET_U || target == PLY_TARGET_V)))
+				{
+					pProperties[j].target = PLY_TARGET_NONE;
+				}
+			}
+
+			pMesh->nVertices = pElement->count;
+			pMesh->pVertices = mioAllocate(pElement->count * 3, coordSize);
+			pMesh->pNormals = haveNormals ? mioAllocate(pElement->count * 3, coordSize) : NULL;
+			pMesh->pTexCoords = haveTexCoords ? mioAllocate(pElement->count * 2, coordSize) : NULL;
+
+			if(header.format == PLY_ASCII)
+			{
+				readAsciiRecords(pInput, pElement, pMesh);
+			}
+			else
+			{
+				readBinaryVertices(pInput, pElement, swap, pMesh);
+			}
+		}
+		else if(header.format == PLY_ASCII)
+		{
+			readAsciiRecords(pInput, pElement, pMesh);
+		}
+		else if(pElement->recordSize != 0 || pElement->properties.size == 0)
+		{
+			copyBytes(pInput, NULL, pElement->count * pElement->recordSize); // skip element
+		}
+		else
+		{
+			const PlyProperty* pProperties = (const PlyProperty*)pElement->properties.pData;
+
+			if(!swap && pElement->properties.size == 1 &&
+			   pProperties[0].target == PLY_TARGET_FACE_INDICES &&
+			   pProperties[0].countType == PLY_UINT8 &&
+			   (pProperties[0].type == PLY_INT32 || pProperties[0].type == PLY_UINT32))
+			{
+				readBinaryPackedFaces(pInput, pElement, pMesh);
+			}
+			else
+			{
+				readBinaryRecords(pInput, pElement, swap, pMesh);
+			}
+		}
+	}
+
+	freeHeader(&header);
+
+	// NOTE: the vertices are checked once all elements are read, since they may follow the faces
+	const unsigned int* pIndices = (const unsigned int*)pMesh->faceVertexIndices.pData;
+
+	for(size_t i = 0; i < pMesh->faceVertexIndices.size; ++i)
+	{
+		if(pIndices[i] >= pMesh->nVertices)
+		{
+			mioLogError("error: face index %u refers to no vertex (of %zu)\n",
+						pIndices[i],
+						pMesh->nVertices);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+	}
+
+	mioLogInfo("\t%zu vertices\n", pMesh->nVertices);
+	mioLogInfo("\t%zu faces\n", pMesh->faceSizes.size);
+}
+
+void mioProbePLY(MioInput* pInput, MioMeshInfo* pInfo)
+{
+	PlyHeader header;
+
+	parseHeader(pInput, &header);
+
+	const bool swap = (header.format == PLY_BINARY_LITTLE_ENDIAN && !isHostLittleEndian()) ||
+					  (header.format == PLY_BINARY_BIG_ENDIAN && isHostLittleEndian());
+
+	PlyElement* pElements = (PlyElement*)header.elements.pData;
+
+	for(size_t i = 0; i < header.elements.size; ++i)
+	{
+		const PlyElement* pElement = pElements + i;
+
+		if(pElement->kind == PLY_ELEMENT_VERTEX)
+		{
+			bool haveNormals = false;
+			bool haveTexCoords = false;
+
+			getVertexTargets(pElement, &haveNormals, &haveTexCoords);
+
+			// the normals and texture coordinates are per vertex (see "mioReadMesh")
+			pInfo->numVertices = pElement->count;
+			pInfo->numNormals = haveNormals ? pElement->count : 0;
+			pInfo->numTexCoords = haveTexCoords ? pElement->count : 0;
+		}
+
+		if(pElement->kind == PLY_ELEMENT_FACE)
+		{
+			pInfo->numFaces = pElement->count;
+			pInfo->numFaceVertices = skipRecords(pInput, pElement, header.format, swap);
+			break; // ... the elements after the faces are not read
+		}
+
+		skipRecords(pInput, pElement, header.format, swap);
+	}
+
+	freeHeader(&header);
+}
+
+// Function to read the .ply file at "fpath" (see "readPLY")
+static void readPLYFile(const char* fpath, size_t coordSize, PlyMesh* pMesh)
+{
+	mioLogInfo("read .ply file: %s\n", fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	readPLY(&input, coordSize, pMesh);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+}
+
+// Function to hand over the arrays of "pMesh" to the caller
+static void handOverMesh(PlyMesh* pMesh,
+						 void** ppVertices,
+						 void** ppNormals,
+						 void** ppTexCoords,
+						 unsigned int** pFaceSizes,
+						 unsigned int** pFaceVertexIndices,
+						 unsigned int* numVertices,
+						 unsigned int* numFaces)
+{
+	if(pMesh->nVertices > UINT_MAX || pMesh->faceSizes.size > UINT_MAX)
+	{
+		mioLogError("error: too many .ply elements\n");
+		mioFail(MIO_STATUS_TOO_LARGE);
+	}
+
+	if(pMesh->nVertices == 0)
+	{
+		mioMemFree(pMesh->pVertices);
+		mioMemFree(pMesh->pNormals);
+		mioMemFree(pMesh->pTexCoords);
+		pMesh->pVertices = NULL;
+		pMesh->pNormals = NULL;
+		pMesh->pTexCoords = NULL;
+	}
+
+	*ppVertices = pMesh->pVertices;
+	*ppNormals = pMesh->pNormals;
+	*ppTexCoords = pMesh->pTexCoords;
+	*numVertices = (unsigned int)pMesh->nVertices;
+	*numFaces = (unsigned int)pMesh->faceSizes.size;
+	*pFaceSizes = (unsigned int*)mioArrayRelease(&pMesh->faceSizes, sizeof(unsigned int));
+	*pFaceVertexIndices =
+		(unsigned int*)mioArrayRelease(&pMesh->faceVertexIndices, sizeof(unsigned int));
+}
+
+void mioReadPLY(const char* fpath,
+				double** pVertices,
+				double** pNormals,
+				double** pTexCoords,
+				unsigned int** pFaceSizes,
+				unsigned int** pFaceVertexIndices,
+				unsigned int* numVertices,
+				unsigned int* numFaces)
+{
+	PlyMesh mesh;
+	void* pVertexData = NULL;
+	void* pNormalData = NULL;
+	void* pTexCoordData = NULL;
+
+	readPLYFile(fpath, sizeof(double), &mesh);
+
+	handOverMesh(&mesh,
+				 &pVertexData,
+				 &pNormalData,
+				 &pTexCoordData,
+				 pFaceSizes,
+				 pFaceVertexIndices,
+				 numVertices,
+				 numFaces);
+
+	*pVertices = (double*)pVertexData;
+	*pNormals = (double*)pNormalData;
+	*pTexCoords = (double*)pTexCoordData;
+}
+
+void mioReadPLYFromMemory(const void* pData,
+						  size_t dataSize,
+						  double** pVertices,
+						  double** pNormals,
+						  double** pTexCoords,
+						  unsigned int** pFaceSizes,
+						  unsigned int** pFaceVertexIndices,
+						  unsigned int* numVertices,
+						  unsigned int* numFaces)
+{
+	mioLogInfo("read .ply file from memory: %zu bytes\n", dataSize);
+
+	MioInput input;
+
+	mioLoadBegin();
+	mioInputOpenRange(&input, (const char*)pData, (const char*)pData + dataSize);
+
+	PlyMesh mesh;
+	void* pVertexData = NULL;
+	void* pNormalData = NULL;
+	void* pTexCoordData = NULL;
+
+	readPLY(&input, sizeof(double), &mesh);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+
+	handOverMesh(&mesh,
+				 &pVertexData,
+				 &pNormalData,
+				 &pTexCoordData,
+				 pFaceSizes,
+				 pFaceVertexIndices,
+				 numVertices,
+				 numFaces);
+
+	*pVertices = (double*)pVertexData;
+	*pNormals = (double*)pNormalData;
+	*pTexCoords = (double*)pTexCoordData;
+}
+
+void mioReadPLYf(const char* fpath,
+				 float** pVertices,
+				 float** pNormals,
+				 float** pTexCoords,
+				 unsigned int** pFaceSizes,
+				 unsigned int** pFaceVertexIndices,
+				 unsigned int* numVertices,
+				 unsigned int* numFaces)
+{
+	PlyMesh mesh;
+	void* pVertexData = NULL;
+	void* pNormalData = NULL;
+	void* pTexCoordData = NULL;
+
+	readPLYFile(fpath, sizeof(float), &mesh);
+
+	handOverMesh(&mesh,
+				 &pVertexData,
+				 &pNormalData,
+				 &pTexCoordData,
+				 pFaceSizes,
+				 pFaceVertexIndices,
+				 numVertices,
+				 numFaces);
+
+	*pVertices = (float*)pVertexData;
+	*pNormals = (float*)pNormalData;
+	*pTexCoords = (float*)pTexCoordData;
+}
+
+//
+// writer
+//
+
+// Function to store "value" at "p" in little-endian byte order
+static void storeUint32LE(unsigned char* p, uint32_t value)
+{
+	p[0] = (unsigned char)(value);
+	p[1] = (unsigned char)(value >> 8);
+	p[2] = (unsigned char)(value >> 16);
+	p[3] = (unsigned char)(value >> 24);
+}
+
+// Function to store the coordinate at "index" of "pCoords" (of "coordSize" bytes) at "p" in
+// little-endian byte order. Returns the number of bytes stored.
+static size_t storeCoordLE(unsigned char* p, const void* pCoords, size_t index, size_t coordSize)
+{
+	if(coordSize == sizeof(double))
+	{
+		uint64_t bits;
+		memcpy(&bits, (const double*)pCoords + index, sizeof(double));
+		storeUint32LE(p, (uint32_t)bits);
+		storeUint32LE(p + 4, (uint32_t)(bits >> 32));
+	}
+	else
+	{
+		uint32_t bits;
+		memcpy(&bits, (const float*)pCoords + index, sizeof(float));
+		storeUint32LE(p, bits);
+	}
+
+	return coordSize;
+}
+
+// Function to write the "count" coordinates of vertex "vertexId" in "pCoords" as ASCII values
+// (separated by spaces) or as binary values
+static void writeCoords(MioWriter* pWriter,
+						bool binary,
+						const void* pCoords,
+						size_t coordSize,
+						size_t vertexId,
+						size_t count)
+{
+	for(size_t k = 0; k < count; ++k)
+	{
+		if(binary)
+		{
+			unsigned char* p = (unsigned char*)mioWriterReserve(pWriter, coordSize);
+			mioWriterCommit(pWriter, storeCoordLE(p, pCoords, vertexId * count + k, coordSize));
+		}
+		else
+		{
+			mioWriterPutChar(pWriter, ' ');
+			mioWriterPutCoord(pWriter, pCoords, vertexId * count + k, coordSize);
+		}
+	}
+}
+
+static void writePLY(const char* fpath,
+					 bool binary,
+					 const void* pVertices,
+					 const void* pNormals,
+					 const void* pTexCoords,
+					 size_t coordSize,
+					 const unsigned int* pFaceSizes,
+					 const unsigned int* pFaceVertexIndices,
+					 unsigned int numVertices,
+					 unsigned int numFaces)
+{
+	mioLogInfo("write .ply file: %s\n", fpath);
+
+	MioWriter writer;
+
+	if(!mioWriterOpen(&writer, fpath, binary ? "wb" : "w"))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	// faces with up to 255 vertices (i.e. nearly always) have a one-byte vertex count
+	unsigned int maxFaceSize = 3;
+
+	for(unsigned int i = 0; pFaceSizes != NULL && i < numFaces; ++i)
+	{
+		maxFaceSize = (pFaceSizes[i] > maxFaceSize) ? pFaceSizes[i] : maxFaceSize;
+	}
+
+	const bool byteCounts = (maxFaceSize <= UCHAR_MAX);
+	const char* coordType = (coordSize == sizeof(double)) ? "double" : "float";
+
+	mioWriterPutString(&writer, "ply\n");
+	mioWriterPutString(&writer,
+					   binary ? "format binary_little_endian 1.0\n" : "format ascii 1.0\n");
+	mioWriterPutString(&writer, "comment written by mio\n");
+	mioWriterPutString(&writer, "element vertex ");
+	mioWriterPutUint(&writer, numVertices);
+	mioWriterPutChar(&writer, '\n');
+
+	const char* const propertyNames[] = {"x", "y", "z", "nx", "ny", "nz", "u", "v"};
+
+	for(int i = 0; i < 8; ++i)
+	{
+		if((i >= 3 && i < 6 && pNormals == NULL) || (i >= 6 && pTexCoords == NULL))
+		{
+			continue;
+		}
+
+		mioWriterPutString(&writer, "property ");
+		mioWriterPutString(&writer, coordType);
+		mioWriterPutChar(&writer, ' ');
+		mioWriterPutString(&writer, propertyNames[i]);
+		mioWriterPutChar(&writer, '\n');
+	}
+
+	mioWriterPutString(&writer, "element face ");
+	mioWriterPutUint(&writer, numFaces);
+	mioWriterPutChar(&writer, '\n');
+	mioWriterPutString(&writer,
+					   byteCounts ? "property list uchar uint vertex_indices\n"
+								  : "property list uint uint vertex_indices\n");
+	mioWriterPutString(&writer, "end_header\n");
+
+	for(size_t i = 0; i < numVertices; ++i)
+	{
+		writeCoords(&writer, binary, pVertices, coordSize, i, 3);
+
+		if(pNormals != NULL)
+		{
+			writeCoords(&writer, binary, pNormals, coordSize, i, 3);
+		}
+
+		if(pTexCoords != NULL)
+		{
+			writeCoords(&writer, binary, pTexCoords, coordSize, i, 2);
+		}
+
+		if(!binary)
+		{
+			mioWriterPutChar(&writer, '\n');
+		}
+	}
+
+	const unsigned int* pIndex = pFaceVertexIndices;
+
+	for(unsigned int i = 0; i < numFaces; ++i)
+	{
+		const unsigned int faceVertexCount = (pFaceSizes != NULL) ? pFaceSizes[i] : 3;
+
+		if(binary)
+		{
+			unsigned char* p = (unsigned char*)mioWriterReserve(&writer, 4);
+
+			if(byteCounts)
+			{
+				p[0] = (unsigned char)faceVertexCount;
+				mioWriterCommit(&writer, 1);
+			}
+			else
+			{
+				storeUint32LE(p, faceVertexCount);
+				mioWriterCommit(&writer, 4);
+			}
+
+			for(unsigned int j = 0; j < faceVertexCount; ++j)
+			{
+				storeUint32LE((unsigned char*)mioWriterReserve(&writer, 4), pIndex[j]);
+				mioWriterCommit(&writer, 4);
+			}
+		}
+		else
+		{
+			mioWriterPutUint(&writer, faceVertexCount);
+
+			for(unsigned int j = 0; j < faceVertexCount; ++j)
+			{
+				mioWriterPutChar(&writer, ' ');
+				mioWriterPutUint(&writer, pIndex[j]);
+			}
+
+			mioWriterPutChar(&writer, '\n');
+		}
+
+		pIndex += faceVertexCount;
+	}
+
+	if(!mioWriterClose(&writer))
+	{
+		mioLogError("error: failed to write file '%s'\n", fpath);
+	}
+
+	mioLogInfo("done.\n");
+}
+
+void mioWritePLY(const char* fpath,
+				 const double* pVertices,
+				 const double* pNormals,
+				 const double* pTexCoords,
+				 const unsigned int* pFaceSizes,
+				 const unsigned int* pFaceVertexIndices,
+				 unsigned int numVertices,
+				 unsigned int numFaces)
+{
+	writePLY(fpath,
+			 false,
+			 pVertices,
+			 pNormals,
+			 pTexCoords,
+			 sizeof(double),
+			 pFaceSizes,
+			 pFaceVertexIndices,
+			 numVertices,
+			 numFaces);
+}
+
+void mioWritePLYBinary(const char* fpath,
+					   const double* pVertices,
+					   const double* pNormals,
+					   const double* pTexCoords,
+					   const unsigned int* pFaceSizes,
+					   const unsigned int* pFaceVertexIndices,
+					   unsigned int numVertices,
+					   unsigned int numFaces)
+{
+	writePLY(fpath,
+			 true,
+			 pVertices,
+			 pNormals,
+			 pTexCoords,
+			 sizeof(double),
+			 pFaceSizes,
+			 pFaceVertexIndices,
+			 numVertices,
+			 numFaces);
+}
+
+void mioWritePLYf(const char* fpath,
+				  const float* pVertices,
+				  const float* pNormals,
+				  const float* pTexCoords,
+				  const unsigned int* pFaceSizes,
+				  const unsigned int* pFaceVertexIndices,
+				  unsigned int numVertices,
+				  unsigned int numFaces)
+{
+	writePLY(fpath,
+			 false,
+			 pVertices,
+			 pNormals,
+			 pTexCoords,
+			 sizeof(float),
+			 pFaceSizes,
+			 pFaceVertexIndices,
+			 numVertices,
+			 numFaces);
+}
+
+void mioWritePLYBinaryf(const char* fpath,
+						const float* pVertices,
+						const float* pNormals,
+						const float* pTexCoords,
+						const unsigned int* pFaceSizes,
+						const unsigned int* pFaceVertexIndices,
+						unsigned int numVertices,
+						unsigned int numFaces)
+{
+	writePLY(fpath,
+			 true,
+			 pVertices,
+			 pNormals,
+			 pTexCoords,
+			 sizeof(float),
+			 pFaceSizes,
+			 pFaceVertexIndices,
+			 numVertices,
+			 numFaces);
+}
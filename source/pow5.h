@@ -0,0 +1,84 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_POW5_H__
+#define __MIO_POW5_H__ 1
+
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
+// Internal tables and wide-integer helpers shared by the number parser (decimal to binary) and the
+// number formatter (binary to decimal).
+
+// 128-bit approximations of 5^q for q in [-342, 324], stored as pairs of [high, low] 64-bit words,
+// normalised such that the most significant bit of the high word is set.
+#define MIO_SMALLEST_POWER_OF_FIVE (-342)
+#define MIO_LARGEST_POWER_OF_FIVE (324)
+
+extern const uint64_t mioPowersOfFive128[];
+
+// Function to compute the full 128-bit product of "a" and "b"
+static inline uint64_t mioMultiply128(uint64_t a, uint64_t b, uint64_t* pHigh)
+{
+#if defined(__SIZEOF_INT128__)
+	const unsigned __int128 product = (unsigned __int128)a * b;
+	*pHigh = (uint64_t)(product >> 64);
+	return (uint64_t)product;
+#elif defined(_MSC_VER) && defined(_M_X64)
+	return _umul128(a, b, pHigh);
+#else
+	const uint64_t aLo = (uint32_t)a;
+	const uint64_t aHi = a >> 32;
+	const uint64_t bLo = (uint32_t)b;
+	const uint64_t bHi = b >> 32;
+	const uint64_t ll = aLo * bLo;
+	const uint64_t lh = aLo * bHi;
+	const uint64_t hl = aHi * bLo;
+	const uint64_t hh = aHi * bHi;
+	const uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+	*pHigh = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+	return (mid << 32) | (uint32_t)ll;
+#endif
+}
+
+static inline int mioCountLeadingZeros64(uint64_t x)
+{
+	// NOTE: x != 0
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_clzll(x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long index = 0;
+	_BitScanReverse64(&index, x);
+	return 63 - (int)index;
+#else
+	int n = 0;
+	while((x & 0x8000000000000000ull) == 0)
+	{
+		x <<= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+#endif // #ifndef __MIO_POW5_H__
@@ -0,0 +1,521 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "mio/mio.h"
+
+#include "array.h"
+#include "log.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Reordering of the vertices and faces of a loaded mesh for cache locality (see "mioReorderMesh").
+// The reordered arrays are built in scratch memory and copied back over the arrays of the mesh,
+// which keep their sizes, so this works the same for meshes in an arena or a mapping.
+
+// number of bits of each coordinate in a Morton code
+#define MORTON_BITS 21
+
+// number of bits of the digits of the radix sort of the Morton codes (3 * 21 = 63 bits in 6 passes)
+#define RADIX_BITS 11
+
+// size of the vertex cache that the faces are ordered for
+#define VERTEX_CACHE_SIZE 16
+
+// a vertex and its Morton code
+typedef struct MortonKey
+{
+	uint64_t code;
+	unsigned int vertex;
+} MortonKey;
+
+// Function to spread the low MORTON_BITS bits of "x" out to every third bit
+static uint64_t spreadBits(uint64_t x)
+{
+	x &= 0x1fffff;
+	x = (x | (x << 32)) & 0x1f00000000ffffull;
+	x = (x | (x << 16)) & 0x1f0000ff0000ffull;
+	x = (x | (x << 8)) & 0x100f00f00f00f00full;
+	x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+	x = (x | (x << 2)) & 0x1249249249249249ull;
+	return x;
+}
+
+// Function to map coordinate "x" to a cell of [0, 2^MORTON_BITS) along an axis starting at "min"
+// with "scale" cells per unit (where NaN maps to cell 0)
+static uint64_t quantize(double x, double min, double scale)
+{
+	const double cell = (x - min) * scale;
+	const double maxCell = (double)((1u << MORTON_BITS) - 1);
+
+	return (cell > 0.0) ? (uint64_t)((cell < maxCell) ? cell : maxCell) : 0;
+}
+
+// Function to sort the "count" keys of "pKeys" by their codes with an (LSD) radix sort, which is
+// stable, so vertices in the same cell keep their order. "pScratch" holds another "count" keys.
+static void sortKeys(MortonKey* pKeys, MortonKey* pScratch, size_t count)
+{
+	size_t histogram[1u << RADIX_BITS];
+
+	for(unsigned int shift = 0; shift < 3 * MORTON_BITS; shift += RADIX_BITS)
+	{
+		memset(histogram, 0, sizeof(histogram));
+
+		for(size_t i = 0; i < count; ++i)
+		{
+			histogram[(pKeys[i].code >> shift) & ((1u << RADIX_BITS) - 1)]++;
+		}
+
+		size_t offset = 0;
+
+		for(size_t d = 0; d < (1u << RADIX_BITS); ++d)
+		{
+			const size_t n = histogram[d];
+			histogram[d] = offset;
+			offset += n;
+		}
+
+		for(size_t i = 0; i < count; ++i)
+		{
+			pScratch[histogram[(pKeys[i].code >> shift) & ((1u << RADIX_BITS) - 1)]++] = pKeys[i];
+		}
+
+		MortonKey* pSorted = pScratch;
+		pScratch = pKeys;
+		pKeys = pSorted;
+	}
+
+	// NOTE: the number of passes is even, so the keys end up in "pKeys" again
+}
+
+// Function to sort the vertices of "pMesh" along a Morton curve through (the cube around) their
+// bounding box, and to remap the face-vertex indices. "pOrder" receives the index (before the
+// sort) of each vertex.
+static void reorderVertices(MioMesh* pMesh, unsigned int* pOrder)
+{
+	const size_t numVertices = pMesh->numVertices;
+	double* pVertices = pMesh->pVertices;
+
+	double min[3] = {0.0, 0.0, 0.0};
+	double max[3] = {0.0, 0.0, 0.0};
+
+	for(size_t i = 0; i < numVertices; ++i)
+	{
+		for(int k = 0; k < 3; ++k)
+		{
+			const double x = pVertices[i * 3 + k];
+
+			min[k] = (i == 0 || x < min[k]) ? x : min[k];
+			max[k] = (i == 0 || x > max[k]) ? x : max[k];
+		}
+	}
+
+	double extent = 0.0;
+
+	for(int k = 0; k < 3; ++k)
+	{
+		extent = (max[k] - min[k] > extent) ? max[k] - min[k] : extent;
+	}
+
+	const double scale = (extent > 0.0) ? (double)(1u << MORTON_BITS) / extent : 0.0;
+
+	MortonKey* pKeys = (MortonKey*)mioAllocate(numVertices * 2, sizeof(MortonKey));
+
+	for(size_t i = 0; i < numVertices; ++i)
+	{
+		const double* p = pVertices + i * 3;
+
+		pKeys[i].code = spreadBits(quantize(p[0], min[0], scale)) |
+						(spreadBits(quantize(p[1], min[1], scale)) << 1) |
+						(spreadBits(quantize(p[2], min[2], scale)) << 2);
+		pKeys[i].vertex = (unsigned int)i;
+	}
+
+	sortKeys(pKeys, pKeys + numVertices, numVertices);
+
+	// the new position of each vertex (in the scratch half of the keys, which is no longer needed)
+	unsigned int* pNewIndices = (unsigned int*)(pKeys + numVertices);
+	double* pSortedVertices = (double*)mioAllocate(numVertices * 3, sizeof(double));
+
+	for(size_t i = 0; i < numVertices; ++i)
+	{
+		const unsigned int v = pKeys[i].vertex;
+
+		pOrder[i] = v;
+		pNewIndices[v] = (unsigned int)i;
+		memcpy(pSortedVertices + i * 3, pVertices + (size_t)v * 3, 3 * sizeof(double));
+	}
+
+	if(numVertices > 0)
+	{
+		memcpy(pVertices, pSortedVertices, numVertices * 3 * sizeof(double));
+	}
+
+	size_t numFaceVertices = 0;
+
+	for(unsigned int f = 0; f < pMesh->numFaces; ++f)
+	{
+		numFaceVertices += pMesh->pFaceSizes[f];
+	}
+
+	for(size_t i = 0; i < numFaceVertices; ++i)
+	{
+		pMesh->pFaceVertexIndices[i] = pNewIndices[pMesh->pFaceVertexIndices[i]];
+	}
+
+	mioMemFree(pSortedVertices);
+	mioMemFree(pKeys);
+}
+
+// adjacency of the vertices and faces of a mesh, and the state of "reorderFaces"
+typedef struct FaceOrdering
+{
+	// index of the first face-vertex of each face
+	size_t* pFaceOffsets;
+	// the faces around each vertex, where those of vertex v are
+	// "pVertexFaces[pVertexFaceOffsets[v], pVertexFaceOffsets[v + 1])"
+	size_t* pVertexFaceOffsets;
+	unsigned int* pVertexFaces;
+	// number of faces around each vertex that have not been emitted yet
+	unsigned int* pLiveFaces;
+	// time at which each vertex last entered the (simulated) cache, where 0 means never
+	size_t* pCacheTimes;
+	bool* pEmitted;
+	// vertices of the emitted faces, from which the ordering restarts when it runs into a dead end
+	unsigned int* pDeadEnds;
+	size_t numDeadEnds;
+	// vertices of the faces that were emitted around the current vertex
+	MioArray candidates;
+	// next vertex (in vertex order) to restart from when there is no dead end left
+	size_t nextVertex;
+	size_t time;
+} FaceOrdering;
+
+// Function to pick the next vertex to emit the faces of (or UINT32_MAX if all faces are emitted):
+// the candidate that is expected to still be in the cache once its remaining faces are emitted
+// (the one that entered it first), or else the most recent dead end, or else the next vertex
+static unsigned int pickNextVertex(FaceOrdering* pOrdering, size_t numVertices)
+{
+	const unsigned int* pCandidates = (const unsigned int*)pOrdering->candidates.pData;
+	unsigned int best = UINT32_MAX;
+	size_t bestPriority = 0;
+
+	for(size_t i = 0; i < pOrdering->candidates.size; ++i)
+	{
+		const unsigned int v = pCandidates[i];
+
+		if(pOrdering->pLiveFaces[v] > 0)
+		{
+			const size_t age = pOrdering->time - pOrdering->pCacheTimes[v];
+			const size_t priority =
+				(age + 2 * (size_t)pOrdering->pLiveFaces[v] <= VERTEX_CACHE_SIZE) ? age + 1 : 1;
+
+			if(priority > bestPriority)
+			{
+				best = v;
+				bestPriority = priority;
+			}
+		}
+	}
+
+	while(best == UINT32_MAX && pOrdering->numDeadEnds > 0)
+	{
+		const unsigned int v = pOrdering->pDeadEnds[--pOrdering->numDeadEnds];
+		best = (pOrdering->pLiveFaces[v] > 0) ? v : UINT32_MAX;
+	}
+
+	while(best == UINT32_MAX && pOrdering->nextVertex < numVertices)
+	{
+		const size_t v = pOrdering->nextVertex++;
+		best = (pOrdering->pLiveFaces[v] > 0) ? (unsigned int)v : UINT32_MAX;
+	}
+
+	return best;
+}
+
+// Function to order the faces of "pMesh" for the reuse of vertices in a vertex cache of
+// VERTEX_CACHE_SIZE vertices, with the "Tipsify" algorithm of Sander et al. (2007) (extended to
+// polygons): the faces around a vertex are emitted as a fan, and the next fanning vertex is one of
+// the vertices of that fan which will still be in the cache. Returns the order in "pOrder", as the
+// index of each face before the ordering.
+static void orderFaces(const MioMesh* pMesh, unsigned int* pOrder)
+{
+	const size_t numVertices = pMesh->numVertices;
+	const size_t numFaces = pMesh->numFaces;
+	const unsigned int* pIndices = pMesh->pFaceVertexIndices;
+
+	FaceOrdering ordering;
+
+	memset(&ordering, 0, sizeof(FaceOrdering));
+
+	ordering.pFaceOffsets = (size_t*)mioAllocate(numFaces + 1, sizeof(size_t));
+	ordering.pVertexFaceOffsets = (size_t*)mioAllocate(numVertices + 1, sizeof(size_t));
+	ordering.pLiveFaces = (unsigned int*)mioAllocate(numVertices, sizeof(unsigned int));
+	ordering.pCacheTimes = (size_t*)mioAllocate(numVertices, sizeof(size_t));
+	ordering.pEmitted = (bool*)mioAllocate(numFaces, sizeof(bool));
+
+	memset(ordering.pLiveFaces, 0, numVertices * sizeof(unsigned int));
+	memset(ordering.pCacheTimes, 0, numVertices * sizeof(size_t));
+	memset(ordering.pEmitted, 0, numFaces * sizeof(bool));
+
+	size_t numFaceVertices = 0;
+
+	for(size_t f = 0; f < numFaces; ++f)
+	{
+		ordering.pFaceOffsets[f] = numFaceVertices;
+
+		for(unsigned int j = 0; j < pMesh->pFaceSizes[f]; ++j)
+		{
+			ordering.pLiveFaces[pIndices[numFaceVertices + j]]++;
+		}
+
+		numFaceVertices += pMesh->pFaceSizes[f];
+	}
+
+	ordering.pFaceOffsets[numFaces] = numFaceVertices;
+
+	// the faces around each vertex (with a prefix sum over the face counts)
+	size_t offset = 0;
+
+	for(size_t v = 0; v < numVertices; ++v)
+	{
+		ordering.pVertexFaceOffsets[v] = offset;
+		offset += ordering.pLiveFaces[v];
+	}
+
+	ordering.pVertexFaceOffsets[numVertices] = offset;
+	ordering.pVertexFaces = (unsigned int*)mioAllocate(numFaceVertices, sizeof(unsigned int));
+	ordering.pDeadEnds = (unsigned int*)mioAllocate(numFaceVertices, sizeof(unsigned int));
+
+	for(size_t f = 0; f < numFaces; ++f)
+	{
+		for(size_t i = ordering.pFaceOffsets[f]; i < ordering.pFaceOffsets[f + 1]; ++i)
+		{
+			// NOTE: "pCacheTimes" (which is zero) counts the faces that have been placed so far
+			const unsigned int v = pIndices[i];
+			ordering.pVertexFaces[ordering.pVertexFaceOffsets[v] + ordering.pCacheTimes[v]++] =
+				(unsigned int)f;
+		}
+	}
+
+	memset(ordering.pCacheTimes, 0, numVertices * sizeof(size_t));
+
+	ordering.time = VERTEX_CACHE_SIZE + 1;
+
+	size_t numEmitted = 0;
+	unsigned int fanVertex = pickNextVertex(&ordering, numVertices);
+
+	while(fanVertex != UINT32_MAX)
+	{
+		ordering.candidates.size = 0;
+
+		for(size_t a = ordering.pVertexFaceOffsets[fanVertex];
+			a < ordering.pVertexFaceOffsets[fanVertex + 1];
+			++a)
+		{
+			const unsigned int f = ordering.pVertexFaces[a];
+
+			if(ordering.pEmitted[f])
+			{
+				continue;
+			}
+
+			const size_t faceSize = ordering.pFaceOffsets[f + 1] - ordering.pFaceOffsets[f];
+
+			mioArrayReserve(
+				&ordering.candidates, sizeof(unsigned int), ordering.candidates.size + faceSize);
+
+			unsigned int* pCandidates = (unsigned int*)ordering.candidates.pData;
+
+			for(size_t i = ordering.pFaceOffsets[f]; i < ordering.pFaceOffsets[f + 1]; ++i)
+			{
+				const unsigned int v = pIndices[i];
+
+				ordering.pDeadEnds[ordering.numDeadEnds++] = v;
+				pCandidates[ordering.candidates.size++] = v;
+				ordering.pLiveFaces[v]--;
+
+				if(ordering.time - ordering.pCacheTimes[v] > VERTEX_CACHE_SIZE)
+				{
+					ordering.pCacheTimes[v] = ordering.time++; // (the vertex is not in the cache)
+				}
+			}
+
+			ordering.pEmitted[f] = true;
+			pOrder[numEmitted++] = f;
+		}
+
+		fanVertex = pickNextVertex(&ordering, numVertices);
+	}
+
+	// faces without vertices are not around any vertex, and go last
+	for(size_t f = 0; f < numFaces; ++f)
+	{
+		if(!ordering.pEmitted[f])
+		{
+			pOrder[numEmitted++] = (unsigned int)f;
+		}
+	}
+
+	mioMemFree(ordering.candidates.pData);
+	mioMemFree(ordering.pDeadEnds);
+	mioMemFree(ordering.pVertexFaces);
+	mioMemFree(ordering.pEmitted);
+	mioMemFree(ordering.pCacheTimes);
+	mioMemFree(ordering.pLiveFaces);
+	mioMemFree(ordering.pVertexFaceOffsets);
+	mioMemFree(ordering.pFaceOffsets);
+}
+
+// Function to put the faces of "pMesh" (and their face-vertex indices and source faces) in the
+// order "pOrder" (see "orderFaces")
+static void applyFaceOrder(MioMesh* pMesh, const unsigned int* pOrder)
+{
+	const size_t numFaces = pMesh->numFaces;
+	size_t* pFaceOffsets = (size_t*)mioAllocate(numFaces + 1, sizeof(size_t));
+
+	pFaceOffsets[0] = 0;
+
+	for(size_t f = 0; f < numFaces; ++f)
+	{
+		pFaceOffsets[f + 1] = pFaceOffsets[f] + pMesh->pFaceSizes[f];
+	}
+
+	const size_t numFaceVertices = pFaceOffsets[numFaces];
+	unsigned int* pScratch =
+		(unsigned int*)mioAllocate((numFaceVertices > numFaces) ? numFaceVertices : numFaces,
+								   sizeof(unsigned int));
+
+	unsigned int* pIndexArrays[3] = {pMesh->pFaceVertexIndices,
+									 pMesh->pFaceVertexTexCoordIndices,
+									 pMesh->pFaceVertexNormalIndices};
+
+	for(int k = 0; k < 3; ++k)
+	{
+		if(pIndexArrays[k] == NULL)
+		{
+			continue;
+		}
+
+		size_t n = 0;
+
+		for(size_t i = 0; i < numFaces; ++i)
+		{
+			const size_t begin = pFaceOffsets[pOrder[i]];
+			const size_t count = pFaceOffsets[pOrder[i] + 1] - begin;
+
+			memcpy(pScratch + n, pIndexArrays[k] + begin, count * sizeof(unsigned int));
+			n += count;
+		}
+
+		memcpy(pIndexArrays[k], pScratch, numFaceVertices * sizeof(unsigned int));
+	}
+
+	unsigned int* pFaceArrays[2] = {pMesh->pFaceSizes, pMesh->pSourceFaces};
+
+	for(int k = 0; k < 2; ++k)
+	{
+		if(pFaceArrays[k] == NULL)
+		{
+			continue;
+		}
+
+		for(size_t i = 0; i < numFaces; ++i)
+		{
+			pScratch[i] = pFaceArrays[k][pOrder[i]];
+		}
+
+		memcpy(pFaceArrays[k], pScratch, numFaces * sizeof(unsigned int));
+	}
+
+	mioMemFree(pScratch);
+	mioMemFree(pFaceOffsets);
+}
+
+int mioReorderMesh(MioMesh* pMesh,
+				   unsigned int flags,
+				   unsigned int** pVertexOrder,
+				   unsigned int** pFaceOrder)
+{
+	if(pVertexOrder != NULL)
+	{
+		*pVertexOrder = NULL;
+	}
+
+	if(pFaceOrder != NULL)
+	{
+		*pFaceOrder = NULL;
+	}
+
+	// NOTE: the mesh may not have come from a reader (which checks its face-vertex indices)
+	size_t numFaceVertices = 0;
+
+	for(unsigned int f = 0; f < pMesh->numFaces; ++f)
+	{
+		numFaceVertices += pMesh->pFaceSizes[f];
+	}
+
+	for(size_t i = 0; i < numFaceVertices; ++i)
+	{
+		if(pMesh->pFaceVertexIndices[i] >= pMesh->numVertices)
+		{
+			mioLogError("error: face-vertex index %u refers to no vertex (of %u)\n",
+						pMesh->pFaceVertexIndices[i],
+						pMesh->numVertices);
+			return 0;
+		}
+	}
+
+	if((flags & MIO_REORDER_VERTICES) != 0 && pMesh->numVertices > 0)
+	{
+		unsigned int* pOrder = (unsigned int*)mioAllocate(pMesh->numVertices, sizeof(unsigned int));
+
+		reorderVertices(pMesh, pOrder);
+
+		if(pVertexOrder != NULL)
+		{
+			*pVertexOrder = pOrder;
+		}
+		else
+		{
+			mioMemFree(pOrder);
+		}
+	}
+
+	if((flags & MIO_REORDER_FACES) != 0 && pMesh->numFaces > 0)
+	{
+		unsigned int* pOrder = (unsigned int*)mioAllocate(pMesh->numFaces, sizeof(unsigned int));
+
+		orderFaces(pMesh, pOrder);
+		applyFaceOrder(pMesh, pOrder);
+
+		if(pFaceOrder != NULL)
+		{
+			*pFaceOrder = pOrder;
+		}
+		else
+		{
+			mioMemFree(pOrder);
+		}
+	}
+
+	return 1;
+}
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "scan.h"
+
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#	define MIO_SCAN_SSE2 1
+#	include <emmintrin.h>
+#	if defined(__GNUC__) || defined(__clang__)
+#		define MIO_SCAN_AVX2 1 // NOTE: compiled for AVX2 per function, and used if the CPU has it
+#		include <immintrin.h>
+#	endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#	define MIO_SCAN_NEON 1
+#	include <arm_neon.h>
+#endif
+
+#if defined(MIO_SCAN_SSE2)
+
+static uint64_t scanSse2(const char* pBlock, char c)
+{
+	const __m128i pattern = _mm_set1_epi8(c);
+	uint64_t mask = 0;
+
+	for(int i = 0; i < MIO_SCAN_BLOCK_SIZE; i += 16)
+	{
+		const __m128i bytes = _mm_loadu_si128((const __m128i*)(pBlock + i));
+		const int bits = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, pattern));
+		mask |= (uint64_t)(uint16_t)bits << i;
+	}
+
+	return mask;
+}
+
+#endif // #if defined(MIO_SCAN_SSE2)
+
+#if defined(MIO_SCAN_AVX2)
+
+__attribute__((target("avx2"))) static uint64_t scanAvx2(const char* pBlock, char c)
+{
+	const __m256i pattern = _mm256_set1_epi8(c);
+	const __m256i bytesLo = _mm256_loadu_si256((const __m256i*)pBlock);
+	const __m256i bytesHi = _mm256_loadu_si256((const __m256i*)(pBlock + 32));
+	const uint32_t bitsLo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytesLo, pattern));
+	const uint32_t bitsHi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytesHi, pattern));
+
+	return ((uint64_t)bitsHi << 32) | bitsLo;
+}
+
+// NOTE: the CPU features are detected by the compiler's runtime before main()
+static bool hasAvx2(void)
+{
+	return __builtin_cpu_supports("avx2") != 0;
+}
+
+#endif // #if defined(MIO_SCAN_AVX2)
+
+#if defined(MIO_SCAN_NEON)
+
+static uint64_t scanNeon(const char* pBlock, char c)
+{
+	// the bit of each byte in a group of 8 bytes, to pack the compare results with pairwise adds
+	static const uint8_t bitsOfBytes[16] = {
+		1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+	const uint8x16_t bits = vld1q_u8(bitsOfBytes);
+	const uint8x16_t pattern = vdupq_n_u8((uint8_t)c);
+	uint8x16_t matches[4];
+
+	for(int i = 0; i < 4; ++i)
+	{
+		const uint8x16_t bytes = vld1q_u8((const uint8_t*)pBlock + i * 16);
+		matches[i] = vandq_u8(vceqq_u8(bytes, pattern), bits);
+	}
+
+	const uint8x16_t sumLo = vpaddq_u8(matches[0], matches[1]);
+	const uint8x16_t sumHi = vpaddq_u8(matches[2], matches[3]);
+	uint8x16_t sum = vpaddq_u8(sumLo, sumHi);
+	sum = vpaddq_u8(sum, sum);
+
+	return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+}
+
+#endif // #if defined(MIO_SCAN_NEON)
+
+static uint64_t scanBytes(const char* pBlock, char c)
+{
+#if defined(MIO_SCAN_AVX2)
+	if(hasAvx2())
+	{
+		return scanAvx2(pBlock, c);
+	}
+#endif
+
+#if defined(MIO_SCAN_SSE2)
+	return scanSse2(pBlock, c);
+#elif defined(MIO_SCAN_NEON)
+	return scanNeon(pBlock, c);
+#else
+	uint64_t mask = 0;
+
+	for(int i = 0; i < MIO_SCAN_BLOCK_SIZE; ++i)
+	{
+		mask |= (uint64_t)(pBlock[i] == c) << i;
+	}
+
+	return mask;
+#endif
+}
+
+uint64_t mioScanNewlines(const char* pBlock)
+{
+	return scanBytes(pBlock, '\n');
+}
@@ -0,0 +1,61 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_SCAN_H__
+#define __MIO_SCAN_H__ 1
+
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
+// Internal byte scanning routines shared by the text readers.
+//
+// The input is scanned in blocks of MIO_SCAN_BLOCK_SIZE bytes, for which a bit mask of the
+// positions of a byte is computed with vector instructions (SSE2 or AVX2 on x86, chosen when the
+// program runs, and NEON on ARM64). Bit i of the mask is set if byte i of the block matches.
+
+#define MIO_SCAN_BLOCK_SIZE 64
+
+// Function to get the mask of the '\n' bytes in the block of MIO_SCAN_BLOCK_SIZE bytes at "pBlock"
+uint64_t mioScanNewlines(const char* pBlock);
+
+static inline int mioCountTrailingZeros64(uint64_t x)
+{
+	// NOTE: x != 0
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long index = 0;
+	_BitScanForward64(&index, x);
+	return (int)index;
+#else
+	int n = 0;
+	while((x & 1u) == 0)
+	{
+		x >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+#endif // #ifndef __MIO_SCAN_H__
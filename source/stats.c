@@ -0,0 +1,108 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "stats.h"
+
+#include "thread.h"
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <time.h>
+#endif
+
+#include <string.h>
+
+// the statistics that the calling thread fills (see "mioSetLoadStats")
+static MIO_THREAD_LOCAL MioLoadStats* pThreadStats = NULL;
+// "pThreadStats" while a load runs on the calling thread (NULL otherwise)
+static MIO_THREAD_LOCAL MioLoadStats* pActiveStats = NULL;
+static MIO_THREAD_LOCAL double loadStartTime = 0.0;
+
+void mioSetLoadStats(MioLoadStats* pStats)
+{
+	pThreadStats = pStats;
+}
+
+MioLoadStats* mioGetActiveLoadStats(void)
+{
+	return pActiveStats;
+}
+
+double mioGetTime(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+#endif
+}
+
+void mioLoadBegin(void)
+{
+	if(pThreadStats == NULL)
+	{
+		return;
+	}
+
+	memset(pThreadStats, 0, sizeof(MioLoadStats));
+	pThreadStats->numPasses = 1; // all readers parse their input in a single pass
+
+	pActiveStats = pThreadStats;
+	loadStartTime = mioGetTime();
+}
+
+void mioLoadEnd(const MioInput* pInput)
+{
+	if(pActiveStats == NULL)
+	{
+		return;
+	}
+
+	MioLoadStats* pStats = pActiveStats;
+
+	pStats->numBytes = pInput->numBytes;
+	pStats->numLines = pInput->numLines;
+	pStats->totalSeconds = mioGetTime() - loadStartTime;
+	pStats->parseSeconds = pStats->totalSeconds - pStats->ioSeconds - pStats->allocSeconds;
+
+	if(pStats->parseSeconds < 0.0)
+	{
+		pStats->parseSeconds = 0.0;
+	}
+
+	pActiveStats = NULL;
+}
+
+void mioLoadCancel(void)
+{
+	pActiveStats = NULL;
+}
@@ -0,0 +1,50 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_STATS_H__
+#define __MIO_STATS_H__ 1
+
+#include "mio/mio.h"
+
+#include "input.h"
+
+// Internal side of "MioLoadStats". Each reader brackets its work with "mioLoadBegin" and
+// "mioLoadEnd", and the input and memory layers add their times to the statistics of the load
+// that runs on the calling thread.
+
+// Function to get the statistics of the load that runs on the calling thread (NULL if there is no
+// load, or if the statistics are turned off)
+MioLoadStats* mioGetActiveLoadStats(void);
+
+// Function to get the current time in seconds (from an arbitrary starting point)
+double mioGetTime(void);
+
+// Function to start a load on the calling thread
+void mioLoadBegin(void);
+
+// Function to finish the load that was started with "mioLoadBegin", where "pInput" is the input
+// that was read (which must not have been closed yet)
+void mioLoadEnd(const MioInput* pInput);
+
+// Function to end the load on the calling thread without finishing its statistics (after the load
+// failed, see fail.h)
+void mioLoadCancel(void);
+
+#endif // #ifndef __MIO_STATS_H__
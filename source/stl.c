@@ -20,8 +20,20 @@
 
 #include "mio/stl.h"
 
+#include "array.h"
+#include "fail.h"
+#include "format.h"
+#include "input.h"
+#include "into.h"
+#include "log.h"
+#include "parse.h"
+#include "stats.h"
+#include "writer.h"
+
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -39,313 +51,1420 @@ enum StlFileCmdType
 	UNKNOWN = 0xFFFFFFFF
 };
 
-void mioReadSTL(
-	// absolute path to file
-	const char* fpath,
-	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
-	double** pVertices,
-	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
-	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
-	double** pNormals,
-	// number of vertices (which can be used to deduce the number of vertices)
-	unsigned int* numVertices)
+// Function to parse three coordinates from [p, pEnd) and append them to "pArray", in double or
+// single precision (depending on "coordSize"). Returns the number of coordinates that were found.
+static size_t parseXYZ(MioArray* pArray, const char* p, const char* pEnd, size_t coordSize)
 {
-	fprintf(stdout, "read .stl file: %s\n", fpath);
-
-	FILE* file = fopen(fpath, "rb"); // open our file
+	size_t nread = 0;
 
-	if(file == NULL)
+	if(coordSize == sizeof(double))
 	{
-		fprintf(stderr, "error: failed to open file '%s'", fpath);
-		exit(1);
+		double xyz[3] = {0.0, 0.0, 0.0};
+		nread = mioParseDoubles(p, pEnd, xyz, 3);
+		mioArrayPushDoubles(pArray, xyz, 3);
 	}
+	else
+	{
+		float xyz[3] = {0.0f, 0.0f, 0.0f};
+		nread = mioParseFloats(p, pEnd, xyz, 3);
+		mioArrayPushFloats(pArray, xyz, 3);
+	}
+
+	return nread;
+}
 
-	fpos_t startOfFile;
+// Function to determine the type of "command" in the stl file that is contained on the line
+// [pLine, pLineEnd), whose keyword starts at "pCmd". "*ppArgs" is set to the start of the data
+// that follows the keyword.
+static enum StlFileCmdType
+parseCmdType(const char* pLine, const char* pCmd, const char* pLineEnd, const char** ppArgs)
+{
+	enum StlFileCmdType cmdType = UNKNOWN;
 
-	if(fgetpos(file, &startOfFile) != 0) /* current position: start of file */
+	if(mioStartsWith(pCmd, pLineEnd, "solid", ppArgs))
 	{
-		perror("fgetpos()");
-		fprintf(stderr, "error fgetpos() failed in file %s at line # %d\n", __FILE__, __LINE__ - 3);
-		exit(EXIT_FAILURE);
+		cmdType = SOLID;
+	}
+	else if(mioStartsWith(pCmd, pLineEnd, "facet", ppArgs) &&
+			mioStartsWith(mioSkipBlanks(*ppArgs, pLineEnd), pLineEnd, "normal", ppArgs))
+	{
+		cmdType = FACET_NORMAL;
+	}
+	else if(mioStartsWith(pCmd, pLineEnd, "outer", ppArgs))
+	{
+		cmdType = OUTER_LOOP;
+	}
+	else if(mioStartsWith(pCmd, pLineEnd, "vertex", ppArgs))
+	{
+		cmdType = VERTEX;
+	}
+	else if(mioStartsWith(pCmd, pLineEnd, "endloop", ppArgs))
+	{
+		cmdType = END_LOOP;
+	}
+	else if(mioStartsWith(pCmd, pLineEnd, "endfacet", ppArgs))
+	{
+		cmdType = END_FACET;
+	}
+	else if(mioStartsWith(pCmd, pLineEnd, "endsolid", ppArgs))
+	{
+		cmdType = END_SOLID;
+	}
+	else
+	{
+		assert(cmdType == UNKNOWN);
+		mioLogNote("note: skipping unrecognised command in line '%.*s'\n",
+				   (int)(pLineEnd - pLine),
+				   pLine);
 	}
 
-	// buffer used to store the contents of a line read from the file.
-	char* lineBuf = NULL;
-	// current length of the line buffer (in characters read)
-	size_t lineBufLen = 0;
-
-	// counts the number of passes we have made over the file to parse contents.
-	// this is needed because multiple passes are required e.g. to determine how
-	// much memory to allocate before actually copying data into pointers.
-	//
-	// The first pass is a survey of the file, counting the number of elements
-	// (vertices, faces etc) and allocating the respective memory.
-	// The second pass actually copies the data from file and into the allocated arrays
+	return cmdType;
+}
 
-	int passIterator = 0;
+// Function to parse the lines of an ASCII STL file into coordinates of "coordSize" bytes
+static void readAsciiSTL(MioInput* pInput,
+						 size_t coordSize,
+						 void** ppVertices,
+						 void** ppNormals,
+						 unsigned int* numVertices)
+{
+	// The file is parsed in a single pass, where vertices and normals are appended to growable
+	// arrays that are trimmed to size and handed over to the caller at the end.
+	MioArray vertices = {NULL, 0, 0};
+	MioArray normals = {NULL, 0, 0};
 
-	do
-	{ // each iteration will parse the file in full
+	size_t nVertices = 0; // number of vertex coordinates found in file
+	size_t nNormals = 0;
 
-		// these variables are defined after having parsed the full file
-		int nVertices = 0; // number of vertex coordinates found in file
-		int nNormals = 0;
-		int verticesCounter = 0;
-		//int solidCommandCounter = 0;
+	// the current line (excluding the line terminator)
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
 
-		// number of characters read on a lineBuf
-		size_t nread = 0;
+	while(mioInputNextLine(pInput, &pLine, &pLineEnd))
+	{ // each iteration will parse a line in the file
 
-		while((nread = getline(&lineBuf, &lineBufLen, file)) != (((size_t)0) - 1) /*-1*/)
-		{ // each iteration will parse a line in the file
-			//printf("line : ");
-			//printf(lineBuf);
+		// the command keyword of a line can be indented
+		const char* pCmd = mioSkipBlanks(pLine, pLineEnd);
 
-			lineBuf[strcspn(lineBuf, "\r\n")] = '\0'; // strip newline and carriage return
+		const bool lineIsEmpty = (pCmd == pLineEnd);
 
-			const size_t lineLen = strlen(lineBuf);
+		if(lineIsEmpty)
+		{
+			continue; // .. skip to next line
+		}
 
-			assert(lineLen <= nread);
+		//
+		// In the following, we determine the type of "command" in the stl
+		// file that is contained on the current line.
+		//
 
-			const bool lineIsEmpty = (lineLen == 0);
+		const char* pArgs = pCmd; // start of the data that follows the command keyword
+		const enum StlFileCmdType cmdType = parseCmdType(pLine, pCmd, pLineEnd, &pArgs);
 
-			if(lineIsEmpty)
-			{
-				continue; // .. skip to next line
-			}
+		if(cmdType == UNKNOWN)
+		{
+			continue; // ... to next line
+		}
 
-			//
-			// In the following, we determine the type of "command" in the stl
-			// file that is contained on the current line.
-			//
+		//
+		// Now that we know the type of command whose data is on the current line,
+		// we can go ahead and parse the line in a command-specific way
+		//
+		switch(cmdType)
+		{
+		case SOLID: {
+			// do nothing
+		}
+		break;
+		case FACET_NORMAL: {
+			const size_t normalId = nNormals++; // incremental vertex-normal count in file
 
-			enum StlFileCmdType cmdType = UNKNOWN;
+			const size_t nread = parseXYZ(&normals, pArgs, pLineEnd, coordSize);
 
-			if(strstr(lineBuf, "solid") != NULL)
-			{
-				cmdType = SOLID;
-			}
-			else if(strstr(lineBuf, "facet normal") != NULL)
-			{
-				cmdType = FACET_NORMAL;
-			}
-			else if(strstr(lineBuf, "outer loop") != NULL)
-			{
-				cmdType = OUTER_LOOP;
-			}
-			else if(strstr(lineBuf, "vertex") != NULL)
-			{
-				cmdType = VERTEX;
-			}
-			else if(strstr(lineBuf, "endloop") != NULL)
+			if(nread != 3)
 			{
-				cmdType = END_LOOP;
+				mioLogError("error: have %zu components for vn%zu\n", nread, normalId);
+				mioFail(MIO_STATUS_MALFORMED);
 			}
-			else if(strstr(lineBuf, "endfacet") != NULL)
+		}
+		break;
+		case OUTER_LOOP: {
+			// do nothing
+		}
+		break;
+		case VERTEX: { // parsing vertex coordinates
+			const size_t vertexId = nVertices++; // incremental vertex count in file
+
+			const size_t nread = parseXYZ(&vertices, pArgs, pLineEnd, coordSize);
+
+			if(nread != 3)
 			{
-				cmdType = END_FACET;
+				mioLogError("error: have %zu components for v%zu\n", nread, vertexId);
+				mioFail(MIO_STATUS_MALFORMED);
 			}
-			else if(strstr(lineBuf, "endsolid") != NULL)
+		}
+		break;
+		case END_LOOP: {
+			// do nothing
+		}
+		break;
+		case END_FACET: {
+			// do nothing
+		}
+		break;
+		case END_SOLID: {
+			// do nothing
+		}
+		break;
+		default:
+			break;
+		} // switch (cmdType) {
+	}
+
+	mioLogInfo("\t%zu vertices\n", nVertices);
+
+	if((nVertices % 3u) != 0 || nNormals != nVertices / 3u)
+	{
+		mioLogError("error: have %zu vertices and %zu normals, but each facet must have one normal "
+					"and 3 vertices\n",
+					nVertices,
+					nNormals);
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+
+	mioLogInfo("\t%zu normals\n", nNormals);
+
+	if(nVertices > 0)
+	{
+		// hand over the parsed data to the caller
+		*ppVertices = mioArrayRelease(&vertices, coordSize);
+		*ppNormals = mioArrayRelease(&normals, coordSize);
+	}
+	else
+	{
+		mioMemFree(vertices.pData);
+		mioMemFree(normals.pData);
+	}
+
+	*numVertices = (unsigned int)nVertices;
+}
+
+// size of the header of a binary STL file: an 80-byte comment followed by the uint32 triangle count
+#define BINARY_HEADER_SIZE 84
+
+// size of a triangle record in a binary STL file: the normal and three vertices (as 12 float32s)
+// followed by the uint16 "attribute byte count"
+#define BINARY_TRIANGLE_SIZE 50
+
+// NOTE: binary STL files are little-endian. The byte-wise loads/stores below are portable and
+// compile to plain (unaligned) loads/stores on little-endian targets.
+static uint32_t readUint32LE(const unsigned char* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float readFloat32LE(const unsigned char* p)
+{
+	const uint32_t bits = readUint32LE(p);
+	float value;
+	memcpy(&value, &bits, sizeof(float));
+	return value;
+}
+
+static void writeUint32LE(unsigned char* p, uint32_t value)
+{
+	p[0] = (unsigned char)(value);
+	p[1] = (unsigned char)(value >> 8);
+	p[2] = (unsigned char)(value >> 16);
+	p[3] = (unsigned char)(value >> 24);
+}
+
+static void writeFloat32LE(unsigned char* p, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(float));
+	writeUint32LE(p, bits);
+}
+
+// Function to determine whether "pInput" holds a binary STL file. The file size is checked against
+// the triangle count in the header when the whole file is available (e.g. when it is mapped).
+// Otherwise (and for binary files with trailing bytes) the header is checked for non-text bytes,
+// which an ASCII file never has but the zero-padded comment and the triangle count nearly always
+// do. NOTE: many binary files start with "solid" as well, so that alone cannot be relied on.
+static bool isBinarySTL(MioInput* pInput)
+{
+	if(!mioInputRequire(pInput, BINARY_HEADER_SIZE))
+	{
+		return false; // too small to be a binary file
+	}
+
+	const unsigned char* pHeader = (const unsigned char*)pInput->pCur;
+
+	if(pInput->atEnd)
+	{
+		const uint64_t numTriangles = readUint32LE(pHeader + 80);
+		const uint64_t expectedSize = BINARY_HEADER_SIZE + numTriangles * BINARY_TRIANGLE_SIZE;
+
+		if((uint64_t)(pInput->pEnd - pInput->pCur) == expectedSize)
+		{
+			return true;
+		}
+	}
+
+	for(int i = 0; i < BINARY_HEADER_SIZE; ++i)
+	{
+		const unsigned char c = pHeader[i];
+		const bool isText = (c >= 0x20 && c != 0x7f) || c == '\t' || c == '\n' || c == '\r' ||
+							c == '\v' || c == '\f';
+
+		if(!isText)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Function to check that the "numTriangles" records of the header of a binary STL file fit in the
+// rest of "pInput" when its size is known (e.g. when it is mapped), so that a corrupt count is
+// found before anything is allocated for it
+static void checkTriangleCount(const MioInput* pInput, uint32_t numTriangles)
+{
+	const uint64_t recordsSize = (uint64_t)numTriangles * BINARY_TRIANGLE_SIZE;
+
+	if(pInput->atEnd && (uint64_t)(pInput->pEnd - pInput->pCur) < recordsSize)
+	{
+		mioLogError("error: the file has %u triangles, but only %zu bytes of records\n",
+					numTriangles,
+					(size_t)(pInput->pEnd - pInput->pCur));
+		mioFail(MIO_STATUS_MALFORMED);
+	}
+}
+
+// Function to read the triangle records of a binary STL file into coordinates of "coordSize"
+// bytes. NOTE: the records store floats, which are copied as they are in single precision.
+static void readBinarySTL(MioInput* pInput,
+						  size_t coordSize,
+						  void** ppVertices,
+						  void** ppNormals,
+						  unsigned int* numVertices)
+{
+	const uint32_t numTriangles = readUint32LE((const unsigned char*)pInput->pCur + 80);
+
+	pInput->pCur += BINARY_HEADER_SIZE;
+
+	if(numTriangles > UINT_MAX / 3u)
+	{
+		mioLogError("error: too many triangles (%u)\n", numTriangles);
+		mioFail(MIO_STATUS_TOO_LARGE);
+	}
+
+	const size_t nVertices = (size_t)numTriangles * 3u;
+
+	mioLogInfo("\t%zu vertices\n", nVertices);
+	mioLogInfo("\t%zu normals\n", (size_t)numTriangles);
+
+	if(numTriangles == 0)
+	{
+		*numVertices = 0;
+		return;
+	}
+
+	checkTriangleCount(pInput, numTriangles);
+
+	// NOTE: the count of a streamed file is only trusted as far as its records are read, so the
+	// arrays of that file grow with the records (and those of a complete file are allocated once)
+	MioArray vertices = {NULL, 0, 0};
+	MioArray normals = {NULL, 0, 0};
+
+	if(pInput->atEnd)
+	{
+		mioArrayReserve(&vertices, coordSize, nVertices * 3u);
+		mioArrayReserve(&normals, coordSize, (size_t)numTriangles * 3u);
+	}
+
+	size_t triangleId = 0;
+
+	while(triangleId < numTriangles)
+	{
+		if(!mioInputRequire(pInput, BINARY_TRIANGLE_SIZE))
+		{
+			mioLogError("error: file ends after %zu of %u triangles\n", triangleId, numTriangles);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+
+		// convert all of the records that are currently available in one go
+		size_t count = (size_t)(pInput->pEnd - pInput->pCur) / BINARY_TRIANGLE_SIZE;
+
+		if(count > numTriangles - triangleId)
+		{
+			count = numTriangles - triangleId;
+		}
+
+		const unsigned char* pRecord = (const unsigned char*)pInput->pCur;
+
+		mioArrayReserve(&vertices, coordSize, (triangleId + count) * 9u);
+		mioArrayReserve(&normals, coordSize, (triangleId + count) * 3u);
+
+		void* pVertexData = vertices.pData;
+		void* pNormalData = normals.pData;
+
+		if(coordSize == sizeof(double))
+		{
+			for(size_t i = 0; i < count; ++i)
 			{
-				cmdType = END_SOLID;
+				double* pNormal = (double*)pNormalData + triangleId * 3u;
+				double* pVertex = (double*)pVertexData + triangleId * 9u;
+
+				for(int k = 0; k < 3; ++k)
+				{
+					pNormal[k] = (double)readFloat32LE(pRecord + k * 4);
+				}
+
+				for(int k = 0; k < 9; ++k)
+				{
+					pVertex[k] = (double)readFloat32LE(pRecord + 12 + k * 4);
+				}
+
+				pRecord += BINARY_TRIANGLE_SIZE;
+				triangleId++;
 			}
-			else
+		}
+		else
+		{
+			for(size_t i = 0; i < count; ++i)
 			{
-				assert(cmdType == UNKNOWN);
-				fprintf(stderr, "note: skipping unrecognised command in line '%s'\n", lineBuf);
-				continue; // ... to next lineBuf
-			}
+				float* pNormal = (float*)pNormalData + triangleId * 3u;
+				float* pVertex = (float*)pVertexData + triangleId * 9u;
 
-			//
-			// Now that we know the type of command whose data is on the current line,
-			// we can go ahead and parse the line in a command-specific way
-			//
-			switch(cmdType)
-			{
-			case SOLID: {
-				if(passIterator == 1)
+				for(int k = 0; k < 3; ++k)
+				{
+					pNormal[k] = readFloat32LE(pRecord + k * 4);
+				}
+
+				for(int k = 0; k < 9; ++k)
 				{
-					// store offset
-					//pVertexOffsets[solidCommandCounter] = nVertices; // current number of vertices parsed
+					pVertex[k] = readFloat32LE(pRecord + 12 + k * 4);
 				}
 
-				//solidCommandCounter += 1;
+				pRecord += BINARY_TRIANGLE_SIZE;
+				triangleId++;
 			}
-			break;
-			case FACET_NORMAL: {
-				const int normalId = nNormals++; // incremental vertex-normal count in file
+		}
 
-				if(passIterator == 1)
-				{
+		pInput->pCur = (const char*)pRecord;
+	}
 
-					double x = 0.0;
-					double y = 0.0;
-					double z = 0.0;
+	// hand over the parsed data to the caller
+	vertices.size = nVertices * 3u;
+	normals.size = (size_t)numTriangles * 3u;
 
-					nread = sscanf(lineBuf + strlen("facet normal"), "%lf %lf %lf", &x, &y, &z);
+	*ppVertices = mioArrayRelease(&vertices, coordSize);
+	*ppNormals = mioArrayRelease(&normals, coordSize);
+	*numVertices = (unsigned int)nVertices;
+}
 
-					(*pNormals)[normalId * 3 + 0] = x;
-					(*pNormals)[normalId * 3 + 1] = y;
-					(*pNormals)[normalId * 3 + 2] = z;
+// Function to read the contents of an (ASCII or binary) .stl file from "pInput" with coordinates
+// of "coordSize" bytes (i.e. sizeof(double) or sizeof(float))
+static void readSTL(MioInput* pInput,
+					size_t coordSize,
+					void** ppVertices,
+					void** ppNormals,
+					unsigned int* numVertices)
+{
+	if(isBinarySTL(pInput))
+	{
+		readBinarySTL(pInput, coordSize, ppVertices, ppNormals, numVertices);
+	}
+	else
+	{
+		readAsciiSTL(pInput, coordSize, ppVertices, ppNormals, numVertices);
+	}
+}
 
-					if(nread != 3)
-					{
-						fprintf(stderr, "error: have %zu components for vn%d\n", nread, normalId);
-						abort();
-					}
-				}
-			}
-			break;
-			case OUTER_LOOP: {
-				// do nothing
-			}
-			break;
-			case VERTEX: { // parsing vertex coordinates
-				const int vertexId = nVertices++; // incremental vertex count in file
+// Function to pass the triangle with index "triangleId" to the "onFace" callback of "pVisitor",
+// where the corners of the triangle are the last three vertices that were visited
+static void visitTriangle(const MioVisitor* pVisitor, size_t triangleId)
+{
+	if(pVisitor->onFace == NULL)
+	{
+		return;
+	}
 
-				if(passIterator == 1)
-				{
-					double x = 0.0;
-					double y = 0.0;
-					double z = 0.0;
+	const unsigned int firstVertex = (unsigned int)(triangleId * 3u);
+	const unsigned int vertexIndices[3] = {firstVertex, firstVertex + 1u, firstVertex + 2u};
+	const unsigned int normalIndices[3] = {
+		(unsigned int)triangleId, (unsigned int)triangleId, (unsigned int)triangleId};
 
-					nread = sscanf(lineBuf + strlen("vertex"), "%lf %lf %lf", &x, &y, &z);
+	pVisitor->onFace(vertexIndices, NULL, normalIndices, 3, pVisitor->pUserData);
+}
 
-					(*pVertices)[vertexId * 3 + 0] = x;
-					(*pVertices)[vertexId * 3 + 1] = y;
-					(*pVertices)[vertexId * 3 + 2] = z;
+// Function to parse the lines of an ASCII STL file and pass the elements to the callbacks of
+// "pVisitor"
+static void visitAsciiSTL(MioInput* pInput, const MioVisitor* pVisitor)
+{
+	size_t nVertices = 0; // number of vertex coordinates found in file
+	size_t nNormals = 0;
 
-					if(nread != 3)
-					{
-						fprintf(stderr, "error: have %zu components for v%d\n", nread, vertexId);
-						abort();
-					}
-				}
-			}
-			break;
-			case END_LOOP: {
-				// do nothing
-			}
-			break;
-			case END_FACET: {
-				// do nothing
-			}
-			break;
-			case END_SOLID: {
-				// do nothing
-			}
-			break;
-			default:
-				break;
-			} // switch (cmdType) {
+	// the current line (excluding the line terminator)
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
+
+	while(mioInputNextLine(pInput, &pLine, &pLineEnd))
+	{ // each iteration will parse a line in the file
+		const char* pCmd = mioSkipBlanks(pLine, pLineEnd);
+
+		if(pCmd == pLineEnd)
+		{
+			continue; // .. skip to next line
 		}
 
-		if(passIterator == 0) // first pass
+		const char* pArgs = pCmd;
+		const enum StlFileCmdType cmdType = parseCmdType(pLine, pCmd, pLineEnd, &pArgs);
+
+		if(cmdType != FACET_NORMAL && cmdType != VERTEX)
 		{
-			printf("\t%d vertices\n", nVertices);
+			continue; // ... to next line (nothing to visit)
+		}
 
-			assert(nNormals == nVertices / 3);
+		const size_t elementId = (cmdType == VERTEX) ? nVertices++ : nNormals++;
+		void (*onCoords)(const double*, void*) =
+			(cmdType == VERTEX) ? pVisitor->onVertex : pVisitor->onNormal;
 
-			printf("\t%d normals\n", nNormals);
+		if(onCoords != NULL)
+		{
+			double xyz[3] = {0.0, 0.0, 0.0};
+			const size_t nread = mioParseDoubles(pArgs, pLineEnd, xyz, 3);
 
-			if(nVertices > 0)
+			if(nread != 3)
 			{
-				// allocate user pointers
-				*pVertices = (double*)malloc(nVertices * sizeof(double) * 3);
-				memset(*pVertices, 0, nVertices * sizeof(unsigned int));
-				*pNormals = (double*)malloc(nNormals * sizeof(double) * 3);
-				memset(*pVertices, 0, nNormals * sizeof(unsigned int));
-				//*pVertexOffsets = (unsigned int*)malloc(solidCommandCounter * sizeof(unsigned int));
+				mioLogError("error: have %zu components for %s%zu\n",
+							nread,
+							(cmdType == VERTEX) ? "v" : "vn",
+							elementId);
+				mioFail(MIO_STATUS_MALFORMED);
 			}
 
-			*numVertices = nVertices;
+			onCoords(xyz, pVisitor->pUserData);
 		}
 
-		if(fsetpos(file, &startOfFile) != 0) /* reset current position to start of file */
+		if(cmdType == VERTEX && (nVertices % 3u) == 0)
 		{
-			if(ferror(file))
-			{
-				perror("fsetpos()");
-				fprintf(stderr,
-						"fsetpos() failed in file %s at lineBuf # %d\n",
-						__FILE__,
-						__LINE__ - 5);
-				exit(EXIT_FAILURE);
-			}
+			visitTriangle(pVisitor, nVertices / 3u - 1u); // the last corner of a triangle
 		}
-	} while(++passIterator < 2);
-
-	//
-	// finish, and free up memory
-	//
-	if(lineBuf != NULL)
-	{
-		free(lineBuf);
 	}
 
-	fclose(file);
-
-	printf("done.\n");
+	mioLogInfo("\t%zu vertices\n", nVertices);
+	mioLogInfo("\t%zu normals\n", nNormals);
 }
 
-void mioWriteSTL(
-	// absolute path to file
-	const char* const fpath,
-	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
-	const double* const pVertices,
-	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
-	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
-	const double* const pNormals,
-	// number of vertices (which can be used to deduce the number of triangles)
-	const unsigned int numVertices)
+// Function to read the triangle records of a binary STL file and pass the elements to the
+// callbacks of "pVisitor"
+static void visitBinarySTL(MioInput* pInput, const MioVisitor* pVisitor)
 {
-	fprintf(stdout, "write .obj file: %s\n", fpath);
+	const uint32_t numTriangles = readUint32LE((const unsigned char*)pInput->pCur + 80);
 
-	FILE* file = fopen(fpath, "w"); // open our file
+	pInput->pCur += BINARY_HEADER_SIZE;
 
-	if(file == NULL)
+	mioLogInfo("\t%zu vertices\n", (size_t)numTriangles * 3u);
+	mioLogInfo("\t%zu normals\n", (size_t)numTriangles);
+
+	for(size_t triangleId = 0; triangleId < numTriangles; ++triangleId)
 	{
-		fprintf(stderr, "error: failed to open file '%s'", fpath);
-		return; // exit(1);
-	}
+		if(!mioInputRequire(pInput, BINARY_TRIANGLE_SIZE))
+		{
+			mioLogError("error: file ends after %zu of %u triangles\n", triangleId, numTriangles);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
 
-	printf("vertices %u\n", numVertices);
+		const unsigned char* pRecord = (const unsigned char*)pInput->pCur;
+		double xyz[3];
 
-	fprintf(file, "solid Unnamed\n");
+		if(pVisitor->onNormal != NULL)
+		{
+			for(int k = 0; k < 3; ++k)
+			{
+				xyz[k] = (double)readFloat32LE(pRecord + k * 4);
+			}
 
-	// for each vertex
-	for(unsigned int j = 0u; j < (unsigned int)numVertices; ++j)
-	{
-		if((j % 3) == 0) // every three vertices correspond to a triangle/normal
+			pVisitor->onNormal(xyz, pVisitor->pUserData);
+		}
+
+		if(pVisitor->onVertex != NULL)
 		{
-			const unsigned int n = j / 3u; // normal index
-			fprintf(file,
-					"facet normal %f %f %f\n",
-					pNormals[n * 3u + 0u],
-					pNormals[n * 3u + 1u],
-					pNormals[n * 3u + 2u]);
+			for(int v = 0; v < 3; ++v)
+			{
+				for(int k = 0; k < 3; ++k)
+				{
+					xyz[k] = (double)readFloat32LE(pRecord + 12 + (v * 3 + k) * 4);
+				}
 
-			fprintf(file, "outer loop\n"); // mark start of triangle
+				pVisitor->onVertex(xyz, pVisitor->pUserData);
+			}
 		}
 
-		const double x = pVertices[j * 3u + 0u];
-		const double y = pVertices[j * 3u + 1u];
-		const double z = pVertices[j * 3u + 2u];
+		visitTriangle(pVisitor, triangleId);
+
+		pInput->pCur += BINARY_TRIANGLE_SIZE;
+	}
+}
+
+// Function to store the implicit face of triangle "triangleId" in the face arrays of "pBuffers",
+// whose corners are the vertices 3 * triangleId + [0, 1, 2] and whose normal is the normal of the
+// triangle. "numTriangles" is the number of triangles that the face arrays have room for.
+static void storeTriangle(const MioMeshBuffers* pBuffers, size_t triangleId, size_t numTriangles)
+{
+	if(triangleId >= numTriangles)
+	{
+		return; // ... the triangle is only counted
+	}
 
-		fprintf(file, "vertex  %f %f %f\n", x, y, z);
+	const unsigned int firstVertex = (unsigned int)(triangleId * 3u);
 
-		if(((j + 1) % 3) == 0) // last vertex of triangle
+	for(unsigned int k = 0; k < 3u; ++k)
+	{
+		if(pBuffers->faceVertexIndices.pData != NULL)
 		{
-			fprintf(file, "endloop\nendfacet\n"); // mark end of triangle
+			pBuffers->faceVertexIndices.pData[firstVertex + k] = firstVertex + k;
+		}
 
-			if(j == numVertices - 1)
-			{
-				fprintf(file, "endsolid\n"); // mark end of solid
-			}
+		if(pBuffers->faceVertexNormalIndices.pData != NULL)
+		{
+			pBuffers->faceVertexNormalIndices.pData[firstVertex + k] = (unsigned int)triangleId;
 		}
 	}
 
-	fclose(file);
+	if(pBuffers->faceSizes.pData != NULL)
+	{
+		pBuffers->faceSizes.pData[triangleId] = 3u;
+	}
+}
+
+// Function to get the number of triangles whose faces fit into the face arrays of "pBuffers"
+static size_t getStoredTriangleCount(const MioMeshBuffers* pBuffers)
+{
+	size_t count = SIZE_MAX;
+
+	if(pBuffers->faceSizes.pData != NULL && pBuffers->faceSizes.capacity < count)
+	{
+		count = pBuffers->faceSizes.capacity;
+	}
+
+	const MioIndexBuffer* pIndexBuffers[2] = {&pBuffers->faceVertexIndices,
+											  &pBuffers->faceVertexNormalIndices};
+
+	for(int i = 0; i < 2; ++i)
+	{
+		if(pIndexBuffers[i]->pData != NULL && pIndexBuffers[i]->capacity / 3u < count)
+		{
+			count = pIndexBuffers[i]->capacity / 3u;
+		}
+	}
+
+	return count;
+}
+
+// Function to parse the lines of an ASCII STL file into the arrays of "pBuffers" with coordinates
+// of "coordSize" bytes, where the elements that do not fit are only counted (see "readSTLInto")
+static void readAsciiSTLInto(MioInput* pInput,
+							 size_t coordSize,
+							 const MioMeshBuffers* pBuffers,
+							 MioMeshCounts* pCounts)
+{
+	const MioCoordBuffer* pVertices = &pBuffers->vertices;
+	const MioCoordBuffer* pNormals = &pBuffers->normals;
+	const size_t vertexStride = mioCoordBufferStride(pVertices, 3, coordSize);
+	const size_t normalStride = mioCoordBufferStride(pNormals, 3, coordSize);
+	const size_t numStoredVertices = (pVertices->pData != NULL) ? pVertices->capacity : 0;
+	const size_t numStoredNormals = (pNormals->pData != NULL) ? pNormals->capacity : 0;
+	const size_t numStoredTriangles = getStoredTriangleCount(pBuffers);
+
+	size_t nVertices = 0; // number of vertex coordinates found in file
+	size_t nNormals = 0;
+
+	// the current line (excluding the line terminator)
+	const char* pLine = NULL;
+	const char* pLineEnd = NULL;
+
+	while(mioInputNextLine(pInput, &pLine, &pLineEnd))
+	{ // each iteration will parse a line in the file
+		const char* pCmd = mioSkipBlanks(pLine, pLineEnd);
+
+		if(pCmd == pLineEnd)
+		{
+			continue; // .. skip to next line
+		}
+
+		const char* pArgs = pCmd;
+		const enum StlFileCmdType cmdType = parseCmdType(pLine, pCmd, pLineEnd, &pArgs);
+
+		if(cmdType != FACET_NORMAL && cmdType != VERTEX)
+		{
+			continue; // ... to next line (nothing to store)
+		}
+
+		const size_t elementId = (cmdType == VERTEX) ? nVertices++ : nNormals++;
+
+		// coordinates that do not fit are still parsed (into "scratch") to check them
+		double scratch[3];
+		void* pDst = scratch;
+
+		if(cmdType == VERTEX && elementId < numStoredVertices)
+		{
+			pDst = mioCoordBufferAt(pVertices, vertexStride, elementId);
+		}
+		else if(cmdType == FACET_NORMAL && elementId < numStoredNormals)
+		{
+			pDst = mioCoordBufferAt(pNormals, normalStride, elementId);
+		}
+
+		const size_t nread = (coordSize == sizeof(double))
+								 ? mioParseDoubles(pArgs, pLineEnd, (double*)pDst, 3)
+								 : mioParseFloats(pArgs, pLineEnd, (float*)pDst, 3);
+
+		if(nread != 3)
+		{
+			mioLogError("error: have %zu components for %s%zu\n",
+						nread,
+						(cmdType == VERTEX) ? "v" : "vn",
+						elementId);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+
+		if(cmdType == VERTEX && (nVertices % 3u) == 0)
+		{
+			storeTriangle(pBuffers, nVertices / 3u - 1u, numStoredTriangles);
+		}
+	}
+
+	mioLogInfo("\t%zu vertices\n", nVertices);
+	mioLogInfo("\t%zu normals\n", nNormals);
+
+	pCounts->numVertices = nVertices;
+	pCounts->numNormals = nNormals;
+	pCounts->numFaces = nVertices / 3u;
+	pCounts->numFaceVertices = pCounts->numFaces * 3u;
+}
+
+// Function to store the three float32s at "pRecord" as point "i" of "pBuffer", whose points are
+// "stride" bytes apart and have coordinates of "coordSize" bytes
+static void storeRecordXYZ(const MioCoordBuffer* pBuffer,
+						   size_t stride,
+						   size_t i,
+						   const unsigned char* pRecord,
+						   size_t coordSize)
+{
+	void* pDst = mioCoordBufferAt(pBuffer, stride, i);
+
+	for(int k = 0; k < 3; ++k)
+	{
+		const float value = readFloat32LE(pRecord + k * 4);
+
+		if(coordSize == sizeof(double))
+		{
+			((double*)pDst)[k] = (double)value;
+		}
+		else
+		{
+			((float*)pDst)[k] = value;
+		}
+	}
+}
+
+// Function to read the triangle records of a binary STL file into the arrays of "pBuffers" with
+// coordinates of "coordSize" bytes, where the elements that do not fit are only counted (see
+// "readSTLInto")
+static void readBinarySTLInto(MioInput* pInput,
+							  size_t coordSize,
+							  const MioMeshBuffers* pBuffers,
+							  MioMeshCounts* pCounts)
+{
+	const uint32_t numTriangles = readUint32LE((const unsigned char*)pInput->pCur + 80);
+
+	pInput->pCur += BINARY_HEADER_SIZE;
+
+	if(numTriangles > UINT_MAX / 3u)
+	{
+		mioLogError("error: too many triangles (%u)\n", numTriangles);
+		mioFail(MIO_STATUS_TOO_LARGE);
+	}
+
+	mioLogInfo("\t%zu vertices\n", (size_t)numTriangles * 3u);
+	mioLogInfo("\t%zu normals\n", (size_t)numTriangles);
+
+	checkTriangleCount(pInput, numTriangles);
+
+	const MioCoordBuffer* pVertices = &pBuffers->vertices;
+	const MioCoordBuffer* pNormals = &pBuffers->normals;
+	const size_t vertexStride = mioCoordBufferStride(pVertices, 3, coordSize);
+	const size_t normalStride = mioCoordBufferStride(pNormals, 3, coordSize);
+	const size_t numStoredVertices = (pVertices->pData != NULL) ? pVertices->capacity : 0;
+	const size_t numStoredNormals = (pNormals->pData != NULL) ? pNormals->capacity : 0;
+	const size_t numStoredTriangles = getStoredTriangleCount(pBuffers);
+
+	for(size_t triangleId = 0; triangleId < numTriangles; ++triangleId)
+	{
+		if(!mioInputRequire(pInput, BINARY_TRIANGLE_SIZE))
+		{
+			mioLogError("error: file ends after %zu of %u triangles\n", triangleId, numTriangles);
+			mioFail(MIO_STATUS_MALFORMED);
+		}
+
+		const unsigned char* pRecord = (const unsigned char*)pInput->pCur;
+
+		if(triangleId < numStoredNormals)
+		{
+			storeRecordXYZ(pNormals, normalStride, triangleId, pRecord, coordSize);
+		}
+
+		for(size_t v = 0; v < 3u; ++v)
+		{
+			const size_t vertexId = triangleId * 3u + v;
+
+			if(vertexId < numStoredVertices)
+			{
+				storeRecordXYZ(
+					pVertices, vertexStride, vertexId, pRecord + 12 + v * 12, coordSize);
+			}
+		}
+
+		storeTriangle(pBuffers, triangleId, numStoredTriangles);
+
+		pInput->pCur += BINARY_TRIANGLE_SIZE;
+	}
+
+	pCounts->numVertices = (size_t)numTriangles * 3u;
+	pCounts->numNormals = numTriangles;
+	pCounts->numFaces = numTriangles;
+	pCounts->numFaceVertices = (size_t)numTriangles * 3u;
+}
+
+// Function to read the contents of an .stl file from "pInput" into "pBuffers" (see
+// "mioReadSTLInto"). The elements are counted first (from the header of a binary file, or else by
+// a scan of the lines), and if they fit, each of them is written straight into its place in the
+// arrays.
+static bool readSTLInto(MioInput* pInput,
+						size_t coordSize,
+						const MioMeshBuffers* pBuffers,
+						MioMeshCounts* pCounts)
+{
+	const bool isBinary = isBinarySTL(pInput);
+
+	if(isBinary)
+	{
+		const size_t numTriangles = readUint32LE((const unsigned char*)pInput->pCur + 80);
+
+		pCounts->numVertices = numTriangles * 3u;
+		pCounts->numNormals = numTriangles;
+		pCounts->numFaces = numTriangles;
+		pCounts->numFaceVertices = numTriangles * 3u;
+	}
+	else
+	{
+		mioCountInput(pInput, mioProbeSTL, pCounts);
+	}
+
+	if(!mioCheckBuffers(pBuffers, pCounts, coordSize))
+	{
+		return false;
+	}
+
+	memset(pCounts, 0, sizeof(MioMeshCounts));
+
+	if(isBinary)
+	{
+		readBinarySTLInto(pInput, coordSize, pBuffers, pCounts);
+	}
+	else
+	{
+		readAsciiSTLInto(pInput, coordSize, pBuffers, pCounts);
+	}
+
+	return mioCheckBuffers(pBuffers, pCounts, coordSize);
+}
+
+// Function to read the .stl file at "fpath" into "pBuffers" (see "readSTLInto")
+static bool readSTLFileInto(const char* fpath,
+							unsigned int numThreads,
+							size_t coordSize,
+							const MioMeshBuffers* pBuffers,
+							MioMeshCounts* pCounts)
+{
+	(void)numThreads; // .stl files are read on the calling thread
+
+	mioLogInfo("read .stl file: %s\n", fpath);
+
+	memset(pCounts, 0, sizeof(MioMeshCounts));
+
+	if(!mioCheckBuffers(pBuffers, pCounts, coordSize))
+	{
+		return false;
+	}
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	const bool ok = readSTLInto(&input, coordSize, pBuffers, pCounts);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+
+	return ok;
+}
+
+// Function to read the .stl file at "fpath" (see "readSTL")
+static void readSTLFile(const char* fpath,
+						size_t coordSize,
+						void** ppVertices,
+						void** ppNormals,
+						unsigned int* numVertices)
+{
+	mioLogInfo("read .stl file: %s\n", fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	readSTL(&input, coordSize, ppVertices, ppNormals, numVertices);
+
+	//
+	// finish, and free up memory
+	//
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+}
+
+void mioReadSTL(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	double** pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	double** pNormals,
+	// number of vertices (which can be used to deduce the number of vertices)
+	unsigned int* numVertices)
+{
+	void* pVertexData = NULL;
+	void* pNormalData = NULL;
+
+	readSTLFile(fpath, sizeof(double), &pVertexData, &pNormalData, numVertices);
+
+	if(*numVertices > 0)
+	{
+		*pVertices = (double*)pVertexData;
+		*pNormals = (double*)pNormalData;
+	}
+}
+
+void mioReadSTLFromMemory(
+	// the contents of an .stl file (which do not need to be null-terminated)
+	const void* pData,
+	// number of bytes at "pData"
+	size_t dataSize,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	double** pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	double** pNormals,
+	// number of vertices
+	unsigned int* numVertices)
+{
+	mioLogInfo("read .stl file from memory: %zu bytes\n", dataSize);
+
+	MioInput input;
+
+	mioLoadBegin();
+	mioInputOpenRange(&input, (const char*)pData, (const char*)pData + dataSize);
+
+	void* pVertexData = NULL;
+	void* pNormalData = NULL;
+
+	readSTL(&input, sizeof(double), &pVertexData, &pNormalData, numVertices);
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+
+	if(*numVertices > 0)
+	{
+		*pVertices = (double*)pVertexData;
+		*pNormals = (double*)pNormalData;
+	}
+}
+
+void mioReadSTLf(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	float** pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	float** pNormals,
+	// number of vertices (which can be used to deduce the number of vertices)
+	unsigned int* numVertices)
+{
+	void* pVertexData = NULL;
+	void* pNormalData = NULL;
+
+	readSTLFile(fpath, sizeof(float), &pVertexData, &pNormalData, numVertices);
+
+	if(*numVertices > 0)
+	{
+		*pVertices = (float*)pVertexData;
+		*pNormals = (float*)pNormalData;
+	}
+}
+
+enum MioStatus
+mioReadSTLInto(const char* fpath, const MioMeshBuffers* pBuffers, MioMeshCounts* pCounts)
+{
+	return mioTryReadInto(readSTLFileInto, fpath, 1, sizeof(double), pBuffers, pCounts);
+}
+
+enum MioStatus
+mioReadSTLIntof(const char* fpath, const MioMeshBuffers* pBuffers, MioMeshCounts* pCounts)
+{
+	return mioTryReadInto(readSTLFileInto, fpath, 1, sizeof(float), pBuffers, pCounts);
+}
+
+// Function to write an ASCII .stl file with coordinates of "coordSize" bytes (i.e. sizeof(double)
+// or sizeof(float))
+static void writeSTL(const char* const fpath,
+					 const void* const pVertices,
+					 const void* const pNormals,
+					 const size_t coordSize,
+					 const unsigned int numVertices)
+{
+	mioLogInfo("write .obj file: %s\n", fpath);
+
+	MioWriter writer;
+
+	if(!mioWriterOpen(&writer, fpath, "w")) // open our file
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		return; // exit(1);
+	}
+
+	mioLogInfo("vertices %u\n", numVertices);
+
+	mioWriterPutString(&writer, "solid Unnamed\n");
+
+	// for each vertex
+	for(unsigned int j = 0u; j < (unsigned int)numVertices; ++j)
+	{
+		if((j % 3) == 0) // every three vertices correspond to a triangle/normal
+		{
+			const unsigned int n = j / 3u; // normal index
+			mioWriterPutString(&writer, "facet normal ");
+			mioWriterPutCoord(&writer, pNormals, n * 3u + 0u, coordSize);
+			mioWriterPutChar(&writer, ' ');
+			mioWriterPutCoord(&writer, pNormals, n * 3u + 1u, coordSize);
+			mioWriterPutChar(&writer, ' ');
+			mioWriterPutCoord(&writer, pNormals, n * 3u + 2u, coordSize);
+			mioWriterPutChar(&writer, '\n');
+
+			mioWriterPutString(&writer, "outer loop\n"); // mark start of triangle
+		}
+
+		mioWriterPutString(&writer, "vertex  ");
+		mioWriterPutCoord(&writer, pVertices, j * 3u + 0u, coordSize);
+		mioWriterPutChar(&writer, ' ');
+		mioWriterPutCoord(&writer, pVertices, j * 3u + 1u, coordSize);
+		mioWriterPutChar(&writer, ' ');
+		mioWriterPutCoord(&writer, pVertices, j * 3u + 2u, coordSize);
+		mioWriterPutChar(&writer, '\n');
+
+		if(((j + 1) % 3) == 0) // last vertex of triangle
+		{
+			mioWriterPutString(&writer, "endloop\nendfacet\n"); // mark end of triangle
+
+			if(j == numVertices - 1)
+			{
+				mioWriterPutString(&writer, "endsolid\n"); // mark end of solid
+			}
+		}
+	}
+
+	if(!mioWriterClose(&writer))
+	{
+		mioLogError("error: failed to write file '%s'\n", fpath);
+	}
+
+	mioLogInfo("done.\n");
+}
+
+// Function to get the element at "index" of "pCoords" (an array of doubles or floats) as a float
+static inline float getCoord(const void* pCoords, size_t index, size_t coordSize)
+{
+	return (coordSize == sizeof(double)) ? (float)((const double*)pCoords)[index]
+										 : ((const float*)pCoords)[index];
+}
+
+// Function to write a binary .stl file with coordinates of "coordSize" bytes (i.e. sizeof(double)
+// or sizeof(float))
+static void writeSTLBinary(const char* const fpath,
+						   const void* const pVertices,
+						   const void* const pNormals,
+						   const size_t coordSize,
+						   const unsigned int numVertices)
+{
+	mioLogInfo("write .stl file: %s\n", fpath);
+
+	MioWriter writer;
+
+	if(!mioWriterOpen(&writer, fpath, "wb")) // open our file
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		return; // exit(1);
+	}
+
+	const unsigned int numTriangles = numVertices / 3u;
+
+	mioLogInfo("triangles %u\n", numTriangles);
+
+	// NOTE: the comment must not start with "solid", which would make the file look like ASCII
+	unsigned char* pHeader = (unsigned char*)mioWriterReserve(&writer, BINARY_HEADER_SIZE);
+	memset(pHeader, 0, BINARY_HEADER_SIZE);
+
+	const char comment[] = "binary STL file written by mio";
+	memcpy(pHeader, comment, sizeof(comment) - 1);
+	writeUint32LE(pHeader + 80, numTriangles);
+
+	mioWriterCommit(&writer, BINARY_HEADER_SIZE);
+
+	for(unsigned int t = 0u; t < numTriangles; ++t)
+	{
+		unsigned char* pRecord = (unsigned char*)mioWriterReserve(&writer, BINARY_TRIANGLE_SIZE);
+
+		for(unsigned int k = 0u; k < 3u; ++k)
+		{
+			const float n = (pNormals != NULL) ? getCoord(pNormals, t * 3u + k, coordSize) : 0.0f;
+			writeFloat32LE(pRecord + k * 4u, n);
+		}
+
+		for(unsigned int k = 0u; k < 9u; ++k)
+		{
+			writeFloat32LE(pRecord + 12u + k * 4u, getCoord(pVertices, t * 9u + k, coordSize));
+		}
+
+		pRecord[48] = 0; // attribute byte count
+		pRecord[49] = 0;
+
+		mioWriterCommit(&writer, BINARY_TRIANGLE_SIZE);
+	}
+
+	if(!mioWriterClose(&writer))
+	{
+		mioLogError("error: failed to write file '%s'\n", fpath);
+	}
+
+	mioLogInfo("done.\n");
+}
+
+void mioWriteSTL(
+	// absolute path to file
+	const char* const fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	const double* const pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	const double* const pNormals,
+	// number of vertices (which can be used to deduce the number of triangles)
+	const unsigned int numVertices)
+{
+	writeSTL(fpath, pVertices, pNormals, sizeof(double), numVertices);
+}
+
+void mioWriteSTLf(
+	// absolute path to file
+	const char* const fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	const float* const pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	const float* const pNormals,
+	// number of vertices (which can be used to deduce the number of triangles)
+	const unsigned int numVertices)
+{
+	writeSTL(fpath, pVertices, pNormals, sizeof(float), numVertices);
+}
+
+void mioWriteSTLBinary(
+	// absolute path to file
+	const char* const fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	const double* const pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	const double* const pNormals,
+	// number of vertices (which can be used to deduce the number of triangles)
+	const unsigned int numVertices)
+{
+	writeSTLBinary(fpath, pVertices, pNormals, sizeof(double), numVertices);
+}
+
+void mioWriteSTLBinaryf(
+	// absolute path to file
+	const char* const fpath,
+	// pointer to list of vertex coordinates stored as [xyz,xyz,xyz,...]
+	const float* const pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	// NOTE: the number of normals is V * 3, where V is the number of vertices in "pVertices"
+	const float* const pNormals,
+	// number of vertices (which can be used to deduce the number of triangles)
+	const unsigned int numVertices)
+{
+	writeSTLBinary(fpath, pVertices, pNormals, sizeof(float), numVertices);
+}
+
+// Function to map a vertex coordinate to the key that is used to identify coincident vertices.
+// With "epsilon" > 0, the coordinate is snapped to a grid with cells of that size.
+static uint64_t weldKey(double x, double epsilon)
+{
+	uint64_t key = 0;
+
+	if(epsilon > 0.0)
+	{
+		double q = x / epsilon + 0.5;
+		q = (q < -9.0e18) ? -9.0e18 : ((q > 9.0e18) ? 9.0e18 : q); // keep the cast defined
+
+		int64_t cell = (int64_t)q; // rounds toward zero ...
+
+		if((double)cell > q)
+		{
+			cell--; // ... so round down instead (i.e. floor)
+		}
+
+		memcpy(&key, &cell, sizeof(key));
+	}
+	else
+	{
+		x = (x == 0.0) ? 0.0 : x; // -0.0 and +0.0 are the same position
+		memcpy(&key, &x, sizeof(key));
+	}
+
+	return key;
+}
+
+static uint64_t hashWeldKey(const uint64_t key[3])
+{
+	uint64_t h = key[0] * 0x9E3779B97F4A7C15ull;
+	h = (h ^ (h >> 29) ^ key[1]) * 0xBF58476D1CE4E5B9ull;
+	h = (h ^ (h >> 32) ^ key[2]) * 0x94D049BB133111EBull;
+	return h ^ (h >> 31);
+}
+
+void mioReadSTLWelded(
+	// absolute path to file
+	const char* fpath,
+	// pointer to list of (unique) vertex coordinates stored as [xyz,xyz,xyz,...]
+	double** pVertices,
+	// pointer to list of normal coordinates associated with each face stored as [xyz,xyz,xyz,...]
+	double** pNormals,
+	// pointer to list of face sizes (number of vertices in each face) stored as [a,b,c,d,e,f,g,...]
+	unsigned int** pFaceSizes,
+	// pointer to list of face-vertex indices stored as [ijk,ijk,ijk,...]
+	unsigned int** pFaceVertexIndices,
+	// number of vertices in "pVertices"
+	unsigned int* numVertices,
+	// number of faces
+	unsigned int* numFaces,
+	// vertices whose coordinates snap to the same grid cell of this size are welded (0 = exact)
+	double epsilon)
+{
+	double* pSoup = NULL;
+	unsigned int numSoupVertices = 0;
+
+	mioReadSTL(fpath, &pSoup, pNormals, &numSoupVertices);
+
+	*numVertices = 0;
+	*numFaces = 0;
+
+	if(numSoupVertices == 0)
+	{
+		return;
+	}
+
+	const size_t nSoupVertices = (size_t)numSoupVertices;
+
+	// open-addressing hash table of unique vertex ids (for a load factor of at most 1/2)
+	size_t tableSize = 16;
+
+	while(tableSize < nSoupVertices * 2)
+	{
+		tableSize *= 2;
+	}
+
+	const size_t tableMask = tableSize - 1;
+	uint32_t* pTable = (uint32_t*)mioAllocate(tableSize, sizeof(uint32_t));
+	memset(pTable, 0xFF, tableSize * sizeof(uint32_t)); // i.e. UINT32_MAX (empty)
+
+	unsigned int* pIndices = (unsigned int*)mioAllocate(nSoupVertices, sizeof(unsigned int));
+
+	// NOTE: the unique vertices are compacted into the front of "pSoup" in place, which is safe
+	// because the id of a unique vertex is never larger than its position in the soup.
+	size_t nUnique = 0;
+
+	for(size_t i = 0; i < nSoupVertices; ++i)
+	{
+		const double* pVertex = pSoup + i * 3u;
+		const uint64_t key[3] = {weldKey(pVertex[0], epsilon),
+								 weldKey(pVertex[1], epsilon),
+								 weldKey(pVertex[2], epsilon)};
+
+		size_t slot = (size_t)hashWeldKey(key) & tableMask;
+
+		for(;;)
+		{
+			const uint32_t id = pTable[slot];
+
+			if(id == UINT32_MAX)
+			{ // first occurrence of this position
+				pTable[slot] = (uint32_t)nUnique;
+				pIndices[i] = (unsigned int)nUnique;
+				memmove(pSoup + nUnique * 3u, pVertex, 3 * sizeof(double));
+				nUnique++;
+				break;
+			}
+
+			const double* pUnique = pSoup + (size_t)id * 3u;
+
+			if(weldKey(pUnique[0], epsilon) == key[0] && weldKey(pUnique[1], epsilon) == key[1] &&
+			   weldKey(pUnique[2], epsilon) == key[2])
+			{
+				pIndices[i] = id;
+				break;
+			}
+
+			slot = (slot + 1) & tableMask;
+		}
+	}
+
+	mioMemFree(pTable);
+
+	const size_t nFaces = nSoupVertices / 3u;
+	unsigned int* pSizes = (unsigned int*)mioAllocate(nFaces, sizeof(unsigned int));
+
+	for(size_t f = 0; f < nFaces; ++f)
+	{
+		pSizes[f] = 3u;
+	}
+
+	mioLogInfo("\t%zu unique vertices\n", nUnique);
+
+	// trim the soup to the unique vertices and hand over the data to the caller
+	double* pUniqueVertices = (double*)mioMemRealloc(pSoup, nUnique * 3u * sizeof(double));
+
+	*pVertices = (pUniqueVertices != NULL) ? pUniqueVertices : pSoup;
+	*pFaceSizes = pSizes;
+	*pFaceVertexIndices = pIndices;
+	*numVertices = (unsigned int)nUnique;
+	*numFaces = (unsigned int)nFaces;
+}
+
+// the arguments of a call of "mioVisitSTL"
+typedef struct StlVisitCall
+{
+	const char* fpath;
+	const MioVisitor* pVisitor;
+} StlVisitCall;
+
+// Function to visit the .stl file of the "StlVisitCall" at "pArg" (see "mioVisitSTL")
+static void visitSTLFile(void* pArg)
+{
+	const char* fpath = ((const StlVisitCall*)pArg)->fpath;
+	const MioVisitor* pVisitor = ((const StlVisitCall*)pArg)->pVisitor;
+
+	mioLogInfo("visit .stl file: %s\n", fpath);
+
+	MioInput input;
+
+	mioLoadBegin();
+
+	if(!mioInputOpenFile(&input, fpath))
+	{
+		mioLogError("error: failed to open file '%s'", fpath);
+		mioFail(MIO_STATUS_OPEN_FAILED);
+	}
+
+	if(isBinarySTL(&input))
+	{
+		visitBinarySTL(&input, pVisitor);
+	}
+	else
+	{
+		visitAsciiSTL(&input, pVisitor);
+	}
+
+	mioLoadEnd(&input);
+	mioInputClose(&input);
+
+	mioLogInfo("done.\n");
+}
+
+enum MioStatus mioVisitSTL(
+	// absolute path to file
+	const char* fpath,
+	// the callbacks that are called for the elements in the file
+	const MioVisitor* pVisitor)
+{
+	assert(pVisitor != NULL);
+
+	StlVisitCall call = {fpath, pVisitor};
+
+	return mioCallInFailScope(visitSTLFile, &call);
+}
+
+void mioProbeSTL(MioInput* pInput, MioMeshInfo* pInfo)
+{
+	uint64_t numTriangles = 0;
+
+	if(isBinarySTL(pInput))
+	{
+		numTriangles = readUint32LE((const unsigned char*)pInput->pCur + 80);
+	}
+	else
+	{
+		// the corners are counted (like "readAsciiSTL"), without parsing their coordinates
+		uint64_t numCorners = 0;
+		const char* pLine = NULL;
+		const char* pLineEnd = NULL;
+
+		while(mioInputNextLine(pInput, &pLine, &pLineEnd))
+		{
+			const char* pArgs = NULL;
+
+			if(mioStartsWith(mioSkipBlanks(pLine, pLineEnd), pLineEnd, "vertex", &pArgs))
+			{
+				numCorners++;
+			}
+		}
+
+		numTriangles = numCorners / 3;
+	}
 
-	printf("done.\n");
+	// one normal per triangle (see "mioReadMesh"), and the corners before they are welded
+	pInfo->numVertices = numTriangles * 3;
+	pInfo->numNormals = numTriangles;
+	pInfo->numFaces = numTriangles;
+	pInfo->numFaceVertices = numTriangles * 3;
 }
@@ -0,0 +1,392 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "mio/mio.h"
+
+#include "array.h"
+#include "log.h"
+#include "writer.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Writer of a mesh that is produced block by block (see "mioBeginMeshWrite"). Each block is
+// formatted into the buffer of the file as it arrives, so at most one block of the mesh is held
+// in memory, and the counts in the header of the file are filled in when it is closed.
+
+// width of the counts line of an .off file, which is written as blanks at first and is then
+// overwritten with the counts (e.g. "8 12 0") when the file is closed
+#define OFF_COUNTS_WIDTH (2 * MIO_MAX_UINT_CHARS + 3)
+
+// size of the header of a binary STL file: an 80-byte comment followed by the uint32 triangle count
+#define STL_HEADER_SIZE 84
+
+// size of a triangle record in a binary STL file: the normal and three vertices (as 12 float32s)
+// followed by the uint16 "attribute byte count"
+#define STL_TRIANGLE_SIZE 50
+
+struct MioMeshWriter
+{
+	enum MioFormat format;
+	// path of the file (for messages)
+	char* pPath;
+	// the file that is written
+	MioWriter writer;
+	// .off only: the faces, which are spilled to a temporary file because all vertices of an .off
+	// file come before its faces
+	MioWriter faceWriter;
+	// .off only: offset of the counts line in the file
+	long countsOffset;
+	// .stl only: the vertices of the last block, which the triangles are made of
+	MioArray blockVertices;
+	// number of vertices that were written, of which the last "numBlockVertices" are those of the
+	// last block
+	unsigned int numVertices;
+	unsigned int numBlockVertices;
+	// number of faces (triangles for .stl) that were written
+	unsigned int numFaces;
+	// true once a face has referred to a vertex outside of the last block
+	bool badIndex;
+};
+
+static void storeUint32LE(unsigned char* p, uint32_t value)
+{
+	p[0] = (unsigned char)(value);
+	p[1] = (unsigned char)(value >> 8);
+	p[2] = (unsigned char)(value >> 16);
+	p[3] = (unsigned char)(value >> 24);
+}
+
+static void storeFloat32LE(unsigned char* p, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(float));
+	storeUint32LE(p, bits);
+}
+
+// Function to overwrite the "count" bytes at "offset" of the file of "pWriter" with "pBytes" (once
+// everything else has been written). Returns false if the file cannot be written.
+static bool patchFile(MioWriter* pWriter, long offset, const void* pBytes, size_t count)
+{
+	mioWriterFlush(pWriter);
+
+	if(pWriter->failed || offset < 0 || fseek(pWriter->file, offset, SEEK_SET) != 0)
+	{
+		return false;
+	}
+
+	pWriter->failed = (fwrite(pBytes, 1, count, pWriter->file) != count);
+
+	return !pWriter->failed;
+}
+
+// Function to write the header of the file, where the counts are filled in by "mioEndMeshWrite"
+static void writeHeader(MioMeshWriter* pWriter)
+{
+	MioWriter* pOut = &pWriter->writer;
+
+	if(pWriter->format == MIO_FORMAT_OFF)
+	{
+		mioWriterPutString(pOut, "OFF\n");
+		mioWriterFlush(pOut);
+
+		pWriter->countsOffset = ftell(pOut->file);
+
+		char* p = mioWriterReserve(pOut, OFF_COUNTS_WIDTH + 1);
+		memset(p, ' ', OFF_COUNTS_WIDTH);
+		p[OFF_COUNTS_WIDTH] = '\n';
+		mioWriterCommit(pOut, OFF_COUNTS_WIDTH + 1);
+	}
+	else if(pWriter->format == MIO_FORMAT_STL)
+	{
+		// NOTE: the comment must not start with "solid", which would make the file look like ASCII
+		unsigned char* pHeader = (unsigned char*)mioWriterReserve(pOut, STL_HEADER_SIZE);
+		memset(pHeader, 0, STL_HEADER_SIZE);
+
+		const char comment[] = "binary STL file written by mio";
+		memcpy(pHeader, comment, sizeof(comment) - 1);
+
+		mioWriterCommit(pOut, STL_HEADER_SIZE);
+	}
+}
+
+MioMeshWriter* mioBeginMeshWrite(const char* fpath, enum MioFormat format)
+{
+	if(format != MIO_FORMAT_OBJ && format != MIO_FORMAT_OFF && format != MIO_FORMAT_STL)
+	{
+		mioLogError("error: only .obj, .off and .stl files can be written block by block\n");
+		return NULL;
+	}
+
+	mioLogInfo("write mesh file block by block: %s\n", fpath);
+
+	MioMeshWriter* pWriter = (MioMeshWriter*)mioAllocate(1, sizeof(MioMeshWriter));
+	memset(pWriter, 0, sizeof(MioMeshWriter));
+
+	pWriter->format = format;
+
+	if(!mioWriterOpen(&pWriter->writer, fpath, (format == MIO_FORMAT_STL) ? "wb" : "w"))
+	{
+		mioLogError("error: failed to open file '%s'\n", fpath);
+		mioMemFree(pWriter);
+		return NULL;
+	}
+
+	if(format == MIO_FORMAT_OFF && !mioWriterOpenTemporary(&pWriter->faceWriter))
+	{
+		mioLogError("error: failed to create a temporary file for the faces of '%s'\n", fpath);
+		mioWriterClose(&pWriter->writer);
+		remove(fpath);
+		mioMemFree(pWriter);
+		return NULL;
+	}
+
+	const size_t pathSize = strlen(fpath) + 1;
+	pWriter->pPath = (char*)mioAllocate(pathSize, sizeof(char));
+	memcpy(pWriter->pPath, fpath, pathSize);
+
+	writeHeader(pWriter);
+
+	return pWriter;
+}
+
+void mioWriteMeshVertices(MioMeshWriter* pWriter, const double* pVertices, unsigned int numVertices)
+{
+	MioWriter* pOut = &pWriter->writer;
+
+	if(pWriter->format == MIO_FORMAT_STL)
+	{
+		// the triangles are written with their corners, so the block is kept until the next one
+		mioArrayReserve(&pWriter->blockVertices, sizeof(double), (size_t)numVertices * 3);
+
+		if(numVertices > 0)
+		{
+			const size_t blockSize = (size_t)numVertices * 3 * sizeof(double);
+			memcpy(pWriter->blockVertices.pData, pVertices, blockSize);
+		}
+	}
+	else
+	{
+		for(size_t i = 0; i < numVertices; ++i)
+		{
+			if(pWriter->format == MIO_FORMAT_OBJ)
+			{
+				mioWriterPutString(pOut, "v ");
+			}
+
+			mioWriterPutDouble(pOut, pVertices[i * 3 + 0]);
+			mioWriterPutChar(pOut, ' ');
+			mioWriterPutDouble(pOut, pVertices[i * 3 + 1]);
+			mioWriterPutChar(pOut, ' ');
+			mioWriterPutDouble(pOut, pVertices[i * 3 + 2]);
+			mioWriterPutChar(pOut, '\n');
+		}
+	}
+
+	pWriter->numVertices += numVertices;
+	pWriter->numBlockVertices = numVertices;
+}
+
+// Function to check that the "count" indices at "pIndices" refer to vertices of the last block
+static bool checkIndices(MioMeshWriter* pWriter, const unsigned int* pIndices, unsigned int count)
+{
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		if(pIndices[i] >= pWriter->numBlockVertices)
+		{
+			if(!pWriter->badIndex)
+			{
+				mioLogError("error: face index %u is outside of the block of %u vertices ('%s')\n",
+							pIndices[i],
+							pWriter->numBlockVertices,
+							pWriter->pPath);
+			}
+
+			pWriter->badIndex = true;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Function to write the triangle of the corners "a", "b" and "c" of the last block to a binary
+// STL file, with a zero normal (like "mioWriteSTLBinary" without normals)
+static void writeTriangle(MioMeshWriter* pWriter, unsigned int a, unsigned int b, unsigned int c)
+{
+	const double* pCoords = (const double*)pWriter->blockVertices.pData;
+	const double* pCorners[3] = {
+		pCoords + (size_t)a * 3, pCoords + (size_t)b * 3, pCoords + (size_t)c * 3};
+
+	unsigned char* pRecord = (unsigned char*)mioWriterReserve(&pWriter->writer, STL_TRIANGLE_SIZE);
+
+	memset(pRecord, 0, 12); // the normal
+
+	for(int j = 0; j < 3; ++j)
+	{
+		for(int k = 0; k < 3; ++k)
+		{
+			storeFloat32LE(pRecord + 12 + (j * 3 + k) * 4, (float)pCorners[j][k]);
+		}
+	}
+
+	pRecord[48] = 0; // attribute byte count
+	pRecord[49] = 0;
+
+	mioWriterCommit(&pWriter->writer, STL_TRIANGLE_SIZE);
+
+	pWriter->numFaces++;
+}
+
+void mioWriteMeshFaces(MioMeshWriter* pWriter,
+					   const unsigned int* pFaceSizes,
+					   const unsigned int* pFaceVertexIndices,
+					   unsigned int numFaces)
+{
+	// the indices of a block are rebased onto the first vertex of the last block
+	const unsigned int base = pWriter->numVertices - pWriter->numBlockVertices;
+	size_t faceVertex = 0;
+
+	for(unsigned int f = 0; f < numFaces; ++f)
+	{
+		const unsigned int faceSize = (pFaceSizes != NULL) ? pFaceSizes[f] : 3;
+		const unsigned int* pIndices = pFaceVertexIndices + faceVertex;
+
+		faceVertex += faceSize;
+
+		if(!checkIndices(pWriter, pIndices, faceSize))
+		{
+			continue; // (the face is dropped)
+		}
+
+		if(pWriter->format == MIO_FORMAT_OBJ)
+		{
+			mioWriterPutChar(&pWriter->writer, 'f');
+
+			for(unsigned int j = 0; j < faceSize; ++j)
+			{
+				// Note: obj file indices start from 1
+				mioWriterPutChar(&pWriter->writer, ' ');
+				mioWriterPutUint(&pWriter->writer, base + pIndices[j] + 1);
+			}
+
+			mioWriterPutChar(&pWriter->writer, '\n');
+			pWriter->numFaces++;
+		}
+		else if(pWriter->format == MIO_FORMAT_OFF)
+		{
+			mioWriterPutUint(&pWriter->faceWriter, faceSize);
+
+			for(unsigned int j = 0; j < faceSize; ++j)
+			{
+				mioWriterPutChar(&pWriter->faceWriter, ' ');
+				mioWriterPutUint(&pWriter->faceWriter, base + pIndices[j]);
+			}
+
+			mioWriterPutChar(&pWriter->faceWriter, '\n');
+			pWriter->numFaces++;
+		}
+		else
+		{
+			// the face is split into a fan of triangles
+			for(unsigned int j = 2; j < faceSize; ++j)
+			{
+				writeTriangle(pWriter, pIndices[0], pIndices[j - 1], pIndices[j]);
+			}
+		}
+	}
+}
+
+// Function to append the faces of an .off file (from the temporary file) to its vertices, and to
+// fill in the counts line. Returns false if the file cannot be written.
+static bool endOFF(MioMeshWriter* pWriter)
+{
+	MioWriter* pFaces = &pWriter->faceWriter;
+
+	mioWriterFlush(pFaces);
+
+	bool ok = !pFaces->failed && (fseek(pFaces->file, 0, SEEK_SET) == 0);
+
+	while(ok)
+	{
+		// NOTE: the (empty) buffer of the temporary file is reused for reading it back
+		const size_t count = fread(pFaces->pBuffer, 1, pFaces->capacity, pFaces->file);
+
+		if(count == 0)
+		{
+			ok = !ferror(pFaces->file);
+			break;
+		}
+
+		mioWriterPutBytes(&pWriter->writer, pFaces->pBuffer, count);
+	}
+
+	mioWriterClose(pFaces);
+
+	char counts[OFF_COUNTS_WIDTH];
+	memset(counts, ' ', OFF_COUNTS_WIDTH);
+
+	size_t length = mioFormatUint(counts, pWriter->numVertices);
+	counts[length++] = ' ';
+	length += mioFormatUint(counts + length, pWriter->numFaces);
+	counts[length++] = ' ';
+	counts[length++] = '0'; // number of edges
+
+	return ok && patchFile(&pWriter->writer, pWriter->countsOffset, counts, OFF_COUNTS_WIDTH);
+}
+
+int mioEndMeshWrite(MioMeshWriter* pWriter)
+{
+	bool ok = true;
+
+	mioLogInfo("vertices %u\n", pWriter->numVertices);
+	mioLogInfo("faces %u\n", pWriter->numFaces);
+
+	if(pWriter->format == MIO_FORMAT_OFF)
+	{
+		ok = endOFF(pWriter);
+	}
+	else if(pWriter->format == MIO_FORMAT_STL)
+	{
+		unsigned char count[4];
+		storeUint32LE(count, pWriter->numFaces);
+
+		ok = patchFile(&pWriter->writer, STL_HEADER_SIZE - 4, count, sizeof(count));
+	}
+
+	ok = mioWriterClose(&pWriter->writer) && ok;
+
+	if(!ok)
+	{
+		mioLogError("error: failed to write file '%s'\n", pWriter->pPath);
+	}
+
+	ok = ok && !pWriter->badIndex;
+
+	mioMemFree(pWriter->blockVertices.pData);
+	mioMemFree(pWriter->pPath);
+	mioMemFree(pWriter);
+
+	mioLogInfo("done.\n");
+
+	return ok ? 1 : 0;
+}
@@ -0,0 +1,187 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "thread.h"
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+static DWORD WINAPI threadEntry(LPVOID pParam)
+{
+	MioThread* pThread = (MioThread*)pParam;
+	pThread->pfnFunc(pThread->pArg);
+	return 0;
+}
+
+bool mioThreadCreate(MioThread* pThread, MioThreadFunc pfnFunc, void* pArg)
+{
+	pThread->pfnFunc = pfnFunc;
+	pThread->pArg = pArg;
+	pThread->handle = (void*)CreateThread(NULL, 0, threadEntry, pThread, 0, NULL);
+
+	return pThread->handle != NULL;
+}
+
+void mioThreadJoin(MioThread* pThread)
+{
+	WaitForSingleObject((HANDLE)pThread->handle, INFINITE);
+	CloseHandle((HANDLE)pThread->handle);
+	pThread->handle = NULL;
+}
+
+unsigned int mioGetHardwareThreadCount(void)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+
+	return (info.dwNumberOfProcessors > 0) ? (unsigned int)info.dwNumberOfProcessors : 1u;
+}
+
+void mioMutexInit(MioMutex* pMutex)
+{
+	InitializeSRWLock((PSRWLOCK)&pMutex->lock);
+}
+
+void mioMutexDestroy(MioMutex* pMutex)
+{
+	(void)pMutex; // nothing to release
+}
+
+void mioMutexLock(MioMutex* pMutex)
+{
+	AcquireSRWLockExclusive((PSRWLOCK)&pMutex->lock);
+}
+
+void mioMutexUnlock(MioMutex* pMutex)
+{
+	ReleaseSRWLockExclusive((PSRWLOCK)&pMutex->lock);
+}
+
+void mioConditionInit(MioCondition* pCondition)
+{
+	InitializeConditionVariable((PCONDITION_VARIABLE)&pCondition->condition);
+}
+
+void mioConditionDestroy(MioCondition* pCondition)
+{
+	(void)pCondition; // nothing to release
+}
+
+void mioConditionWait(MioCondition* pCondition, MioMutex* pMutex)
+{
+	SleepConditionVariableSRW(
+		(PCONDITION_VARIABLE)&pCondition->condition, (PSRWLOCK)&pMutex->lock, INFINITE, 0);
+}
+
+void mioConditionBroadcast(MioCondition* pCondition)
+{
+	WakeAllConditionVariable((PCONDITION_VARIABLE)&pCondition->condition);
+}
+
+size_t mioAtomicFetchAdd(volatile size_t* pCounter, size_t value)
+{
+#	if defined(_WIN64)
+	return (size_t)InterlockedExchangeAdd64((volatile LONG64*)pCounter, (LONG64)value);
+#	else
+	return (size_t)InterlockedExchangeAdd((volatile LONG*)pCounter, (LONG)value);
+#	endif
+}
+
+#else // #if defined(_WIN32)
+
+static void* threadEntry(void* pParam)
+{
+	MioThread* pThread = (MioThread*)pParam;
+	pThread->pfnFunc(pThread->pArg);
+	return NULL;
+}
+
+bool mioThreadCreate(MioThread* pThread, MioThreadFunc pfnFunc, void* pArg)
+{
+	pThread->pfnFunc = pfnFunc;
+	pThread->pArg = pArg;
+
+	return pthread_create(&pThread->handle, NULL, threadEntry, pThread) == 0;
+}
+
+void mioThreadJoin(MioThread* pThread)
+{
+	pthread_join(pThread->handle, NULL);
+}
+
+unsigned int mioGetHardwareThreadCount(void)
+{
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (count > 0) ? (unsigned int)count : 1u;
+}
+
+void mioMutexInit(MioMutex* pMutex)
+{
+	pthread_mutex_init(&pMutex->lock, NULL);
+}
+
+void mioMutexDestroy(MioMutex* pMutex)
+{
+	pthread_mutex_destroy(&pMutex->lock);
+}
+
+void mioMutexLock(MioMutex* pMutex)
+{
+	pthread_mutex_lock(&pMutex->lock);
+}
+
+void mioMutexUnlock(MioMutex* pMutex)
+{
+	pthread_mutex_unlock(&pMutex->lock);
+}
+
+void mioConditionInit(MioCondition* pCondition)
+{
+	pthread_cond_init(&pCondition->condition, NULL);
+}
+
+void mioConditionDestroy(MioCondition* pCondition)
+{
+	pthread_cond_destroy(&pCondition->condition);
+}
+
+void mioConditionWait(MioCondition* pCondition, MioMutex* pMutex)
+{
+	pthread_cond_wait(&pCondition->condition, &pMutex->lock);
+}
+
+void mioConditionBroadcast(MioCondition* pCondition)
+{
+	pthread_cond_broadcast(&pCondition->condition);
+}
+
+size_t mioAtomicFetchAdd(volatile size_t* pCounter, size_t value)
+{
+	return __atomic_fetch_add(pCounter, value, __ATOMIC_SEQ_CST);
+}
+
+#endif // #if defined(_WIN32)
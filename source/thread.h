@@ -0,0 +1,102 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_THREAD_H__
+#define __MIO_THREAD_H__ 1
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if !defined(_WIN32)
+#	include <pthread.h>
+#endif
+
+// Internal (minimal) threading layer, used by the readers/writers that process data in parallel.
+
+// storage class of a variable that each thread has its own copy of
+#if defined(_MSC_VER)
+#	define MIO_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#	define MIO_THREAD_LOCAL _Thread_local
+#else
+#	define MIO_THREAD_LOCAL __thread
+#endif
+
+typedef void (*MioThreadFunc)(void* pArg);
+
+typedef struct MioThread
+{
+#if defined(_WIN32)
+	void* handle; // HANDLE
+#else
+	pthread_t handle;
+#endif
+	MioThreadFunc pfnFunc;
+	void* pArg;
+} MioThread;
+
+// Function to start a thread that runs "pfnFunc(pArg)".
+// NOTE: "pThread" must remain valid until the thread is joined.
+bool mioThreadCreate(MioThread* pThread, MioThreadFunc pfnFunc, void* pArg);
+
+// Function to wait for a thread that was started with "mioThreadCreate" to finish
+void mioThreadJoin(MioThread* pThread);
+
+// Function to get the number of hardware threads of the system (at least 1)
+unsigned int mioGetHardwareThreadCount(void);
+
+typedef struct MioMutex
+{
+#if defined(_WIN32)
+	void* lock; // SRWLOCK
+#else
+	pthread_mutex_t lock;
+#endif
+} MioMutex;
+
+typedef struct MioCondition
+{
+#if defined(_WIN32)
+	void* condition; // CONDITION_VARIABLE
+#else
+	pthread_cond_t condition;
+#endif
+} MioCondition;
+
+void mioMutexInit(MioMutex* pMutex);
+void mioMutexDestroy(MioMutex* pMutex);
+void mioMutexLock(MioMutex* pMutex);
+void mioMutexUnlock(MioMutex* pMutex);
+
+void mioConditionInit(MioCondition* pCondition);
+void mioConditionDestroy(MioCondition* pCondition);
+
+// Function to unlock "pMutex" (which must be locked), wait until "pCondition" is signalled and
+// then lock "pMutex" again. NOTE: the wait can end spuriously, so the condition must be rechecked.
+void mioConditionWait(MioCondition* pCondition, MioMutex* pMutex);
+
+// Function to wake up all threads that wait for "pCondition"
+void mioConditionBroadcast(MioCondition* pCondition);
+
+// Function to add "value" to "*pCounter" atomically (e.g. to hand out work items to threads).
+// Returns the value of "*pCounter" before the addition.
+size_t mioAtomicFetchAdd(volatile size_t* pCounter, size_t value);
+
+#endif // #ifndef __MIO_THREAD_H__
@@ -0,0 +1,366 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#include "triangulate.h"
+
+#include "array.h"
+#include "fail.h"
+#include "log.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+
+// scratch memory of "triangulateFace", which is reused from face to face
+typedef struct FaceScratch
+{
+	// the corners of the face projected onto its plane, stored as [uv,uv,uv,...]
+	MioArray points;
+	// the corners that have not been clipped yet
+	MioArray corners;
+} FaceScratch;
+
+static double absolute(double x)
+{
+	return (x < 0.0) ? -x : x;
+}
+
+// Function to get twice the signed area of the 2D triangle "a", "b", "c" (positive if the
+// triangle is counter-clockwise)
+static double cross2(const double* a, const double* b, const double* c)
+{
+	return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+// Function to project the "n" corners of a face with the vertex indices "pIndices" onto the plane
+// of the face, such that the face is counter-clockwise in the plane (see "FaceScratch")
+static void projectFace(const double* pVertices,
+						const unsigned int* pIndices,
+						unsigned int n,
+						FaceScratch* pScratch)
+{
+	// the (Newell) normal of the face, which is robust for non-planar faces
+	double normal[3] = {0.0, 0.0, 0.0};
+
+	for(unsigned int i = 0; i < n; ++i)
+	{
+		const double* p = pVertices + (size_t)pIndices[i] * 3;
+		const double* q = pVertices + (size_t)pIndices[(i + 1) % n] * 3;
+
+		normal[0] += (p[1] - q[1]) * (p[2] + q[2]);
+		normal[1] += (p[2] - q[2]) * (p[0] + q[0]);
+		normal[2] += (p[0] - q[0]) * (p[1] + q[1]);
+	}
+
+	// drop the axis along which the normal is largest, and keep the other two in cyclic order
+	// (mirrored if the normal points down that axis)
+	int axis = 0;
+
+	for(int k = 1; k < 3; ++k)
+	{
+		if(absolute(normal[k]) > absolute(normal[axis]))
+		{
+			axis = k;
+		}
+	}
+
+	int u = (axis + 1) % 3;
+	int v = (axis + 2) % 3;
+
+	if(normal[axis] < 0.0)
+	{
+		const int tmp = u;
+		u = v;
+		v = tmp;
+	}
+
+	mioArrayReserve(&pScratch->points, 2 * sizeof(double), n);
+
+	double* pPoints = (double*)pScratch->points.pData;
+
+	for(unsigned int i = 0; i < n; ++i)
+	{
+		const double* p = pVertices + (size_t)pIndices[i] * 3;
+
+		pPoints[i * 2 + 0] = p[u];
+		pPoints[i * 2 + 1] = p[v];
+	}
+}
+
+// Function to check whether the corner "cur" (with the neighbours "prev" and "next") of a face
+// that is being ear-clipped can be clipped i.e. whether it is convex and none of the other
+// "numCorners" remaining corners "pCorners" are inside of the triangle that it forms
+static bool isEar(const double* pPoints,
+				  const unsigned int* pCorners,
+				  unsigned int numCorners,
+				  unsigned int prev,
+				  unsigned int cur,
+				  unsigned int next)
+{
+	const double* a = pPoints + prev * 2;
+	const double* b = pPoints + cur * 2;
+	const double* c = pPoints + next * 2;
+
+	if(cross2(a, b, c) <= 0.0)
+	{
+		return false; // reflex (or degenerate) corner
+	}
+
+	for(unsigned int j = 0; j < numCorners; ++j)
+	{
+		const unsigned int corner = pCorners[j];
+
+		if(corner == prev || corner == cur || corner == next)
+		{
+			continue;
+		}
+
+		const double* p = pPoints + corner * 2;
+
+		if(cross2(a, b, p) >= 0.0 && cross2(b, c, p) >= 0.0 && cross2(c, a, p) >= 0.0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Function to split the face with the "n" vertex indices "pIndices" into n - 2 triangles, whose
+// corners (in [0, n), as positions in the face) are stored in "pTriangles" as [abc,abc,...]
+static void triangulateFace(const double* pVertices,
+							unsigned int numVertices,
+							const unsigned int* pIndices,
+							unsigned int n,
+							FaceScratch* pScratch,
+							unsigned int* pTriangles)
+{
+	// the corners that remain after clipping, which are finished as a fan
+	mioArrayReserve(&pScratch->corners, sizeof(unsigned int), n);
+
+	unsigned int* pCorners = (unsigned int*)pScratch->corners.pData;
+	unsigned int numCorners = n;
+	unsigned int numTriangles = 0;
+
+	for(unsigned int i = 0; i < n; ++i)
+	{
+		pCorners[i] = i;
+	}
+
+	// NOTE: a face that refers to a vertex that the file does not have cannot be projected, so
+	// it is split into a fan
+	bool isConvex = true;
+	bool canProject = (n > 3);
+
+	for(unsigned int i = 0; i < n && canProject; ++i)
+	{
+		canProject = (pIndices[i] < numVertices);
+	}
+
+	if(canProject)
+	{
+		projectFace(pVertices, pIndices, n, pScratch);
+
+		const double* pPoints = (const double*)pScratch->points.pData;
+
+		for(unsigned int i = 0; i < n && isConvex; ++i)
+		{
+			isConvex = cross2(pPoints + i * 2,
+							  pPoints + ((i + 1) % n) * 2,
+							  pPoints + ((i + 2) % n) * 2) >= 0.0;
+		}
+	}
+
+	if(!isConvex)
+	{ // ear clipping, which stops (and fans the remaining corners) if no ear is found e.g. for a
+	  // self-intersecting face
+		const double* pPoints = (const double*)pScratch->points.pData;
+		unsigned int i = 0;
+		unsigned int numMisses = 0;
+
+		while(numCorners > 3 && numMisses < numCorners)
+		{
+			const unsigned int prev = pCorners[(i + numCorners - 1) % numCorners];
+			const unsigned int cur = pCorners[i];
+			const unsigned int next = pCorners[(i + 1) % numCorners];
+
+			if(isEar(pPoints, pCorners, numCorners, prev, cur, next))
+			{
+				pTriangles[numTriangles * 3 + 0] = prev;
+				pTriangles[numTriangles * 3 + 1] = cur;
+				pTriangles[numTriangles * 3 + 2] = next;
+				numTriangles++;
+
+				memmove(
+					pCorners + i, pCorners + i + 1, (numCorners - i - 1) * sizeof(unsigned int));
+				numCorners--;
+				numMisses = 0;
+				i = (i < numCorners) ? i : 0;
+			}
+			else
+			{
+				i = (i + 1) % numCorners;
+				numMisses++;
+			}
+		}
+	}
+
+	for(unsigned int k = 1; k + 1 < numCorners; ++k)
+	{
+		pTriangles[numTriangles * 3 + 0] = pCorners[0];
+		pTriangles[numTriangles * 3 + 1] = pCorners[k];
+		pTriangles[numTriangles * 3 + 2] = pCorners[k + 1];
+		numTriangles++;
+	}
+}
+
+void mioTriangulateMesh(MioMesh* pMesh)
+{
+	size_t numTriangles = 0;
+	unsigned int maxFaceSize = 0;
+
+	for(unsigned int i = 0; i < pMesh->numFaces; ++i)
+	{
+		const unsigned int n = pMesh->pFaceSizes[i];
+
+		numTriangles += (n >= 3) ? n - 2 : 0; // NOTE: faces with fewer corners are dropped
+		maxFaceSize = (n > maxFaceSize) ? n : maxFaceSize;
+	}
+
+	if(numTriangles * 3 > UINT_MAX)
+	{
+		mioLogError("error: too many triangles (%zu)\n", numTriangles);
+		mioFail(MIO_STATUS_TOO_LARGE);
+	}
+
+	// the triangle arrays: face sizes, source faces and the three face index arrays
+	const unsigned int* pSrcIndices[3] = {pMesh->pFaceVertexIndices,
+										  pMesh->pFaceVertexTexCoordIndices,
+										  pMesh->pFaceVertexNormalIndices};
+	unsigned int* pDstIndices[3] = {NULL, NULL, NULL};
+	unsigned int* pFaceSizes = NULL;
+	unsigned int* pSourceFaces = NULL;
+	const bool isMapped = (pMesh->pMapping != NULL);
+
+	if(isMapped)
+	{ // one block for all of the arrays, which is freed with the mesh
+		size_t blockSize = numTriangles * 2;
+
+		for(int k = 0; k < 3; ++k)
+		{
+			blockSize += (pSrcIndices[k] != NULL) ? numTriangles * 3 : 0;
+		}
+
+		unsigned int* pBlock = (unsigned int*)mioAllocate(blockSize, sizeof(unsigned int));
+
+		pMesh->pArena = pBlock;
+		pFaceSizes = pBlock;
+		pSourceFaces = pBlock + numTriangles;
+		pBlock += numTriangles * 2;
+
+		for(int k = 0; k < 3; ++k)
+		{
+			if(pSrcIndices[k] != NULL)
+			{
+				pDstIndices[k] = pBlock;
+				pBlock += numTriangles * 3;
+			}
+		}
+	}
+	else
+	{
+		pFaceSizes = (unsigned int*)mioAllocate(numTriangles, sizeof(unsigned int));
+		pSourceFaces = (unsigned int*)mioAllocate(numTriangles, sizeof(unsigned int));
+
+		for(int k = 0; k < 3; ++k)
+		{
+			if(pSrcIndices[k] != NULL)
+			{
+				pDstIndices[k] =
+					(unsigned int*)mioAllocate(numTriangles * 3, sizeof(unsigned int));
+			}
+		}
+	}
+
+	FaceScratch scratch = {{NULL, 0, 0}, {NULL, 0, 0}};
+	// the corners of the triangles of the current face
+	const size_t maxTriangles = (maxFaceSize > 3) ? maxFaceSize - 2 : 1;
+	unsigned int* pCorners = (unsigned int*)mioAllocate(maxTriangles * 3, sizeof(unsigned int));
+	size_t base = 0; // first face-vertex of the current face
+	size_t triangleId = 0;
+
+	for(unsigned int i = 0; i < pMesh->numFaces; ++i)
+	{
+		const unsigned int n = pMesh->pFaceSizes[i];
+
+		if(n >= 3)
+		{
+			triangulateFace(pMesh->pVertices,
+							pMesh->numVertices,
+							pMesh->pFaceVertexIndices + base,
+							n,
+							&scratch,
+							pCorners);
+
+			for(unsigned int t = 0; t < n - 2; ++t, ++triangleId)
+			{
+				pFaceSizes[triangleId] = 3;
+				pSourceFaces[triangleId] = i;
+
+				for(int k = 0; k < 3; ++k)
+				{
+					if(pSrcIndices[k] == NULL)
+					{
+						continue;
+					}
+
+					const unsigned int* pSrc = pSrcIndices[k] + base;
+
+					for(int c = 0; c < 3; ++c)
+					{
+						pDstIndices[k][triangleId * 3 + c] = pSrc[pCorners[t * 3 + c]];
+					}
+				}
+			}
+		}
+
+		base += n;
+	}
+
+	mioMemFree(pCorners);
+	mioMemFree(scratch.points.pData);
+	mioMemFree(scratch.corners.pData);
+
+	if(!isMapped)
+	{
+		mioMemFree(pMesh->pFaceSizes);
+		mioMemFree(pMesh->pFaceVertexIndices);
+		mioMemFree(pMesh->pFaceVertexTexCoordIndices);
+		mioMemFree(pMesh->pFaceVertexNormalIndices);
+	}
+
+	pMesh->pFaceSizes = pFaceSizes;
+	pMesh->pFaceVertexIndices = pDstIndices[0];
+	pMesh->pFaceVertexTexCoordIndices = pDstIndices[1];
+	pMesh->pFaceVertexNormalIndices = pDstIndices[2];
+	pMesh->pSourceFaces = pSourceFaces;
+	pMesh->numFaces = (unsigned int)numTriangles;
+}
@@ -0,0 +1,33 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+
+#ifndef __MIO_TRIANGULATE_H__
+#define __MIO_TRIANGULATE_H__ 1
+
+#include "mio/mio.h"
+
+// Function to replace the faces of "pMesh" with triangles (see "MIO_MESH_TRIANGULATE"). Convex
+// faces are split into a fan, and the other faces are ear-clipped. The face arrays of a mesh
+// whose arrays are part of a mapping are left in the mapping, and the triangles are put into a
+// single block that becomes "pMesh->pArena".
+void mioTriangulateMesh(MioMesh* pMesh);
+
+#endif // #ifndef __MIO_TRIANGULATE_H__
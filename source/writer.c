@@ -0,0 +1,907 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#include "writer.h"
+
+#include "mio/mio.h"
+
+#include "array.h"
+#include "fail.h"
+#include "pow5.h"
+#include "thread.h"
+
+#include <stdlib.h>
+
+// size of the buffer that the output is formatted into
+#define MIO_WRITER_BUFFER_SIZE (1u << 20)
+
+// number of rows in each chunk of "mioWriterPutRows" (but the last)
+#define MIO_ROWS_PER_CHUNK (1u << 16)
+
+// the format of floating point numbers in text files (see "mioSetFloatFormat")
+static enum MioFloatFormat floatFormat = MIO_FLOAT_FORMAT_SHORTEST;
+
+void mioSetFloatFormat(enum MioFloatFormat format)
+{
+	floatFormat = format;
+}
+
+bool mioWriterOpen(MioWriter* pWriter, const char* fpath, const char* mode)
+{
+	memset(pWriter, 0, sizeof(MioWriter));
+
+	pWriter->file = fopen(fpath, mode);
+
+	if(pWriter->file == NULL)
+	{
+		return false;
+	}
+
+	pWriter->pBuffer = (char*)mioAllocate(MIO_WRITER_BUFFER_SIZE, sizeof(char));
+	pWriter->capacity = MIO_WRITER_BUFFER_SIZE;
+
+	return true;
+}
+
+bool mioWriterOpenTemporary(MioWriter* pWriter)
+{
+	memset(pWriter, 0, sizeof(MioWriter));
+
+	pWriter->file = tmpfile();
+
+	if(pWriter->file == NULL)
+	{
+		return false;
+	}
+
+	pWriter->pBuffer = (char*)mioAllocate(MIO_WRITER_BUFFER_SIZE, sizeof(char));
+	pWriter->capacity = MIO_WRITER_BUFFER_SIZE;
+
+	return true;
+}
+
+void mioWriterOpenMemory(MioWriter* pWriter)
+{
+	memset(pWriter, 0, sizeof(MioWriter));
+
+	pWriter->pBuffer = (char*)mioAllocate(MIO_WRITER_BUFFER_SIZE, sizeof(char));
+	pWriter->capacity = MIO_WRITER_BUFFER_SIZE;
+}
+
+void mioWriterFlush(MioWriter* pWriter)
+{
+	if(pWriter->file == NULL)
+	{
+		return; // i.e. the output stays in memory
+	}
+
+	if(pWriter->size > 0 && !pWriter->failed)
+	{
+		const size_t written = fwrite(pWriter->pBuffer, 1, pWriter->size, pWriter->file);
+		pWriter->failed = (written != pWriter->size);
+	}
+
+	pWriter->size = 0;
+}
+
+bool mioWriterClose(MioWriter* pWriter)
+{
+	mioWriterFlush(pWriter);
+
+	bool ok = true;
+
+	if(pWriter->file != NULL)
+	{
+		ok = !pWriter->failed && (fclose(pWriter->file) == 0);
+
+		if(pWriter->failed)
+		{
+			fclose(pWriter->file);
+		}
+	}
+
+	mioMemFree(pWriter->pBuffer);
+	memset(pWriter, 0, sizeof(MioWriter));
+
+	return ok;
+}
+
+void mioWriterMakeRoom(MioWriter* pWriter, size_t count)
+{
+	if(pWriter->file != NULL)
+	{
+		mioWriterFlush(pWriter);
+		return;
+	}
+
+	MioArray buffer = {pWriter->pBuffer, pWriter->size, pWriter->capacity};
+
+	mioArrayReserve(&buffer, sizeof(char), pWriter->size + count);
+
+	pWriter->pBuffer = (char*)buffer.pData;
+	pWriter->capacity = buffer.capacity;
+}
+
+void mioWriterPutBytes(MioWriter* pWriter, const char* pBytes, size_t count)
+{
+	if(pWriter->file != NULL && pWriter->capacity - pWriter->size < count)
+	{
+		mioWriterFlush(pWriter);
+
+		if(count > pWriter->capacity && !pWriter->failed)
+		{
+			// a large block is not copied through the buffer
+			const size_t written = fwrite(pBytes, 1, count, pWriter->file);
+			pWriter->failed = (written != count);
+			return;
+		}
+	}
+
+	memcpy(mioWriterReserve(pWriter, count), pBytes, count);
+	mioWriterCommit(pWriter, count);
+}
+
+//
+// Chunked (multi-threaded) formatting
+//
+
+// a chunk of rows that is formatted into a buffer of its own by "formatChunkTask"
+typedef struct RowChunk
+{
+	MioFormatRowsFunc pfnFormat;
+	const void* pContext;
+	size_t beginRow;
+	size_t endRow;
+	size_t offset;
+	MioWriter writer;
+} RowChunk;
+
+// the chunks whose sizes are summed by "sumChunksTask"
+typedef struct RowSumTask
+{
+	const unsigned int* pRowSizes;
+	size_t numRows;
+	size_t beginChunk;
+	size_t endChunk;
+	// the sum of the row sizes of each chunk of the table
+	size_t* pChunkSums;
+} RowSumTask;
+
+// Function to get the end of the rows of chunk "c" of a table of "numRows" rows
+static size_t getChunkEnd(size_t c, size_t numRows)
+{
+	const size_t endRow = (c + 1) * MIO_ROWS_PER_CHUNK;
+	return (endRow < numRows) ? endRow : numRows;
+}
+
+static void sumChunksTask(void* pArg)
+{
+	const RowSumTask* pTask = (const RowSumTask*)pArg;
+
+	for(size_t c = pTask->beginChunk; c < pTask->endChunk; ++c)
+	{
+		const size_t endRow = getChunkEnd(c, pTask->numRows);
+		size_t sum = 0;
+
+		for(size_t r = c * MIO_ROWS_PER_CHUNK; r < endRow; ++r)
+		{
+			sum += pTask->pRowSizes[r];
+		}
+
+		pTask->pChunkSums[c] = sum;
+	}
+}
+
+static void formatChunkTask(void* pArg)
+{
+	RowChunk* pChunk = (RowChunk*)pArg;
+
+	pChunk->writer.size = 0;
+	pChunk->pfnFormat(
+		&pChunk->writer, pChunk->pContext, pChunk->beginRow, pChunk->endRow, pChunk->offset);
+}
+
+// Function to compute the offset of the first row of each of the "numChunks" chunks of a table (see
+// "mioWriterPutRows"), where the row sizes of the chunks are summed on "numThreads" threads and
+// the offsets are the (exclusive) prefix sum of these sums
+static size_t* getChunkOffsets(size_t numRows,
+							   const unsigned int* pRowSizes,
+							   unsigned int rowSize,
+							   size_t numChunks,
+							   unsigned int numThreads)
+{
+	size_t* pOffsets = (size_t*)mioAllocate(numChunks, sizeof(size_t));
+
+	if(pRowSizes == NULL)
+	{
+		for(size_t c = 0; c < numChunks; ++c)
+		{
+			pOffsets[c] = c * MIO_ROWS_PER_CHUNK * (size_t)rowSize;
+		}
+
+		return pOffsets;
+	}
+
+	const size_t numTasks = (numThreads < numChunks) ? numThreads : numChunks;
+	RowSumTask* pTasks = (RowSumTask*)mioAllocate(numTasks, sizeof(RowSumTask));
+
+	for(size_t i = 0; i < numTasks; ++i)
+	{
+		pTasks[i].pRowSizes = pRowSizes;
+		pTasks[i].numRows = numRows;
+		pTasks[i].beginChunk = (numChunks * i) / numTasks;
+		pTasks[i].endChunk = (numChunks * (i + 1)) / numTasks;
+		pTasks[i].pChunkSums = pOffsets;
+	}
+
+	mioRunTasks(sumChunksTask, pTasks, sizeof(RowSumTask), numTasks);
+	mioMemFree(pTasks);
+
+	size_t offset = 0;
+
+	for(size_t c = 0; c < numChunks; ++c)
+	{
+		const size_t sum = pOffsets[c];
+		pOffsets[c] = offset;
+		offset += sum;
+	}
+
+	return pOffsets;
+}
+
+void mioWriterPutRows(MioWriter* pWriter,
+					  MioFormatRowsFunc pfnFormat,
+					  const void* pContext,
+					  size_t numRows,
+					  const unsigned int* pRowSizes,
+					  unsigned int rowSize,
+					  unsigned int numThreads)
+{
+	if(numThreads == 0)
+	{
+		numThreads = mioGetHardwareThreadCount();
+	}
+
+	const size_t numChunks = (numRows + MIO_ROWS_PER_CHUNK - 1) / MIO_ROWS_PER_CHUNK;
+
+	if(numThreads <= 1 || numChunks <= 1)
+	{
+		pfnFormat(pWriter, pContext, 0, numRows, 0);
+		return;
+	}
+
+	size_t* pOffsets = getChunkOffsets(numRows, pRowSizes, rowSize, numChunks, numThreads);
+
+	// the chunks are formatted in rounds of (up to) one chunk per thread, and the buffers of a
+	// round are written out before the next round reuses them
+	const size_t numTasks = (numThreads < numChunks) ? numThreads : numChunks;
+	RowChunk* pChunks = (RowChunk*)mioAllocate(numTasks, sizeof(RowChunk));
+
+	for(size_t i = 0; i < numTasks; ++i)
+	{
+		pChunks[i].pfnFormat = pfnFormat;
+		pChunks[i].pContext = pContext;
+		mioWriterOpenMemory(&pChunks[i].writer);
+	}
+
+	for(size_t roundBegin = 0; roundBegin < numChunks; roundBegin += numTasks)
+	{
+		const size_t numLeft = numChunks - roundBegin;
+		const size_t roundSize = (numTasks < numLeft) ? numTasks : numLeft;
+
+		for(size_t i = 0; i < roundSize; ++i)
+		{
+			const size_t c = roundBegin + i;
+
+			pChunks[i].beginRow = c * MIO_ROWS_PER_CHUNK;
+			pChunks[i].endRow = getChunkEnd(c, numRows);
+			pChunks[i].offset = pOffsets[c];
+		}
+
+		// NOTE: the calling thread formats the first chunk
+		mioRunTasks(formatChunkTask, pChunks, sizeof(RowChunk), roundSize);
+
+		for(size_t i = 0; i < roundSize; ++i)
+		{
+			mioWriterPutBytes(pWriter, pChunks[i].writer.pBuffer, pChunks[i].writer.size);
+		}
+	}
+
+	for(size_t i = 0; i < numTasks; ++i)
+	{
+		mioWriterClose(&pChunks[i].writer);
+	}
+
+	mioMemFree(pChunks);
+	mioMemFree(pOffsets);
+}
+
+void mioWriterPutDouble(MioWriter* pWriter, double value)
+{
+	if(floatFormat == MIO_FLOAT_FORMAT_FIXED)
+	{
+		char* p = mioWriterReserve(pWriter, MIO_MAX_FIXED_DOUBLE_CHARS);
+		mioWriterCommit(pWriter, mioFormatDoubleFixed(p, value));
+	}
+	else
+	{
+		char* p = mioWriterReserve(pWriter, MIO_MAX_DOUBLE_CHARS);
+		mioWriterCommit(pWriter, mioFormatDouble(p, value));
+	}
+}
+
+void mioWriterPutFloat(MioWriter* pWriter, float value)
+{
+	if(floatFormat == MIO_FLOAT_FORMAT_FIXED)
+	{
+		char* p = mioWriterReserve(pWriter, MIO_MAX_FIXED_DOUBLE_CHARS);
+		mioWriterCommit(pWriter, mioFormatDoubleFixed(p, (double)value));
+	}
+	else
+	{
+		char* p = mioWriterReserve(pWriter, MIO_MAX_DOUBLE_CHARS);
+		mioWriterCommit(pWriter, mioFormatFloat(p, value));
+	}
+}
+
+//
+// Integer formatting
+//
+
+static const char digitPairs[201] = "00010203040506070809"
+									"10111213141516171819"
+									"20212223242526272829"
+									"30313233343536373839"
+									"40414243444546474849"
+									"50515253545556575859"
+									"60616263646566676869"
+									"70717273747576777879"
+									"80818283848586878889"
+									"90919293949596979899";
+
+static size_t formatUint64(char* pOut, uint64_t value)
+{
+	// digits are generated (two at a time) from the back of a temporary
+	char digits[20];
+	char* p = digits + sizeof(digits);
+
+	while(value >= 100)
+	{
+		const unsigned int pair = (unsigned int)(value % 100);
+		value /= 100;
+		p -= 2;
+		memcpy(p, digitPairs + pair * 2, 2);
+	}
+
+	if(value >= 10)
+	{
+		p -= 2;
+		memcpy(p, digitPairs + value * 2, 2);
+	}
+	else
+	{
+		*--p = (char)('0' + value);
+	}
+
+	const size_t len = (size_t)(digits + sizeof(digits) - p);
+	memcpy(pOut, p, len);
+
+	return len;
+}
+
+size_t mioFormatUint(char* pOut, uint32_t value)
+{
+	return formatUint64(pOut, value);
+}
+
+//
+// Shortest round-trip double-to-decimal conversion.
+//
+// This is the Schubfach algorithm (see R. Giulietti, "The Schubfach way to render doubles", 2020),
+// which finds the shortest decimal in the rounding interval of a double (and the one closest to
+// it if there are several) with three 128x64-bit multiplications. The 128-bit approximations of
+// 10^-k are the powers of five that are shared with the parser.
+//
+
+// floor(log10(2^e))
+static inline int flog10pow2(int e)
+{
+	return (int)(((int64_t)e * 661971961083LL) >> 41);
+}
+
+// floor(log10(3/4 * 2^e))
+static inline int flog10threeQuartersPow2(int e)
+{
+	return (int)(((int64_t)e * 661971961083LL - 274743187321LL) >> 41);
+}
+
+// floor(log2(10^e))
+static inline int flog2pow10(int e)
+{
+	return (int)(((int64_t)e * 913124641741LL) >> 38);
+}
+
+// Function to compute floor(g * cp / 2^128), rounded to odd (i.e. with the lowest bit set if the
+// division is inexact), where g = [gHigh, gLow]
+// NOTE: g is (slightly) larger than 10^-k, which only affects the lowest 64 bits of the product,
+// so these are ignored for telling exact from inexact results.
+static inline uint64_t roundToOdd(uint64_t gHigh, uint64_t gLow, uint64_t cp)
+{
+	uint64_t xHigh = 0;
+	mioMultiply128(gLow, cp, &xHigh);
+	uint64_t yHigh = 0;
+	const uint64_t yLow = mioMultiply128(gHigh, cp, &yHigh);
+	const uint64_t middle = yLow + xHigh;
+	const uint64_t high = yHigh + (middle < yLow);
+
+	return high | (uint64_t)(middle != 0);
+}
+
+// Function to compute the shortest decimal significand "f" and exponent "e", such that f * 10^e
+// parses back to c * 2^q (which is then c * 2^q * 10^dk)
+static void toDecimal(int q, uint64_t c, int dk, uint64_t* pSignificand, int* pExponent)
+{
+	const uint64_t out = c & 1; // the interval bounds are excluded if c is odd
+	const uint64_t cb = c << 2;
+	const uint64_t cbr = cb + 2;
+	uint64_t cbl = 0;
+	int k = 0;
+
+	if(c != (1ull << 52) || q == -1074)
+	{
+		cbl = cb - 2;
+		k = flog10pow2(q);
+	}
+	else
+	{ // the interval is asymmetric at powers of two
+		cbl = cb - 1;
+		k = flog10threeQuartersPow2(q);
+	}
+
+	const int h = q + flog2pow10(-k) + 1;
+
+	// g = floor(10^-k * 2^-r) + 1, normalised to 128 bits
+	// NOTE: the table is truncated except for 5^q with q in [-27, -1], which is rounded up
+	const size_t index = 2 * (size_t)(-k - MIO_SMALLEST_POWER_OF_FIVE);
+	uint64_t gHigh = mioPowersOfFive128[index];
+	uint64_t gLow = mioPowersOfFive128[index + 1];
+
+	if(-k < -27 || -k >= 0)
+	{
+		gLow++;
+		gHigh += (gLow == 0);
+	}
+
+	const uint64_t vb = roundToOdd(gHigh, gLow, cb << h);
+	const uint64_t vbl = roundToOdd(gHigh, gLow, cbl << h);
+	const uint64_t vbr = roundToOdd(gHigh, gLow, cbr << h);
+
+	const uint64_t s = vb >> 2;
+
+	// NOTE: s only has less than 16 digits for subnormals
+	if(s >= 10)
+	{ // try one digit less
+		const uint64_t sp10 = (s / 10) * 10;
+		const uint64_t tp10 = sp10 + 10;
+		const bool upin = vbl + out <= (sp10 << 2);
+		const bool wpin = (tp10 << 2) + out <= vbr;
+
+		if(upin != wpin)
+		{
+			*pSignificand = upin ? sp10 : tp10;
+			*pExponent = k;
+			return;
+		}
+	}
+
+	const uint64_t t = s + 1;
+	const bool uin = vbl + out <= (s << 2);
+	const bool win = (t << 2) + out <= vbr;
+
+	if(uin != win)
+	{
+		*pSignificand = uin ? s : t;
+		*pExponent = k + dk;
+		return;
+	}
+
+	// both are in the interval, so pick the closest one (or the even one if it is a tie)
+	const int64_t cmp = (int64_t)(vb - ((s + t) << 1));
+
+	*pSignificand = (cmp < 0 || (cmp == 0 && (s & 1) == 0)) ? s : t;
+	*pExponent = k + dk;
+}
+
+// Function to compute floor(g * cp / 2^96), rounded to odd, for the single precision variant of
+// "toDecimal"
+static inline uint32_t roundToOddFloat(uint64_t g, uint64_t cp)
+{
+	uint64_t high = 0;
+	mioMultiply128(g, cp, &high);
+
+	return (uint32_t)(high >> 32) | (uint32_t)((high & 0xFFFFFFFFu) != 0);
+}
+
+// Function to compute the shortest decimal significand "f" and exponent "e", such that f * 10^e
+// parses back to the float c * 2^q
+// NOTE: this is "toDecimal" for floats, where the upper 64 bits of 10^-k are precise enough
+static void toDecimalFloat(int q, uint32_t c, uint64_t* pSignificand, int* pExponent)
+{
+	const uint32_t out = c & 1;
+	const uint64_t cb = (uint64_t)c << 2;
+	const uint64_t cbr = cb + 2;
+	uint64_t cbl = 0;
+	int k = 0;
+
+	if(c != (1u << 23) || q == -149)
+	{
+		cbl = cb - 2;
+		k = flog10pow2(q);
+	}
+	else
+	{
+		cbl = cb - 1;
+		k = flog10threeQuartersPow2(q);
+	}
+
+	const int h = q + flog2pow10(-k) + 33;
+
+	// g = floor(10^-k * 2^-r) + 1, normalised to 64 bits
+	const uint64_t g = mioPowersOfFive128[2 * (size_t)(-k - MIO_SMALLEST_POWER_OF_FIVE)] + 1;
+
+	const uint32_t vb = roundToOddFloat(g, cb << h);
+	const uint32_t vbl = roundToOddFloat(g, cbl << h);
+	const uint32_t vbr = roundToOddFloat(g, cbr << h);
+
+	const uint32_t s = vb >> 2;
+
+	if(s >= 10)
+	{
+		const uint32_t sp10 = (s / 10) * 10;
+		const uint32_t tp10 = sp10 + 10;
+		const bool upin = vbl + out <= (sp10 << 2);
+		const bool wpin = (tp10 << 2) + out <= vbr;
+
+		if(upin != wpin)
+		{
+			*pSignificand = upin ? sp10 : tp10;
+			*pExponent = k;
+			return;
+		}
+	}
+
+	const uint32_t t = s + 1;
+	const bool uin = vbl + out <= (s << 2);
+	const bool win = (t << 2) + out <= vbr;
+
+	if(uin != win)
+	{
+		*pSignificand = uin ? s : t;
+		*pExponent = k;
+		return;
+	}
+
+	const int32_t cmp = (int32_t)(vb - ((s + t) << 1));
+
+	*pSignificand = (cmp < 0 || (cmp == 0 && (s & 1) == 0)) ? s : t;
+	*pExponent = k;
+}
+
+// Function to write f * 10^e (in the style of "%g", but with all significant digits)
+static size_t writeDecimal(char* pOut, uint64_t f, int e)
+{
+	while(f % 10 == 0)
+	{
+		f /= 10;
+		e++;
+	}
+
+	char digits[20];
+	const int numDigits = (int)formatUint64(digits, f);
+	const int pointPos = numDigits + e; // number of digits before the decimal point
+	char* p = pOut;
+
+	if(pointPos - 1 >= -4 && pointPos - 1 < 16)
+	{ // fixed notation
+		if(pointPos <= 0)
+		{ // e.g. 0.00123
+			*p++ = '0';
+			*p++ = '.';
+			memset(p, '0', (size_t)-pointPos);
+			p += -pointPos;
+			memcpy(p, digits, (size_t)numDigits);
+			p += numDigits;
+		}
+		else if(pointPos >= numDigits)
+		{ // e.g. 12300
+			memcpy(p, digits, (size_t)numDigits);
+			p += numDigits;
+			memset(p, '0', (size_t)(pointPos - numDigits));
+			p += pointPos - numDigits;
+		}
+		else
+		{ // e.g. 12.3
+			memcpy(p, digits, (size_t)pointPos);
+			p += pointPos;
+			*p++ = '.';
+			memcpy(p, digits + pointPos, (size_t)(numDigits - pointPos));
+			p += numDigits - pointPos;
+		}
+	}
+	else
+	{ // scientific notation e.g. 1.23e-07
+		*p++ = digits[0];
+
+		if(numDigits > 1)
+		{
+			*p++ = '.';
+			memcpy(p, digits + 1, (size_t)(numDigits - 1));
+			p += numDigits - 1;
+		}
+
+		int exponent = pointPos - 1;
+
+		*p++ = 'e';
+		*p++ = (exponent < 0) ? '-' : '+';
+		exponent = (exponent < 0) ? -exponent : exponent;
+
+		if(exponent < 10)
+		{
+			*p++ = '0';
+		}
+
+		p += formatUint64(p, (uint64_t)exponent);
+	}
+
+	return (size_t)(p - pOut);
+}
+
+size_t mioFormatDouble(char* pOut, double value)
+{
+	uint64_t bits = 0;
+	memcpy(&bits, &value, sizeof(double));
+
+	const uint64_t t = bits & ((1ull << 52) - 1); // mantissa bits
+	const int bq = (int)((bits >> 52) & 0x7FF); // biased exponent
+	char* p = pOut;
+
+	if(bits >> 63)
+	{
+		*p++ = '-';
+	}
+
+	if(bq == 0x7FF)
+	{
+		memcpy(p, (t != 0) ? "nan" : "inf", 3);
+		return (size_t)(p - pOut) + 3;
+	}
+
+	if(bq == 0 && t == 0)
+	{
+		*p++ = '0';
+		return (size_t)(p - pOut);
+	}
+
+	uint64_t f = 0;
+	int e = 0;
+
+	if(bq != 0)
+	{ // normal
+		const int mq = 1075 - bq; // value = c * 2^-mq
+		const uint64_t c = (1ull << 52) | t;
+		const bool isSmallInteger = (mq > 0 && mq < 53 && ((c >> mq) << mq) == c);
+
+		if(isSmallInteger)
+		{
+			f = c >> mq;
+			e = 0;
+		}
+		else
+		{
+			toDecimal(-mq, c, 0, &f, &e);
+		}
+	}
+	else if(t < 3)
+	{ // the algorithm needs c >= 3, and the two smallest subnormals are 5e-324 and 1e-323
+		f = (t == 1) ? 5 : 1;
+		e = (t == 1) ? -324 : -323;
+	}
+	else
+	{ // subnormal
+		toDecimal(-1074, t, 0, &f, &e);
+	}
+
+	return (size_t)(p - pOut) + writeDecimal(p, f, e);
+}
+
+size_t mioFormatFloat(char* pOut, float value)
+{
+	uint32_t bits = 0;
+	memcpy(&bits, &value, sizeof(float));
+
+	const uint32_t t = bits & ((1u << 23) - 1); // mantissa bits
+	const int bq = (int)((bits >> 23) & 0xFF); // biased exponent
+	char* p = pOut;
+
+	if(bits >> 31)
+	{
+		*p++ = '-';
+	}
+
+	if(bq == 0xFF)
+	{
+		memcpy(p, (t != 0) ? "nan" : "inf", 3);
+		return (size_t)(p - pOut) + 3;
+	}
+
+	if(bq == 0 && t == 0)
+	{
+		*p++ = '0';
+		return (size_t)(p - pOut);
+	}
+
+	uint64_t f = 0;
+	int e = 0;
+
+	if(bq != 0)
+	{ // normal
+		const int mq = 150 - bq; // value = c * 2^-mq
+		const uint32_t c = (1u << 23) | t;
+		const bool isSmallInteger = (mq > 0 && mq < 24 && ((c >> mq) << mq) == c);
+
+		if(isSmallInteger)
+		{
+			f = c >> mq;
+			e = 0;
+		}
+		else
+		{
+			toDecimalFloat(-mq, c, &f, &e);
+		}
+	}
+	else if(t < 3)
+	{ // the two smallest subnormals are 1e-45 and 3e-45
+		f = (t == 1) ? 1 : 3;
+		e = -45;
+	}
+	else
+	{ // subnormal
+		toDecimalFloat(-149, t, &f, &e);
+	}
+
+	return (size_t)(p - pOut) + writeDecimal(p, f, e);
+}
+
+//
+// Exact "%f" formatting.
+//
+// A finite double is m * 2^q, so its value with 6 decimal places is the integer part of m * 2^q
+// followed by round(fraction * 10^6), which can be computed exactly with 128-bit integers. Only the
+// (huge) values whose integer part does not fit into 64 bits are handed over to snprintf.
+//
+
+// Function to compute round-half-to-even([high, low] / 2^shift), for shift in [1, 127]. The
+// result must fit into 64 bits.
+static uint64_t roundShift128(uint64_t high, uint64_t low, int shift)
+{
+	uint64_t result = 0;
+	uint64_t remHigh = 0;
+	uint64_t remLow = 0;
+	uint64_t halfHigh = 0;
+	uint64_t halfLow = 0;
+
+	if(shift < 64)
+	{
+		result = (low >> shift) | (high << (64 - shift));
+		remLow = low & ((1ull << shift) - 1);
+		halfLow = 1ull << (shift - 1);
+	}
+	else if(shift == 64)
+	{
+		result = high;
+		remLow = low;
+		halfLow = 1ull << 63;
+	}
+	else
+	{
+		result = high >> (shift - 64);
+		remHigh = high & ((1ull << (shift - 64)) - 1);
+		remLow = low;
+		halfHigh = 1ull << (shift - 65);
+	}
+
+	const bool aboveHalf = (remHigh > halfHigh) || (remHigh == halfHigh && remLow > halfLow);
+	const bool isHalf = (remHigh == halfHigh && remLow == halfLow);
+
+	if(aboveHalf || (isHalf && (result & 1)))
+	{
+		result++;
+	}
+
+	return result;
+}
+
+size_t mioFormatDoubleFixed(char* pOut, double value)
+{
+	uint64_t bits = 0;
+	memcpy(&bits, &value, sizeof(double));
+
+	const uint64_t t = bits & ((1ull << 52) - 1);
+	const int bq = (int)((bits >> 52) & 0x7FF);
+	const uint64_t m = (bq != 0) ? ((1ull << 52) | t) : t;
+	const int q = (bq != 0) ? (bq - 1075) : -1074;
+
+	if(bq == 0x7FF || q > 11)
+	{ // inf/nan, or |value| >= 2^64
+		const int len = snprintf(pOut, MIO_MAX_FIXED_DOUBLE_CHARS, "%f", value);
+		return (len > 0) ? (size_t)len : 0;
+	}
+
+	uint64_t integer = 0;
+	uint64_t fraction = 0; // in units of 10^-6
+
+	if(q >= 0)
+	{
+		integer = m << q;
+	}
+	else
+	{
+		const int shift = -q;
+		uint64_t fractionBits = m;
+
+		if(shift < 64)
+		{
+			integer = m >> shift;
+			fractionBits = m & ((1ull << shift) - 1);
+		}
+
+		if(shift < 128)
+		{
+			uint64_t high = 0;
+			const uint64_t low = mioMultiply128(fractionBits, 1000000, &high);
+			fraction = roundShift128(high, low, shift); // NOTE: m < 2^53, so the product < 2^73
+
+			if(fraction == 1000000)
+			{ // rounded up to the next integer
+				integer++;
+				fraction = 0;
+			}
+		}
+	}
+
+	char* p = pOut;
+
+	if(bits >> 63)
+	{
+		*p++ = '-';
+	}
+
+	p += formatUint64(p, integer);
+	*p++ = '.';
+
+	char fractionDigits[8];
+	const size_t numFractionDigits = formatUint64(fractionDigits, fraction);
+	memset(p, '0', 6 - numFractionDigits);
+	p += 6 - numFractionDigits;
+	memcpy(p, fractionDigits, numFractionDigits);
+	p += numFractionDigits;
+
+	return (size_t)(p - pOut);
+}
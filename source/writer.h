@@ -0,0 +1,177 @@
+/***************************************************************************
+ *
+ *  Copyright (C) 2024 CutDigital Enterprise Ltd
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  For your convenience, a copy of the License has been included in this
+ *  repository.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.WE
+ *
+ **************************************************************************/
+
+#ifndef __MIO_WRITER_H__
+#define __MIO_WRITER_H__ 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Internal output layer shared by the writers.
+//
+// Text is formatted directly into a large in-memory buffer (numbers are formatted by hand rather
+// than with printf), which is written to the file in big blocks.
+
+// maximum number of characters written by "mioFormatDouble"
+#define MIO_MAX_DOUBLE_CHARS 32
+
+// maximum number of characters written by "mioFormatDoubleFixed" (e.g. "-DBL_MAX" with "%f")
+#define MIO_MAX_FIXED_DOUBLE_CHARS 320
+
+// maximum number of characters written by "mioFormatUint"
+#define MIO_MAX_UINT_CHARS 10
+
+typedef struct MioWriter
+{
+	// the file that is written, or NULL for a writer that formats into memory (in which case the
+	// buffer grows to hold all of the output)
+	FILE* file;
+	// bytes that have not been written to "file" yet
+	char* pBuffer;
+	size_t size;
+	size_t capacity;
+	// true once a write to "file" has failed
+	bool failed;
+} MioWriter;
+
+// Function to open the file at "fpath" for writing with the given "fopen" mode. Returns false if
+// the file cannot be opened.
+bool mioWriterOpen(MioWriter* pWriter, const char* fpath, const char* mode);
+
+// Function to open a writer that formats into memory instead of a file (see "mioWriterPutRows")
+void mioWriterOpenMemory(MioWriter* pWriter);
+
+// Function to open a writer for an anonymous temporary file (see "tmpfile"), which is removed when
+// it is closed. Returns false if the file cannot be created.
+bool mioWriterOpenTemporary(MioWriter* pWriter);
+
+// Function to write out any buffered bytes and close the file. Returns false if any write failed.
+bool mioWriterClose(MioWriter* pWriter);
+
+// Function to write out the buffered bytes
+void mioWriterFlush(MioWriter* pWriter);
+
+// Function to make room for "count" more bytes in the buffer, by writing it out to the file or (for
+// a writer that formats into memory) by growing it
+void mioWriterMakeRoom(MioWriter* pWriter, size_t count);
+
+// Function to write the "count" bytes at "pBytes", where a block that does not fit into the buffer
+// is written straight to the file
+void mioWriterPutBytes(MioWriter* pWriter, const char* pBytes, size_t count);
+
+// Function to format the rows "[beginRow, endRow)" of a table (e.g. the faces of a mesh) into
+// "pWriter", where "offset" is the sum of the sizes of the rows before "beginRow" (e.g. the index
+// of the first face-vertex of the face "beginRow")
+typedef void (*MioFormatRowsFunc)(
+	MioWriter* pWriter, const void* pContext, size_t beginRow, size_t endRow, size_t offset);
+
+// Function to write the "numRows" rows of a table with "pfnFormat", where the size of a row is
+// given by "pRowSizes", or is "rowSize" if "pRowSizes" is NULL. The rows are split into chunks
+// that are formatted into buffers of their own on up to "numThreads" threads (0 = number of
+// hardware threads), and the buffers are then written out in order, so the output is the same
+// as that of formatting all rows straight into "pWriter".
+void mioWriterPutRows(MioWriter* pWriter,
+					  MioFormatRowsFunc pfnFormat,
+					  const void* pContext,
+					  size_t numRows,
+					  const unsigned int* pRowSizes,
+					  unsigned int rowSize,
+					  unsigned int numThreads);
+
+// Function to format "value" as the shortest decimal string that parses back to the same double
+// (e.g. "0.1", "-3", "1e+300"). Returns the number of characters written (no null terminator).
+size_t mioFormatDouble(char* pOut, double value);
+
+// Function to format "value" as the shortest decimal string that parses back to the same float
+// (e.g. "0.1" rather than "0.100000001"). Writes at most MIO_MAX_DOUBLE_CHARS characters.
+size_t mioFormatFloat(char* pOut, float value);
+
+// Function to format "value" exactly like printf's "%f" (i.e. with 6 decimal places) in the "C"
+// locale. Returns the number of characters written (no null terminator).
+size_t mioFormatDoubleFixed(char* pOut, double value);
+
+// Function to format "value" in decimal. Returns the number of characters written (no null
+// terminator).
+size_t mioFormatUint(char* pOut, uint32_t value);
+
+// Function to get space for (at least) "count" bytes at the end of the buffer, which become part of
+// the output once they are committed with "mioWriterCommit".
+// NOTE: "count" must not be larger than the capacity of the buffer of a file writer.
+static inline char* mioWriterReserve(MioWriter* pWriter, size_t count)
+{
+	if(pWriter->capacity - pWriter->size < count)
+	{
+		mioWriterMakeRoom(pWriter, count);
+	}
+
+	return pWriter->pBuffer + pWriter->size;
+}
+
+static inline void mioWriterCommit(MioWriter* pWriter, size_t count)
+{
+	pWriter->size += count;
+}
+
+static inline void mioWriterPutChar(MioWriter* pWriter, char c)
+{
+	*mioWriterReserve(pWriter, 1) = c;
+	mioWriterCommit(pWriter, 1);
+}
+
+// NOTE: "str" must not be longer than the capacity of the buffer
+static inline void mioWriterPutString(MioWriter* pWriter, const char* str)
+{
+	const size_t len = strlen(str);
+	memcpy(mioWriterReserve(pWriter, len), str, len);
+	mioWriterCommit(pWriter, len);
+}
+
+static inline void mioWriterPutUint(MioWriter* pWriter, unsigned int value)
+{
+	char* p = mioWriterReserve(pWriter, MIO_MAX_UINT_CHARS);
+	mioWriterCommit(pWriter, mioFormatUint(p, value));
+}
+
+// Function to write "value" in the format that is selected with "mioSetFloatFormat"
+void mioWriterPutDouble(MioWriter* pWriter, double value);
+
+// Function to write the single precision "value" in the format that is selected with
+// "mioSetFloatFormat"
+void mioWriterPutFloat(MioWriter* pWriter, float value);
+
+// Function to write the element at "index" of "pCoords", which is an array of doubles or floats
+// (i.e. "coordSize" is sizeof(double) or sizeof(float))
+static inline void
+mioWriterPutCoord(MioWriter* pWriter, const void* pCoords, size_t index, size_t coordSize)
+{
+	if(coordSize == sizeof(double))
+	{
+		mioWriterPutDouble(pWriter, ((const double*)pCoords)[index]);
+	}
+	else
+	{
+		mioWriterPutFloat(pWriter, ((const float*)pCoords)[index]);
+	}
+}
+
+#endif // #ifndef __MIO_WRITER_H__